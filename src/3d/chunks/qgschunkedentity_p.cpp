@@ -16,6 +16,7 @@
 #include "qgschunkedentity_p.h"
 
 #include <QElapsedTimer>
+#include <QThread>
 #include <QVector4D>
 #include <Qt3DRender/QObjectPicker>
 #include <Qt3DRender/QPickTriangleEvent>
@@ -25,6 +26,7 @@
 #include "qgschunklist_p.h"
 #include "qgschunkloader_p.h"
 #include "qgschunknode_p.h"
+#include "qgssettings.h"
 #include "qgstessellatedpolygongeometry.h"
 
 #include "qgseventtracing.h"
@@ -82,6 +84,9 @@ QgsChunkedEntity::QgsChunkedEntity( float tau, QgsChunkLoaderFactory *loaderFact
   mRootNode = loaderFactory->createRootNode();
   mChunkLoaderQueue = new QgsChunkList;
   mReplacementQueue = new QgsChunkList;
+
+  // chunk loaders do most of their work in worker threads, so keep all cores busy
+  mMaxConcurrentJobs = std::max( QgsSettings().value( QStringLiteral( "3D/maxConcurrentChunkJobs" ), std::max( QThread::idealThreadCount(), 4 ) ).toInt(), 1 );
 }
 
 
@@ -248,6 +253,7 @@ int QgsChunkedEntity::pendingJobsCount() const
 void QgsChunkedEntity::update( QgsChunkNode *root, const SceneState &state )
 {
   QSet<QgsChunkNode *> nodes;
+  // nodes to load, with their screen space error and level
   QVector<std::tuple<QgsChunkNode *, float, int>> residencyRequests;
 
   using slot = std::pair<QgsChunkNode *, float>;
@@ -276,8 +282,7 @@ void QgsChunkedEntity::update( QgsChunkNode *root, const SceneState &state )
 
     // make sure all nodes leading to children are always loaded
     // so that zooming out does not create issues
-    double dist = node->bbox().center().distanceToPoint( state.cameraPos );
-    residencyRequests.push_back( std::make_tuple( node, dist, node->level() ) );
+    residencyRequests.push_back( std::make_tuple( node, s.second, node->level() ) );
 
     if ( !node->entity() )
     {
@@ -320,8 +325,7 @@ void QgsChunkedEntity::update( QgsChunkNode *root, const SceneState &state )
       QgsChunkNode *const *children = node->children();
       for ( int i = 0; i < node->childCount(); ++i )
       {
-        double dist = children[i]->bbox().center().distanceToPoint( state.cameraPos );
-        residencyRequests.push_back( std::make_tuple( children[i], dist, children[i]->level() ) );
+        residencyRequests.push_back( std::make_tuple( children[i], screenSpaceError( children[i], state ), children[i]->level() ) );
       }
     }
     if ( becomesActive )
@@ -337,15 +341,47 @@ void QgsChunkedEntity::update( QgsChunkNode *root, const SceneState &state )
       nodes.insert( node );
     }
   }
-  // sort nodes by their level and their distance from the camera
-  std::sort( residencyRequests.begin(), residencyRequests.end(), [&]( std::tuple<QgsChunkNode *, float, int> &n1, std::tuple<QgsChunkNode *, float, int> &n2 )
+  // sort nodes by their level and their screen space error: nodes are inserted at the front of
+  // the loader queue, so the queue ends up with the coarsest levels first and, within a level,
+  // the nodes with the largest error (i.e. the most visible missing detail) first
+  std::sort( residencyRequests.begin(), residencyRequests.end(), []( const std::tuple<QgsChunkNode *, float, int> &n1, const std::tuple<QgsChunkNode *, float, int> &n2 )
   {
     if ( std::get<2>( n1 ) == std::get<2>( n2 ) )
-      return std::get<1>( n1 ) >= std::get<1>( n1 );
-    return std::get<2>( n1 ) >= std::get<2>( n2 );
+      return std::get<1>( n1 ) < std::get<1>( n2 );
+    return std::get<2>( n1 ) > std::get<2>( n2 );
   } );
-  for ( std::tuple<QgsChunkNode *, float, int> n : residencyRequests )
+  QSet<QgsChunkNode *> requestedNodes;
+  for ( const std::tuple<QgsChunkNode *, float, int> &n : std::as_const( residencyRequests ) )
+  {
     requestResidency( std::get<0>( n ) );
+    requestedNodes.insert( std::get<0>( n ) );
+  }
+
+  // nodes which went out of view do not need to be loaded anymore
+  cancelUnrequestedLoads( requestedNodes );
+}
+
+void QgsChunkedEntity::cancelUnrequestedLoads( const QSet<QgsChunkNode *> &requestedNodes )
+{
+  QgsChunkListEntry *entry = mChunkLoaderQueue->first();
+  while ( entry )
+  {
+    QgsChunkListEntry *next = entry->next;
+    QgsChunkNode *node = entry->chunk;
+    if ( node->state() == QgsChunkNode::QueuedForLoad && !requestedNodes.contains( node ) )
+    {
+      mChunkLoaderQueue->takeEntry( entry );
+      node->cancelQueuedForLoad();  // also deletes the entry
+    }
+    entry = next;
+  }
+
+  const QList<QgsChunkQueueJob *> activeJobs = mActiveJobs;
+  for ( QgsChunkQueueJob *job : activeJobs )
+  {
+    if ( qobject_cast<QgsChunkLoader *>( job ) && !requestedNodes.contains( job->chunk() ) )
+      cancelActiveJob( job );
+  }
 }
 
 void QgsChunkedEntity::requestResidency( QgsChunkNode *node )
@@ -454,7 +490,7 @@ void QgsChunkedEntity::onActiveJobFinished()
 
 void QgsChunkedEntity::startJobs()
 {
-  while ( mActiveJobs.count() < 4 )
+  while ( mActiveJobs.count() < mMaxConcurrentJobs )
   {
     if ( mChunkLoaderQueue->isEmpty() )
       return;
@@ -518,6 +554,8 @@ void QgsChunkedEntity::cancelActiveJob( QgsChunkQueueJob *job )
     QgsEventTracing::addEvent( QgsEventTracing::AsyncEnd, QStringLiteral( "3D" ), QStringLiteral( "Update" ), node->tileId().text() );
   }
 
+  // the job may still emit finished() before it gets deleted
+  disconnect( job, &QgsChunkQueueJob::finished, this, &QgsChunkedEntity::onActiveJobFinished );
   job->cancel();
   mActiveJobs.removeOne( job );
   job->deleteLater();
@@ -45,6 +45,7 @@ class QgsChunkQueueJobFactory;
 
 #include <QTime>
 
+#include "qgis_3d.h"
 #include "qgsfeatureid.h"
 #include "qgschunknode_p.h"
 
@@ -59,7 +60,7 @@ namespace Qt3DRender
  * based on data error and unloading of data when data are not necessary anymore
  * \since QGIS 3.0
  */
-class QgsChunkedEntity : public Qt3DCore::QEntity
+class _3D_EXPORT QgsChunkedEntity : public Qt3DCore::QEntity
 {
     Q_OBJECT
   public:
@@ -111,6 +112,21 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
      */
     bool usingAditiveStrategy() const { return mAdditiveStrategy; }
 
+    /**
+     * Sets the maximum \a count of chunk load and update jobs processed at the same time.
+     * \see maximumConcurrentJobs()
+     * \since QGIS 3.20
+     */
+    void setMaximumConcurrentJobs( int count ) { mMaxConcurrentJobs = std::max( count, 1 ); }
+
+    /**
+     * Returns the maximum count of chunk load and update jobs processed at the same time.
+     * By default it is taken from the "3D/maxConcurrentChunkJobs" setting, or the number of CPU cores.
+     * \see setMaximumConcurrentJobs()
+     * \since QGIS 3.20
+     */
+    int maximumConcurrentJobs() const { return mMaxConcurrentJobs; }
+
   protected:
     //! Cancels the background job that is currently in progress
     void cancelActiveJob( QgsChunkQueueJob *job );
@@ -124,6 +140,9 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! make sure that the chunk will be loaded soon (if not loaded yet) and not unloaded anytime soon (if loaded already)
     void requestResidency( QgsChunkNode *node );
 
+    //! Cancels loading of chunks which are queued or being loaded, but not part of \a requestedNodes anymore
+    void cancelUnrequestedLoads( const QSet<QgsChunkNode *> &requestedNodes );
+
     void startJobs();
     QgsChunkQueueJob *startJob( QgsChunkNode *node );
 
@@ -182,6 +201,9 @@ class QgsChunkedEntity : public Qt3DCore::QEntity
     //! jobs that are currently being processed (asynchronously in worker threads)
     QList<QgsChunkQueueJob *> mActiveJobs;
 
+    //! maximum number of jobs processed at the same time
+    int mMaxConcurrentJobs = 4;
+
     //! If picking is enabled, QObjectPicker objects will be assigned to chunks and pickedObject() signals fired on mouse click
     bool mPickingEnabled = false;
 
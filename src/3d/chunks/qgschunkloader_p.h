@@ -39,7 +39,7 @@
  *
  * \since QGIS 3.0
  */
-class QgsChunkLoader : public QgsChunkQueueJob
+class _3D_EXPORT QgsChunkLoader : public QgsChunkQueueJob
 {
     Q_OBJECT
   public:
@@ -59,7 +59,7 @@ class QgsChunkLoader : public QgsChunkQueueJob
  * \brief Factory for chunk loaders for a particular type of entity
  * \since QGIS 3.0
  */
-class QgsChunkLoaderFactory  : public QObject
+class _3D_EXPORT QgsChunkLoaderFactory  : public QObject
 {
     Q_OBJECT
   public:
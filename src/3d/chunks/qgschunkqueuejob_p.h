@@ -36,6 +36,8 @@ namespace Qt3DCore
 
 #define SIP_NO_FILE
 
+#include "qgis_3d.h"
+
 #include <QObject>
 
 /**
@@ -54,7 +56,7 @@ namespace Qt3DCore
  *
  * \since QGIS 3.0
  */
-class QgsChunkQueueJob : public QObject
+class _3D_EXPORT QgsChunkQueueJob : public QObject
 {
     Q_OBJECT
   public:
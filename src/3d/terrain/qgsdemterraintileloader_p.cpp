@@ -76,11 +76,25 @@ QgsDemTerrainTileLoader::QgsDemTerrainTileLoader( QgsTerrainEntity *terrain, Qgs
     Q_ASSERT( false );
 
   // get heightmap asynchronously
+  mHeightMapGenerator = heightMapGenerator;
   connect( heightMapGenerator, &QgsDemHeightMapGenerator::heightMapReady, this, &QgsDemTerrainTileLoader::onHeightMapReady );
   mHeightMapJobId = heightMapGenerator->render( node->tileId() );
   mResolution = heightMapGenerator->resolution();
 }
 
+void QgsDemTerrainTileLoader::cancel()
+{
+  if ( mHeightMapJobId != -1 && mHeightMapGenerator )
+  {
+    disconnect( mHeightMapGenerator, &QgsDemHeightMapGenerator::heightMapReady, this, &QgsDemTerrainTileLoader::onHeightMapReady );
+    mHeightMapGenerator->cancelJob( mHeightMapJobId );
+    mHeightMapJobId = -1;
+  }
+
+  // the map texture may be rendering already if the height map was ready
+  QgsTerrainTileLoader::cancel();
+}
+
 Qt3DCore::QEntity *QgsDemTerrainTileLoader::createEntity( Qt3DCore::QEntity *parent )
 {
   float zMin, zMax;
@@ -244,6 +258,25 @@ int QgsDemHeightMapGenerator::render( const QgsChunkNodeId &nodeId )
   return jd.jobId;
 }
 
+void QgsDemHeightMapGenerator::cancelJob( int jobId )
+{
+  for ( auto it = mJobs.begin(); it != mJobs.end(); ++it )
+  {
+    if ( it->jobId == jobId )
+    {
+      QFutureWatcher<QByteArray> *fw = it.key();
+      QgsEventTracing::addEvent( QgsEventTracing::AsyncEnd, QStringLiteral( "3D" ), QStringLiteral( "DEM" ), it->tileId.text() );
+
+      // a job still waiting in the thread pool will not start at all, a running one
+      // cannot be interrupted: its result gets dropped and the watcher deletes itself once finished
+      disconnect( fw, &QFutureWatcher<QByteArray>::finished, this, &QgsDemHeightMapGenerator::onFutureFinished );
+      it->future.cancel();
+      mJobs.erase( it );
+      return;
+    }
+  }
+}
+
 void QgsDemHeightMapGenerator::waitForFinished()
 {
   for ( QFutureWatcher<QByteArray> *fw : mJobs.keys() )
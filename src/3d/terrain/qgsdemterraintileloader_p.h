@@ -33,6 +33,7 @@
 #include <QFutureWatcher>
 #include <QElapsedTimer>
 #include <QMutex>
+#include <QPointer>
 
 #include "qgschunknode_p.h"
 #include "qgscoordinatetransformcontext.h"
@@ -44,6 +45,7 @@ class QgsRasterDataProvider;
 class QgsRasterLayer;
 class QgsCoordinateTransformContext;
 class QgsTerrainGenerator;
+class QgsDemHeightMapGenerator;
 
 /**
  * \ingroup 3d
@@ -59,12 +61,17 @@ class QgsDemTerrainTileLoader : public QgsTerrainTileLoader
 
     Qt3DCore::QEntity *createEntity( Qt3DCore::QEntity *parent ) override;
 
+    //! Cancels reading of the height map and rendering of the map texture if they are still in progress
+    void cancel() override;
+
   private slots:
     void onHeightMapReady( int jobId, const QByteArray &heightMap );
 
   private:
 
-    int mHeightMapJobId;
+    //! the generator may get replaced (and deleted) while the terrain entity still exists
+    QPointer<QgsDemHeightMapGenerator> mHeightMapGenerator;
+    int mHeightMapJobId = -1;
     QByteArray mHeightMap;
     int mResolution;
     float mSkirtHeight;
@@ -93,6 +100,14 @@ class QgsDemHeightMapGenerator : public QObject
     //! asynchronous terrain read for a tile (array of floats)
     int render( const QgsChunkNodeId &nodeId );
 
+    /**
+     * Cancels the height map job with the given \a jobId. If the terrain data are already
+     * being read in a worker thread, the reading is not interrupted, but its result is discarded
+     * and heightMapReady() is not emitted for the job.
+     * \since QGIS 3.20
+     */
+    void cancelJob( int jobId );
+
     //! Waits for the tile to finish rendering
     void waitForFinished();
 
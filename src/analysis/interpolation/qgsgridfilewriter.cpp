@@ -17,10 +17,14 @@
 
 #include "qgsgridfilewriter.h"
 #include "qgsinterpolator.h"
+#include "qgsidwinterpolator.h"
 #include "qgsvectorlayer.h"
 #include "qgsfeedback.h"
 #include <QFile>
 #include <QFileInfo>
+#include <QtConcurrentMap>
+
+#include <numeric>
 
 QgsGridFileWriter::QgsGridFileWriter( QgsInterpolator *i, const QString &outputPath, const QgsRectangle &extent, int nCols, int nRows )
   : mInterpolator( i )
@@ -54,27 +58,69 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
   outStream.setRealNumberPrecision( 8 );
   writeHeader( outStream );
 
-  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0; //calculate value in the center of the cell
-  double currentXValue;
-  double interpolatedValue;
+  // only the IDW interpolator can be evaluated from several threads at once, once its input data is cached
+  // (and indexed). Without any input vertex, each call would try to fill the cache again, so the rows
+  // are then evaluated sequentially.
+  QgsIDWInterpolator *idwInterpolator = dynamic_cast< QgsIDWInterpolator * >( mInterpolator );
+  const bool parallel = idwInterpolator && idwInterpolator->cacheInputData( feedback ) > 0;
+
+  // rows are evaluated in batches, and written once the whole batch is done
+  const int batchRows = parallel ? std::max( 1, std::min( 64, mNumRows ) ) : 1;
+  QVector<double> values( batchRows * mNumColumns );
+  QVector<bool> interpolated( batchRows * mNumColumns );
+  double *valueData = values.data();
+  bool *interpolatedData = interpolated.data();
 
+  // calculate values in the center of the cells
+  QVector<double> yValues( mNumRows );
+  double currentYValue = mInterpolationExtent.yMaximum() - mCellSizeY / 2.0;
   for ( int i = 0; i < mNumRows; ++i )
   {
-    currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0; //calculate value in the center of the cell
+    yValues[i] = currentYValue;
+    currentYValue -= mCellSizeY;
+  }
+
+  auto evaluateRow = [&]( int row, int batchRow )
+  {
+    double currentXValue = mInterpolationExtent.xMinimum() + mCellSizeX / 2.0;
     for ( int j = 0; j < mNumColumns; ++j )
     {
-      if ( mInterpolator->interpolatePoint( currentXValue, currentYValue, interpolatedValue, feedback ) == 0 )
-      {
-        outStream << interpolatedValue << ' ';
-      }
-      else
+      double interpolatedValue = 0;
+      interpolatedData[batchRow * mNumColumns + j] = mInterpolator->interpolatePoint( currentXValue, yValues.at( row ), interpolatedValue, feedback ) == 0;
+      valueData[batchRow * mNumColumns + j] = interpolatedValue;
+      currentXValue += mCellSizeX;
+    }
+  };
+
+  for ( int firstRow = 0; firstRow < mNumRows; firstRow += batchRows )
+  {
+    const int rows = std::min( batchRows, mNumRows - firstRow );
+    if ( parallel )
+    {
+      QVector<int> batch( rows );
+      std::iota( batch.begin(), batch.end(), 0 );
+      QtConcurrent::blockingMap( batch, [&]( int batchRow ) { evaluateRow( firstRow + batchRow, batchRow ); } );
+    }
+    else
+    {
+      evaluateRow( firstRow, 0 );
+    }
+
+    for ( int batchRow = 0; batchRow < rows; ++batchRow )
+    {
+      for ( int j = 0; j < mNumColumns; ++j )
       {
-        outStream << "-9999 ";
+        if ( interpolatedData[batchRow * mNumColumns + j] )
+        {
+          outStream << valueData[batchRow * mNumColumns + j] << ' ';
+        }
+        else
+        {
+          outStream << "-9999 ";
+        }
       }
-      currentXValue += mCellSizeX;
+      outStream << endl;
     }
-    outStream << endl;
-    currentYValue -= mCellSizeY;
 
     if ( feedback )
     {
@@ -83,7 +129,7 @@ int QgsGridFileWriter::writeFile( QgsFeedback *feedback )
         outputFile.remove();
         return 3;
       }
-      feedback->setProgress( 100.0 * i / static_cast< double >( mNumRows ) );
+      feedback->setProgress( 100.0 * ( firstRow + rows - 1 ) / static_cast< double >( mNumRows ) );
     }
   }
 
@@ -17,34 +17,180 @@
 
 #include "qgsidwinterpolator.h"
 #include "qgis.h"
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
+
+///@cond PRIVATE
+namespace
+{
+
+  /**
+   * Sorts the vertices in [begin, end) into an implicit kd-tree: the median vertex along \a axis is the
+   * node of the range, the vertices before it form the left subtree and the ones after it the right subtree.
+   */
+  void buildKdTree( QgsInterpolatorVertexData *begin, QgsInterpolatorVertexData *end, int axis )
+  {
+    if ( end - begin <= 1 )
+      return;
+
+    QgsInterpolatorVertexData *median = begin + ( end - begin ) / 2;
+    std::nth_element( begin, median, end, [axis]( const QgsInterpolatorVertexData & a, const QgsInterpolatorVertexData & b )
+    {
+      return axis == 0 ? a.x < b.x : a.y < b.y;
+    } );
+    buildKdTree( begin, median, 1 - axis );
+    buildKdTree( median + 1, end, 1 - axis );
+  }
+
+  //! Finds the nearest vertices to a point in a kd-tree built with buildKdTree()
+  class NeighborSearch
+  {
+    public:
+      struct Neighbor
+      {
+        double squaredDistance;
+        const QgsInterpolatorVertexData *vertex;
+
+        bool operator<( const Neighbor &other ) const { return squaredDistance < other.squaredDistance; }
+      };
+
+      NeighborSearch( double x, double y, int maxCount, double maxDistance )
+        : mX( x )
+        , mY( y )
+        , mMaxCount( maxCount )
+        , mMaxSquaredDistance( maxDistance > 0 ? maxDistance * maxDistance : std::numeric_limits<double>::max() )
+      {
+        if ( mMaxCount > 0 )
+          mNeighbors.reserve( mMaxCount );
+      }
+
+      void search( const QgsInterpolatorVertexData *begin, const QgsInterpolatorVertexData *end, int axis )
+      {
+        if ( begin >= end )
+          return;
+
+        const QgsInterpolatorVertexData *median = begin + ( end - begin ) / 2;
+        const double dx = mX - median->x;
+        const double dy = mY - median->y;
+        const double squaredDistance = dx * dx + dy * dy;
+        if ( squaredDistance <= limit() )
+          add( squaredDistance, median );
+
+        // visit the side containing the point first, the other one only if it may contain closer vertices
+        const double delta = axis == 0 ? dx : dy;
+        if ( delta < 0 )
+        {
+          search( begin, median, 1 - axis );
+          if ( delta * delta <= limit() )
+            search( median + 1, end, 1 - axis );
+        }
+        else
+        {
+          search( median + 1, end, 1 - axis );
+          if ( delta * delta <= limit() )
+            search( begin, median, 1 - axis );
+        }
+      }
+
+      //! Returns the neighbors found, in no particular order
+      const std::vector<Neighbor> &neighbors() const { return mNeighbors; }
+
+    private:
+
+      double limit() const
+      {
+        if ( mMaxCount > 0 && static_cast< int >( mNeighbors.size() ) == mMaxCount )
+          return std::min( mMaxSquaredDistance, mNeighbors.front().squaredDistance );
+        return mMaxSquaredDistance;
+      }
+
+      void add( double squaredDistance, const QgsInterpolatorVertexData *vertex )
+      {
+        // with a maximum count, neighbors are kept in a max-heap so that the farthest one can be replaced
+        if ( mMaxCount > 0 && static_cast< int >( mNeighbors.size() ) == mMaxCount )
+        {
+          std::pop_heap( mNeighbors.begin(), mNeighbors.end() );
+          mNeighbors.pop_back();
+        }
+        mNeighbors.push_back( { squaredDistance, vertex } );
+        if ( mMaxCount > 0 )
+          std::push_heap( mNeighbors.begin(), mNeighbors.end() );
+      }
+
+      double mX;
+      double mY;
+      int mMaxCount;
+      double mMaxSquaredDistance;
+      std::vector<Neighbor> mNeighbors;
+  };
+
+}
+///@endcond
 
 QgsIDWInterpolator::QgsIDWInterpolator( const QList<LayerData> &layerData )
   : QgsInterpolator( layerData )
 {}
 
-int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
+int QgsIDWInterpolator::cacheInputData( QgsFeedback *feedback )
 {
   if ( !mDataIsCached )
   {
     cacheBaseData( feedback );
   }
+  if ( !mDataIsCached )
+  {
+    return 0;
+  }
+
+  if ( !mIndexBuilt && ( mMaxNeighbors > 0 || mSearchRadius > 0 ) )
+  {
+    buildKdTree( mCachedBaseData.data(), mCachedBaseData.data() + mCachedBaseData.size(), 0 );
+    mIndexBuilt = true;
+  }
+  return mCachedBaseData.size();
+}
+
+int QgsIDWInterpolator::interpolatePoint( double x, double y, double &result, QgsFeedback *feedback )
+{
+  cacheInputData( feedback );
 
   double sumCounter = 0;
   double sumDenominator = 0;
 
-  for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+  if ( mMaxNeighbors <= 0 && mSearchRadius <= 0 )
+  {
+    for ( const QgsInterpolatorVertexData &vertex : std::as_const( mCachedBaseData ) )
+    {
+      double distance = std::sqrt( ( vertex.x - x ) * ( vertex.x - x ) + ( vertex.y - y ) * ( vertex.y - y ) );
+      if ( qgsDoubleNear( distance, 0.0 ) )
+      {
+        result = vertex.z;
+        return 0;
+      }
+      double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+      sumCounter += ( currentWeight * vertex.z );
+      sumDenominator += currentWeight;
+    }
+  }
+  else
   {
-    double distance = std::sqrt( ( vertex.x - x ) * ( vertex.x - x ) + ( vertex.y - y ) * ( vertex.y - y ) );
-    if ( qgsDoubleNear( distance, 0.0 ) )
+    NeighborSearch search( x, y, mMaxNeighbors, mSearchRadius );
+    const QgsInterpolatorVertexData *data = std::as_const( mCachedBaseData ).constData();
+    search.search( data, data + mCachedBaseData.size(), 0 );
+    for ( const NeighborSearch::Neighbor &neighbor : search.neighbors() )
     {
-      result = vertex.z;
-      return 0;
+      double distance = std::sqrt( neighbor.squaredDistance );
+      if ( qgsDoubleNear( distance, 0.0 ) )
+      {
+        result = neighbor.vertex->z;
+        return 0;
+      }
+      double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
+      sumCounter += ( currentWeight * neighbor.vertex->z );
+      sumDenominator += currentWeight;
     }
-    double currentWeight = 1 / ( std::pow( distance, mDistanceCoefficient ) );
-    sumCounter += ( currentWeight * vertex.z );
-    sumDenominator += currentWeight;
   }
 
   if ( sumDenominator == 0.0 )
@@ -60,11 +60,74 @@ class ANALYSIS_EXPORT QgsIDWInterpolator: public QgsInterpolator
     */
     double distanceCoefficient() const { return mDistanceCoefficient; }
 
+    /**
+     * Sets the maximum \a count of input points taken into account for each interpolated point.
+     * Only the \a count points nearest to the interpolated point are used. A count of 0 (the default)
+     * means all points are used.
+     *
+     * Limiting the number of points or the search radius enables a spatial index over the input points,
+     * which makes interpolation of large data sets much faster.
+     *
+     * \see maxNeighbors()
+     * \see setSearchRadius()
+     * \since QGIS 3.20
+    */
+    void setMaxNeighbors( int count ) { mMaxNeighbors = count; }
+
+    /**
+     * Returns the maximum count of input points taken into account for each interpolated point,
+     * or 0 if all points are used.
+     *
+     * \see setMaxNeighbors()
+     * \since QGIS 3.20
+    */
+    int maxNeighbors() const { return mMaxNeighbors; }
+
+    /**
+     * Sets the search \a radius: only input points within this distance of an interpolated point
+     * are taken into account. Points without any input point within the radius are not interpolated.
+     * A radius of 0 (the default) means the distance is not limited.
+     *
+     * \see searchRadius()
+     * \see setMaxNeighbors()
+     * \since QGIS 3.20
+    */
+    void setSearchRadius( double radius ) { mSearchRadius = radius; }
+
+    /**
+     * Returns the search radius, or 0 if the distance to input points is not limited.
+     *
+     * \see setSearchRadius()
+     * \since QGIS 3.20
+    */
+    double searchRadius() const { return mSearchRadius; }
+
+    /**
+     * Caches the input vertices, and indexes them if the number of neighbors or the search radius is limited.
+     *
+     * interpolatePoint() does it on demand, but it must be called before interpolating points from several
+     * threads at once: interpolatePoint() can only be called concurrently once the input vertices are cached and
+     * indexed, and as long as the settings of the interpolator are not changed.
+     *
+     * An optional \a feedback argument may be specified to allow cancellation and progress reports.
+     *
+     * \returns the number of cached input vertices. If no vertex could be cached, e.g. because the sources are empty,
+     * the cache will be filled again by the next call.
+     *
+     * \since QGIS 3.20
+    */
+    int cacheInputData( QgsFeedback *feedback = nullptr );
+
   private:
 
     QgsIDWInterpolator() = delete;
 
     double mDistanceCoefficient = 2.0;
+    int mMaxNeighbors = 0;
+    double mSearchRadius = 0;
+
+    //! TRUE once mCachedBaseData has been sorted into a kd-tree
+    bool mIndexBuilt = false;
 };
 
 #endif
@@ -0,0 +1,564 @@
+/***************************************************************************
+  qgscontractionhierarchy.cpp
+  --------------------------------------
+  Date                 : March 2021
+  Copyright            : (C) 2021 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#include "qgscontractionhierarchy.h"
+#include "qgsgraph.h"
+#include "qgsfeedback.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QIODevice>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+///@cond PRIVATE
+
+namespace
+{
+  //! Identifies streams written by QgsContractionHierarchy::write()
+  constexpr quint32 STREAM_MAGIC = 0x51434831;
+  constexpr quint32 STREAM_VERSION = 1;
+
+  //! Maximum number of vertices settled by a witness search, more shortcuts are added when it is reached
+  constexpr int MAX_WITNESS_SETTLED = 500;
+
+  //! Edge of the graph while it is contracted
+  struct ContractionArc
+  {
+    //! Vertex at the other end of the edge
+    int vertex;
+    //! Contracted vertex bypassed by a shortcut, or -1 for graph edges
+    int middle;
+    //! Index of the graph edge, or -1 for shortcuts
+    int edge;
+    double cost;
+  };
+
+  typedef std::vector< std::vector< ContractionArc > > ContractionArcs;
+  typedef std::pair< double, int > QueueItem;
+  typedef std::priority_queue< QueueItem, std::vector< QueueItem >, std::greater< QueueItem > > Queue;
+
+  //! Shortcut between two neighbors of a contracted vertex
+  struct Shortcut
+  {
+    int from;
+    int to;
+    double cost;
+  };
+
+  /**
+   * Graph being contracted, with the outgoing and incoming edges of each vertex among the remaining vertices.
+   */
+  class ContractionGraph
+  {
+    public:
+
+      ContractionGraph( const QgsGraph *graph, int criterionNum )
+        : mOutgoing( graph->vertexCount() )
+        , mIncoming( graph->vertexCount() )
+        , mContractedNeighbors( graph->vertexCount(), 0 )
+        , mLevels( graph->vertexCount(), 0 )
+        , mWitnessCosts( graph->vertexCount(), std::numeric_limits< double >::infinity() )
+      {
+        for ( int edgeId = 0; edgeId < graph->edgeCount(); ++edgeId )
+        {
+          const QgsGraphEdge &edge = graph->edge( edgeId );
+          if ( edge.fromVertex() != edge.toVertex() )
+            addArc( edge.fromVertex(), edge.toVertex(), -1, edgeId, edge.cost( criterionNum ).toDouble() );
+        }
+      }
+
+      //! Adds an edge, or lowers the cost of the existing edge between the same vertices
+      void addArc( int from, int to, int middle, int edge, double cost )
+      {
+        std::vector< ContractionArc > &outgoing = mOutgoing[ from ];
+        auto it = std::find_if( outgoing.begin(), outgoing.end(), [to]( const ContractionArc & arc ) { return arc.vertex == to; } );
+        if ( it == outgoing.end() )
+        {
+          outgoing.push_back( { to, middle, edge, cost } );
+          mIncoming[ to ].push_back( { from, middle, edge, cost } );
+          return;
+        }
+        if ( it->cost <= cost )
+          return;
+
+        *it = { to, middle, edge, cost };
+        std::vector< ContractionArc > &incoming = mIncoming[ to ];
+        *std::find_if( incoming.begin(), incoming.end(), [from]( const ContractionArc & arc ) { return arc.vertex == from; } ) = { from, middle, edge, cost };
+      }
+
+      //! Returns the shortcuts required to contract \a vertex
+      std::vector< Shortcut > shortcuts( int vertex )
+      {
+        std::vector< Shortcut > result;
+        const std::vector< ContractionArc > &outgoing = mOutgoing[ vertex ];
+        if ( outgoing.empty() )
+          return result;
+
+        double maxOutgoingCost = 0;
+        for ( const ContractionArc &out : outgoing )
+          maxOutgoingCost = std::max( maxOutgoingCost, out.cost );
+
+        for ( const ContractionArc &in : mIncoming[ vertex ] )
+        {
+          // a shortcut is only needed if no other path between the neighbors is as short
+          witnessSearch( in.vertex, vertex, in.cost + maxOutgoingCost );
+          for ( const ContractionArc &out : outgoing )
+          {
+            if ( out.vertex != in.vertex && mWitnessCosts[ out.vertex ] > in.cost + out.cost )
+              result.push_back( { in.vertex, out.vertex, in.cost + out.cost } );
+          }
+          resetWitnessSearch();
+        }
+        return result;
+      }
+
+      //! Returns the contraction priority of \a vertex, less important vertices have lower priorities
+      int priority( int vertex )
+      {
+        const int shortcutCount = static_cast< int >( shortcuts( vertex ).size() );
+        const int removedCount = static_cast< int >( mOutgoing[ vertex ].size() + mIncoming[ vertex ].size() );
+        // contracting vertices uniformly keeps the hierarchy shallow
+        return 2 * ( shortcutCount - removedCount ) + mContractedNeighbors[ vertex ] + mLevels[ vertex ];
+      }
+
+      //! Contracts \a vertex, adding the required shortcuts between its neighbors
+      void contract( int vertex, const std::vector< Shortcut > &shortcuts )
+      {
+        for ( const Shortcut &shortcut : shortcuts )
+          addArc( shortcut.from, shortcut.to, vertex, -1, shortcut.cost );
+
+        for ( const ContractionArc &out : mOutgoing[ vertex ] )
+        {
+          removeArc( mIncoming[ out.vertex ], vertex );
+          mContractedNeighbors[ out.vertex ]++;
+          mLevels[ out.vertex ] = std::max( mLevels[ out.vertex ], mLevels[ vertex ] + 1 );
+        }
+        for ( const ContractionArc &in : mIncoming[ vertex ] )
+        {
+          removeArc( mOutgoing[ in.vertex ], vertex );
+          mContractedNeighbors[ in.vertex ]++;
+          mLevels[ in.vertex ] = std::max( mLevels[ in.vertex ], mLevels[ vertex ] + 1 );
+        }
+      }
+
+      //! Outgoing edges of each vertex, to vertices which are not contracted yet
+      const std::vector< ContractionArc > &outgoing( int vertex ) const { return mOutgoing[ vertex ]; }
+
+      //! Incoming edges of each vertex, from vertices which are not contracted yet
+      const std::vector< ContractionArc > &incoming( int vertex ) const { return mIncoming[ vertex ]; }
+
+    private:
+
+      static void removeArc( std::vector< ContractionArc > &arcs, int vertex )
+      {
+        arcs.erase( std::remove_if( arcs.begin(), arcs.end(), [vertex]( const ContractionArc & arc ) { return arc.vertex == vertex; } ), arcs.end() );
+      }
+
+      //! Dijkstra search from \a source avoiding \a excluded, up to \a maxCost
+      void witnessSearch( int source, int excluded, double maxCost )
+      {
+        Queue queue;
+        mWitnessCosts[ source ] = 0;
+        mWitnessTouched.push_back( source );
+        queue.push( QueueItem( 0, source ) );
+        int settled = 0;
+        while ( !queue.empty() && settled < MAX_WITNESS_SETTLED )
+        {
+          const QueueItem item = queue.top();
+          queue.pop();
+          if ( item.first > mWitnessCosts[ item.second ] )
+            continue;
+          if ( item.first > maxCost )
+            break;
+          ++settled;
+
+          for ( const ContractionArc &arc : mOutgoing[ item.second ] )
+          {
+            if ( arc.vertex == excluded )
+              continue;
+            const double cost = item.first + arc.cost;
+            if ( cost < mWitnessCosts[ arc.vertex ] )
+            {
+              if ( std::isinf( mWitnessCosts[ arc.vertex ] ) )
+                mWitnessTouched.push_back( arc.vertex );
+              mWitnessCosts[ arc.vertex ] = cost;
+              queue.push( QueueItem( cost, arc.vertex ) );
+            }
+          }
+        }
+      }
+
+      void resetWitnessSearch()
+      {
+        for ( int vertex : mWitnessTouched )
+          mWitnessCosts[ vertex ] = std::numeric_limits< double >::infinity();
+        mWitnessTouched.clear();
+      }
+
+      ContractionArcs mOutgoing;
+      ContractionArcs mIncoming;
+      std::vector< int > mContractedNeighbors;
+      //! Depth of each vertex in the hierarchy of the contracted vertices
+      std::vector< int > mLevels;
+
+      std::vector< double > mWitnessCosts;
+      std::vector< int > mWitnessTouched;
+  };
+}
+
+///@endcond
+
+QgsContractionHierarchy::QgsContractionHierarchy( const QgsGraph *graph, int criterionNum, QgsFeedback *feedback )
+  : mCriterion( criterionNum )
+  , mGraph( graph )
+{
+  const int vertexCount = graph->vertexCount();
+  ContractionGraph contraction( graph, criterionNum );
+
+  // vertices are contracted from the least to the most important, priorities being updated lazily
+  // when they are popped, as contracting a vertex only changes the priorities of its neighbors
+  typedef std::pair< int, int > PriorityItem;
+  std::priority_queue< PriorityItem, std::vector< PriorityItem >, std::greater< PriorityItem > > queue;
+  for ( int vertex = 0; vertex < vertexCount; ++vertex )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+    queue.push( PriorityItem( contraction.priority( vertex ), vertex ) );
+  }
+
+  std::vector< QVector< Arc > > upward( vertexCount );
+  std::vector< QVector< Arc > > downward( vertexCount );
+  int contractedCount = 0;
+  while ( !queue.empty() )
+  {
+    const int vertex = queue.top().second;
+    queue.pop();
+
+    const int priority = contraction.priority( vertex );
+    if ( !queue.empty() && priority > queue.top().first )
+    {
+      queue.push( PriorityItem( priority, vertex ) );
+      continue;
+    }
+
+    // the remaining edges of the vertex all lead to more important vertices
+    for ( const ContractionArc &arc : contraction.outgoing( vertex ) )
+    {
+      Arc upwardArc;
+      upwardArc.vertex = arc.vertex;
+      upwardArc.middle = arc.middle;
+      upwardArc.edge = arc.edge;
+      upwardArc.cost = arc.cost;
+      upward[ vertex ].append( upwardArc );
+    }
+    for ( const ContractionArc &arc : contraction.incoming( vertex ) )
+    {
+      Arc downwardArc;
+      downwardArc.vertex = arc.vertex;
+      downwardArc.middle = arc.middle;
+      downwardArc.edge = arc.edge;
+      downwardArc.cost = arc.cost;
+      downward[ vertex ].append( downwardArc );
+    }
+
+    const std::vector< Shortcut > shortcuts = contraction.shortcuts( vertex );
+    mShortcutCount += static_cast< int >( shortcuts.size() );
+    contraction.contract( vertex, shortcuts );
+
+    ++contractedCount;
+    if ( feedback && contractedCount % 1000 == 0 )
+    {
+      if ( feedback->isCanceled() )
+        return;
+      feedback->setProgress( 100.0 * contractedCount / vertexCount );
+    }
+  }
+
+  for ( ArcList *list : { &mUpward, &mDownward } )
+  {
+    const std::vector< QVector< Arc > > &arcs = list == &mUpward ? upward : downward;
+    list->offsets.reserve( vertexCount + 1 );
+    for ( const QVector< Arc > &vertexArcs : arcs )
+    {
+      list->offsets.append( list->arcs.size() );
+      list->arcs.append( vertexArcs );
+    }
+    list->offsets.append( list->arcs.size() );
+  }
+
+  mValid = true;
+}
+
+double QgsContractionHierarchy::shortestPath( int startVertexIdx, int endVertexIdx, QVector<int> *resultPath ) const
+{
+  if ( resultPath )
+    resultPath->clear();
+
+  const int vertexCount = mUpward.offsets.size() - 1;
+  if ( !mValid || startVertexIdx < 0 || startVertexIdx >= vertexCount || endVertexIdx < 0 || endVertexIdx >= vertexCount )
+    return std::numeric_limits<double>::infinity();
+
+  struct Label
+  {
+    double cost;
+    //! Previous vertex, and index of the edge from it
+    int parent;
+    int arc;
+  };
+
+  // a search from each end vertex, both only going up the hierarchy. They meet at the most important vertex of the path.
+  // Searches only visit a few hundred vertices, so labels are stored in hash maps rather than graph sized arrays.
+  std::unordered_map< int, Label > labels[2];
+  Queue queues[2];
+  const ArcList *arcLists[2] = { &mUpward, &mDownward };
+  labels[0][ startVertexIdx ] = Label{ 0, -1, -1 };
+  labels[1][ endVertexIdx ] = Label{ 0, -1, -1 };
+  queues[0].push( QueueItem( 0, startVertexIdx ) );
+  queues[1].push( QueueItem( 0, endVertexIdx ) );
+
+  double bestCost = std::numeric_limits<double>::infinity();
+  int meetingVertex = -1;
+  while ( true )
+  {
+    // each search can stop once all its remaining vertices cost more than the best path found
+    const bool forwardDone = queues[0].empty() || queues[0].top().first >= bestCost;
+    const bool backwardDone = queues[1].empty() || queues[1].top().first >= bestCost;
+    if ( forwardDone && backwardDone )
+      break;
+
+    const int direction = forwardDone ? 1 : backwardDone ? 0 : ( queues[0].top().first <= queues[1].top().first ? 0 : 1 );
+    const QueueItem item = queues[ direction ].top();
+    queues[ direction ].pop();
+    if ( item.first > labels[ direction ].at( item.second ).cost )
+      continue;
+
+    const auto other = labels[ 1 - direction ].find( item.second );
+    if ( other != labels[ 1 - direction ].end() && item.first + other->second.cost < bestCost )
+    {
+      bestCost = item.first + other->second.cost;
+      meetingVertex = item.second;
+    }
+
+    // stall on demand: the vertex is reached by a shorter path through a more important vertex, which
+    // will be followed instead, so searching from this vertex is pointless
+    const ArcList *reverseArcList = arcLists[ 1 - direction ];
+    bool stalled = false;
+    for ( int arcIndex = reverseArcList->offsets.at( item.second ); arcIndex < reverseArcList->offsets.at( item.second + 1 ); ++arcIndex )
+    {
+      const Arc &arc = reverseArcList->arcs.at( arcIndex );
+      const auto label = labels[ direction ].find( arc.vertex );
+      if ( label != labels[ direction ].end() && label->second.cost + arc.cost < item.first )
+      {
+        stalled = true;
+        break;
+      }
+    }
+    if ( stalled )
+      continue;
+
+    const ArcList *arcList = arcLists[ direction ];
+    for ( int arcIndex = arcList->offsets.at( item.second ); arcIndex < arcList->offsets.at( item.second + 1 ); ++arcIndex )
+    {
+      const Arc &arc = arcList->arcs.at( arcIndex );
+      const double cost = item.first + arc.cost;
+      auto label = labels[ direction ].find( arc.vertex );
+      if ( label == labels[ direction ].end() || cost < label->second.cost )
+      {
+        labels[ direction ][ arc.vertex ] = Label{ cost, item.second, arcIndex };
+        queues[ direction ].push( QueueItem( cost, arc.vertex ) );
+      }
+    }
+  }
+
+  if ( meetingVertex < 0 )
+    return std::numeric_limits<double>::infinity();
+
+  if ( resultPath )
+  {
+    QVector< int > edges;
+    // edges from the start to the meeting vertex, collected backward
+    QVector< int > startEdges;
+    for ( int vertex = meetingVertex; vertex != startVertexIdx; )
+    {
+      const Label &label = labels[0].at( vertex );
+      QVector< int > arcEdges;
+      unpackArc( label.parent, mUpward.arcs.at( label.arc ), arcEdges );
+      std::reverse( arcEdges.begin(), arcEdges.end() );
+      startEdges.append( arcEdges );
+      vertex = label.parent;
+    }
+    std::reverse( startEdges.begin(), startEdges.end() );
+    edges = startEdges;
+
+    // edges from the meeting to the end vertex
+    for ( int vertex = meetingVertex; vertex != endVertexIdx; )
+    {
+      const Label &label = labels[1].at( vertex );
+      // downward arcs are stored with their start vertex, from the vertex at their end
+      Arc arc = mDownward.arcs.at( label.arc );
+      arc.vertex = label.parent;
+      unpackArc( vertex, arc, edges );
+      vertex = label.parent;
+    }
+
+    resultPath->reserve( edges.size() + 1 );
+    resultPath->append( startVertexIdx );
+    for ( int edge : std::as_const( edges ) )
+      resultPath->append( mGraph->edge( edge ).toVertex() );
+  }
+
+  return bestCost;
+}
+
+void QgsContractionHierarchy::unpackArc( int fromVertex, const Arc &arc, QVector< int > &edges ) const
+{
+  // edges still to unpack, in reverse order
+  std::vector< std::pair< int, Arc > > stack;
+  stack.emplace_back( fromVertex, arc );
+  while ( !stack.empty() )
+  {
+    const std::pair< int, Arc > item = stack.back();
+    stack.pop_back();
+    if ( item.second.middle < 0 )
+    {
+      edges.append( item.second.edge );
+      continue;
+    }
+
+    // a shortcut bypasses a less important vertex, its two halves are stored with that vertex
+    const int middle = item.second.middle;
+    for ( int arcIndex = mUpward.offsets.at( middle ); arcIndex < mUpward.offsets.at( middle + 1 ); ++arcIndex )
+    {
+      if ( mUpward.arcs.at( arcIndex ).vertex == item.second.vertex )
+      {
+        stack.emplace_back( middle, mUpward.arcs.at( arcIndex ) );
+        break;
+      }
+    }
+    for ( int arcIndex = mDownward.offsets.at( middle ); arcIndex < mDownward.offsets.at( middle + 1 ); ++arcIndex )
+    {
+      if ( mDownward.arcs.at( arcIndex ).vertex == item.first )
+      {
+        Arc firstHalf = mDownward.arcs.at( arcIndex );
+        firstHalf.vertex = middle;
+        stack.emplace_back( item.first, firstHalf );
+        break;
+      }
+    }
+  }
+}
+
+QByteArray QgsContractionHierarchy::graphFingerprint( const QgsGraph *graph, int criterionNum )
+{
+  QCryptographicHash hash( QCryptographicHash::Sha1 );
+  auto addValue = [&hash]( auto value )
+  {
+    hash.addData( reinterpret_cast< const char * >( &value ), sizeof( value ) );
+  };
+
+  addValue( graph->vertexCount() );
+  addValue( graph->edgeCount() );
+  for ( int vertex = 0; vertex < graph->vertexCount(); ++vertex )
+  {
+    addValue( graph->vertex( vertex ).point().x() );
+    addValue( graph->vertex( vertex ).point().y() );
+  }
+  for ( int edgeId = 0; edgeId < graph->edgeCount(); ++edgeId )
+  {
+    const QgsGraphEdge &edge = graph->edge( edgeId );
+    addValue( edge.fromVertex() );
+    addValue( edge.toVertex() );
+    addValue( edge.cost( criterionNum ).toDouble() );
+  }
+  return hash.result();
+}
+
+bool QgsContractionHierarchy::write( QIODevice *device ) const
+{
+  if ( !mValid || !device )
+    return false;
+
+  QDataStream stream( device );
+  stream.setVersion( QDataStream::Qt_5_0 );
+  stream << STREAM_MAGIC << STREAM_VERSION;
+  stream << static_cast< qint32 >( mCriterion ) << static_cast< qint32 >( mShortcutCount ) << graphFingerprint( mGraph, mCriterion );
+  for ( const ArcList *list : { &mUpward, &mDownward } )
+  {
+    stream << list->offsets;
+    stream << static_cast< qint32 >( list->arcs.size() );
+    for ( const Arc &arc : list->arcs )
+      stream << static_cast< qint32 >( arc.vertex ) << static_cast< qint32 >( arc.middle ) << static_cast< qint32 >( arc.edge ) << arc.cost;
+  }
+  return stream.status() == QDataStream::Ok;
+}
+
+QgsContractionHierarchy *QgsContractionHierarchy::read( QIODevice *device, const QgsGraph *graph )
+{
+  if ( !device || !graph )
+    return nullptr;
+
+  QDataStream stream( device );
+  stream.setVersion( QDataStream::Qt_5_0 );
+  quint32 magic = 0;
+  quint32 version = 0;
+  stream >> magic >> version;
+  if ( magic != STREAM_MAGIC || version != STREAM_VERSION )
+    return nullptr;
+
+  std::unique_ptr< QgsContractionHierarchy > hierarchy( new QgsContractionHierarchy() );
+  qint32 criterion = 0;
+  qint32 shortcutCount = 0;
+  QByteArray fingerprint;
+  stream >> criterion >> shortcutCount >> fingerprint;
+  if ( stream.status() != QDataStream::Ok || fingerprint != graphFingerprint( graph, criterion ) )
+    return nullptr;
+
+  const int vertexCount = graph->vertexCount();
+  for ( ArcList *list : { &hierarchy->mUpward, &hierarchy->mDownward } )
+  {
+    qint32 arcCount = 0;
+    stream >> list->offsets >> arcCount;
+    if ( stream.status() != QDataStream::Ok || list->offsets.size() != vertexCount + 1 || list->offsets.constLast() != arcCount )
+      return nullptr;
+
+    list->arcs.resize( arcCount );
+    for ( Arc &arc : list->arcs )
+    {
+      qint32 vertex = 0;
+      qint32 middle = 0;
+      qint32 edge = 0;
+      stream >> vertex >> middle >> edge >> arc.cost;
+      if ( vertex < 0 || vertex >= vertexCount || middle >= vertexCount || edge >= graph->edgeCount() || ( middle < 0 && edge < 0 ) )
+        return nullptr;
+      arc.vertex = vertex;
+      arc.middle = middle;
+      arc.edge = edge;
+    }
+  }
+  if ( stream.status() != QDataStream::Ok )
+    return nullptr;
+
+  hierarchy->mCriterion = criterion;
+  hierarchy->mShortcutCount = shortcutCount;
+  hierarchy->mGraph = graph;
+  hierarchy->mValid = true;
+  return hierarchy.release();
+}
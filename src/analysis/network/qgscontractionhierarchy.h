@@ -0,0 +1,152 @@
+/***************************************************************************
+  qgscontractionhierarchy.h
+  --------------------------------------
+  Date                 : March 2021
+  Copyright            : (C) 2021 by the QGIS project
+****************************************************************************
+*                                                                          *
+*   This program is free software; you can redistribute it and/or modify   *
+*   it under the terms of the GNU General Public License as published by   *
+*   the Free Software Foundation; either version 2 of the License, or      *
+*   (at your option) any later version.                                    *
+*                                                                          *
+***************************************************************************/
+
+#ifndef QGSCONTRACTIONHIERARCHY_H
+#define QGSCONTRACTIONHIERARCHY_H
+
+#include <QVector>
+#include <QByteArray>
+
+#include "qgis_sip.h"
+#include "qgis_analysis.h"
+
+class QgsGraph;
+class QgsFeedback;
+class QIODevice;
+
+/**
+ * \ingroup analysis
+ * \class QgsContractionHierarchy
+ * \brief Contraction hierarchy of a QgsGraph, answering shortest path queries between two vertices much faster than QgsGraphAnalyzer.
+ *
+ * The hierarchy is built once for a graph and a cost strategy: the vertices are ordered by importance, and
+ * contracted one after the other, adding shortcut edges between their neighbors wherever the contracted
+ * vertex lies on the only shortest path between them. Queries are then answered by a bidirectional search
+ * which only follows edges toward more important vertices, and only visits a tiny fraction of the graph.
+ *
+ * Building the hierarchy takes much longer than a single QgsGraphAnalyzer::dijkstra() call, so it can be
+ * saved with write() and loaded again with read() for the same graph.
+ *
+ * The edges of the hierarchy are stored in compressed sparse row arrays, independently from the source graph.
+ * Queries don't modify the hierarchy, so they can be run concurrently from several threads.
+ *
+ * Edge costs must not be negative.
+ *
+ * \since QGIS 3.20
+ */
+class ANALYSIS_EXPORT QgsContractionHierarchy
+{
+  public:
+
+    /**
+     * Builds the contraction hierarchy of a \a graph, for the strategy with index \a criterionNum.
+     *
+     * The graph must not be modified while the hierarchy is in use.
+     *
+     * An optional \a feedback can be specified to report progress and cancel the build, in which case
+     * the hierarchy will be invalid.
+     */
+    QgsContractionHierarchy( const QgsGraph *graph, int criterionNum, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns TRUE if the hierarchy was completely built or read.
+     */
+    bool isValid() const { return mValid; }
+
+    /**
+     * Returns the index of the strategy used for the edge costs.
+     */
+    int criterion() const { return mCriterion; }
+
+    /**
+     * Returns the number of shortcut edges added by the contraction.
+     */
+    int shortcutCount() const { return mShortcutCount; }
+
+    /**
+     * Calculates the shortest path from \a startVertexIdx to \a endVertexIdx.
+     *
+     * \param startVertexIdx index of the start vertex in the graph
+     * \param endVertexIdx index of the end vertex in the graph
+     * \param resultPath if specified, will be set to the indices of the graph vertices along the path, from the start to the end vertex. It is left empty if the end vertex is not reachable.
+     * \returns the cost of the path, or infinity if the end vertex is not reachable
+     *
+     * \see QgsGraphAnalyzer::shortestPath()
+     */
+    double shortestPath( int startVertexIdx, int endVertexIdx, QVector<int> *resultPath SIP_OUT = nullptr ) const;
+
+    /**
+     * Writes the hierarchy to a \a device, so that it can be loaded again with read().
+     *
+     * Returns FALSE if the hierarchy is invalid or could not be written.
+     */
+    bool write( QIODevice *device ) const;
+
+    /**
+     * Reads a hierarchy saved with write() from a \a device.
+     *
+     * The hierarchy must have been built for the same \a graph: NULLPTR is returned if the data is
+     * not a valid hierarchy, or if it was built for a graph with different vertices, edges or costs.
+     */
+    static QgsContractionHierarchy *read( QIODevice *device, const QgsGraph *graph ) SIP_FACTORY;
+
+  private:
+
+    QgsContractionHierarchy() = default;
+
+    //! Edge of the hierarchy, either an edge of the graph or a shortcut
+    struct Arc
+    {
+      //! Vertex at the other end of the edge
+      int vertex = -1;
+      //! Contracted vertex bypassed by a shortcut, or -1 for graph edges
+      int middle = -1;
+      //! Index of the graph edge, or -1 for shortcuts
+      int edge = -1;
+      double cost = 0;
+    };
+
+    //! Compressed sparse row arrays of edges, grouped by vertex
+    struct ArcList
+    {
+      //! Offsets of the edges of each vertex in arcs, with a final item for the end of the array
+      QVector< int > offsets;
+      QVector< Arc > arcs;
+    };
+
+    //! Returns a fingerprint of the vertices, edges and costs of a \a graph
+    static QByteArray graphFingerprint( const QgsGraph *graph, int criterionNum );
+
+    //! Appends the graph edges bypassed by the edge from \a fromVertex to \a arc to \a edges
+    void unpackArc( int fromVertex, const Arc &arc, QVector< int > &edges ) const;
+
+    bool mValid = false;
+    int mCriterion = 0;
+    int mShortcutCount = 0;
+    const QgsGraph *mGraph = nullptr;
+
+    /**
+     * Edges from each vertex toward more important vertices, used by the search from the start vertex.
+     * Arc::vertex is the end vertex.
+     */
+    ArcList mUpward;
+
+    /**
+     * Edges to each vertex from more important vertices, used by the search from the end vertex.
+     * Arc::vertex is the start vertex.
+     */
+    ArcList mDownward;
+};
+
+#endif // QGSCONTRACTIONHIERARCHY_H
@@ -14,6 +14,10 @@
 ***************************************************************************/
 
 #include <limits>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <cmath>
 
 #include <QMap>
 #include <QVector>
@@ -123,3 +127,88 @@ QgsGraph *QgsGraphAnalyzer::shortestTree( const QgsGraph *source, int startVerte
 
   return treeResult;
 }
+
+double QgsGraphAnalyzer::shortestPath( const QgsGraph *source, int startVertexIdx, int endVertexIdx, int criterionNum, QVector<int> *resultPath )
+{
+  if ( resultPath )
+    resultPath->clear();
+
+  const int vertexCount = source->vertexCount();
+  if ( startVertexIdx < 0 || startVertexIdx >= vertexCount || endVertexIdx < 0 || endVertexIdx >= vertexCount )
+  {
+    // invalid start or end point
+    return std::numeric_limits<double>::infinity();
+  }
+
+  // the lowest cost per distance unit makes the straight line distance to the end vertex a lower
+  // bound of the remaining cost, as no edge is shorter than the distance between its vertices
+  double costPerDistance = std::numeric_limits<double>::infinity();
+  for ( int edgeId = 0; edgeId < source->edgeCount(); ++edgeId )
+  {
+    const QgsGraphEdge &arc = source->edge( edgeId );
+    const double distance = source->vertex( arc.fromVertex() ).point().distance( source->vertex( arc.toVertex() ).point() );
+    if ( distance > 0 )
+      costPerDistance = std::min( costPerDistance, arc.cost( criterionNum ).toDouble() / distance );
+  }
+  if ( !std::isfinite( costPerDistance ) || costPerDistance < 0 )
+    costPerDistance = 0;
+
+  const QgsPointXY endPoint = source->vertex( endVertexIdx ).point();
+  auto remainingCost = [&]( int vertexIdx )
+  {
+    return costPerDistance * source->vertex( vertexIdx ).point().distance( endPoint );
+  };
+
+  QVector< double > costs( vertexCount, std::numeric_limits<double>::infinity() );
+  QVector< int > tree( vertexCount, -1 );
+  QVector< bool > settled( vertexCount, false );
+  costs[ startVertexIdx ] = 0.0;
+
+  // pairs of estimated total cost and vertex index, settled vertices are skipped when popped again
+  typedef std::pair< double, int > QueueItem;
+  std::priority_queue< QueueItem, std::vector< QueueItem >, std::greater< QueueItem > > queue;
+  queue.push( QueueItem( remainingCost( startVertexIdx ), startVertexIdx ) );
+
+  while ( !queue.empty() )
+  {
+    const int curVertex = queue.top().second;
+    queue.pop();
+    if ( settled.at( curVertex ) )
+      continue;
+    settled[ curVertex ] = true;
+
+    if ( curVertex == endVertexIdx )
+      break;
+
+    const double curCost = costs.at( curVertex );
+    const QgsGraphEdgeIds &outgoingEdges = source->vertex( curVertex ).outgoingEdges();
+    for ( int edgeId : outgoingEdges )
+    {
+      const QgsGraphEdge &arc = source->edge( edgeId );
+      const int toVertex = arc.toVertex();
+      const double cost = arc.cost( criterionNum ).toDouble() + curCost;
+      if ( cost < costs.at( toVertex ) )
+      {
+        costs[ toVertex ] = cost;
+        tree[ toVertex ] = edgeId;
+        queue.push( QueueItem( cost + remainingCost( toVertex ), toVertex ) );
+      }
+    }
+  }
+
+  if ( !settled.at( endVertexIdx ) )
+    return std::numeric_limits<double>::infinity();
+
+  if ( resultPath )
+  {
+    int vertexIdx = endVertexIdx;
+    resultPath->append( vertexIdx );
+    while ( vertexIdx != startVertexIdx )
+    {
+      vertexIdx = source->edge( tree.at( vertexIdx ) ).fromVertex();
+      resultPath->append( vertexIdx );
+    }
+    std::reverse( resultPath->begin(), resultPath->end() );
+  }
+  return costs.at( endVertexIdx );
+}
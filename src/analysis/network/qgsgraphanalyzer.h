@@ -82,6 +82,26 @@ class ANALYSIS_EXPORT QgsGraphAnalyzer
      * \param criterionNum index of the optimization strategy
      */
     static QgsGraph *shortestTree( const QgsGraph *source, int startVertexIdx, int criterionNum );
+
+    /**
+     * Calculates the shortest path from \a startVertexIdx to \a endVertexIdx using the A* algorithm.
+     *
+     * Unlike dijkstra(), the search stops as soon as the end vertex is reached, and it is directed toward
+     * the end vertex by a lower bound of the remaining cost: the straight line distance to the end vertex
+     * multiplied by the lowest ratio of edge cost to edge length in the graph. Edge costs must not be negative.
+     *
+     * For many queries on the same graph, QgsContractionHierarchy is much faster.
+     *
+     * \param source source graph
+     * \param startVertexIdx index of the start vertex
+     * \param endVertexIdx index of the end vertex
+     * \param criterionNum index of the optimization strategy
+     * \param resultPath if specified, will be set to the indices of the vertices along the path, from the start to the end vertex. It is left empty if the end vertex is not reachable.
+     * \returns the cost of the path, or infinity if the end vertex is not reachable
+     *
+     * \since QGIS 3.20
+     */
+    static double shortestPath( const QgsGraph *source, int startVertexIdx, int endVertexIdx, int criterionNum, QVector<int> *resultPath SIP_OUT = nullptr );
 };
 
 #endif // QGSGRAPHANALYZER_H
@@ -58,6 +58,11 @@ QString QgsBoundaryAlgorithm::shortHelpString() const
                       "polygon or line layers." );
 }
 
+bool QgsBoundaryAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QList<int> QgsBoundaryAlgorithm::inputLayerTypes() const
 {
   return QList<int>() << QgsProcessing::TypeVectorLine << QgsProcessing::TypeVectorPolygon;
@@ -56,6 +56,11 @@ QString QgsBoundingBoxAlgorithm::shortHelpString() const
          QObject::tr( "See the 'Minimum bounding geometry' algorithm for a bounding box calculation which covers the whole layer or grouped subsets of features." );
 }
 
+bool QgsBoundingBoxAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsBoundingBoxAlgorithm *QgsBoundingBoxAlgorithm::createInstance() const
 {
   return new QgsBoundingBoxAlgorithm();
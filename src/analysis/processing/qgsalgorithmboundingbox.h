@@ -40,6 +40,7 @@ class QgsBoundingBoxAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    bool supportsParallelFeatureProcessing() const override;
     QgsBoundingBoxAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
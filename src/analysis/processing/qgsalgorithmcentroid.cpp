@@ -64,6 +64,12 @@ QString QgsCentroidAlgorithm::shortHelpString() const
                       "The attributes associated to each point in the output layer are the same ones associated to the original features." );
 }
 
+bool QgsCentroidAlgorithm::supportsParallelFeatureProcessing() const
+{
+  // data defined properties share their expression, which can't be evaluated concurrently
+  return !mDynamicAllParts;
+}
+
 QgsCentroidAlgorithm *QgsCentroidAlgorithm::createInstance() const
 {
   return new QgsCentroidAlgorithm();
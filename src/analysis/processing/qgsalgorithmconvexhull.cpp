@@ -56,6 +56,11 @@ QString QgsConvexHullAlgorithm::shortHelpString() const
          QObject::tr( "See the 'Minimum bounding geometry' algorithm for a convex hull calculation which covers the whole layer or grouped subsets of features." );
 }
 
+bool QgsConvexHullAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsConvexHullAlgorithm *QgsConvexHullAlgorithm::createInstance() const
 {
   return new QgsConvexHullAlgorithm();
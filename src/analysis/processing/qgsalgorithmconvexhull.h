@@ -44,6 +44,7 @@ class QgsConvexHullAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    bool supportsParallelFeatureProcessing() const override;
     QgsConvexHullAlgorithm *createInstance() const override SIP_FACTORY;
 
   protected:
@@ -17,14 +17,84 @@
 
 #include "qgsalgorithmdissolve.h"
 
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+
 ///@cond PRIVATE
 
+namespace
+{
+  //! Number of parts dissolved together by each task of a cascaded union
+  constexpr int UNION_GROUP_SIZE = 1000;
+
+  //! Returns the distance of a cell along a Hilbert curve filling a 65536x65536 grid
+  quint64 hilbertDistance( quint32 x, quint32 y )
+  {
+    const quint32 n = 1 << 16;
+    quint64 d = 0;
+    for ( quint32 s = n / 2; s > 0; s /= 2 )
+    {
+      const quint32 rx = ( x & s ) > 0;
+      const quint32 ry = ( y & s ) > 0;
+      d += static_cast< quint64 >( s ) * s * ( ( 3 * rx ) ^ ry );
+      // rotate the quadrant
+      if ( ry == 0 )
+      {
+        if ( rx == 1 )
+        {
+          x = n - 1 - x;
+          y = n - 1 - y;
+        }
+        std::swap( x, y );
+      }
+    }
+    return d;
+  }
+
+  //! Sorts \a geometries along a Hilbert curve, so that neighboring geometries are close to each other
+  void sortByHilbertDistance( QVector< QgsGeometry > &geometries )
+  {
+    QVector< QgsPointXY > centers;
+    centers.reserve( geometries.size() );
+    QgsRectangle extent;
+    for ( const QgsGeometry &geometry : std::as_const( geometries ) )
+    {
+      const QgsRectangle bbox = geometry.boundingBox();
+      centers << bbox.center();
+      if ( extent.isNull() )
+        extent = bbox;
+      else
+        extent.combineExtentWith( bbox );
+    }
+
+    const double xScale = extent.width() > 0 ? 65535 / extent.width() : 0;
+    const double yScale = extent.height() > 0 ? 65535 / extent.height() : 0;
+    std::vector< std::pair< quint64, int > > order;
+    order.reserve( geometries.size() );
+    for ( int i = 0; i < centers.size(); ++i )
+    {
+      const quint32 x = static_cast< quint32 >( ( centers.at( i ).x() - extent.xMinimum() ) * xScale );
+      const quint32 y = static_cast< quint32 >( ( centers.at( i ).y() - extent.yMinimum() ) * yScale );
+      order.emplace_back( hilbertDistance( x, y ), i );
+    }
+    std::sort( order.begin(), order.end() );
+
+    QVector< QgsGeometry > sorted;
+    sorted.reserve( geometries.size() );
+    for ( const std::pair< quint64, int > &item : order )
+      sorted << geometries.at( item.second );
+    geometries = sorted;
+  }
+}
+
 //
 // QgsCollectorAlgorithm
 //
 
 QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-    const std::function<QgsGeometry( const QVector< QgsGeometry >& )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags )
+    const std::function<QgsGeometry( const QVector< QgsGeometry >&, CollectorMessages & )> &collector, int maxQueueLength, QgsProcessingFeatureSource::Flags sourceFlags )
 {
   std::unique_ptr< QgsProcessingFeatureSource > source( parameterAsSource( parameters, QStringLiteral( "INPUT" ), context ) );
   if ( !source )
@@ -53,6 +123,22 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
     // we dissolve geometries in blocks using unaryUnion
     QVector< QgsGeometry > geomQueue;
     QgsFeature outputFeature;
+    // the collector runs on this thread, its messages are reported as soon as it returns
+    auto collect = [&]( const QVector< QgsGeometry > &parts )->QgsGeometry
+    {
+      CollectorMessages messages;
+      try
+      {
+        const QgsGeometry geometry = collector( parts, messages );
+        reportMessages( messages, feedback );
+        return geometry;
+      }
+      catch ( QgsProcessingException & )
+      {
+        reportMessages( messages, feedback );
+        throw;
+      }
+    };
 
     while ( it.nextFeature( f ) )
     {
@@ -73,7 +159,7 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
         if ( maxQueueLength > 0 && geomQueue.length() > maxQueueLength )
         {
           // queue too long, combine it
-          QgsGeometry tempOutputGeometry = collector( geomQueue );
+          QgsGeometry tempOutputGeometry = collect( geomQueue );
           geomQueue.clear();
           geomQueue << tempOutputGeometry;
         }
@@ -83,7 +169,7 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       current++;
     }
 
-    outputFeature.setGeometry( collector( geomQueue ) );
+    outputFeature.setGeometry( collect( geomQueue ) );
     sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
   }
   else
@@ -126,9 +212,54 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       }
     }
 
-    int numberFeatures = attributeHash.count();
-    QHash< QVariant, QgsAttributes >::const_iterator attrIt = attributeHash.constBegin();
-    for ( ; attrIt != attributeHash.constEnd(); ++attrIt )
+    // collect the geometries of the different groups concurrently, in batches. Worker threads
+    // never report to the feedback: messages and progress are reported from this thread after each batch
+    const QList< QVariant > keys = attributeHash.keys();
+    const int numberFeatures = keys.count();
+    QVector< QgsGeometry > geometries( numberFeatures );
+    QVector< CollectorMessages > messages( numberFeatures );
+    QVector< QString > exceptionMessages( numberFeatures );
+    QgsGeometry *geometriesData = geometries.data();
+    CollectorMessages *messagesData = messages.data();
+    QString *exceptionMessagesData = exceptionMessages.data();
+    const int batchSize = std::max( QThreadPool::globalInstance()->maxThreadCount(), 1 ) * 4;
+    for ( int batchStart = 0; batchStart < numberFeatures && !feedback->isCanceled(); batchStart += batchSize )
+    {
+      std::vector< int > keyIndexes( std::min( batchSize, numberFeatures - batchStart ) );
+      std::iota( keyIndexes.begin(), keyIndexes.end(), batchStart );
+      QtConcurrent::blockingMap( keyIndexes, [&]( int index )
+      {
+        auto geometryIt = geometryHash.constFind( keys.at( index ) );
+        if ( feedback->isCanceled() || geometryIt == geometryHash.constEnd() )
+          return;
+
+        try
+        {
+          QgsGeometry geom = collector( geometryIt.value(), messagesData[ index ] );
+          if ( !geom.isMultipart() )
+          {
+            geom.convertToMultiType();
+          }
+          geometriesData[ index ] = geom;
+        }
+        catch ( QgsProcessingException &e )
+        {
+          // exceptions can't cross thread boundaries
+          exceptionMessagesData[ index ] = e.what();
+        }
+      } );
+
+      for ( int index : keyIndexes )
+      {
+        reportMessages( messages.at( index ), feedback );
+        if ( !exceptionMessages.at( index ).isEmpty() )
+          throw QgsProcessingException( exceptionMessages.at( index ) );
+      }
+      current += static_cast< int >( keyIndexes.size() );
+      feedback->setProgress( current * 100.0 / numberFeatures );
+    }
+
+    for ( int i = 0; i < numberFeatures; ++i )
     {
       if ( feedback->isCanceled() )
       {
@@ -136,20 +267,10 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
       }
 
       QgsFeature outputFeature;
-      if ( geometryHash.contains( attrIt.key() ) )
-      {
-        QgsGeometry geom = collector( geometryHash.value( attrIt.key() ) );
-        if ( !geom.isMultipart() )
-        {
-          geom.convertToMultiType();
-        }
-        outputFeature.setGeometry( geom );
-      }
-      outputFeature.setAttributes( attrIt.value() );
+      if ( !geometries.at( i ).isNull() )
+        outputFeature.setGeometry( geometries.at( i ) );
+      outputFeature.setAttributes( attributeHash.value( keys.at( i ) ) );
       sink->addFeature( outputFeature, QgsFeatureSink::FastInsert );
-
-      feedback->setProgress( current * 100.0 / numberFeatures );
-      current++;
     }
   }
 
@@ -158,6 +279,13 @@ QVariantMap QgsCollectorAlgorithm::processCollection( const QVariantMap &paramet
   return outputs;
 }
 
+void QgsCollectorAlgorithm::reportMessages( const CollectorMessages &messages, QgsProcessingFeedback *feedback )
+{
+  for ( const QString &info : messages.debugInfo )
+    feedback->pushDebugInfo( info );
+  for ( const QString &error : messages.errors )
+    feedback->reportError( error, true );
+}
 
 //
 // QgsDissolveAlgorithm
@@ -214,37 +342,80 @@ QgsDissolveAlgorithm *QgsDissolveAlgorithm::createInstance() const
 
 QVariantMap QgsDissolveAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts )->QgsGeometry
+  // all the parts are kept in memory and dissolved at once, in a cascaded union, rather than
+  // repeatedly merging blocks of parts into an ever growing geometry
+  return processCollection( parameters, context, feedback, [ & ]( const QVector< QgsGeometry > &parts, CollectorMessages & messages )->QgsGeometry
   {
-    QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
-    if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
-      result = result.mergeLines();
-    // Geos may fail in some cases, let's try a slower but safer approach
-    // See: https://github.com/qgis/QGIS/issues/28411 - Dissolve tool failing to produce outputs
-    if ( ! result.lastError().isEmpty() && parts.count() >  2 )
+    QgsGeometry result = cascadedUnion( parts, feedback, messages );
+    if ( !messages.errors.isEmpty() && result.isEmpty() && !feedback->isCanceled() )
+      throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
+    return result;
+  } );
+}
+
+QgsGeometry QgsDissolveAlgorithm::cascadedUnion( QVector< QgsGeometry > parts, QgsFeedback *feedback, CollectorMessages &messages )
+{
+  while ( parts.size() > UNION_GROUP_SIZE )
+  {
+    // dissolve groups of neighboring parts concurrently, then dissolve the results of the groups
+    sortByHilbertDistance( parts );
+    const int groupCount = ( parts.size() + UNION_GROUP_SIZE - 1 ) / UNION_GROUP_SIZE;
+    QVector< QgsGeometry > groupUnions( groupCount );
+    QVector< CollectorMessages > groupMessages( groupCount );
+    QgsGeometry *groupUnionsData = groupUnions.data();
+    CollectorMessages *groupMessagesData = groupMessages.data();
+    std::vector< int > groups( groupCount );
+    std::iota( groups.begin(), groups.end(), 0 );
+    QtConcurrent::blockingMap( groups, [&]( int group )
     {
-      if ( feedback->isCanceled() )
-        return result;
+      if ( !feedback->isCanceled() )
+        groupUnionsData[ group ] = unionParts( parts.mid( group * UNION_GROUP_SIZE, UNION_GROUP_SIZE ), feedback, groupMessagesData[ group ] );
+    } );
 
-      feedback->pushDebugInfo( QObject::tr( "GEOS exception: taking the slower route ..." ) );
-      result = QgsGeometry();
-      for ( const auto &p : parts )
-      {
-        result = QgsGeometry::unaryUnion( QVector< QgsGeometry >() << result << p );
-        if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
-          result = result.mergeLines();
-        if ( feedback->isCanceled() )
-          return result;
-      }
+    if ( feedback->isCanceled() )
+      return QgsGeometry();
+
+    parts.clear();
+    for ( int group = 0; group < groupCount; ++group )
+    {
+      messages.debugInfo << groupMessages.at( group ).debugInfo;
+      messages.errors << groupMessages.at( group ).errors;
+      if ( !groupUnions.at( group ).isEmpty() )
+        parts << groupUnions.at( group );
     }
-    if ( ! result.lastError().isEmpty() )
+  }
+
+  return unionParts( parts, feedback, messages );
+}
+
+QgsGeometry QgsDissolveAlgorithm::unionParts( const QVector< QgsGeometry > &parts, QgsFeedback *feedback, CollectorMessages &messages )
+{
+  QgsGeometry result( QgsGeometry::unaryUnion( parts ) );
+  if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
+    result = result.mergeLines();
+  // Geos may fail in some cases, let's try a slower but safer approach
+  // See: https://github.com/qgis/QGIS/issues/28411 - Dissolve tool failing to produce outputs
+  if ( ! result.lastError().isEmpty() && parts.count() >  2 )
+  {
+    if ( feedback->isCanceled() )
+      return result;
+
+    messages.debugInfo << QObject::tr( "GEOS exception: taking the slower route ..." );
+    result = QgsGeometry();
+    for ( const auto &p : parts )
     {
-      feedback->reportError( result.lastError(), true );
-      if ( result.isEmpty() )
-        throw QgsProcessingException( QObject::tr( "The algorithm returned no output." ) );
+      result = QgsGeometry::unaryUnion( QVector< QgsGeometry >() << result << p );
+      if ( QgsWkbTypes::geometryType( result.wkbType() ) == QgsWkbTypes::LineGeometry )
+        result = result.mergeLines();
+      if ( feedback->isCanceled() )
+        return result;
     }
-    return result;
-  }, 10000 );
+  }
+  if ( ! result.lastError().isEmpty() )
+  {
+    messages.errors << result.lastError();
+  }
+  return result;
 }
 
 //
@@ -278,7 +449,7 @@ QString QgsCollectAlgorithm::groupId() const
 
 QVariantMap QgsCollectAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
-  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts )->QgsGeometry
+  return processCollection( parameters, context, feedback, []( const QVector< QgsGeometry > &parts, CollectorMessages & )->QgsGeometry
   {
     return QgsGeometry::collectGeometry( parts );
   }, 0, QgsProcessingFeatureSource::FlagSkipGeometryValidityChecks );
@@ -33,8 +33,31 @@ class QgsCollectorAlgorithm : public QgsProcessingAlgorithm
 {
   protected:
 
+    /**
+     * Messages raised while collecting the geometries of a group. They are reported
+     * to the feedback from the algorithm thread, once the group has been collected.
+     */
+    struct CollectorMessages
+    {
+      //! Debug information messages
+      QStringList debugInfo;
+      //! Error messages
+      QStringList errors;
+    };
+
+    /**
+     * Collects the geometries of the source features, grouped by the values of the dissolve fields.
+     *
+     * The \a collector is called concurrently for the different groups, so it must be thread safe. It must
+     * not report to the feedback, but store its messages in the CollectorMessages argument instead.
+     */
     QVariantMap processCollection( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback,
-                                   const std::function<QgsGeometry( const QVector<QgsGeometry>& )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags() );
+                                   const std::function<QgsGeometry( const QVector<QgsGeometry>&, CollectorMessages & )> &collector, int maxQueueLength = 0, QgsProcessingFeatureSource::Flags sourceFlags = QgsProcessingFeatureSource::Flags() );
+
+  private:
+
+    //! Reports the collector \a messages to the \a feedback
+    static void reportMessages( const CollectorMessages &messages, QgsProcessingFeedback *feedback );
 };
 
 /**
@@ -62,6 +85,18 @@ class QgsDissolveAlgorithm : public QgsCollectorAlgorithm
     QVariantMap processAlgorithm( const QVariantMap &parameters,
                                   QgsProcessingContext &context, QgsProcessingFeedback *feedback ) override;
 
+  private:
+
+    /**
+     * Dissolves \a parts with a cascaded union: parts are sorted along a Hilbert curve, and
+     * groups of spatially close parts are dissolved concurrently, recursively.
+     * GEOS fallbacks and errors are stored in \a messages, the \a feedback is only used for cancellation.
+     */
+    static QgsGeometry cascadedUnion( QVector< QgsGeometry > parts, QgsFeedback *feedback, CollectorMessages &messages );
+
+    //! Dissolves \a parts in a single union, falling back to pairwise unions if GEOS fails
+    static QgsGeometry unionParts( const QVector< QgsGeometry > &parts, QgsFeedback *feedback, CollectorMessages &messages );
+
 };
 
 /**
@@ -54,6 +54,11 @@ QString QgsDropMZValuesAlgorithm::shortHelpString() const
   return QObject::tr( "This algorithm can remove any measure (M) or Z values from input geometries." );
 }
 
+bool QgsDropMZValuesAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsDropMZValuesAlgorithm *QgsDropMZValuesAlgorithm::createInstance() const
 {
   return new QgsDropMZValuesAlgorithm();
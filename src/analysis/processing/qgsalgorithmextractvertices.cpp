@@ -54,6 +54,11 @@ QString QgsExtractVerticesAlgorithm::shortHelpString() const
          QObject::tr( "Additional fields are added to the point indicating the vertex index (beginning at 0), the vertex’s part and its index within the part (as well as its ring for polygons), distance along original geometry and bisector angle of vertex for original geometry." );
 }
 
+bool QgsExtractVerticesAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QString QgsExtractVerticesAlgorithm::outputName() const
 {
   return QObject::tr( "Vertices" );
@@ -68,6 +68,11 @@ QString QgsFixGeometriesAlgorithm::shortHelpString() const
                       "NOTE: M values will be dropped from the output." );
 }
 
+bool QgsFixGeometriesAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsFixGeometriesAlgorithm *QgsFixGeometriesAlgorithm::createInstance() const
 {
   return new QgsFixGeometriesAlgorithm();
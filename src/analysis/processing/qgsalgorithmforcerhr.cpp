@@ -64,6 +64,11 @@ QString QgsForceRHRAlgorithm::shortHelpString() const
                       "rings in a counter-clockwise direction." );
 }
 
+bool QgsForceRHRAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QString QgsForceRHRAlgorithm::shortDescription() const
 {
   return QObject::tr( "Forces polygon geometries to respect the Right-Hand-Rule." );
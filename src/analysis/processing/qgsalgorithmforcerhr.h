@@ -40,6 +40,7 @@ class QgsForceRHRAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    bool supportsParallelFeatureProcessing() const override;
     QString shortDescription() const override;
     QList<int> inputLayerTypes() const override;
     QgsForceRHRAlgorithm *createInstance() const override SIP_FACTORY;
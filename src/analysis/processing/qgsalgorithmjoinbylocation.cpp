@@ -18,6 +18,7 @@
 #include "qgsalgorithmjoinbylocation.h"
 #include "qgsprocessing.h"
 #include "qgsgeometryengine.h"
+#include "qgsgeos.h"
 #include "qgsvectorlayer.h"
 #include "qgsapplication.h"
 #include "qgsfeature.h"
@@ -513,19 +514,27 @@ bool QgsJoinByLocationAlgorithm::processFeatureFromInputSource( QgsFeature &base
 
   double largestOverlap  = std::numeric_limits< double >::lowest();
   QgsFeature bestMatch;
+  const int featVertexCount = featGeom.constGet()->nCoordinates();
 
   while ( it.nextFeature( joinFeature ) )
   {
     if ( feedback->isCanceled() )
       break;
 
-    if ( !engine )
+    // prepare the most complex geometry of the pair. Complex join features (e.g. large polygons) are
+    // usually tested against many input features, so their prepared geometries are cached
+    std::shared_ptr< QgsGeos > joinEngine;
+    if ( joinFeature.hasGeometry() && joinFeature.geometry().constGet()->nCoordinates() > featVertexCount )
+    {
+      joinEngine = mPreparedJoinGeometries.engine( joinFeature.id(), joinFeature.geometry() );
+    }
+    else if ( !engine )
     {
       engine.reset( QgsGeometry::createGeometryEngine( featGeom.constGet() ) );
       engine->prepareGeometry();
     }
 
-    if ( featureFilter( joinFeature, engine.get(), true ) )
+    if ( joinEngine ? featureFilter( baseFeature, joinEngine.get(), false ) : featureFilter( joinFeature, engine.get(), true ) )
     {
       switch ( mJoinMethod )
       {
@@ -549,7 +558,7 @@ bool QgsJoinByLocationAlgorithm::processFeatureFromInputSource( QgsFeature &base
         case JoinToLargestOverlap:
         {
           // calculate area of overlap
-          std::unique_ptr< QgsAbstractGeometry > intersection( engine->intersection( joinFeature.geometry().constGet() ) );
+          std::unique_ptr< QgsAbstractGeometry > intersection( joinEngine ? joinEngine->intersection( featGeom.constGet() ) : engine->intersection( joinFeature.geometry().constGet() ) );
           double overlap = 0;
           switch ( QgsWkbTypes::geometryType( intersection->wkbType() ) )
           {
@@ -23,6 +23,7 @@
 #include "qgis.h"
 #include "qgsprocessingalgorithm.h"
 #include "qgsfeature.h"
+#include "qgspreparedgeometrycache.h"
 
 
 ///@cond PRIVATE
@@ -75,6 +76,8 @@ class QgsJoinByLocationAlgorithm : public QgsProcessingAlgorithm
     std::unique_ptr< QgsFeatureSink > mUnjoinedFeatures;
     JoinMethod mJoinMethod = OneToMany;
     QList<int> mPredicates;
+    //! Prepared geometries of complex join features, reused for all the input features they are tested against
+    QgsPreparedGeometryCache mPreparedJoinGeometries;
 
     static void sortPredicates( QList<int > &predicates );
 };
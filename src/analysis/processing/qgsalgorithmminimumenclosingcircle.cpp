@@ -68,6 +68,11 @@ QString QgsMinimumEnclosingCircleAlgorithm::shortHelpString() const
          QObject::tr( "See the 'Minimum bounding geometry' algorithm for a minimal enclosing circle calculation which covers the whole layer or grouped subsets of features." );
 }
 
+bool QgsMinimumEnclosingCircleAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsMinimumEnclosingCircleAlgorithm *QgsMinimumEnclosingCircleAlgorithm::createInstance() const
 {
   return new QgsMinimumEnclosingCircleAlgorithm();
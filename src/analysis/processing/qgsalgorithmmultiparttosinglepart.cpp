@@ -62,6 +62,11 @@ QString QgsMultipartToSinglepartAlgorithm::shortHelpString() const
                       "contain, and the same attributes are used for each of them." );
 }
 
+bool QgsMultipartToSinglepartAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsMultipartToSinglepartAlgorithm *QgsMultipartToSinglepartAlgorithm::createInstance() const
 {
   return new QgsMultipartToSinglepartAlgorithm();
@@ -62,6 +62,11 @@ QString QgsOrientedMinimumBoundingBoxAlgorithm::shortHelpString() const
          QObject::tr( "See the 'Minimum bounding geometry' algorithm for a oriented bounding box calculation which covers the whole layer or grouped subsets of features." );
 }
 
+bool QgsOrientedMinimumBoundingBoxAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsOrientedMinimumBoundingBoxAlgorithm *QgsOrientedMinimumBoundingBoxAlgorithm::createInstance() const
 {
   return new QgsOrientedMinimumBoundingBoxAlgorithm();
@@ -80,6 +80,11 @@ QString QgsPolygonsToLinesAlgorithm::shortHelpString() const
   return QObject::tr( "Converts polygons to lines" );
 }
 
+bool QgsPolygonsToLinesAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QString QgsPolygonsToLinesAlgorithm::shortDescription() const
 {
   return QObject::tr( "Converts polygons to lines." );
@@ -43,6 +43,7 @@ class QgsPolygonsToLinesAlgorithm : public QgsProcessingFeatureBasedAlgorithm
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    bool supportsParallelFeatureProcessing() const override;
     QString shortDescription() const override;
     QgsPolygonsToLinesAlgorithm *createInstance() const override SIP_FACTORY;
     QList<int> inputLayerTypes() const override;
@@ -61,6 +61,11 @@ QString QgsPromoteToMultipartAlgorithm::shortHelpString() const
          QObject::tr( "See the 'Collect geometries' or 'Aggregate' algorithms for alternative options." );
 }
 
+bool QgsPromoteToMultipartAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsPromoteToMultipartAlgorithm *QgsPromoteToMultipartAlgorithm::createInstance() const
 {
   return new QgsPromoteToMultipartAlgorithm();
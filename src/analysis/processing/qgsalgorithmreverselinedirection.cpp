@@ -56,6 +56,11 @@ QString QgsReverseLineDirectionAlgorithm ::shortHelpString() const
   return QObject::tr( "This algorithm reverses the direction of curve or LineString geometries." );
 }
 
+bool QgsReverseLineDirectionAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QString QgsReverseLineDirectionAlgorithm::shortDescription() const
 {
   return QObject::tr( "Reverses the direction of curve or LineString geometries." );
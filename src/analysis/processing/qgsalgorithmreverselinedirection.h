@@ -40,6 +40,7 @@ class QgsReverseLineDirectionAlgorithm : public QgsProcessingFeatureBasedAlgorit
     QString group() const override;
     QString groupId() const override;
     QString shortHelpString() const override;
+    bool supportsParallelFeatureProcessing() const override;
     QString shortDescription() const override;
     QgsReverseLineDirectionAlgorithm  *createInstance() const override SIP_FACTORY;
     QgsProcessing::SourceType outputLayerType() const override;
@@ -20,6 +20,11 @@
 #include "qgsgeometryutils.h"
 #include "qgsgraphanalyzer.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+#include <atomic>
+
 ///@cond PRIVATE
 
 QString QgsServiceAreaFromLayerAlgorithm::name() const
@@ -109,7 +114,7 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
   mDirector->makeGraph( mBuilder.get(), points, snappedPoints, feedback );
 
   feedback->pushInfo( QObject::tr( "Calculating service areas…" ) );
-  QgsGraph *graph = mBuilder->graph();
+  const QgsGraph *graph = mBuilder->graph();
 
   QgsFields fields = startPoints->fields();
   fields.append( QgsField( QStringLiteral( "type" ), QVariant::String ) );
@@ -123,39 +128,24 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
   std::unique_ptr< QgsFeatureSink > linesSink( parameterAsSink( parameters, QStringLiteral( "OUTPUT_LINES" ), context, linesSinkId, fields,
       QgsWkbTypes::MultiLineString, mNetwork->sourceCrs() ) );
 
-  int idxStart;
-  QString origPoint;
-  QVector< int > tree;
-  QVector< double > costs;
-
-  int inboundEdgeIndex;
-  double startVertexCost, endVertexCost;
-  QgsPointXY startPoint, endPoint;
-  QgsGraphEdge edge;
-
-  QgsFeature feat;
-  QgsAttributes attributes;
-
-  int step =  snappedPoints.size() > 0 ? 100.0 / snappedPoints.size() : 1;
-  for ( int i = 0; i < snappedPoints.size(); i++ )
+  struct ServiceArea
+  {
+    bool located = false;
+    QgsGeometry points;
+    QgsGeometry upperBoundary;
+    QgsGeometry lowerBoundary;
+    QgsGeometry lines;
+  };
+
+  auto calculateServiceArea = [graph, travelCost, includeBounds, &pointsSink, &linesSink]( int idxStart, const QVector< int > &tree, const QVector< double > &costs, ServiceArea &area )
   {
-    if ( feedback->isCanceled() )
-    {
-      break;
-    }
-
-    idxStart = graph->findVertex( snappedPoints.at( i ) );
-    origPoint = points.at( i ).toString();
-
-    QgsGraphAnalyzer::dijkstra( graph, idxStart, 0, &tree, &costs );
-
     QgsMultiPointXY areaPoints;
     QgsMultiPolylineXY lines;
     QSet< int > vertices;
 
     for ( int j = 0; j < costs.size(); j++ )
     {
-      inboundEdgeIndex = tree.at( j );
+      const int inboundEdgeIndex = tree.at( j );
 
       if ( inboundEdgeIndex == -1 && j != idxStart )
       {
@@ -163,7 +153,7 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
         continue;
       }
 
-      startVertexCost = costs.at( j );
+      const double startVertexCost = costs.at( j );
       if ( startVertexCost > travelCost )
       {
         // vertex is too expensive, discard
@@ -171,15 +161,15 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
       }
 
       vertices.insert( j );
-      startPoint = graph->vertex( j ).point();
+      const QgsPointXY startPoint = graph->vertex( j ).point();
 
       // find all edges coming from this vertex
       const QList< int > outgoingEdges = graph->vertex( j ).outgoingEdges() ;
       for ( int edgeId : outgoingEdges )
       {
-        edge = graph->edge( edgeId );
-        endVertexCost = startVertexCost + edge.cost( 0 ).toDouble();
-        endPoint = graph->vertex( edge.toVertex() ).point();
+        const QgsGraphEdge &edge = graph->edge( edgeId );
+        const double endVertexCost = startVertexCost + edge.cost( 0 ).toDouble();
+        const QgsPointXY endPoint = graph->vertex( edge.toVertex() ).point();
         if ( endVertexCost <= travelCost )
         {
           // end vertex is cheap enough to include
@@ -209,12 +199,7 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
 
     if ( pointsSink )
     {
-      QgsGeometry geomPoints = QgsGeometry::fromMultiPointXY( areaPoints );
-      feat.setGeometry( geomPoints );
-      attributes = sourceAttributes.value( i + 1 );
-      attributes << QStringLiteral( "within" ) << origPoint;
-      feat.setAttributes( attributes );
-      pointsSink->addFeature( feat, QgsFeatureSink::FastInsert );
+      area.points = QgsGeometry::fromMultiPointXY( areaPoints );
 
       if ( includeBounds )
       {
@@ -241,34 +226,112 @@ QVariantMap QgsServiceAreaFromLayerAlgorithm::processAlgorithm( const QVariantMa
           lowerBoundary.push_back( graph->vertex( graph->edge( tree.at( n ) ).fromVertex() ).point() );
         } // nodes
 
-        QgsGeometry geomUpper = QgsGeometry::fromMultiPointXY( upperBoundary );
-        QgsGeometry geomLower = QgsGeometry::fromMultiPointXY( lowerBoundary );
+        area.upperBoundary = QgsGeometry::fromMultiPointXY( upperBoundary );
+        area.lowerBoundary = QgsGeometry::fromMultiPointXY( lowerBoundary );
+      } // includeBounds
+    }
+
+    if ( linesSink )
+    {
+      area.lines = QgsGeometry::fromMultiPolylineXY( lines );
+    }
+  };
+
+  // search buffers of each worker, reused for all the start points it handles
+  struct SearchBuffers
+  {
+    QVector< int > tree;
+    QVector< double > costs;
+  };
+
+  // the graph is not modified anymore, so the service areas of several start points are calculated
+  // concurrently, and written in the start points order after each batch
+  std::vector< SearchBuffers > buffers( std::max( QThread::idealThreadCount(), 1 ) );
+  const int batchSize = 4 * static_cast< int >( buffers.size() );
+  std::vector< ServiceArea > areas;
+
+  QgsFeature feat;
+  QgsAttributes attributes;
+
+  for ( int batchStart = 0; batchStart < snappedPoints.size(); batchStart += batchSize )
+  {
+    if ( feedback->isCanceled() )
+    {
+      break;
+    }
+
+    const int batchEnd = std::min( batchStart + batchSize, snappedPoints.size() );
+    areas.assign( batchEnd - batchStart, ServiceArea() );
+
+    std::atomic< int > nextPoint( batchStart );
+    QtConcurrent::blockingMap( buffers, [&]( SearchBuffers & searchBuffers )
+    {
+      for ( int i = nextPoint++; i < batchEnd && !feedback->isCanceled(); i = nextPoint++ )
+      {
+        const int idxStart = graph->findVertex( snappedPoints.at( i ) );
+        // dijkstra() returns early for invalid vertices, leaving the tree of the previous start point
+        // of this worker in the buffers: there is no service area to calculate
+        if ( idxStart < 0 )
+          continue;
+
+        QgsGraphAnalyzer::dijkstra( graph, idxStart, 0, &searchBuffers.tree, &searchBuffers.costs );
+        ServiceArea &area = areas[ i - batchStart ];
+        calculateServiceArea( idxStart, searchBuffers.tree, searchBuffers.costs, area );
+        area.located = true;
+      }
+    } );
+
+    if ( feedback->isCanceled() )
+    {
+      break;
+    }
 
-        feat.setGeometry( geomUpper );
+    for ( int i = batchStart; i < batchEnd; i++ )
+    {
+      const ServiceArea &area = areas[ i - batchStart ];
+      const QString origPoint = points.at( i ).toString();
+
+      if ( !area.located )
+      {
+        feedback->reportError( QObject::tr( "Start point (%1) could not be located in the network." ).arg( origPoint ) );
+        continue;
+      }
+
+      if ( pointsSink )
+      {
+        feat.setGeometry( area.points );
         attributes = sourceAttributes.value( i + 1 );
-        attributes << QStringLiteral( "upper" ) << origPoint;
+        attributes << QStringLiteral( "within" ) << origPoint;
         feat.setAttributes( attributes );
         pointsSink->addFeature( feat, QgsFeatureSink::FastInsert );
 
-        feat.setGeometry( geomLower );
+        if ( includeBounds )
+        {
+          feat.setGeometry( area.upperBoundary );
+          attributes = sourceAttributes.value( i + 1 );
+          attributes << QStringLiteral( "upper" ) << origPoint;
+          feat.setAttributes( attributes );
+          pointsSink->addFeature( feat, QgsFeatureSink::FastInsert );
+
+          feat.setGeometry( area.lowerBoundary );
+          attributes = sourceAttributes.value( i + 1 );
+          attributes << QStringLiteral( "lower" ) << origPoint;
+          feat.setAttributes( attributes );
+          pointsSink->addFeature( feat, QgsFeatureSink::FastInsert );
+        }
+      }
+
+      if ( linesSink )
+      {
+        feat.setGeometry( area.lines );
         attributes = sourceAttributes.value( i + 1 );
-        attributes << QStringLiteral( "lower" ) << origPoint;
+        attributes << QStringLiteral( "lines" ) << origPoint;
         feat.setAttributes( attributes );
-        pointsSink->addFeature( feat, QgsFeatureSink::FastInsert );
-      } // includeBounds
-    }
-
-    if ( linesSink )
-    {
-      QgsGeometry geomLines = QgsGeometry::fromMultiPolylineXY( lines );
-      feat.setGeometry( geomLines );
-      attributes = sourceAttributes.value( i + 1 );
-      attributes << QStringLiteral( "lines" ) << origPoint;
-      feat.setAttributes( attributes );
-      linesSink->addFeature( feat, QgsFeatureSink::FastInsert );
+        linesSink->addFeature( feat, QgsFeatureSink::FastInsert );
+      }
     }
 
-    feedback->setProgress( i * step );
+    feedback->setProgress( 100.0 * batchEnd / snappedPoints.size() );
   } // snappedPoints
 
   QVariantMap outputs;
@@ -21,6 +21,11 @@
 
 #include "qgsmessagelog.h"
 
+#include <QThread>
+#include <QtConcurrent>
+
+#include <atomic>
+
 ///@cond PRIVATE
 
 QString QgsShortestPathLayerToPointAlgorithm::name() const
@@ -87,67 +92,102 @@ QVariantMap QgsShortestPathLayerToPointAlgorithm::processAlgorithm( const QVaria
   mDirector->makeGraph( mBuilder.get(), points, snappedPoints, feedback );
 
   feedback->pushInfo( QObject::tr( "Calculating shortest paths…" ) );
-  QgsGraph *graph = mBuilder->graph();
-  int idxEnd = graph->findVertex( snappedPoints[0] );
-  int idxStart;
-  int currentIdx;
+  const QgsGraph *graph = mBuilder->graph();
+  const int idxEnd = graph->findVertex( snappedPoints[0] );
 
-  QVector< int > tree;
-  QVector< double > costs;
+  struct Route
+  {
+    bool reachable = false;
+    QgsGeometry geometry;
+    double cost = 0;
+  };
 
-  QVector<QgsPointXY> route;
-  double cost;
+  // search buffers of each worker, reused for all the start points it handles
+  struct SearchBuffers
+  {
+    QVector< int > tree;
+    QVector< double > costs;
+  };
 
-  QgsFeature feat;
-  feat.setFields( fields );
-  QgsAttributes attributes;
+  // the graph is not modified anymore, so the routes from several start points are searched
+  // concurrently, and written in the start points order after each batch
+  std::vector< SearchBuffers > buffers( std::max( QThread::idealThreadCount(), 1 ) );
+  const int batchSize = 16 * static_cast< int >( buffers.size() );
+  std::vector< Route > routes;
 
-  int step =  points.size() > 0 ? 100.0 / points.size() : 1;
-  for ( int i = 1; i < points.size(); i++ )
+  for ( int batchStart = 1; batchStart < points.size(); batchStart += batchSize )
   {
     if ( feedback->isCanceled() )
     {
       break;
     }
 
-    idxStart = graph->findVertex( snappedPoints[i] );
-    QgsGraphAnalyzer::dijkstra( graph, idxStart, 0, &tree, &costs );
+    const int batchEnd = std::min( batchStart + batchSize, points.size() );
+    routes.assign( batchEnd - batchStart, Route() );
 
-    if ( tree.at( idxEnd ) == -1 )
+    std::atomic< int > nextPoint( batchStart );
+    QtConcurrent::blockingMap( buffers, [&]( SearchBuffers & searchBuffers )
     {
-      feedback->reportError( QObject::tr( "There is no route from start point (%1) to end point (%2)." )
-                             .arg( points[i].toString(),
-                                   endPoint.toString() ) );
-      feat.clearGeometry();
-      attributes = sourceAttributes.value( i );
-      attributes.append( points[i].toString() );
-      feat.setAttributes( attributes );
-      sink->addFeature( feat, QgsFeatureSink::FastInsert );
-      continue;
+      for ( int i = nextPoint++; i < batchEnd && !feedback->isCanceled(); i = nextPoint++ )
+      {
+        const int idxStart = graph->findVertex( snappedPoints[i] );
+        // dijkstra() returns early for invalid vertices, leaving the tree of the previous start point
+        // of this worker in the buffers: the route must be reported as unreachable instead
+        if ( idxStart < 0 || idxEnd < 0 )
+          continue;
+
+        QgsGraphAnalyzer::dijkstra( graph, idxStart, 0, &searchBuffers.tree, &searchBuffers.costs );
+
+        if ( searchBuffers.tree.at( idxEnd ) == -1 )
+          continue;
+
+        QVector< QgsPointXY > route;
+        route.push_front( graph->vertex( idxEnd ).point() );
+        int currentIdx = idxEnd;
+        while ( currentIdx != idxStart )
+        {
+          currentIdx = graph->edge( searchBuffers.tree.at( currentIdx ) ).fromVertex();
+          route.push_front( graph->vertex( currentIdx ).point() );
+        }
+
+        Route &result = routes[ i - batchStart ];
+        result.reachable = true;
+        result.geometry = QgsGeometry::fromPolylineXY( route );
+        result.cost = searchBuffers.costs.at( idxEnd );
+      }
+    } );
+
+    if ( feedback->isCanceled() )
+    {
+      break;
     }
 
-    route.clear();
-    route.push_front( graph->vertex( idxEnd ).point() );
-    cost = costs.at( idxEnd );
-    currentIdx = idxEnd;
-    while ( currentIdx != idxStart )
+    for ( int i = batchStart; i < batchEnd; i++ )
     {
-      currentIdx = graph->edge( tree.at( currentIdx ) ).fromVertex();
-      route.push_front( graph->vertex( currentIdx ).point() );
+      const Route &route = routes[ i - batchStart ];
+      QgsFeature feat;
+      feat.setFields( fields );
+      QgsAttributes attributes = sourceAttributes.value( i );
+      attributes.append( points[i].toString() );
+
+      if ( !route.reachable )
+      {
+        feedback->reportError( QObject::tr( "There is no route from start point (%1) to end point (%2)." )
+                               .arg( points[i].toString(),
+                                     endPoint.toString() ) );
+        feat.setAttributes( attributes );
+        sink->addFeature( feat, QgsFeatureSink::FastInsert );
+        continue;
+      }
+
+      attributes.append( endPoint.toString() );
+      attributes.append( route.cost / mMultiplier );
+      feat.setAttributes( attributes );
+      feat.setGeometry( route.geometry );
+      sink->addFeature( feat, QgsFeatureSink::FastInsert );
     }
 
-    QgsGeometry geom = QgsGeometry::fromPolylineXY( route );
-    QgsFeature feat;
-    feat.setFields( fields );
-    attributes = sourceAttributes.value( i );
-    attributes.append( points[i].toString() );
-    attributes.append( endPoint.toString() );
-    attributes.append( cost / mMultiplier );
-    feat.setAttributes( attributes );
-    feat.setGeometry( geom );
-    sink->addFeature( feat, QgsFeatureSink::FastInsert );
-
-    feedback->setProgress( i * step );
+    feedback->setProgress( 100.0 * batchEnd / points.size() );
   }
 
   QVariantMap outputs;
@@ -84,22 +84,20 @@ QVariantMap QgsShortestPathPointToPointAlgorithm::processAlgorithm( const QVaria
   int idxStart = graph->findVertex( snappedPoints[0] );
   int idxEnd = graph->findVertex( snappedPoints[1] );
 
-  QVector< int > tree;
-  QVector< double > costs;
-  QgsGraphAnalyzer::dijkstra( graph, idxStart, 0, &tree, &costs );
+  // the search stops at the end point, rather than calculating the whole shortest path tree
+  QVector< int > path;
+  const double cost = QgsGraphAnalyzer::shortestPath( graph, idxStart, idxEnd, 0, &path );
 
-  if ( tree.at( idxEnd ) == -1 )
+  if ( path.size() < 2 )
   {
     throw QgsProcessingException( QObject::tr( "There is no route from start point to end point." ) );
   }
 
   QVector<QgsPointXY> route;
-  route.push_front( graph->vertex( idxEnd ).point() );
-  double cost = costs.at( idxEnd );
-  while ( idxEnd != idxStart )
+  route.reserve( path.size() );
+  for ( int vertexIdx : std::as_const( path ) )
   {
-    idxEnd = graph->edge( tree.at( idxEnd ) ).fromVertex();
-    route.push_front( graph->vertex( idxEnd ).point() );
+    route.append( graph->vertex( vertexIdx ).point() );
   }
 
   feedback->pushInfo( QObject::tr( "Writing results…" ) );
@@ -18,6 +18,7 @@
 #include "qgsalgorithmspatialindex.h"
 #include "qgsvectorlayer.h"
 #include "qgsvectordataprovider.h"
+#include "qgsspatialindex.h"
 
 ///@cond PRIVATE
 
@@ -57,7 +58,12 @@ QString QgsSpatialIndexAlgorithm::shortHelpString() const
   return QObject::tr( "Creates an index to speed up access to the features "
                       "in a layer based on their spatial location. Support "
                       "for spatial index creation is dependent on the layer's "
-                      "data provider." );
+                      "data provider.\n\n"
+                      "Optionally, a portable spatial index file can also be "
+                      "written. This file can be reused by later QGIS sessions "
+                      "to avoid rebuilding an in-memory index for the layer, "
+                      "and is automatically ignored once the layer's source "
+                      "changes." );
 }
 
 QgsSpatialIndexAlgorithm *QgsSpatialIndexAlgorithm::createInstance() const
@@ -69,6 +75,9 @@ void QgsSpatialIndexAlgorithm::initAlgorithm( const QVariantMap & )
 {
   addParameter( new QgsProcessingParameterVectorLayer( QStringLiteral( "INPUT" ), QObject::tr( "Input layer" ) ) );
 
+  addParameter( new QgsProcessingParameterFileDestination( QStringLiteral( "INDEX_FILE" ), QObject::tr( "Portable spatial index file" ),
+                QObject::tr( "QGIS spatial index (*.qsix *.QSIX)" ), QVariant(), true, false ) );
+
   addOutput( new QgsProcessingOutputVectorLayer( QStringLiteral( "OUTPUT" ), QObject::tr( "Indexed layer" ) ) );
 }
 
@@ -94,6 +103,22 @@ QVariantMap QgsSpatialIndexAlgorithm::processAlgorithm( const QVariantMap &param
   }
 
   QVariantMap outputs;
+
+  const QString indexFile = parameterAsFileOutput( parameters, QStringLiteral( "INDEX_FILE" ), context );
+  if ( !indexFile.isEmpty() )
+  {
+    feedback->pushInfo( QObject::tr( "Writing portable spatial index" ) );
+    QgsSpatialIndex index( layer->getFeatures( QgsFeatureRequest().setNoAttributes() ), feedback );
+    if ( feedback->isCanceled() )
+      return QVariantMap();
+
+    QString error;
+    if ( !index.writeToFile( indexFile, QgsSpatialIndex::indexSourceKey( layer->providerType(), layer->source() ), &error ) )
+      throw QgsProcessingException( error );
+
+    outputs.insert( QStringLiteral( "INDEX_FILE" ), indexFile );
+  }
+
   outputs.insert( QStringLiteral( "OUTPUT" ), layer->id() );
   return outputs;
 }
@@ -56,6 +56,11 @@ QString QgsSwapXYAlgorithm::shortHelpString() const
                       "which have accidentally had their latitude and longitude values reversed." );
 }
 
+bool QgsSwapXYAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return true;
+}
+
 QgsSwapXYAlgorithm *QgsSwapXYAlgorithm::createInstance() const
 {
   return new QgsSwapXYAlgorithm();
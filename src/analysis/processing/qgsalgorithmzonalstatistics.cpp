@@ -142,6 +142,9 @@ QVariantMap QgsZonalStatisticsAlgorithm::processAlgorithm( const QVariantMap &pa
                          mBand,
                          QgsZonalStatistics::Statistics( mStats )
                        );
+  // the tile based calculation keeps the pixel values of all the zones in memory when they
+  // are needed, so only use it for statistics which can be accumulated
+  zs.setTileBasedCalculation( !( mStats & ( QgsZonalStatistics::Median | QgsZonalStatistics::StDev | QgsZonalStatistics::Variance ) ) );
 
   zs.calculateStatistics( feedback );
 
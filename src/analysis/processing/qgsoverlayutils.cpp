@@ -16,10 +16,21 @@
 #include "qgsoverlayutils.h"
 
 #include "qgsgeometryengine.h"
+#include "qgsgeos.h"
 #include "qgsprocessingalgorithm.h"
 
 ///@cond PRIVATE
 
+//! Returns the intersection of the geometry of a prepared \a engine with \a geometry, without converting the engine geometry to GEOS again
+static QgsGeometry engineIntersection( const QgsGeometryEngine *engine, const QgsGeometry &geometry )
+{
+  QString error;
+  QgsGeometry result( std::unique_ptr< QgsAbstractGeometry >( engine->intersection( geometry.constGet(), &error ) ) );
+  if ( result.isNull() )
+    throw QgsProcessingException( QStringLiteral( "%1\n\n%2" ).arg( QObject::tr( "GEOS geoprocessing error: intersection failed." ), error ) );
+  return result;
+}
+
 bool QgsOverlayUtils::sanitizeIntersectionResult( QgsGeometry &geom, QgsWkbTypes::GeometryType geometryType )
 {
   if ( geom.isNull() )
@@ -121,15 +132,7 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
       if ( outputAttrs != OutputBA )
         request.setDestinationCrs( sourceA.sourceCrs(), context.transformContext() );
 
-      std::unique_ptr< QgsGeometryEngine > engine;
-      if ( !intersects.isEmpty() )
-      {
-        // use prepared geometries for faster intersection tests
-        engine.reset( QgsGeometry::createGeometryEngine( geom.constGet() ) );
-        engine->prepareGeometry();
-      }
-
-      QVector<QgsGeometry> geometriesB;
+      QVector<QgsGeometry> candidatesB;
       QgsFeature featB;
       QgsFeatureIterator fitB = sourceB.getFeatures( request );
       while ( fitB.nextFeature( featB ) )
@@ -137,8 +140,21 @@ void QgsOverlayUtils::difference( const QgsFeatureSource &sourceA, const QgsFeat
         if ( feedback->isCanceled() )
           break;
 
-        if ( engine->intersects( featB.geometry().constGet() ) )
-          geometriesB << featB.geometry();
+        candidatesB << featB.geometry();
+      }
+
+      QVector<QgsGeometry> geometriesB;
+      if ( !candidatesB.isEmpty() )
+      {
+        // use prepared geometries for faster intersection tests, testing all the candidates at once
+        QgsGeos engine( geom.constGet() );
+        engine.prepareGeometry();
+        const QVector< bool > intersectsB = engine.testRelation( candidatesB, QgsGeos::RelationIntersects );
+        for ( int i = 0; i < candidatesB.size(); ++i )
+        {
+          if ( intersectsB.at( i ) )
+            geometriesB << candidatesB.at( i );
+        }
       }
 
       if ( !geometriesB.isEmpty() )
@@ -249,7 +265,7 @@ void QgsOverlayUtils::intersection( const QgsFeatureSource &sourceA, const QgsFe
       if ( !engine->intersects( tmpGeom.constGet() ) )
         continue;
 
-      QgsGeometry intGeom = geom.intersection( tmpGeom );
+      QgsGeometry intGeom = engineIntersection( engine.get(), tmpGeom );
       if ( !sanitizeIntersectionResult( intGeom, geometryType ) )
         continue;
 
@@ -337,7 +353,7 @@ void QgsOverlayUtils::resolveOverlaps( const QgsFeatureSource &source, QgsFeatur
       if ( !g1engine->intersects( g2.constGet() ) )
         continue;
 
-      QgsGeometry geomIntersection = g1.intersection( g2 );
+      QgsGeometry geomIntersection = engineIntersection( g1engine.get(), g2 );
       if ( !sanitizeIntersectionResult( geomIntersection, geometryType ) )
         continue;
 
@@ -27,15 +27,72 @@
 #include "qgsproject.h"
 
 #include <QFile>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 
 #include <cpl_string.h>
 #include <gdalwarper.h>
 
+#include <atomic>
+#include <numeric>
+
 #ifdef HAVE_OPENCL
 #include "qgsopenclutils.h"
 #include "qgsgdalutils.h"
 #endif
 
+///@cond PRIVATE
+namespace
+{
+  //! Approximate number of pixels read, evaluated and written at once
+  constexpr int STRIP_PIXELS = 1 << 20;
+
+  /**
+   * Evaluates \a node for \a rows rows of \a rasterData starting at \a firstRow, and stores
+   * the results in \a output. Rows are evaluated in parallel.
+   */
+  bool calculateRows( const QgsRasterCalcNode *node, const QMap<QString, QgsRasterBlock *> &rasterData, int firstRow, int rows, int columns, double nodataValue, float *output )
+  {
+    QVector<int> rowIndexes( rows );
+    std::iota( rowIndexes.begin(), rowIndexes.end(), firstRow );
+    std::atomic<bool> ok( true );
+    QtConcurrent::blockingMap( rowIndexes, [&]( int row )
+    {
+      if ( !ok )
+        return;
+
+      // calculate() takes a non-const map, so every row works on its own copy
+      QMap<QString, QgsRasterBlock *> rowData = rasterData;
+      QgsRasterMatrix resultMatrix( columns, 1, nullptr, nodataValue );
+      if ( !node->calculate( rowData, resultMatrix, row ) )
+      {
+        ok = false;
+        return;
+      }
+
+      float *rowOutput = output + static_cast< std::size_t >( row - firstRow ) * columns;
+      if ( resultMatrix.isNumber() )
+        std::fill( rowOutput, rowOutput + columns, static_cast< float >( resultMatrix.number() ) );
+      else
+        std::copy( resultMatrix.data(), resultMatrix.data() + columns, rowOutput );
+    } );
+    return ok;
+  }
+
+  //! Writes \a rows rows of \a data to \a band from a background thread
+  QFuture<void> writeRowsAsync( GDALRasterBandH band, int firstRow, int rows, int columns, const std::vector<float> &data )
+  {
+    return QtConcurrent::run( [band, firstRow, rows, columns, &data]
+    {
+      if ( GDALRasterIO( band, GF_Write, 0, firstRow, columns, rows, const_cast< float * >( data.data() ), columns, rows, GDT_Float32, 0, 0 ) != CE_None )
+      {
+        QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
+      }
+    } );
+  }
+}
+///@endcond
+
 QgsRasterCalculator::QgsRasterCalculator( const QString &formulaString, const QString &outputFile, const QString &outputFormat, const QgsRectangle &outputExtent, int nOutputColumns, int nOutputRows, const QVector<QgsRasterCalculatorEntry> &rasterEntries, const QgsCoordinateTransformContext &transformContext )
   : mFormulaString( formulaString )
   , mOutputFile( outputFile )
@@ -184,16 +241,19 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
       }
     }
 
-    //read / write line by line
+    // Read strips of rows from the providers on this thread, evaluate the rows of each strip
+    // in parallel, and write the results in the background while the next strip is read
     QMap<QString, QgsRasterBlock * > _rasterData;
-    // Cast to float
-    std::vector<float> castedResult( static_cast<size_t>( mNumOutputColumns ), 0 );
-    auto rowHeight = mOutputRectangle.height() / mNumOutputRows;
-    for ( size_t row = 0; row < static_cast<size_t>( mNumOutputRows ); ++row )
+    const int stripRows = std::max( 1, std::min( STRIP_PIXELS / std::max( mNumOutputColumns, 1 ), mNumOutputRows ) );
+    std::vector<float> stripResult;
+    std::vector<float> writtenResult;
+    QFuture<void> writeFuture;
+    const double rowHeight = mOutputRectangle.height() / mNumOutputRows;
+    for ( int firstRow = 0; firstRow < mNumOutputRows; firstRow += stripRows )
     {
       if ( feedback )
       {
-        feedback->setProgress( 100.0 * static_cast< double >( row ) / mNumOutputRows );
+        feedback->setProgress( 100.0 * static_cast< double >( firstRow ) / mNumOutputRows );
       }
 
       if ( feedback && feedback->isCanceled() )
@@ -201,10 +261,12 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
         break;
       }
 
-      // Calculates the rect for a single row read
+      const int rows = std::min( stripRows, mNumOutputRows - firstRow );
+
+      // Calculates the rect for the strip
       QgsRectangle rect( mOutputRectangle );
-      rect.setYMaximum( rect.yMaximum() - rowHeight * row );
-      rect.setYMinimum( rect.yMaximum() - rowHeight );
+      rect.setYMaximum( rect.yMaximum() - rowHeight * firstRow );
+      rect.setYMinimum( rect.yMaximum() - rowHeight * rows );
 
       // Read rows into input blocks
       for ( auto &layerRef : inputBlocks )
@@ -216,38 +278,36 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
           proj.setCrs( ref.raster->crs(), mOutputCrs, mTransformContext );
           proj.setInput( ref.raster->dataProvider() );
           proj.setPrecision( QgsRasterProjector::Exact );
-          layerRef.second.reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          layerRef.second.reset( proj.block( ref.bandNumber, rect, mNumOutputColumns, rows ) );
         }
         else
         {
-          layerRef.second.reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, 1 ) );
+          layerRef.second.reset( ref.raster->dataProvider()->block( ref.bandNumber, rect, mNumOutputColumns, rows ) );
         }
       }
 
-      // 1 row X mNumOutputColumns matrix
-      QgsRasterMatrix resultMatrix( mNumOutputColumns, 1, nullptr, outputNodataValue );
-
       _rasterData.clear();
       for ( const auto &layerRef : inputBlocks )
       {
         _rasterData.insert( layerRef.first, layerRef.second.get() );
       }
 
-      if ( calcNode->calculate( _rasterData, resultMatrix, 0 ) )
-      {
-        std::copy( resultMatrix.data(), resultMatrix.data() + mNumOutputColumns, castedResult.begin() );
-        if ( GDALRasterIO( outputRasterBand, GF_Write, 0, row, mNumOutputColumns, 1, castedResult.data(), mNumOutputColumns, 1, GDT_Float32, 0, 0 ) != CE_None )
-        {
-          QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
-        }
-      }
-      else
+      stripResult.resize( static_cast< std::size_t >( rows ) * mNumOutputColumns );
+      const bool calculated = calculateRows( calcNode.get(), _rasterData, 0, rows, mNumOutputColumns, outputNodataValue, stripResult.data() );
+
+      // the previous strip must be written before its buffer is reused
+      writeFuture.waitForFinished();
+      if ( !calculated )
       {
         //delete the dataset without closing (because it is faster)
         gdal::fast_delete_and_close( outputDataset, outputDriver, mOutputFile );
         return CalculationError;
       }
+
+      std::swap( stripResult, writtenResult );
+      writeFuture = writeRowsAsync( outputRasterBand, firstRow, rows, mNumOutputColumns, writtenResult );
     }
+    writeFuture.waitForFinished();
 
     if ( feedback )
     {
@@ -292,15 +352,16 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
       inputBlocks.insert( it->ref, block.release() );
     }
 
-    QgsRasterMatrix resultMatrix;
-    resultMatrix.setNodataValue( outputNodataValue );
-
-    //read / write line by line
-    for ( int i = 0; i < mNumOutputRows; ++i )
+    // evaluate strips of rows in parallel, and write each strip while the next one is evaluated
+    const int stripRows = std::max( 1, std::min( STRIP_PIXELS / std::max( mNumOutputColumns, 1 ), mNumOutputRows ) );
+    std::vector<float> stripResult;
+    std::vector<float> writtenResult;
+    QFuture<void> writeFuture;
+    for ( int firstRow = 0; firstRow < mNumOutputRows; firstRow += stripRows )
     {
       if ( feedback )
       {
-        feedback->setProgress( 100.0 * static_cast< double >( i ) / mNumOutputRows );
+        feedback->setProgress( 100.0 * static_cast< double >( firstRow ) / mNumOutputRows );
       }
 
       if ( feedback && feedback->isCanceled() )
@@ -308,25 +369,12 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
         break;
       }
 
-      if ( calcNode->calculate( inputBlocks, resultMatrix, i ) )
-      {
-        bool resultIsNumber = resultMatrix.isNumber();
-        float *calcData = new float[mNumOutputColumns];
+      const int rows = std::min( stripRows, mNumOutputRows - firstRow );
+      stripResult.resize( static_cast< std::size_t >( rows ) * mNumOutputColumns );
+      const bool calculated = calculateRows( calcNode.get(), inputBlocks, firstRow, rows, mNumOutputColumns, outputNodataValue, stripResult.data() );
 
-        for ( int j = 0; j < mNumOutputColumns; ++j )
-        {
-          calcData[j] = ( float )( resultIsNumber ? resultMatrix.number() : resultMatrix.data()[j] );
-        }
-
-        //write scanline to the dataset
-        if ( GDALRasterIO( outputRasterBand, GF_Write, 0, i, mNumOutputColumns, 1, calcData, mNumOutputColumns, 1, GDT_Float32, 0, 0 ) != CE_None )
-        {
-          QgsDebugMsg( QStringLiteral( "RasterIO error!" ) );
-        }
-
-        delete[] calcData;
-      }
-      else
+      writeFuture.waitForFinished();
+      if ( !calculated )
       {
         qDeleteAll( inputBlocks );
         inputBlocks.clear();
@@ -334,7 +382,10 @@ QgsRasterCalculator::Result QgsRasterCalculator::processCalculation( QgsFeedback
         return CalculationError;
       }
 
+      std::swap( stripResult, writtenResult );
+      writeFuture = writeRowsAsync( outputRasterBand, firstRow, rows, mNumOutputColumns, writtenResult );
     }
+    writeFuture.waitForFinished();
 
     if ( feedback )
     {
@@ -19,6 +19,110 @@
 #include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <functional>
+
+///@cond PRIVATE
+namespace
+{
+  /**
+   * Applies \a op to all entries of \a data and \a other. The loop body has no branches, so
+   * that the compiler is able to vectorize it.
+   */
+  template <typename Op>
+  void applyElementWise( double *data, const double *other, int nEntries, double nodataValue, double otherNodataValue, Op op )
+  {
+    for ( int i = 0; i < nEntries; ++i )
+    {
+      const double value1 = data[i];
+      const double value2 = other[i];
+      const bool isNodata = value1 == nodataValue || value2 == otherNodataValue;
+      data[i] = isNodata ? nodataValue : op( value1, value2 );
+    }
+  }
+
+  //! Applies \a op to all entries of \a data and the number \a value
+  template <typename Op>
+  void applyWithNumber( double *data, double value, int nEntries, double nodataValue, Op op )
+  {
+    for ( int i = 0; i < nEntries; ++i )
+    {
+      const double value1 = data[i];
+      data[i] = value1 == nodataValue ? nodataValue : op( value1, value );
+    }
+  }
+
+  //! Returns 1 if the comparison of both arguments is TRUE, 0 otherwise
+  template <typename Compare>
+  struct BooleanResult
+  {
+    double operator()( double arg1, double arg2 ) const
+    {
+      return Compare()( arg1, arg2 ) ? 1.0 : 0.0;
+    }
+  };
+
+  struct Maximum
+  {
+    double operator()( double arg1, double arg2 ) const { return std::max( arg1, arg2 ); }
+  };
+
+  struct Minimum
+  {
+    double operator()( double arg1, double arg2 ) const { return std::min( arg1, arg2 ); }
+  };
+
+  /**
+   * Dispatches the operators which can be evaluated without branches to \a function, called
+   * with the matching functor. Returns FALSE if the operator needs per-entry validity checks.
+   */
+  template <typename Function>
+  bool dispatchSimpleOperator( QgsRasterMatrix::TwoArgOperator op, Function function )
+  {
+    switch ( op )
+    {
+      case QgsRasterMatrix::opPLUS:
+        function( std::plus<double>() );
+        return true;
+      case QgsRasterMatrix::opMINUS:
+        function( std::minus<double>() );
+        return true;
+      case QgsRasterMatrix::opMUL:
+        function( std::multiplies<double>() );
+        return true;
+      case QgsRasterMatrix::opEQ:
+        function( BooleanResult< std::equal_to<double> >() );
+        return true;
+      case QgsRasterMatrix::opNE:
+        function( BooleanResult< std::not_equal_to<double> >() );
+        return true;
+      case QgsRasterMatrix::opGT:
+        function( BooleanResult< std::greater<double> >() );
+        return true;
+      case QgsRasterMatrix::opLT:
+        function( BooleanResult< std::less<double> >() );
+        return true;
+      case QgsRasterMatrix::opGE:
+        function( BooleanResult< std::greater_equal<double> >() );
+        return true;
+      case QgsRasterMatrix::opLE:
+        function( BooleanResult< std::less_equal<double> >() );
+        return true;
+      case QgsRasterMatrix::opMAX:
+        function( Maximum() );
+        return true;
+      case QgsRasterMatrix::opMIN:
+        function( Minimum() );
+        return true;
+      case QgsRasterMatrix::opDIV:
+      case QgsRasterMatrix::opPOW:
+      case QgsRasterMatrix::opAND:
+      case QgsRasterMatrix::opOR:
+        break;
+    }
+    return false;
+  }
+}
+///@endcond
 
 QgsRasterMatrix::QgsRasterMatrix( int nCols, int nRows, double *data, double nodataValue )
   : mColumns( nCols )
@@ -350,6 +454,10 @@ bool QgsRasterMatrix::twoArgumentOperation( TwoArgOperator op, const QgsRasterMa
   {
     double *matrix = other.mData;
     int nEntries = mColumns * mRows;
+
+    if ( dispatchSimpleOperator( op, [&]( auto function ) { applyElementWise( mData, matrix, nEntries, mNodataValue, other.mNodataValue, function ); } ) )
+      return true;
+
     double value1, value2;
 
     for ( int i = 0; i < nEntries; ++i )
@@ -415,6 +523,9 @@ bool QgsRasterMatrix::twoArgumentOperation( TwoArgOperator op, const QgsRasterMa
       return true;
     }
 
+    if ( dispatchSimpleOperator( op, [&]( auto function ) { applyWithNumber( mData, value, nEntries, mNodataValue, function ); } ) )
+      return true;
+
     for ( int i = 0; i < nEntries; ++i )
     {
       if ( mData[i] == mNodataValue )
@@ -27,8 +27,148 @@
 #include "qgsrasterlayer.h"
 #include "qgslogger.h"
 #include "qgsproject.h"
+#include "qgsrasteriterator.h"
+#include "qgsrasterblock.h"
+#include "qgsspatialindex.h"
+#include "qgsgeometryengine.h"
+#include "qgscurvepolygon.h"
+#include "qgslinestring.h"
+#include "qgspoint.h"
 
 #include <QFile>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <map>
+
+namespace
+{
+  //! Maximum width and height in pixels of the raster tiles used by the tile based calculation
+  constexpr int TILE_SIZE = 512;
+
+  //! Boundary of a zone, used to rasterize it along the center lines of raster rows
+  struct ZoneBoundary
+  {
+    //! Non horizontal edges of all the rings, as x1, y1, x2, y2 with y1 < y2
+    std::vector< std::array< double, 4 > > edges;
+    //! Sorted y coordinates of all the vertices
+    std::vector< double > vertexY;
+    QgsRectangle extent;
+  };
+
+  ZoneBoundary zoneBoundary( const QgsGeometry &geometry )
+  {
+    ZoneBoundary boundary;
+    boundary.extent = geometry.boundingBox();
+
+    std::unique_ptr< QgsAbstractGeometry > segmentized( geometry.constGet()->segmentize() );
+    for ( auto partIt = segmentized->const_parts_begin(); partIt != segmentized->const_parts_end(); ++partIt )
+    {
+      const QgsCurvePolygon *polygon = qgsgeometry_cast< const QgsCurvePolygon * >( *partIt );
+      if ( !polygon )
+        continue;
+
+      for ( int ringIndex = -1; ringIndex < polygon->numInteriorRings(); ++ringIndex )
+      {
+        const QgsLineString *ring = qgsgeometry_cast< const QgsLineString * >( ringIndex < 0 ? polygon->exteriorRing() : polygon->interiorRing( ringIndex ) );
+        if ( !ring )
+          continue;
+
+        const int pointCount = ring->numPoints();
+        const double *x = ring->xData();
+        const double *y = ring->yData();
+        for ( int i = 0; i < pointCount; ++i )
+        {
+          boundary.vertexY.push_back( y[i] );
+          // the last edge closes the ring, it is degenerate for rings which are already closed
+          const int previous = i > 0 ? i - 1 : pointCount - 1;
+          if ( y[previous] < y[i] )
+            boundary.edges.push_back( { x[previous], y[previous], x[i], y[i] } );
+          else if ( y[previous] > y[i] )
+            boundary.edges.push_back( { x[i], y[i], x[previous], y[previous] } );
+        }
+      }
+    }
+    std::sort( boundary.vertexY.begin(), boundary.vertexY.end() );
+    return boundary;
+  }
+
+  /**
+   * Rasterizes a zone \a boundary within a raster tile covering \a extent, using the middle point of the cells.
+   *
+   * Runs of cells whose center is inside the zone are passed to \a addCells. Cells whose center lies on
+   * the zone boundary, within the rounding errors, are passed to \a testCell instead, so that the caller
+   * can test them exactly.
+   */
+  void rasterizeZone( const ZoneBoundary &boundary, const QgsRectangle &extent, int columns, int rows, double cellSizeX, double cellSizeY,
+                      const std::function< void( int row, int firstColumn, int lastColumn ) > &addCells,
+                      const std::function< void( int row, int column ) > &testCell )
+  {
+    const double epsilonX = cellSizeX * 1e-8;
+    const double epsilonY = cellSizeY * 1e-8;
+    auto cellCenterX = [&]( int column ) { return extent.xMinimum() + ( column + 0.5 ) * cellSizeX; };
+    auto cellCenterY = [&]( int row ) { return extent.yMaximum() - ( row + 0.5 ) * cellSizeY; };
+    // clamps to [min, max] before converting to int, as zones may extend far beyond the tile
+    auto clampedIndex = []( double index, int min, int max ) { return static_cast< int >( std::clamp( index, static_cast< double >( min ), static_cast< double >( max ) ) ); };
+
+    // x coordinates where the center line of each row crosses the zone boundary, the edges
+    // contain their lowest vertex only so that rows crossing a vertex are handled consistently
+    std::vector< std::vector< double > > crossings( rows );
+    for ( const std::array< double, 4 > &edge : boundary.edges )
+    {
+      const int firstRow = clampedIndex( std::floor( ( extent.yMaximum() - edge[3] ) / cellSizeY - 0.5 ), 0, rows );
+      const int lastRow = clampedIndex( std::ceil( ( extent.yMaximum() - edge[1] ) / cellSizeY - 0.5 ), -1, rows - 1 );
+      for ( int row = firstRow; row <= lastRow; ++row )
+      {
+        const double y = cellCenterY( row );
+        if ( y < edge[1] || y >= edge[3] )
+          continue;
+        crossings[ row ].push_back( edge[0] + ( y - edge[1] ) * ( edge[2] - edge[0] ) / ( edge[3] - edge[1] ) );
+      }
+    }
+
+    const int zoneFirstColumn = clampedIndex( std::floor( ( boundary.extent.xMinimum() - extent.xMinimum() ) / cellSizeX ), 0, columns );
+    const int zoneLastColumn = clampedIndex( std::ceil( ( boundary.extent.xMaximum() - extent.xMinimum() ) / cellSizeX ), -1, columns - 1 );
+    std::vector< int > boundaryColumns;
+    for ( int row = 0; row < rows; ++row )
+    {
+      const double y = cellCenterY( row );
+      auto vertexIt = std::lower_bound( boundary.vertexY.begin(), boundary.vertexY.end(), y - epsilonY );
+      if ( vertexIt != boundary.vertexY.end() && *vertexIt <= y + epsilonY )
+      {
+        // the center line runs through a vertex, and maybe along a horizontal edge
+        for ( int column = zoneFirstColumn; column <= zoneLastColumn; ++column )
+          testCell( row, column );
+        continue;
+      }
+
+      std::vector< double > &rowCrossings = crossings[ row ];
+      std::sort( rowCrossings.begin(), rowCrossings.end() );
+      for ( std::size_t i = 0; i + 1 < rowCrossings.size(); i += 2 )
+      {
+        const int firstColumn = clampedIndex( std::floor( ( rowCrossings[i] + epsilonX - extent.xMinimum() ) / cellSizeX - 0.5 ) + 1, 0, columns );
+        const int lastColumn = clampedIndex( std::ceil( ( rowCrossings[i + 1] - epsilonX - extent.xMinimum() ) / cellSizeX - 0.5 ) - 1, -1, columns - 1 );
+        if ( firstColumn <= lastColumn )
+          addCells( row, firstColumn, lastColumn );
+      }
+
+      boundaryColumns.clear();
+      for ( double x : rowCrossings )
+      {
+        const int column = static_cast< int >( std::round( std::clamp( ( x - extent.xMinimum() ) / cellSizeX - 0.5, -1.0, static_cast< double >( columns ) ) ) );
+        if ( column >= 0 && column < columns && std::fabs( cellCenterX( column ) - x ) <= epsilonX )
+          boundaryColumns.push_back( column );
+      }
+      std::sort( boundaryColumns.begin(), boundaryColumns.end() );
+      boundaryColumns.erase( std::unique( boundaryColumns.begin(), boundaryColumns.end() ), boundaryColumns.end() );
+      for ( int column : boundaryColumns )
+        testCell( row, column );
+    }
+  }
+}
 
 QgsZonalStatistics::QgsZonalStatistics( QgsVectorLayer *polygonLayer, QgsRasterLayer *rasterLayer, const QString &attributePrefix, int rasterBand, QgsZonalStatistics::Statistics stats )
   : QgsZonalStatistics( polygonLayer,
@@ -122,33 +262,61 @@ QgsZonalStatistics::Result QgsZonalStatistics::calculateStatistics( QgsFeedback
   int featureCounter = 0;
 
   QgsChangedAttributesMap changeMap;
-  while ( fi.nextFeature( feature ) )
+  auto addResults = [&]( QgsFeatureId id, const QMap<QgsZonalStatistics::Statistic, QVariant> &results )
   {
-    ++featureCounter;
-    if ( feedback && feedback->isCanceled() )
+    if ( results.empty() )
+      return;
+
+    QgsAttributeMap changeAttributeMap;
+    for ( const auto &result : results.toStdMap() )
     {
-      break;
+      changeAttributeMap.insert( statFieldIndexes.value( result.first ), result.second );
     }
 
-    if ( feedback )
+    changeMap.insert( id, changeAttributeMap );
+  };
+
+  if ( mTileBasedCalculation )
+  {
+    QVector< QgsFeatureId > ids;
+    QVector< QgsGeometry > geometries;
+    ids.reserve( featureCount );
+    geometries.reserve( featureCount );
+    while ( fi.nextFeature( feature ) )
     {
-      feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+      if ( feedback && feedback->isCanceled() )
+      {
+        break;
+      }
+      ids << feature.id();
+      geometries << feature.geometry();
     }
 
-    QgsGeometry featureGeometry = feature.geometry();
+    const QVector< QMap<QgsZonalStatistics::Statistic, QVariant> > results = calculateTiledStatistics( geometries, feedback );
+    for ( int i = 0; i < results.size(); ++i )
+    {
+      addResults( ids.at( i ), results.at( i ) );
+    }
+  }
+  else
+  {
+    while ( fi.nextFeature( feature ) )
+    {
+      ++featureCounter;
+      if ( feedback && feedback->isCanceled() )
+      {
+        break;
+      }
 
-    QMap<QgsZonalStatistics::Statistic, QVariant> results = calculateStatistics( mRasterInterface, featureGeometry, mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+      if ( feedback )
+      {
+        feedback->setProgress( 100.0 * static_cast< double >( featureCounter ) / featureCount );
+      }
 
-    if ( results.empty() )
-      continue;
+      QgsGeometry featureGeometry = feature.geometry();
 
-    QgsAttributeMap changeAttributeMap;
-    for ( const auto &result : results.toStdMap() )
-    {
-      changeAttributeMap.insert( statFieldIndexes.value( result.first ), result.second );
+      addResults( feature.id(), calculateStatistics( mRasterInterface, featureGeometry, mCellSizeX, mCellSizeY, mRasterBand, mStatistics ) );
     }
-
-    changeMap.insert( feature.id(), changeAttributeMap );
   }
 
   vectorProvider->changeAttributeValues( changeMap );
@@ -339,7 +507,12 @@ QMap<QgsZonalStatistics::Statistic, QVariant> QgsZonalStatistics::calculateStati
     QgsRasterAnalysisUtils::statisticsFromPreciseIntersection( rasterInterface, rasterBand, geometry, nCellsX, nCellsY, cellSizeX, cellSizeY, rasterBlockExtent, [ &featureStats ]( double value, double weight ) { featureStats.addValue( value, weight ); } );
   }
 
-  // calculate the statistics
+  return statisticsResults( featureStats, statistics );
+}
+
+QMap<QgsZonalStatistics::Statistic, QVariant> QgsZonalStatistics::statisticsResults( FeatureStats &featureStats, QgsZonalStatistics::Statistics statistics )
+{
+  QMap<QgsZonalStatistics::Statistic, QVariant> results;
 
   if ( statistics & QgsZonalStatistics::Count )
     results.insert( QgsZonalStatistics::Count, QVariant( featureStats.count ) );
@@ -410,3 +583,164 @@ QMap<QgsZonalStatistics::Statistic, QVariant> QgsZonalStatistics::calculateStati
 
   return results;
 }
+
+QVector< QMap<QgsZonalStatistics::Statistic, QVariant> > QgsZonalStatistics::calculateTiledStatistics( const QVector< QgsGeometry > &geometries, QgsFeedback *feedback ) const
+{
+  const int zoneCount = geometries.size();
+  const QgsRectangle rasterBBox = mRasterInterface->extent();
+
+  // zones are indexed by their position in geometries
+  QgsSpatialIndex index;
+  std::vector< ZoneBoundary > boundaries( zoneCount );
+  std::vector< bool > zoneInRaster( zoneCount, false );
+  QgsRectangle zonesExtent;
+  for ( int zone = 0; zone < zoneCount; ++zone )
+  {
+    const QgsGeometry &geometry = geometries.at( zone );
+    if ( geometry.isEmpty() )
+      continue;
+
+    const QgsRectangle zoneRect = geometry.boundingBox().intersect( rasterBBox );
+    if ( zoneRect.isEmpty() )
+      continue;
+
+    boundaries[ zone ] = zoneBoundary( geometry );
+    zoneInRaster[ zone ] = true;
+    index.addFeature( zone, zoneRect );
+    if ( zonesExtent.isNull() )
+      zonesExtent = zoneRect;
+    else
+      zonesExtent.combineExtentWith( zoneRect );
+  }
+
+  const bool statsStoreValues = ( mStatistics & QgsZonalStatistics::Median ) ||
+                                ( mStatistics & QgsZonalStatistics::StDev ) ||
+                                ( mStatistics & QgsZonalStatistics::Variance );
+  const bool statsStoreValueCount = ( mStatistics & QgsZonalStatistics::Minority ) ||
+                                    ( mStatistics & QgsZonalStatistics::Majority );
+  std::vector< FeatureStats > zoneStats( zoneCount, FeatureStats( statsStoreValues, statsStoreValueCount ) );
+
+  if ( !zonesExtent.isNull() )
+  {
+    int nCellsX = 0;
+    int nCellsY = 0;
+    QgsRectangle rasterBlockExtent;
+    QgsRasterAnalysisUtils::cellInfoForBBox( rasterBBox, zonesExtent, mCellSizeX, mCellSizeY, nCellsX, nCellsY, mRasterInterface->xSize(), mRasterInterface->ySize(), rasterBlockExtent );
+
+    QgsRasterIterator iter( mRasterInterface );
+    iter.setMaximumTileWidth( TILE_SIZE );
+    iter.setMaximumTileHeight( TILE_SIZE );
+    iter.startRasterRead( mRasterBand, nCellsX, nCellsY, rasterBlockExtent );
+    const int tileCount = ( ( nCellsX + TILE_SIZE - 1 ) / TILE_SIZE ) * ( ( nCellsY + TILE_SIZE - 1 ) / TILE_SIZE );
+
+    struct Tile
+    {
+      QgsRectangle extent;
+      int columns = 0;
+      int rows = 0;
+      QList< QgsFeatureId > zones;
+      std::unique_ptr< QgsRasterBlock > block;
+      std::map< int, FeatureStats > stats;
+    };
+
+    // tiles are read on this thread, as raster interfaces are not thread safe, then rasterized concurrently
+    const int batchSize = 2 * std::max( QThread::idealThreadCount(), 1 );
+    int tileCounter = 0;
+    bool lastTile = false;
+    while ( !lastTile )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return QVector< QMap<QgsZonalStatistics::Statistic, QVariant> >();
+
+      std::vector< Tile > tiles;
+      while ( static_cast< int >( tiles.size() ) < batchSize )
+      {
+        Tile tile;
+        int topLeftColumn = 0;
+        int topLeftRow = 0;
+        if ( !iter.next( mRasterBand, tile.columns, tile.rows, topLeftColumn, topLeftRow, tile.extent ) )
+        {
+          lastTile = true;
+          break;
+        }
+        ++tileCounter;
+
+        // skip tiles between zones without reading them
+        tile.zones = index.intersects( tile.extent );
+        if ( tile.zones.isEmpty() )
+          continue;
+
+        tile.block.reset( mRasterInterface->block( mRasterBand, tile.extent, tile.columns, tile.rows ) );
+        if ( tile.block && tile.block->isValid() )
+          tiles.push_back( std::move( tile ) );
+      }
+
+      QtConcurrent::blockingMap( tiles, [&]( Tile & tile )
+      {
+        if ( feedback && feedback->isCanceled() )
+          return;
+
+        for ( QgsFeatureId zoneId : std::as_const( tile.zones ) )
+        {
+          const int zone = static_cast< int >( zoneId );
+          FeatureStats &stats = tile.stats.emplace( zone, FeatureStats( statsStoreValues, statsStoreValueCount ) ).first->second;
+          auto addCell = [&tile, &stats]( int row, int column )
+          {
+            bool isNoData = false;
+            const double pixelValue = tile.block->valueAndNoData( row, column, isNoData );
+            if ( QgsRasterAnalysisUtils::validPixel( pixelValue ) && !isNoData )
+              stats.addValue( pixelValue );
+          };
+
+          // exact middle point tests for cells on the zone boundary, with an engine owned by this thread
+          std::unique_ptr< QgsGeometryEngine > engine;
+          rasterizeZone( boundaries[ zone ], tile.extent, tile.columns, tile.rows, mCellSizeX, mCellSizeY,
+                         [&addCell]( int row, int firstColumn, int lastColumn )
+          {
+            for ( int column = firstColumn; column <= lastColumn; ++column )
+              addCell( row, column );
+          },
+          [&]( int row, int column )
+          {
+            if ( !engine )
+            {
+              engine.reset( QgsGeometry::createGeometryEngine( geometries.at( zone ).constGet() ) );
+              engine->prepareGeometry();
+            }
+            const QgsPoint cellCenter( tile.extent.xMinimum() + ( column + 0.5 ) * mCellSizeX, tile.extent.yMaximum() - ( row + 0.5 ) * mCellSizeY );
+            if ( engine->contains( &cellCenter ) )
+              addCell( row, column );
+          } );
+        }
+      } );
+
+      for ( Tile &tile : tiles )
+      {
+        for ( auto &stats : tile.stats )
+          zoneStats[ stats.first ].merge( stats.second );
+      }
+
+      if ( feedback )
+        feedback->setProgress( 100.0 * tileCounter / tileCount );
+    }
+  }
+
+  QVector< QMap<QgsZonalStatistics::Statistic, QVariant> > results( zoneCount );
+  for ( int zone = 0; zone < zoneCount; ++zone )
+  {
+    if ( !zoneInRaster[ zone ] )
+      continue;
+
+    if ( zoneStats[ zone ].count <= 1 )
+    {
+      // the cell resolution is probably larger than the zone, the precise pixel - polygon intersection
+      // of the zone by zone calculation is used instead
+      results[ zone ] = calculateStatistics( mRasterInterface, geometries.at( zone ), mCellSizeX, mCellSizeY, mRasterBand, mStatistics );
+    }
+    else
+    {
+      results[ zone ] = statisticsResults( zoneStats[ zone ], mStatistics );
+    }
+  }
+  return results;
+}
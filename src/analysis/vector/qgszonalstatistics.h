@@ -20,6 +20,7 @@
 
 #include <QString>
 #include <QMap>
+#include <QVector>
 
 #include <limits>
 #include <cfloat>
@@ -133,6 +134,31 @@ class ANALYSIS_EXPORT QgsZonalStatistics
      */
     QgsZonalStatistics::Result calculateStatistics( QgsFeedback *feedback );
 
+    /**
+     * Sets whether the statistics are calculated tile by tile over the raster, rather than zone by zone.
+     *
+     * By default, a raster block covering the bounding box of each zone is read and tested separately
+     * for each zone, so raster areas shared by the bounding boxes of adjacent zones are read repeatedly.
+     *
+     * If \a enabled is TRUE, all the zones are loaded in memory and the raster is read only once, in tiles
+     * covering the zones. The zones touching each tile are rasterized within the tile and the statistics of all of
+     * them are accumulated in a single pass, with tiles processed concurrently. This is much faster
+     * for large rasters and many zones, and gives the same results as the default method. When calculating
+     * the median, standard deviation or variance, the pixel values of all the zones are kept in memory too.
+     *
+     * \see tileBasedCalculation()
+     * \since QGIS 3.20
+     */
+    void setTileBasedCalculation( bool enabled ) { mTileBasedCalculation = enabled; }
+
+    /**
+     * Returns TRUE if the statistics are calculated tile by tile over the raster.
+     *
+     * \see setTileBasedCalculation()
+     * \since QGIS 3.20
+     */
+    bool tileBasedCalculation() const { return mTileBasedCalculation; }
+
     /**
      * Returns the friendly display name for a \a statistic.
      * \see shortName()
@@ -195,6 +221,22 @@ class ANALYSIS_EXPORT QgsZonalStatistics
           values.clear();
         }
 
+        //! Adds the values accumulated by \a other, e.g. for another part of the same zone
+        void merge( const FeatureStats &other )
+        {
+          sum += other.sum;
+          count += other.count;
+          min = std::min( min, other.min );
+          max = std::max( max, other.max );
+          if ( mStoreValueCounts )
+          {
+            for ( auto it = other.valueCount.constBegin(); it != other.valueCount.constEnd(); ++it )
+              valueCount.insert( it.key(), valueCount.value( it.key(), 0 ) + it.value() );
+          }
+          if ( mStoreValues )
+            values.append( other.values );
+        }
+
         void addValue( double value, double weight = 1.0 )
         {
           if ( weight < 1.0 )
@@ -228,6 +270,12 @@ class ANALYSIS_EXPORT QgsZonalStatistics
 
     QString getUniqueFieldName( const QString &fieldName, const QList<QgsField> &newFields );
 
+    //! Converts accumulated \a featureStats to the values of the requested \a statistics
+    static QMap<QgsZonalStatistics::Statistic, QVariant> statisticsResults( FeatureStats &featureStats, QgsZonalStatistics::Statistics statistics );
+
+    //! Calculates the statistics of all the zone \a geometries at once, reading the raster tile by tile
+    QVector< QMap<QgsZonalStatistics::Statistic, QVariant> > calculateTiledStatistics( const QVector< QgsGeometry > &geometries, QgsFeedback *feedback ) const;
+
     QgsRasterInterface *mRasterInterface = nullptr;
     QgsCoordinateReferenceSystem mRasterCrs;
 
@@ -239,6 +287,7 @@ class ANALYSIS_EXPORT QgsZonalStatistics
     QgsVectorLayer *mPolygonLayer = nullptr;
     QString mAttributePrefix;
     Statistics mStatistics = QgsZonalStatistics::All;
+    bool mTileBasedCalculation = false;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS( QgsZonalStatistics::Statistics )
@@ -54,6 +54,7 @@ void QgsExpression::setExpression( const QString &expression )
   d->mEvalErrorString = QString();
   d->mExp = expression;
   d->mIsPrepared = false;
+  d->mProgram.reset();
 }
 
 QString QgsExpression::expression() const
@@ -342,7 +343,34 @@ bool QgsExpression::prepare( const QgsExpressionContext *context )
 
   initGeomCalculator( context );
   d->mIsPrepared = true;
-  return d->mRootNode->prepare( this, context );
+  const bool res = d->mRootNode->prepare( this, context );
+
+  // static values may have changed, so any previous program is invalid
+  d->mProgram.reset();
+  if ( d->mCompile )
+    d->mProgram = QgsExpressionProgram::compile( d->mRootNode );
+
+  return res;
+}
+
+bool QgsExpression::compile()
+{
+  if ( !d->mRootNode )
+    return false;
+
+  if ( d->mCompile )
+    return true;
+
+  detach();
+  d->mCompile = true;
+  if ( d->mIsPrepared )
+    d->mProgram = QgsExpressionProgram::compile( d->mRootNode );
+  return true;
+}
+
+bool QgsExpression::isCompiled() const
+{
+  return static_cast< bool >( d->mProgram );
 }
 
 QVariant QgsExpression::evaluate()
@@ -354,6 +382,9 @@ QVariant QgsExpression::evaluate()
     return QVariant();
   }
 
+  if ( d->mProgram )
+    return d->mProgram->run( this, nullptr );
+
   return d->mRootNode->eval( this, static_cast<const QgsExpressionContext *>( nullptr ) );
 }
 
@@ -370,6 +401,10 @@ QVariant QgsExpression::evaluate( const QgsExpressionContext *context )
   {
     prepare( context );
   }
+
+  if ( d->mProgram )
+    return d->mProgram->run( this, context );
+
   return d->mRootNode->eval( this, context );
 }
 
@@ -231,6 +231,30 @@ class CORE_EXPORT QgsExpression
      */
     bool prepare( const QgsExpressionContext *context );
 
+    /**
+     * Compiles the expression into a flat, register based program which is then used by evaluate()
+     * in place of walking the expression node tree.
+     *
+     * Operators, CASE conditions, field references and static values are compiled, with typed fast paths
+     * for numeric and string values. All other nodes (e.g. function calls) are still evaluated by the node
+     * tree, so the results are identical to those of an uncompiled expression. Compilation is most
+     * beneficial for expressions which are evaluated for many features, such as rule filters.
+     *
+     * Once requested, the expression is compiled again every time it is prepared.
+     *
+     * \returns TRUE if the expression is valid and will be compiled
+     * \see isCompiled()
+     * \since QGIS 3.20
+     */
+    bool compile();
+
+    /**
+     * Returns TRUE if the expression has been compiled and prepared, and evaluate() will use the compiled program.
+     * \see compile()
+     * \since QGIS 3.20
+     */
+    bool isCompiled() const;
+
     /**
      * Gets list of columns referenced by the expression.
      *
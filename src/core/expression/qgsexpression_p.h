@@ -24,6 +24,7 @@
 #include "qgsdistancearea.h"
 #include "qgsunittypes.h"
 #include "qgsexpressionnode.h"
+#include "qgsexpressionprogram_p.h"
 
 ///@cond
 
@@ -50,6 +51,7 @@ class QgsExpressionPrivate
       , mCalc( other.mCalc )
       , mDistanceUnit( other.mDistanceUnit )
       , mAreaUnit( other.mAreaUnit )
+      , mCompile( other.mCompile )
     {
       if ( other.mDaCrs )
         mDaCrs = std::make_unique<QgsCoordinateReferenceSystem>( *other.mDaCrs.get() );
@@ -84,6 +86,12 @@ class QgsExpressionPrivate
     //! Whether prepare() has been called before evaluate()
     bool mIsPrepared = false;
 
+    //! Whether the expression should be compiled to a program whenever it is prepared
+    bool mCompile = false;
+
+    //! Compiled program for the prepared node tree, if compilation was requested
+    std::unique_ptr< QgsExpressionProgram > mProgram;
+
     QgsExpressionPrivate &operator= ( const QgsExpressionPrivate & ) = delete;
 };
 
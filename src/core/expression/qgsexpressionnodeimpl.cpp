@@ -109,6 +109,11 @@ QVariant QgsExpressionNodeUnaryOperator::evalNode( QgsExpression *parent, const
   QVariant val = mOperand->eval( parent, context );
   ENSURE_NO_EVAL_ERROR
 
+  return evalOperation( parent, val );
+}
+
+QVariant QgsExpressionNodeUnaryOperator::evalOperation( QgsExpression *parent, const QVariant &val )
+{
   switch ( mOp )
   {
     case uoNot:
@@ -215,6 +220,11 @@ QVariant QgsExpressionNodeBinaryOperator::evalNode( QgsExpression *parent, const
   QVariant vR = mOpRight->eval( parent, context );
   ENSURE_NO_EVAL_ERROR
 
+  return evalOperation( parent, context, vL, vR );
+}
+
+QVariant QgsExpressionNodeBinaryOperator::evalOperation( QgsExpression *parent, const QgsExpressionContext *context, const QVariant &vL, const QVariant &vR )
+{
   switch ( mOp )
   {
     case boPlus:
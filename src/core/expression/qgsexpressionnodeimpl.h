@@ -78,10 +78,18 @@ class CORE_EXPORT QgsExpressionNodeUnaryOperator : public QgsExpressionNode
     QString text() const;
 
   private:
+
+    /**
+     * Applies the operator to an already evaluated operand value \a val.
+     */
+    QVariant evalOperation( QgsExpression *parent, const QVariant &val );
+
     UnaryOperator mOp;
     QgsExpressionNode *mOperand = nullptr;
 
     static const char *UNARY_OPERATOR_TEXT[];
+
+    friend class QgsExpressionProgram;
 };
 
 /**
@@ -199,11 +207,18 @@ class CORE_EXPORT QgsExpressionNodeBinaryOperator : public QgsExpressionNode
      */
     QDateTime computeDateTimeFromInterval( const QDateTime &d, QgsInterval *i );
 
+    /**
+     * Applies the operator to already evaluated left and right operand values \a vL and \a vR.
+     */
+    QVariant evalOperation( QgsExpression *parent, const QgsExpressionContext *context, const QVariant &vL, const QVariant &vR );
+
     BinaryOperator mOp;
     QgsExpressionNode *mOpLeft = nullptr;
     QgsExpressionNode *mOpRight = nullptr;
 
     static const char *BINARY_OPERATOR_TEXT[];
+
+    friend class QgsExpressionProgram;
 };
 
 /**
@@ -431,6 +446,8 @@ class CORE_EXPORT QgsExpressionNodeColumnRef : public QgsExpressionNode
   private:
     QString mName;
     int mIndex;
+
+    friend class QgsExpressionProgram;
 };
 
 /**
@@ -0,0 +1,572 @@
+/***************************************************************************
+ qgsexpressionprogram.cpp
+
+ ---------------------
+ begin                : March 2021
+ copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsexpressionprogram_p.h"
+#include "qgsexpression.h"
+#include "qgsexpressioncontext.h"
+#include "qgsexpressionnodeimpl.h"
+#include "qgsexpressionutils.h"
+#include "qgsfeature.h"
+
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+
+///@cond PRIVATE
+
+/**
+ * A program register. Results of the typed fast paths are stored unboxed and are only
+ * converted to a QVariant when they are passed to a node, or returned as the final result.
+ */
+struct QgsExpressionProgram::Register
+{
+  enum Kind
+  {
+    Variant, //!< Value stored in v
+    Integer, //!< Value stored in i, equivalent to a QVariant( qlonglong )
+    Double, //!< Value stored in d, equivalent to a QVariant( double )
+    Logical, //!< Value stored in i, equivalent to TVL_True/TVL_False
+  };
+
+  Kind kind = Variant;
+  qlonglong i = 0;
+  double d = 0;
+  QVariant v;
+
+  void setVariant( const QVariant &value )
+  {
+    kind = Variant;
+    v = value;
+  }
+
+  void setNull()
+  {
+    setVariant( QVariant() );
+  }
+
+  void setInteger( qlonglong value )
+  {
+    kind = Integer;
+    i = value;
+  }
+
+  void setDouble( double value )
+  {
+    kind = Double;
+    d = value;
+  }
+
+  void setLogical( bool value )
+  {
+    kind = Logical;
+    i = value ? 1 : 0;
+  }
+
+  bool isNull() const
+  {
+    return kind == Variant && v.isNull();
+  }
+
+  bool isString() const
+  {
+    return kind == Variant && v.type() == QVariant::String;
+  }
+
+  QVariant toVariant() const
+  {
+    switch ( kind )
+    {
+      case Integer:
+        return QVariant( i );
+      case Double:
+        return QVariant( d );
+      case Logical:
+        return i ? TVL_True : TVL_False;
+      case Variant:
+        break;
+    }
+    return v;
+  }
+};
+
+QgsExpressionProgram::NumericType QgsExpressionProgram::numericValue( const Register &r, qlonglong &i, double &d )
+{
+  switch ( r.kind )
+  {
+    case Register::Integer:
+    case Register::Logical:
+      i = r.i;
+      d = static_cast< double >( r.i );
+      return IntegerValue;
+
+    case Register::Double:
+      if ( !std::isfinite( r.d ) )
+        return NotNumeric;
+      d = r.d;
+      return DoubleValue;
+
+    case Register::Variant:
+      if ( r.v.isNull() )
+        return NotNumeric;
+
+      switch ( r.v.type() )
+      {
+        case QVariant::Int:
+        case QVariant::LongLong:
+          i = r.v.toLongLong();
+          d = static_cast< double >( i );
+          return IntegerValue;
+
+        case QVariant::Double:
+          d = r.v.toDouble();
+          return std::isfinite( d ) ? DoubleValue : NotNumeric;
+
+        default:
+          return NotNumeric;
+      }
+  }
+  return NotNumeric;
+}
+
+QgsExpressionUtils::TVL QgsExpressionProgram::registerTvl( const Register &r, QgsExpression *parent )
+{
+  switch ( r.kind )
+  {
+    case Register::Integer:
+    case Register::Logical:
+      return r.i != 0 ? QgsExpressionUtils::True : QgsExpressionUtils::False;
+    case Register::Double:
+      return !qgsDoubleNear( r.d, 0.0 ) ? QgsExpressionUtils::True : QgsExpressionUtils::False;
+    case Register::Variant:
+      break;
+  }
+  return QgsExpressionUtils::getTVLValue( r.v, parent );
+}
+
+bool QgsExpressionProgram::evalBinaryFast( QgsExpressionNodeBinaryOperator *node, const Register &l, const Register &r, Register &out )
+{
+  const QgsExpressionNodeBinaryOperator::BinaryOperator op = node->op();
+
+  qlonglong iL = 0;
+  qlonglong iR = 0;
+  double dL = 0;
+  double dR = 0;
+  const NumericType typeL = numericValue( l, iL, dL );
+  const NumericType typeR = numericValue( r, iR, dR );
+  if ( typeL != NotNumeric && typeR != NotNumeric )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boPlus:
+      case QgsExpressionNodeBinaryOperator::boMinus:
+      case QgsExpressionNodeBinaryOperator::boMul:
+      case QgsExpressionNodeBinaryOperator::boDiv:
+      case QgsExpressionNodeBinaryOperator::boMod:
+        if ( op != QgsExpressionNodeBinaryOperator::boDiv && typeL == IntegerValue && typeR == IntegerValue )
+        {
+          if ( op == QgsExpressionNodeBinaryOperator::boMod && iR == 0 )
+            out.setNull();
+          else
+            out.setInteger( node->computeInt( iL, iR ) );
+        }
+        else if ( ( op == QgsExpressionNodeBinaryOperator::boDiv || op == QgsExpressionNodeBinaryOperator::boMod ) && dR == 0. )
+        {
+          out.setNull();
+        }
+        else
+        {
+          out.setDouble( node->computeDouble( dL, dR ) );
+        }
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boIntDiv:
+        if ( dR == 0. )
+          out.setNull();
+        else
+          out.setInteger( qlonglong( std::floor( dL / dR ) ) );
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boPow:
+        out.setDouble( std::pow( dL, dR ) );
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boEQ:
+      case QgsExpressionNodeBinaryOperator::boNE:
+      case QgsExpressionNodeBinaryOperator::boLT:
+      case QgsExpressionNodeBinaryOperator::boGT:
+      case QgsExpressionNodeBinaryOperator::boLE:
+      case QgsExpressionNodeBinaryOperator::boGE:
+        out.setLogical( node->compare( dL - dR ) );
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boIs:
+      case QgsExpressionNodeBinaryOperator::boIsNot:
+      {
+        const bool equal = qgsDoubleNear( dL, dR );
+        out.setLogical( op == QgsExpressionNodeBinaryOperator::boIs ? equal : !equal );
+        return true;
+      }
+
+      case QgsExpressionNodeBinaryOperator::boAnd:
+        out.setLogical( !qgsDoubleNear( dL, 0.0 ) && !qgsDoubleNear( dR, 0.0 ) );
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boOr:
+        out.setLogical( !qgsDoubleNear( dL, 0.0 ) || !qgsDoubleNear( dR, 0.0 ) );
+        return true;
+
+      default:
+        return false;
+    }
+  }
+
+  if ( l.isString() && r.isString() && !l.v.isNull() && !r.v.isNull() )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boPlus:
+      case QgsExpressionNodeBinaryOperator::boConcat:
+      {
+        const QString result = l.v.toString() + r.v.toString();
+        out.setVariant( result );
+        return true;
+      }
+
+      case QgsExpressionNodeBinaryOperator::boEQ:
+      case QgsExpressionNodeBinaryOperator::boNE:
+      case QgsExpressionNodeBinaryOperator::boLT:
+      case QgsExpressionNodeBinaryOperator::boGT:
+      case QgsExpressionNodeBinaryOperator::boLE:
+      case QgsExpressionNodeBinaryOperator::boGE:
+        out.setLogical( node->compare( QString::compare( l.v.toString(), r.v.toString() ) ) );
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boIs:
+      case QgsExpressionNodeBinaryOperator::boIsNot:
+      {
+        const bool equal = QString::compare( l.v.toString(), r.v.toString() ) == 0;
+        out.setLogical( op == QgsExpressionNodeBinaryOperator::boIs ? equal : !equal );
+        return true;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  const bool nullL = l.isNull();
+  const bool nullR = r.isNull();
+  if ( nullL || nullR )
+  {
+    switch ( op )
+    {
+      case QgsExpressionNodeBinaryOperator::boPlus:
+        // two string values are concatenated, even if NULL
+        if ( l.isString() && r.isString() )
+          return false;
+        out.setNull();
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boMinus:
+      case QgsExpressionNodeBinaryOperator::boMul:
+      case QgsExpressionNodeBinaryOperator::boDiv:
+      case QgsExpressionNodeBinaryOperator::boMod:
+      case QgsExpressionNodeBinaryOperator::boPow:
+      case QgsExpressionNodeBinaryOperator::boConcat:
+      case QgsExpressionNodeBinaryOperator::boEQ:
+      case QgsExpressionNodeBinaryOperator::boNE:
+      case QgsExpressionNodeBinaryOperator::boLT:
+      case QgsExpressionNodeBinaryOperator::boGT:
+      case QgsExpressionNodeBinaryOperator::boLE:
+      case QgsExpressionNodeBinaryOperator::boGE:
+      case QgsExpressionNodeBinaryOperator::boRegexp:
+      case QgsExpressionNodeBinaryOperator::boLike:
+      case QgsExpressionNodeBinaryOperator::boNotLike:
+      case QgsExpressionNodeBinaryOperator::boILike:
+      case QgsExpressionNodeBinaryOperator::boNotILike:
+        out.setNull();
+        return true;
+
+      case QgsExpressionNodeBinaryOperator::boIs:
+      case QgsExpressionNodeBinaryOperator::boIsNot:
+      {
+        const bool equal = nullL && nullR;
+        out.setLogical( op == QgsExpressionNodeBinaryOperator::boIs ? equal : !equal );
+        return true;
+      }
+
+      default:
+        return false;
+    }
+  }
+
+  return false;
+}
+
+bool QgsExpressionProgram::evalUnaryFast( QgsExpressionNodeUnaryOperator *node, const Register &operand, Register &out )
+{
+  qlonglong i = 0;
+  double d = 0;
+  const NumericType type = numericValue( operand, i, d );
+
+  switch ( node->op() )
+  {
+    case QgsExpressionNodeUnaryOperator::uoNot:
+      if ( operand.isNull() )
+      {
+        out.setNull();
+        return true;
+      }
+      else if ( type != NotNumeric )
+      {
+        out.setLogical( qgsDoubleNear( d, 0.0 ) );
+        return true;
+      }
+      return false;
+
+    case QgsExpressionNodeUnaryOperator::uoMinus:
+      if ( type == IntegerValue )
+      {
+        out.setInteger( -i );
+        return true;
+      }
+      else if ( type == DoubleValue )
+      {
+        out.setDouble( -d );
+        return true;
+      }
+      return false;
+  }
+  return false;
+}
+
+std::unique_ptr< QgsExpressionProgram > QgsExpressionProgram::compile( QgsExpressionNode *root )
+{
+  if ( !root )
+    return nullptr;
+
+  std::unique_ptr< QgsExpressionProgram > program( new QgsExpressionProgram() );
+  program->compileNode( root, 0 );
+  return program;
+}
+
+int QgsExpressionProgram::addInstruction( OpCode op, int dest, int a, int b, QgsExpressionNode *node )
+{
+  Instruction instruction;
+  instruction.op = op;
+  instruction.dest = dest;
+  instruction.a = a;
+  instruction.b = b;
+  instruction.node = node;
+  mInstructions.append( instruction );
+  return mInstructions.size() - 1;
+}
+
+int QgsExpressionProgram::addConstant( const QVariant &value )
+{
+  mConstants.append( value );
+  return mConstants.size() - 1;
+}
+
+void QgsExpressionProgram::compileNode( QgsExpressionNode *node, int reg )
+{
+  mRegisterCount = std::max( mRegisterCount, reg + 1 );
+
+  // static nodes (including all literals) have been evaluated during preparation
+  if ( node->hasCachedStaticValue() )
+  {
+    addInstruction( LoadConstant, reg, addConstant( node->cachedStaticValue() ) );
+    return;
+  }
+
+  switch ( node->nodeType() )
+  {
+    case QgsExpressionNode::ntLiteral:
+      addInstruction( LoadConstant, reg, addConstant( static_cast< QgsExpressionNodeLiteral * >( node )->value() ) );
+      return;
+
+    case QgsExpressionNode::ntColumnRef:
+      addInstruction( LoadField, reg, static_cast< QgsExpressionNodeColumnRef * >( node )->mIndex, 0, node );
+      return;
+
+    case QgsExpressionNode::ntUnaryOperator:
+    {
+      QgsExpressionNodeUnaryOperator *unary = static_cast< QgsExpressionNodeUnaryOperator * >( node );
+      compileNode( unary->operand(), reg );
+      addInstruction( UnaryOperation, reg, reg, 0, node );
+      return;
+    }
+
+    case QgsExpressionNode::ntBinaryOperator:
+    {
+      QgsExpressionNodeBinaryOperator *binary = static_cast< QgsExpressionNodeBinaryOperator * >( node );
+      compileNode( binary->opLeft(), reg );
+
+      int shortCircuit = -1;
+      if ( binary->op() == QgsExpressionNodeBinaryOperator::boAnd || binary->op() == QgsExpressionNodeBinaryOperator::boOr )
+        shortCircuit = addInstruction( ShortCircuit, reg, reg, -1, node );
+
+      compileNode( binary->opRight(), reg + 1 );
+      addInstruction( BinaryOperation, reg, reg, reg + 1, node );
+
+      if ( shortCircuit >= 0 )
+        mInstructions[ shortCircuit ].b = mInstructions.size();
+      return;
+    }
+
+    case QgsExpressionNode::ntCondition:
+    {
+      QgsExpressionNodeCondition *condition = static_cast< QgsExpressionNodeCondition * >( node );
+      QVector< int > jumpsToEnd;
+      const QgsExpressionNodeCondition::WhenThenList conditions = condition->conditions();
+      for ( QgsExpressionNodeCondition::WhenThen *whenThen : conditions )
+      {
+        compileNode( whenThen->whenExp(), reg );
+        const int test = addInstruction( JumpUnlessTrue, reg, reg, -1 );
+        compileNode( whenThen->thenExp(), reg );
+        jumpsToEnd << addInstruction( Jump, reg, 0, -1 );
+        mInstructions[ test ].b = mInstructions.size();
+      }
+
+      if ( condition->elseExp() )
+        compileNode( condition->elseExp(), reg );
+      else
+        addInstruction( LoadConstant, reg, addConstant( QVariant() ) );
+
+      for ( int jump : std::as_const( jumpsToEnd ) )
+        mInstructions[ jump ].b = mInstructions.size();
+      return;
+    }
+
+    case QgsExpressionNode::ntInOperator:
+    case QgsExpressionNode::ntFunction:
+    case QgsExpressionNode::ntIndexOperator:
+      break;
+  }
+
+  addInstruction( EvalNode, reg, 0, 0, node );
+}
+
+QVariant QgsExpressionProgram::run( QgsExpression *parent, const QgsExpressionContext *context ) const
+{
+  QVarLengthArray< Register, 8 > registers( mRegisterCount );
+
+  const Instruction *instructions = mInstructions.constData();
+  const int count = mInstructions.size();
+  int pc = 0;
+  while ( pc < count )
+  {
+    const Instruction &instruction = instructions[ pc++ ];
+    switch ( instruction.op )
+    {
+      case LoadConstant:
+        registers[ instruction.dest ].setVariant( mConstants.at( instruction.a ) );
+        break;
+
+      case LoadField:
+      {
+        // resolved field indexes are read directly, everything else (including error reporting) is left to the node
+        if ( instruction.a >= 0 && context )
+        {
+          const QgsFeature feature = context->feature();
+          if ( feature.isValid() )
+          {
+            registers[ instruction.dest ].setVariant( feature.attribute( instruction.a ) );
+            break;
+          }
+        }
+
+        const QVariant value = instruction.node->eval( parent, context );
+        if ( parent->hasEvalError() )
+          return QVariant();
+        registers[ instruction.dest ].setVariant( value );
+        break;
+      }
+
+      case EvalNode:
+      {
+        const QVariant value = instruction.node->eval( parent, context );
+        if ( parent->hasEvalError() )
+          return QVariant();
+        registers[ instruction.dest ].setVariant( value );
+        break;
+      }
+
+      case UnaryOperation:
+      {
+        QgsExpressionNodeUnaryOperator *node = static_cast< QgsExpressionNodeUnaryOperator * >( instruction.node );
+        if ( !evalUnaryFast( node, registers[ instruction.a ], registers[ instruction.dest ] ) )
+        {
+          const QVariant value = node->evalOperation( parent, registers[ instruction.a ].toVariant() );
+          if ( parent->hasEvalError() )
+            return QVariant();
+          registers[ instruction.dest ].setVariant( value );
+        }
+        break;
+      }
+
+      case BinaryOperation:
+      {
+        QgsExpressionNodeBinaryOperator *node = static_cast< QgsExpressionNodeBinaryOperator * >( instruction.node );
+        if ( !evalBinaryFast( node, registers[ instruction.a ], registers[ instruction.b ], registers[ instruction.dest ] ) )
+        {
+          const QVariant value = node->evalOperation( parent, context, registers[ instruction.a ].toVariant(), registers[ instruction.b ].toVariant() );
+          if ( parent->hasEvalError() )
+            return QVariant();
+          registers[ instruction.dest ].setVariant( value );
+        }
+        break;
+      }
+
+      case ShortCircuit:
+      {
+        const QgsExpressionUtils::TVL tvl = registerTvl( registers[ instruction.a ], parent );
+        if ( parent->hasEvalError() )
+          return QVariant();
+
+        const QgsExpressionNodeBinaryOperator::BinaryOperator op = static_cast< QgsExpressionNodeBinaryOperator * >( instruction.node )->op();
+        if ( op == QgsExpressionNodeBinaryOperator::boAnd && tvl == QgsExpressionUtils::False )
+        {
+          registers[ instruction.dest ].setLogical( false );
+          pc = instruction.b;
+        }
+        else if ( op == QgsExpressionNodeBinaryOperator::boOr && tvl == QgsExpressionUtils::True )
+        {
+          registers[ instruction.dest ].setLogical( true );
+          pc = instruction.b;
+        }
+        break;
+      }
+
+      case JumpUnlessTrue:
+      {
+        const QgsExpressionUtils::TVL tvl = registerTvl( registers[ instruction.a ], parent );
+        if ( parent->hasEvalError() )
+          return QVariant();
+        if ( tvl != QgsExpressionUtils::True )
+          pc = instruction.b;
+        break;
+      }
+
+      case Jump:
+        pc = instruction.b;
+        break;
+    }
+  }
+
+  return mRegisterCount > 0 ? registers[ 0 ].toVariant() : QVariant();
+}
+
+///@endcond
@@ -0,0 +1,135 @@
+/***************************************************************************
+ qgsexpressionprogram_p.h
+
+ ---------------------
+ begin                : March 2021
+ copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSEXPRESSIONPROGRAM_P_H
+#define QGSEXPRESSIONPROGRAM_P_H
+
+#include "qgsexpressionutils.h"
+
+#include <QVariant>
+#include <QVector>
+#include <memory>
+
+///@cond PRIVATE
+
+class QgsExpression;
+class QgsExpressionContext;
+class QgsExpressionNode;
+class QgsExpressionNodeBinaryOperator;
+class QgsExpressionNodeUnaryOperator;
+
+/**
+ * A prepared expression node tree, flattened into a linear register based program.
+ *
+ * Operators, CASE conditions, field references and static values are translated into
+ * instructions, with typed fast paths for numeric and string values which avoid creating
+ * intermediate QVariant values. Anything else (e.g. function calls) is evaluated by
+ * delegating to the original node, so results are always identical to evaluation of
+ * the node tree.
+ *
+ * The program keeps pointers to the nodes it was compiled from, so it must be discarded
+ * whenever the node tree is destroyed or prepared again.
+ *
+ * This class is not a part of the public API.
+ */
+class QgsExpressionProgram
+{
+  public:
+
+    /**
+     * Compiles the prepared node tree starting at \a root.
+     */
+    static std::unique_ptr< QgsExpressionProgram > compile( QgsExpressionNode *root );
+
+    /**
+     * Runs the program and returns the expression result.
+     */
+    QVariant run( QgsExpression *parent, const QgsExpressionContext *context ) const;
+
+    //! Returns the number of instructions in the program
+    int instructionCount() const { return mInstructions.size(); }
+
+    //! Returns the number of registers used by the program
+    int registerCount() const { return mRegisterCount; }
+
+  private:
+
+    enum OpCode
+    {
+      LoadConstant, //!< Loads constant a into dest
+      LoadField, //!< Loads field with index a into dest
+      EvalNode, //!< Evaluates node via the node tree into dest
+      UnaryOperation, //!< Applies unary operator node to register a, result into dest
+      BinaryOperation, //!< Applies binary operator node to registers a and b, result into dest
+      ShortCircuit, //!< Stores the result of the AND/OR node into dest and jumps to b if it is decided by register a alone
+      JumpUnlessTrue, //!< Jumps to b unless register a is true
+      Jump, //!< Jumps to b
+    };
+
+    struct Instruction
+    {
+      OpCode op;
+      int dest = 0;
+      int a = 0;
+      int b = 0;
+      QgsExpressionNode *node = nullptr;
+    };
+
+    struct Register;
+
+    enum NumericType
+    {
+      NotNumeric,
+      IntegerValue,
+      DoubleValue,
+    };
+
+    QgsExpressionProgram() = default;
+
+    int addInstruction( OpCode op, int dest, int a = 0, int b = 0, QgsExpressionNode *node = nullptr );
+    int addConstant( const QVariant &value );
+    void compileNode( QgsExpressionNode *node, int reg );
+
+    /**
+     * Extracts the numeric value of a register, for values which the node tree would treat as
+     * non-null numbers without any string conversion. Integer values are stored in both \a i and \a d.
+     */
+    static NumericType numericValue( const Register &r, qlonglong &i, double &d );
+
+    //! Returns the three-valued logic value of a register
+    static QgsExpressionUtils::TVL registerTvl( const Register &r, QgsExpression *parent );
+
+    /**
+     * Typed fast paths for binary operators. These must exactly match the results of
+     * QgsExpressionNodeBinaryOperator::evalOperation() for the handled value types.
+     * Returns FALSE if the values must be evaluated by the node instead.
+     */
+    static bool evalBinaryFast( QgsExpressionNodeBinaryOperator *node, const Register &l, const Register &r, Register &out );
+
+    /**
+     * Typed fast paths for unary operators. These must exactly match the results of
+     * QgsExpressionNodeUnaryOperator::evalOperation() for the handled value types.
+     * Returns FALSE if the value must be evaluated by the node instead.
+     */
+    static bool evalUnaryFast( QgsExpressionNodeUnaryOperator *node, const Register &operand, Register &out );
+
+    QVector< Instruction > mInstructions;
+    QVector< QVariant > mConstants;
+    int mRegisterCount = 0;
+};
+
+///@endcond
+
+#endif // QGSEXPRESSIONPROGRAM_P_H
@@ -1625,6 +1625,41 @@ bool QgsGeos::relation( const QgsAbstractGeometry *geom, Relation r, QString *er
   return result;
 }
 
+QVector< bool > QgsGeos::testRelation( const QVector< QgsGeometry > &geometries, Relation r, QString *errorMsg ) const
+{
+  QVector< bool > results( geometries.size(), false );
+  if ( !mGeos || !mGeometry )
+  {
+    return results;
+  }
+
+  // snapping to the precision grid may move vertices outside of the original bounding boxes
+  const bool useBounds = qgsDoubleNear( mPrecision, 0.0 );
+  const QgsRectangle bounds = mGeometry->boundingBox();
+  for ( int i = 0; i < geometries.size(); ++i )
+  {
+    const QgsAbstractGeometry *geom = geometries.at( i ).constGet();
+    if ( !geom )
+      continue;
+
+    if ( useBounds )
+    {
+      const QgsRectangle geomBounds = geom->boundingBox();
+      if ( !bounds.intersects( geomBounds ) )
+      {
+        results[i] = r == RelationDisjoint;
+        continue;
+      }
+      if ( ( r == RelationContains && !bounds.contains( geomBounds ) )
+           || ( r == RelationWithin && !geomBounds.contains( bounds ) ) )
+        continue;
+    }
+
+    results[i] = relation( geom, r, errorMsg );
+  }
+  return results;
+}
+
 QgsAbstractGeometry *QgsGeos::buffer( double distance, int segments, QString *errorMsg ) const
 {
   if ( !mGeos )
@@ -104,6 +104,21 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
 {
   public:
 
+    /**
+     * Spatial relationships which can be tested against many geometries with testRelation().
+     * \since QGIS 3.20
+     */
+    enum Relation
+    {
+      RelationIntersects, //!< Geometries intersect
+      RelationTouches, //!< Geometries touch
+      RelationCrosses, //!< Geometries cross
+      RelationWithin, //!< Engine geometry is within the tested geometry
+      RelationOverlaps, //!< Geometries overlap
+      RelationContains, //!< Engine geometry contains the tested geometry
+      RelationDisjoint //!< Geometries are disjoint
+    };
+
     /**
      * GEOS geometry engine constructor
      * \param geometry The geometry
@@ -262,6 +277,19 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
     bool contains( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override;
     bool disjoint( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override;
     QString relate( const QgsAbstractGeometry *geom, QString *errorMsg = nullptr ) const override;
+
+    /**
+     * Tests the spatial \a relation between the engine geometry and each of the \a geometries,
+     * returning one result per geometry.
+     *
+     * Geometries for which the relation can be decided from their bounding box alone are not
+     * converted to GEOS, so this is much faster than repeated predicate calls when a (prepared)
+     * geometry is tested against many candidates which mostly do not interact with it.
+     *
+     * \see prepareGeometry()
+     * \since QGIS 3.20
+     */
+    QVector< bool > testRelation( const QVector< QgsGeometry > &geometries, Relation relation, QString *errorMsg = nullptr ) const;
     bool relatePattern( const QgsAbstractGeometry *geom, const QString &pattern, QString *errorMsg = nullptr ) const override;
     double area( QString *errorMsg = nullptr ) const override;
     double length( QString *errorMsg = nullptr ) const override;
@@ -557,17 +585,6 @@ class CORE_EXPORT QgsGeos: public QgsGeometryEngine
       OverlaySymDifference
     };
 
-    enum Relation
-    {
-      RelationIntersects,
-      RelationTouches,
-      RelationCrosses,
-      RelationWithin,
-      RelationOverlaps,
-      RelationContains,
-      RelationDisjoint
-    };
-
     //geos util functions
     void cacheGeos() const;
     std::unique_ptr< QgsAbstractGeometry > overlay( const QgsAbstractGeometry *geom, Overlay op, QString *errorMsg = nullptr ) const;
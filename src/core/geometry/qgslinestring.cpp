@@ -572,12 +572,21 @@ QgsRectangle QgsLineString::calculateBoundingBox() const
   if ( mX.empty() )
     return QgsRectangle();
 
-  auto result = std::minmax_element( mX.begin(), mX.end() );
-  const double xmin = *result.first;
-  const double xmax = *result.second;
-  result = std::minmax_element( mY.begin(), mY.end() );
-  const double ymin = *result.first;
-  const double ymax = *result.second;
+  // single pass over both coordinate arrays, using branch free min/max so that the loop can be vectorized
+  const int size = mX.size();
+  const double *x = mX.constData();
+  const double *y = mY.constData();
+  double xmin = x[0];
+  double xmax = x[0];
+  double ymin = y[0];
+  double ymax = y[0];
+  for ( int i = 1; i < size; ++i )
+  {
+    xmin = std::min( xmin, x[i] );
+    xmax = std::max( xmax, x[i] );
+    ymin = std::min( ymin, y[i] );
+    ymax = std::max( ymax, y[i] );
+  }
   return QgsRectangle( xmin, ymin, xmax, ymax, false );
 }
 
@@ -1564,30 +1573,52 @@ void QgsLineString::transform( const QgsCoordinateTransform &ct, QgsCoordinateTr
 
 void QgsLineString::transform( const QTransform &t, double zTranslate, double zScale, double mTranslate, double mScale )
 {
-  int nPoints = numPoints();
-  bool hasZ = is3D();
-  bool hasM = isMeasure();
+  const int nPoints = numPoints();
+  const bool hasZ = is3D();
+  const bool hasM = isMeasure();
   double *x = mX.data();
   double *y = mY.data();
-  double *z = hasZ ? mZ.data() : nullptr;
-  double *m = hasM ? mM.data() : nullptr;
-  for ( int i = 0; i < nPoints; ++i )
+
+  if ( t.type() <= QTransform::TxShear )
   {
-    double xOut, yOut;
-    t.map( *x, *y, &xOut, &yOut );
-    *x++ = xOut;
-    *y++ = yOut;
-    if ( hasZ )
+    // affine transform -- avoid the per point type dispatch in QTransform::map, so that the loop can be vectorized
+    const double m11 = t.m11();
+    const double m12 = t.m12();
+    const double m21 = t.m21();
+    const double m22 = t.m22();
+    const double dx = t.dx();
+    const double dy = t.dy();
+    for ( int i = 0; i < nPoints; ++i )
     {
-      *z = *z * zScale + zTranslate;
-      z++;
+      const double xIn = x[i];
+      const double yIn = y[i];
+      x[i] = m11 * xIn + m21 * yIn + dx;
+      y[i] = m12 * xIn + m22 * yIn + dy;
     }
-    if ( hasM )
+  }
+  else
+  {
+    for ( int i = 0; i < nPoints; ++i )
     {
-      *m = *m * mScale + mTranslate;
-      m++;
+      double xOut, yOut;
+      t.map( x[i], y[i], &xOut, &yOut );
+      x[i] = xOut;
+      y[i] = yOut;
     }
   }
+
+  if ( hasZ )
+  {
+    double *z = mZ.data();
+    for ( int i = 0; i < nPoints; ++i )
+      z[i] = z[i] * zScale + zTranslate;
+  }
+  if ( hasM )
+  {
+    double *m = mM.data();
+    for ( int i = 0; i < nPoints; ++i )
+      m[i] = m[i] * mScale + mTranslate;
+  }
   clearCache();
 }
 
@@ -1830,12 +1861,18 @@ QgsPoint QgsLineString::centroid() const
 
 void QgsLineString::sumUpArea( double &sum ) const
 {
-  int maxIndex = numPoints() - 1;
+  const int maxIndex = numPoints() - 1;
+  if ( maxIndex <= 0 )
+    return;
 
+  const double *x = mX.constData();
+  const double *y = mY.constData();
+  double total = 0;
   for ( int i = 0; i < maxIndex; ++i )
   {
-    sum += 0.5 * ( mX.at( i ) * mY.at( i + 1 ) - mY.at( i ) * mX.at( i + 1 ) );
+    total += x[i] * y[i + 1] - y[i] * x[i + 1];
   }
+  sum += 0.5 * total;
 }
 
 void QgsLineString::importVerticesFromWkb( const QgsConstWkbPtr &wkb )
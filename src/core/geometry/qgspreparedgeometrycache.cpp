@@ -0,0 +1,82 @@
+/***************************************************************************
+                         qgspreparedgeometrycache.cpp
+                         ----------------------------
+    begin                : March 2021
+    copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgspreparedgeometrycache.h"
+#include "qgsgeos.h"
+
+QgsPreparedGeometryCache::QgsPreparedGeometryCache( int maximumVertexCount )
+  : mEntries( maximumVertexCount )
+{
+}
+
+void QgsPreparedGeometryCache::setMaximumVertexCount( int count )
+{
+  mEntries.setMaxCost( count );
+}
+
+int QgsPreparedGeometryCache::maximumVertexCount() const
+{
+  return mEntries.maxCost();
+}
+
+int QgsPreparedGeometryCache::count() const
+{
+  return mEntries.count();
+}
+
+std::shared_ptr< QgsGeos > QgsPreparedGeometryCache::engine( QgsFeatureId id, const QgsGeometry &geometry )
+{
+  return cachedEngine( Key( id, 0 ), geometry );
+}
+
+std::shared_ptr< QgsGeos > QgsPreparedGeometryCache::engine( const QgsGeometry &geometry )
+{
+  return cachedEngine( Key( FID_NULL, reinterpret_cast< quintptr >( geometry.constGet() ) ), geometry );
+}
+
+void QgsPreparedGeometryCache::remove( QgsFeatureId id )
+{
+  mEntries.remove( Key( id, 0 ) );
+}
+
+void QgsPreparedGeometryCache::clear()
+{
+  mEntries.clear();
+}
+
+std::shared_ptr< QgsGeos > QgsPreparedGeometryCache::cachedEngine( const Key &key, const QgsGeometry &geometry )
+{
+  if ( geometry.isNull() )
+    return nullptr;
+
+  std::shared_ptr< Entry > entry;
+  if ( std::shared_ptr< Entry > *cached = mEntries.object( key ) )
+  {
+    entry = *cached;
+  }
+  else
+  {
+    entry = std::make_shared< Entry >();
+    entry->geometry = geometry;
+    entry->engine = std::make_unique< QgsGeos >( entry->geometry.constGet() );
+    entry->engine->prepareGeometry();
+    // geometries larger than the whole cache are not stored, but the engine is still returned
+    mEntries.insert( key, new std::shared_ptr< Entry >( entry ), std::max( entry->geometry.constGet()->nCoordinates(), 1 ) );
+  }
+
+  // the returned engine shares the ownership of the entry, so it outlives evictions
+  return std::shared_ptr< QgsGeos >( entry, entry->engine.get() );
+}
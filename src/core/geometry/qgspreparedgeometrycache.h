@@ -0,0 +1,128 @@
+/***************************************************************************
+                         qgspreparedgeometrycache.h
+                         --------------------------
+    begin                : March 2021
+    copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSPREPAREDGEOMETRYCACHE_H
+#define QGSPREPAREDGEOMETRYCACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsgeometry.h"
+
+#include <QCache>
+#include <QPair>
+#include <memory>
+
+class QgsGeos;
+
+/**
+ * \ingroup core
+ * \class QgsPreparedGeometryCache
+ * \brief A memory bounded cache of prepared GEOS geometry engines.
+ *
+ * Preparing a geometry (see QgsGeometryEngine::prepareGeometry()) is expensive for complex
+ * geometries, and only pays off when the prepared geometry is tested against many others.
+ * This cache allows code which repeatedly tests the same geometries (e.g. the polygons of a
+ * layer which are matched against many input features) to prepare each of them only once.
+ *
+ * Engines are either keyed by a feature id, in which case the caller must guarantee that an id
+ * always refers to the same geometry during the lifetime of the cache, or by the identity of a
+ * QgsGeometry (i.e. geometries sharing the same implicitly shared data).
+ *
+ * The cache size is bounded by the total number of vertices of the cached geometries.
+ *
+ * \warning This class is not thread safe: GEOS geometries can only be used from the thread
+ * they were created in, so each thread must use its own cache.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.20
+ */
+class CORE_EXPORT QgsPreparedGeometryCache
+{
+  public:
+
+    /**
+     * Constructor for QgsPreparedGeometryCache, storing geometries with at most
+     * \a maximumVertexCount vertices in total.
+     */
+    explicit QgsPreparedGeometryCache( int maximumVertexCount = 10000000 );
+
+    /**
+     * Sets the maximum total number of vertices of the cached geometries.
+     * \see maximumVertexCount()
+     */
+    void setMaximumVertexCount( int count );
+
+    /**
+     * Returns the maximum total number of vertices of the cached geometries.
+     * \see setMaximumVertexCount()
+     */
+    int maximumVertexCount() const;
+
+    /**
+     * Returns the number of cached engines.
+     */
+    int count() const;
+
+    /**
+     * Returns a prepared engine for the feature with matching \a id, creating it from
+     * \a geometry if it is not cached yet.
+     *
+     * The returned engine remains valid as long as it is referenced, even if it gets
+     * evicted from the cache. A NULLPTR is returned for empty geometries.
+     */
+    std::shared_ptr< QgsGeos > engine( QgsFeatureId id, const QgsGeometry &geometry );
+
+    /**
+     * Returns a prepared engine for \a geometry, keyed by the identity of its implicitly shared
+     * data: copies of the same QgsGeometry share the engine, while an equal geometry created
+     * separately does not.
+     *
+     * The returned engine remains valid as long as it is referenced, even if it gets
+     * evicted from the cache. A NULLPTR is returned for empty geometries.
+     */
+    std::shared_ptr< QgsGeos > engine( const QgsGeometry &geometry );
+
+    /**
+     * Removes the engine of the feature with matching \a id from the cache.
+     */
+    void remove( QgsFeatureId id );
+
+    /**
+     * Removes all engines from the cache.
+     */
+    void clear();
+
+  private:
+
+    struct Entry
+    {
+      //! Keeps the geometry referenced by the engine alive, and its data pointer unique
+      QgsGeometry geometry;
+      std::unique_ptr< QgsGeos > engine;
+    };
+
+    //! Feature id, or FID_NULL and the geometry data pointer for identity keys
+    typedef QPair< QgsFeatureId, quintptr > Key;
+
+    std::shared_ptr< QgsGeos > cachedEngine( const Key &key, const QgsGeometry &geometry );
+
+    //! Cached entries, with costs in vertices
+    QCache< Key, std::shared_ptr< Entry > > mEntries;
+};
+
+#endif // QGSPREPAREDGEOMETRYCACHE_H
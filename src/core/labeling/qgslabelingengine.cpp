@@ -277,6 +277,7 @@ void QgsLabelingEngine::registerLabels( QgsRenderContext &context )
 
   mPal->setShowPartialLabels( settings.testFlag( QgsLabelingEngineSettings::UsePartialCandidates ) );
   mPal->setPlacementVersion( settings.placementVersion() );
+  mPal->setSolveComponentsInParallel( settings.testFlag( QgsLabelingEngineSettings::SolveComponentsInParallel ) );
 
   // for each provider: get labels and register them in PAL
   for ( QgsAbstractLabelProvider *provider : std::as_const( mProviders ) )
@@ -342,6 +343,11 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
 
   mPal->registerCancellationCallback( &_palIsCanceled, reinterpret_cast< void * >( &context ) );
 
+  // after a pan, labels clear of the newly exposed parts of the map can keep their previous placement
+  const QgsRectangle reusableExtent = mPreviousPlacements.reusableExtent( mMapSettings );
+  if ( !reusableExtent.isNull() )
+    mPal->setReusablePlacements( &mPreviousPlacements, reusableExtent );
+
   QElapsedTimer t;
   t.start();
 
@@ -397,6 +403,9 @@ void QgsLabelingEngine::solve( QgsRenderContext &context )
   // sort labels
   std::sort( mLabels.begin(), mLabels.end(), QgsLabelSorter( mMapSettings ) );
 
+  if ( !context.renderingStopped() )
+    mPlacements = QgsLabelPlacements::fromLabels( mMapSettings, mLabels );
+
   QgsDebugMsgLevel( QStringLiteral( "LABELING work:  %1 ms ... labels# %2" ).arg( t.elapsed() ).arg( mLabels.size() ), 4 );
 }
 
@@ -24,6 +24,7 @@
 #include "qgspallabeling.h"
 #include "qgslabelingenginesettings.h"
 #include "qgslabeling.h"
+#include "qgslabelplacements.h"
 
 class QgsLabelingEngine;
 class QgsLabelingResults;
@@ -266,6 +267,25 @@ class CORE_EXPORT QgsLabelingEngine
     //! For internal use by the providers
     QgsLabelingResults *results() const { return mResults.get(); }
 
+    /**
+     * Sets the label \a placements from a previous labeling run. When the map has only been panned
+     * since then, labels which are not affected by the change of extent keep their previous placements,
+     * and only the remaining labels are placed from scratch.
+     *
+     * \see placements()
+     * \since QGIS 3.20
+     */
+    void setPreviousPlacements( const QgsLabelPlacements &placements ) { mPreviousPlacements = placements; }
+
+    /**
+     * Returns the label placements calculated by the last labeling run, which can be passed
+     * to setPreviousPlacements() for a subsequent run.
+     *
+     * \see setPreviousPlacements()
+     * \since QGIS 3.20
+     */
+    QgsLabelPlacements placements() const { return mPlacements; }
+
   protected:
     void processProvider( QgsAbstractLabelProvider *provider, QgsRenderContext &context, pal::Pal &p );
 
@@ -323,6 +343,9 @@ class CORE_EXPORT QgsLabelingEngine
     QList<pal::LabelPosition *> mUnlabeled;
     QList<pal::LabelPosition *> mLabels;
 
+    QgsLabelPlacements mPreviousPlacements;
+    QgsLabelPlacements mPlacements;
+
 };
 
 /**
@@ -40,6 +40,7 @@ class CORE_EXPORT QgsLabelingEngineSettings
       DrawLabelRectOnly     = 1 << 4,  //!< Whether to only draw the label rect and not the actual label text (used for unit tests)
       DrawCandidates        = 1 << 5,  //!< Whether to draw rectangles of generated candidates (good for debugging)
       DrawUnplacedLabels    = 1 << 6,  //!< Whether to render unplaced labels as an indicator/warning for users
+      SolveComponentsInParallel = 1 << 7,  //!< Whether to solve independent groups of conflicting labels separately and in parallel. Label placements may differ from the default sequential solver (since QGIS 3.20)
     };
     Q_DECLARE_FLAGS( Flags, Flag )
 
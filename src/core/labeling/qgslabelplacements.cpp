@@ -0,0 +1,147 @@
+/***************************************************************************
+  qgslabelplacements.cpp
+  -------------------
+   begin                : March 2021
+   copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgslabelplacements.h"
+#include "qgsmapsettings.h"
+#include "qgslabelingengine.h"
+#include "qgslabelfeature.h"
+#include "feature.h"
+#include "labelposition.h"
+#include "layer.h"
+
+#include <QSet>
+
+QgsLabelPlacements QgsLabelPlacements::fromLabels( const QgsMapSettings &settings, const QList<pal::LabelPosition *> &labels )
+{
+  QgsLabelPlacements placements;
+
+  // label coordinates are pre-rotated around the center of the map, so they can't be reused after a pan
+  if ( !qgsDoubleNear( settings.rotation(), 0.0 ) )
+    return placements;
+
+  placements.mExtent = settings.visibleExtent();
+  placements.mMapUnitsPerPixel = settings.mapUnitsPerPixel();
+  placements.mOutputDpi = settings.outputDpi();
+  placements.mCrs = settings.destinationCrs();
+  placements.mEngineFlags = settings.labelingEngineSettings().flags();
+  placements.mPlacementVersion = settings.labelingEngineSettings().placementVersion();
+
+  QSet< QPair< QString, QgsFeatureId > > seen;
+  QSet< QPair< QString, QgsFeatureId > > duplicates;
+  for ( pal::LabelPosition *label : labels )
+  {
+    QgsLabelFeature *lf = label->getFeaturePart()->feature();
+    if ( !lf || !lf->provider() )
+      continue;
+
+    const QString providerId = lf->provider()->providerId();
+    const QPair< QString, QgsFeatureId > key = qMakePair( providerId, lf->id() );
+    if ( seen.contains( key ) )
+    {
+      // features with several labels can't be matched to a single placement
+      duplicates.insert( key );
+      continue;
+    }
+    seen.insert( key );
+
+    if ( label->nextPart() || label->getUpsideDown() || label->getFeaturePart()->layer()->isCurved() )
+      continue;
+
+    Placement placement;
+    placement.x = label->getX();
+    placement.y = label->getY();
+    placement.width = label->getWidth();
+    placement.height = label->getHeight();
+    placement.angle = label->getAlpha();
+    placement.quadrant = static_cast< int >( label->getQuadrant() );
+    placement.reversed = label->getReversed();
+    placements.mPlacements[ providerId ].insert( lf->id(), placement );
+  }
+
+  for ( const QPair< QString, QgsFeatureId > &duplicate : std::as_const( duplicates ) )
+  {
+    auto it = placements.mPlacements.find( duplicate.first );
+    if ( it == placements.mPlacements.end() )
+      continue;
+
+    it->remove( duplicate.second );
+    if ( it->isEmpty() )
+      placements.mPlacements.erase( it );
+  }
+
+  return placements;
+}
+
+int QgsLabelPlacements::count() const
+{
+  int count = 0;
+  for ( auto it = mPlacements.constBegin(); it != mPlacements.constEnd(); ++it )
+    count += it->count();
+  return count;
+}
+
+void QgsLabelPlacements::clear()
+{
+  mPlacements.clear();
+  mExtent = QgsRectangle();
+}
+
+bool QgsLabelPlacements::isCompatible( const QgsMapSettings &settings ) const
+{
+  if ( mPlacements.isEmpty() )
+    return false;
+
+  return qgsDoubleNear( settings.rotation(), 0.0 )
+         && qgsDoubleNear( settings.mapUnitsPerPixel(), mMapUnitsPerPixel, mMapUnitsPerPixel * 1e-9 )
+         && qgsDoubleNear( settings.outputDpi(), mOutputDpi )
+         && settings.destinationCrs() == mCrs
+         && settings.labelingEngineSettings().flags() == mEngineFlags
+         && settings.labelingEngineSettings().placementVersion() == mPlacementVersion;
+}
+
+QgsRectangle QgsLabelPlacements::reusableExtent( const QgsMapSettings &settings ) const
+{
+  if ( !isCompatible( settings ) )
+    return QgsRectangle();
+
+  const QgsRectangle newExtent = settings.visibleExtent();
+  const QgsRectangle shared = mExtent.intersect( newExtent );
+  if ( shared.isEmpty() )
+    return QgsRectangle();
+
+  const double margin = 0.1 * std::min( newExtent.width(), newExtent.height() );
+  const double tolerance = 0.5 * mMapUnitsPerPixel;
+
+  const double xMin = shared.xMinimum() + ( qgsDoubleNear( mExtent.xMinimum(), newExtent.xMinimum(), tolerance ) ? 0 : margin );
+  const double xMax = shared.xMaximum() - ( qgsDoubleNear( mExtent.xMaximum(), newExtent.xMaximum(), tolerance ) ? 0 : margin );
+  const double yMin = shared.yMinimum() + ( qgsDoubleNear( mExtent.yMinimum(), newExtent.yMinimum(), tolerance ) ? 0 : margin );
+  const double yMax = shared.yMaximum() - ( qgsDoubleNear( mExtent.yMaximum(), newExtent.yMaximum(), tolerance ) ? 0 : margin );
+  if ( xMin >= xMax || yMin >= yMax )
+    return QgsRectangle();
+
+  return QgsRectangle( xMin, yMin, xMax, yMax, false );
+}
+
+const QgsLabelPlacements::Placement *QgsLabelPlacements::placement( const QString &providerId, QgsFeatureId id ) const
+{
+  auto providerIt = mPlacements.constFind( providerId );
+  if ( providerIt == mPlacements.constEnd() )
+    return nullptr;
+
+  auto it = providerIt->constFind( id );
+  if ( it == providerIt->constEnd() )
+    return nullptr;
+
+  return &it.value();
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+  qgslabelplacements.h
+  -------------------
+   begin                : March 2021
+   copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSLABELPLACEMENTS_H
+#define QGSLABELPLACEMENTS_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsrectangle.h"
+#include "qgscoordinatereferencesystem.h"
+#include "qgslabelingenginesettings.h"
+
+#include <QHash>
+#include <QString>
+
+class QgsMapSettings;
+
+namespace pal
+{
+  class LabelPosition;
+}
+
+/**
+ * \ingroup core
+ * \brief A snapshot of the final label placements from a labeling run.
+ *
+ * Placements are stored by label provider and feature ID, together with the map settings
+ * they were calculated for. When the map is only panned, a subsequent labeling run can reuse
+ * the placements of labels which are not affected by the newly exposed part of the map,
+ * skipping candidate generation for those labels and reducing the size of the problem
+ * to solve.
+ *
+ * Placements are stored in QgsMapRendererCache alongside the cached label images.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.20
+ */
+class CORE_EXPORT QgsLabelPlacements
+{
+  public:
+
+    /**
+     * Final placement of a single label, in labeling engine coordinates.
+     */
+    struct Placement
+    {
+      //! X coordinate of the label's first corner
+      double x = 0;
+      //! Y coordinate of the label's first corner
+      double y = 0;
+      //! Label width
+      double width = 0;
+      //! Label height
+      double height = 0;
+      //! Label angle, in radians
+      double angle = 0;
+      //! Label quadrant, as a pal::LabelPosition::Quadrant value
+      int quadrant = 0;
+      //! TRUE if the label is reversed
+      bool reversed = false;
+    };
+
+    /**
+     * Creates a snapshot of the final placements of \a labels, which were calculated
+     * for the specified map \a settings.
+     *
+     * Only labels which can be exactly recreated from a Placement are stored, i.e.
+     * curved labels, labels which were flipped to be upright and features with several
+     * labels are skipped. No placements are stored for rotated maps.
+     */
+    static QgsLabelPlacements fromLabels( const QgsMapSettings &settings, const QList< pal::LabelPosition * > &labels );
+
+    /**
+     * Returns TRUE if no placements are stored.
+     */
+    bool isEmpty() const { return mPlacements.isEmpty(); }
+
+    /**
+     * Returns the number of stored placements.
+     */
+    int count() const;
+
+    /**
+     * Removes all stored placements.
+     */
+    void clear();
+
+    /**
+     * Returns TRUE if the placements can be reused for labeling a map with the specified
+     * \a settings, i.e. the map uses the same scale, CRS, resolution and labeling engine
+     * settings, and only its extent differs.
+     */
+    bool isCompatible( const QgsMapSettings &settings ) const;
+
+    /**
+     * Returns the part of the map with the specified \a settings in which stored placements
+     * may be reused. Only labels which fall completely within this extent should be reused.
+     *
+     * This is the area shared by the previous and new map extents, shrunk by a margin on
+     * every side where the map boundary has moved. Labels close to a moved boundary may
+     * have been pushed away from the old boundary, or may need to make room for labels
+     * from the newly exposed part of the map.
+     *
+     * Returns a null rectangle if the placements are not compatible with the settings.
+     */
+    QgsRectangle reusableExtent( const QgsMapSettings &settings ) const;
+
+    /**
+     * Returns the stored placement for the feature with matching \a id from the label provider
+     * with the specified \a providerId, or NULLPTR if no placement is stored for the feature.
+     */
+    const Placement *placement( const QString &providerId, QgsFeatureId id ) const;
+
+  private:
+
+    QgsRectangle mExtent;
+    double mMapUnitsPerPixel = 0;
+    double mOutputDpi = 0;
+    QgsCoordinateReferenceSystem mCrs;
+    QgsLabelingEngineSettings::Flags mEngineFlags;
+    QgsLabelingEngineSettings::PlacementEngineVersion mPlacementVersion = QgsLabelingEngineSettings::PlacementEngineVersion2;
+
+    QHash< QString, QHash< QgsFeatureId, Placement > > mPlacements;
+};
+
+#endif // QGSLABELPLACEMENTS_H
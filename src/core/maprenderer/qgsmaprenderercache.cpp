@@ -49,6 +49,8 @@ void QgsMapRendererCache::clearInternal()
     }
   }
   mCachedImages.clear();
+  mLabelPlacements.clear();
+  mLabelPlacementLayers.clear();
   mConnectedLayers.clear();
 }
 
@@ -81,6 +83,11 @@ QSet<QgsWeakMapLayerPointer > QgsMapRendererCache::dependentLayers() const
         result << l;
     }
   }
+  for ( const QgsWeakMapLayerPointer &l : mLabelPlacementLayers )
+  {
+    if ( l.data() )
+      result << l;
+  }
   return result;
 }
 
@@ -304,6 +311,13 @@ void QgsMapRendererCache::invalidateCacheForLayer( QgsMapLayer *layer )
 
     it = mCachedImages.erase( it );
   }
+
+  if ( mLabelPlacementLayers.contains( layer ) )
+  {
+    mLabelPlacements.clear();
+    mLabelPlacementLayers.clear();
+  }
+
   dropUnusedConnections();
 }
 
@@ -315,3 +329,30 @@ void QgsMapRendererCache::clearCacheImage( const QString &cacheKey )
   dropUnusedConnections();
 }
 
+void QgsMapRendererCache::setLabelPlacements( const QgsLabelPlacements &placements, const QList<QgsMapLayer *> &dependentLayers )
+{
+  QMutexLocker lock( &mMutex );
+
+  mLabelPlacements = placements;
+  mLabelPlacementLayers.clear();
+  for ( QgsMapLayer *layer : dependentLayers )
+  {
+    if ( layer )
+    {
+      mLabelPlacementLayers << layer;
+      if ( !mConnectedLayers.contains( QgsWeakMapLayerPointer( layer ) ) )
+      {
+        connect( layer, &QgsMapLayer::repaintRequested, this, &QgsMapRendererCache::layerRequestedRepaint );
+        connect( layer, &QgsMapLayer::willBeDeleted, this, &QgsMapRendererCache::layerRequestedRepaint );
+        mConnectedLayers << layer;
+      }
+    }
+  }
+  dropUnusedConnections();
+}
+
+QgsLabelPlacements QgsMapRendererCache::labelPlacements() const
+{
+  QMutexLocker lock( &mMutex );
+  return mLabelPlacements;
+}
@@ -23,6 +23,7 @@
 
 #include "qgsrectangle.h"
 #include "qgsmaplayer.h"
+#include "qgslabelplacements.h"
 
 
 /**
@@ -173,6 +174,29 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
      */
     void invalidateCacheForLayer( QgsMapLayer *layer );
 
+    /**
+     * Stores the label \a placements calculated by a labeling run, which depend on the
+     * specified \a dependentLayers.
+     *
+     * Unlike cached images, the placements are kept when the map extent changes, so that
+     * subsequent labeling runs can reuse them (see QgsLabelPlacements). They are removed
+     * when any of the dependent layers requests a repaint.
+     *
+     * \see labelPlacements()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    void setLabelPlacements( const QgsLabelPlacements &placements, const QList< QgsMapLayer * > &dependentLayers ) SIP_SKIP;
+
+    /**
+     * Returns the label placements stored in the cache, or empty placements if none are stored.
+     *
+     * \see setLabelPlacements()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    QgsLabelPlacements labelPlacements() const SIP_SKIP;
+
   private slots:
     //! Remove layer (that emitted the signal) from the cache
     void layerRequestedRepaint();
@@ -203,6 +227,10 @@ class CORE_EXPORT QgsMapRendererCache : public QObject
 
     //! Map of cache key to cache parameters
     QMap<QString, CacheParameters> mCachedImages;
+    //! Label placements from the last labeling run
+    QgsLabelPlacements mLabelPlacements;
+    //! Layers which the label placements depend on
+    QgsWeakMapLayerPointerList mLabelPlacementLayers;
     //! List of all layers on which this cache is currently connected
     QSet< QgsWeakMapLayerPointer > mConnectedLayers;
 };
@@ -18,6 +18,7 @@
 #include <QPainter>
 #include <QElapsedTimer>
 #include <QTimer>
+#include <QThreadPool>
 #include <QtConcurrentMap>
 
 #include "qgslogger.h"
@@ -43,6 +44,8 @@
 #include "qgsmaplayertemporalproperties.h"
 #include "qgsmaplayerelevationproperties.h"
 #include "qgsvectorlayerrenderer.h"
+#include "qgsmarkersymbol.h"
+#include "qgspainteffect.h"
 
 ///@cond PRIVATE
 
@@ -428,6 +431,7 @@ LayerRenderJobs QgsMapRendererJob::prepareJobs( QPainter *painter, QgsLabelingEn
 
     if ( mFeatureFilterProvider )
       job.context.setFeatureFilterProvider( mFeatureFilterProvider );
+    job.context.setRenderFeatureCache( mRenderFeatureCache );
 
     QgsMapLayerStyleOverride styleOverride( ml );
     if ( mSettings.layerStyleOverrides().contains( ml->id() ) )
@@ -682,6 +686,207 @@ LayerRenderJobs QgsMapRendererJob::prepareSecondPassJobs( LayerRenderJobs &first
   return secondPassJobs;
 }
 
+LayerRenderJobs QgsMapRendererJob::prepareTiledJobs( LayerRenderJobs &firstPassJobs, const LayerRenderJobs &secondPassJobs )
+{
+  LayerRenderJobs tiledJobs;
+
+  if ( !mSettings.testFlag( QgsMapSettings::ParallelLayerTiling ) )
+    return tiledJobs;
+
+  // tiles are defined in pixels and converted to map extents, which isn't possible for rotated maps
+  if ( !qgsDoubleNear( mSettings.rotation(), 0.0 ) )
+    return tiledJobs;
+
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  if ( threadCount < 2 )
+    return tiledJobs;
+
+  // lay out roughly one tile per thread, keeping tiles close to square
+  const QSize outputSize = mSettings.outputSize();
+  if ( outputSize.isEmpty() )
+    return tiledJobs;
+
+  const double aspect = static_cast< double >( outputSize.width() ) / outputSize.height();
+  const int columns = std::clamp( static_cast< int >( std::round( std::sqrt( threadCount * aspect ) ) ), 1, threadCount );
+  const int rows = std::max( 1, threadCount / columns );
+  if ( columns * rows < 2 )
+    return tiledJobs;
+
+  QVector< QRect > tileRects;
+  tileRects.reserve( columns * rows );
+  for ( int row = 0; row < rows; ++row )
+  {
+    const int top = outputSize.height() * row / rows;
+    const int bottom = outputSize.height() * ( row + 1 ) / rows;
+    for ( int column = 0; column < columns; ++column )
+    {
+      const int left = outputSize.width() * column / columns;
+      const int right = outputSize.width() * ( column + 1 ) / columns;
+      tileRects << QRect( left, top, right - left, bottom - top );
+    }
+  }
+
+  // layers which take part in selective masking are composed against their complete first pass image,
+  // so they can't be split
+  QSet< QString > maskedLayerIds;
+  for ( const LayerRenderJob &job : secondPassJobs )
+    maskedLayerIds.insert( job.layerId );
+
+  const QgsMapToPixel &mtp = mSettings.mapToPixel();
+
+  for ( LayerRenderJob &job : firstPassJobs )
+  {
+    if ( job.cached || !job.renderer || !job.img || job.maskImage || maskedLayerIds.contains( job.layerId ) )
+      continue;
+
+    QgsVectorLayer *vl = qobject_cast< QgsVectorLayer * >( job.layer );
+    if ( !vl )
+      continue;
+
+    // label and diagram candidates must be registered exactly once per feature
+    if ( job.context.labelingEngine() && QgsPalLabeling::staticWillUseLayer( vl ) )
+      continue;
+
+    if ( job.context.testFlag( QgsRenderContext::ApplyClipAfterReprojection ) )
+      continue;
+
+    QgsFeatureRenderer *featureRenderer = static_cast< QgsVectorLayerRenderer * >( job.renderer )->featureRenderer();
+    // layer wide effects (e.g. blurs or shadows) spill over tile boundaries
+    if ( !featureRenderer || ( featureRenderer->paintEffect() && featureRenderer->paintEffect()->enabled() ) )
+      continue;
+
+    // only renderers which draw each feature on its own can be split. Others, like the heatmap or
+    // point cluster renderers, depend on all the features of the extent.
+    static const QStringList sTileableRenderers
+    {
+      QStringLiteral( "singleSymbol" ),
+      QStringLiteral( "categorizedSymbol" ),
+      QStringLiteral( "graduatedSymbol" ),
+      QStringLiteral( "RuleRenderer" ),
+    };
+    if ( !sTileableRenderers.contains( featureRenderer->type() ) )
+      continue;
+
+    // features just outside a tile may still draw inside it, so grow each tile's
+    // request extent by the largest symbol extent. This can't be estimated for
+    // data defined sizes, widths or offsets, and some symbol layers (e.g. shapeburst
+    // fills) draw differently when features are clipped to the tile.
+    double bleed = 0;
+    bool symbolsPreventSplit = false;
+    const QgsSymbolList symbols = featureRenderer->symbols( job.context );
+    for ( QgsSymbol *symbol : symbols )
+    {
+      if ( symbol->hasDataDefinedProperties() || symbol->canCauseArtifactsBetweenAdjacentTiles() )
+      {
+        symbolsPreventSplit = true;
+        break;
+      }
+      bleed = std::max( bleed, QgsSymbolLayerUtils::estimateMaxSymbolBleed( symbol, job.context ) );
+      if ( symbol->type() == Qgis::SymbolType::Marker )
+        bleed = std::max( bleed, static_cast< QgsMarkerSymbol * >( symbol )->size( job.context ) );
+    }
+    if ( symbolsPreventSplit )
+      continue;
+    const double margin = ( bleed + 1 ) * mSettings.mapUnitsPerPixel();
+
+    const QgsCoordinateTransform ct = job.context.coordinateTransform();
+    QVector< QgsRectangle > tileExtents;
+    tileExtents.reserve( tileRects.size() );
+    bool canSplit = true;
+    for ( const QRect &rect : std::as_const( tileRects ) )
+    {
+      QgsRectangle extent( mtp.toMapCoordinates( static_cast< double >( rect.left() ), static_cast< double >( rect.top() ) ),
+                           mtp.toMapCoordinates( static_cast< double >( rect.left() + rect.width() ), static_cast< double >( rect.top() + rect.height() ) ) );
+      extent.grow( margin );
+      QgsRectangle r2;
+      if ( ct.isValid() && !reprojectToLayerExtent( vl, ct, extent, r2 ) )
+      {
+        canSplit = false;
+        break;
+      }
+      if ( !extent.isFinite() )
+      {
+        canSplit = false;
+        break;
+      }
+      tileExtents << extent;
+    }
+    if ( !canSplit )
+      continue;
+
+    QgsMapLayerStyleOverride styleOverride( vl );
+    if ( mSettings.layerStyleOverrides().contains( vl->id() ) )
+      styleOverride.setOverrideStyle( mSettings.layerStyleOverrides().value( vl->id() ) );
+
+    for ( int i = 1; i < tileRects.size(); ++i )
+    {
+      tiledJobs.append( LayerRenderJob() );
+      LayerRenderJob &tileJob = tiledJobs.last();
+      tileJob.cached = false;
+      tileJob.img = nullptr;
+      tileJob.layer = job.layer;
+      tileJob.layerId = job.layerId;
+      tileJob.blendMode = job.blendMode;
+      tileJob.opacity = job.opacity;
+      tileJob.estimatedRenderingTime = job.estimatedRenderingTime;
+      tileJob.renderingTime = -1;
+      tileJob.tileParentJob = &job;
+      tileJob.tileRect = tileRects.at( i );
+
+      tileJob.context = job.context;
+      tileJob.context.setLabelingEngine( nullptr );
+      tileJob.context.setExtent( tileExtents.at( i ) );
+      tileJob.context.setPainter( allocateImageAndPainter( vl->id(), tileJob.img ) );
+      if ( !tileJob.img )
+      {
+        tiledJobs.removeLast();
+        continue;
+      }
+      tileJob.context.painter()->setClipRect( tileJob.tileRect );
+
+      tileJob.renderer = vl->createMapRenderer( tileJob.context );
+      if ( tileJob.renderer )
+        tileJob.renderer->setLayerRenderingTimeHint( tileJob.estimatedRenderingTime );
+    }
+
+    // the original job takes care of the first tile. Its renderer only reads the extent when rendering starts,
+    // so it can safely be restricted here
+    job.tileRect = tileRects.at( 0 );
+    job.context.setExtent( tileExtents.at( 0 ) );
+    job.context.painter()->setClipRect( job.tileRect );
+  }
+
+  return tiledJobs;
+}
+
+void QgsMapRendererJob::composeTiledJobs( LayerRenderJobs &tiledJobs )
+{
+  for ( LayerRenderJob &job : tiledJobs )
+  {
+    LayerRenderJob *parentJob = job.tileParentJob;
+    if ( !parentJob || !parentJob->img )
+      continue;
+
+    if ( job.img && job.imageInitialized )
+    {
+      // the parent painter is still active on the parent image, and clipped to the parent's own tile
+      QPainter *painter = parentJob->context.painter();
+      painter->save();
+      painter->setClipping( false );
+      painter->setCompositionMode( QPainter::CompositionMode_SourceOver );
+      painter->setOpacity( 1.0 );
+      const qreal dpr = job.img->devicePixelRatio();
+      const QRectF sourceRect( job.tileRect.x() * dpr, job.tileRect.y() * dpr, job.tileRect.width() * dpr, job.tileRect.height() * dpr );
+      painter->drawImage( QRectF( job.tileRect ), *job.img, sourceRect );
+      painter->restore();
+    }
+
+    parentJob->completed = parentJob->completed && job.completed;
+    parentJob->errors << job.errors;
+    parentJob->renderingTime = std::max( parentJob->renderingTime, job.renderingTime );
+  }
+}
+
 LabelRenderJob QgsMapRendererJob::prepareLabelingJob( QPainter *painter, QgsLabelingEngine *labelingEngine2, bool canUseLabelCache )
 {
   LabelRenderJob job;
@@ -710,6 +915,10 @@ LabelRenderJob QgsMapRendererJob::prepareLabelingJob( QPainter *painter, QgsLabe
     {
       job.img = allocateImage( QStringLiteral( "labels" ) );
     }
+
+    // labels which are unaffected by a pan can keep their placement from the previous render
+    if ( mCache && labelingEngine2 )
+      labelingEngine2->setPreviousPlacements( mCache->labelPlacements() );
   }
 
   return job;
@@ -788,8 +997,36 @@ void QgsMapRendererJob::cleanupSecondPassJobs( LayerRenderJobs &jobs )
   jobs.clear();
 }
 
+void QgsMapRendererJob::cleanupTiledJobs( LayerRenderJobs &jobs )
+{
+  for ( LayerRenderJob &job : jobs )
+  {
+    if ( job.img )
+    {
+      delete job.context.painter();
+      job.context.setPainter( nullptr );
+
+      delete job.img;
+      job.img = nullptr;
+    }
+
+    if ( job.renderer )
+    {
+      delete job.renderer;
+      job.renderer = nullptr;
+    }
+  }
+
+  jobs.clear();
+}
+
 void QgsMapRendererJob::cleanupLabelJob( LabelRenderJob &job )
 {
+  if ( mCache && !job.cached && !job.context.renderingStopped() && job.context.labelingEngine() )
+  {
+    mCache->setLabelPlacements( job.context.labelingEngine()->placements(), _qgis_listQPointerToRaw( job.participatingLayers ) );
+  }
+
   if ( job.img )
   {
     if ( mCache && !job.cached && !job.context.renderingStopped() )
@@ -37,6 +37,7 @@ class QgsLabelingResults;
 class QgsMapLayerRenderer;
 class QgsMapRendererCache;
 class QgsFeatureFilterProvider;
+class QgsRenderFeatureCache;
 
 #ifndef SIP_RUN
 /// @cond PRIVATE
@@ -132,6 +133,25 @@ struct LayerRenderJob
    * In this latter case, the second element of the QPair gives the label mask id.
    */
   QList<QPair<LayerRenderJob *, int>> maskJobs;
+
+  /**
+   * Pointer to the job which renders the same layer over the whole map, when this
+   * job only renders one spatial tile of that layer.
+   *
+   * Tile jobs render into their own image, which is composed into the parent job's
+   * image once all tiles are complete.
+   *
+   * \since QGIS 3.20
+   */
+  LayerRenderJob *tileParentJob = nullptr;
+
+  /**
+   * Area of the map image (in logical pixels) covered by this job, when
+   * the layer is split into spatial tiles. An empty rectangle means the whole map.
+   *
+   * \since QGIS 3.20
+   */
+  QRect tileRect;
 };
 
 typedef QList<LayerRenderJob> LayerRenderJobs;
@@ -274,6 +294,24 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
      */
     const QgsFeatureFilterProvider *featureFilterProvider() const { return mFeatureFilterProvider; }
 
+    /**
+     * Sets a \a cache for features fetched while rendering vector layers, which may be shared
+     * between many render jobs. Ownership is not transferred and the cache must not be deleted
+     * before the render job.
+     * \see renderFeatureCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    void setRenderFeatureCache( QgsRenderFeatureCache *cache ) { mRenderFeatureCache = cache; } SIP_SKIP
+
+    /**
+     * Returns the cache for features fetched while rendering vector layers.
+     * \see setRenderFeatureCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    QgsRenderFeatureCache *renderFeatureCache() const { return mRenderFeatureCache; } SIP_SKIP
+
     struct Error
     {
       Error( const QString &lid, const QString &msg )
@@ -425,6 +463,35 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
      */
     LayerRenderJobs prepareSecondPassJobs( LayerRenderJobs &firstPassJobs, LabelRenderJob &labelJob ) SIP_SKIP;
 
+    /**
+     * Splits the rendering of eligible vector layers into spatial tiles which can be
+     * rendered in parallel. Must be called after prepareSecondPassJobs.
+     *
+     * The first tile of each split layer is rendered by the original job from \a firstPassJobs,
+     * and jobs for the remaining tiles are returned. Only layers drawn by single symbol, categorized,
+     * graduated or rule based renderers can be split, as other renderers (e.g. heatmaps or point
+     * clusters) depend on all the features of the extent. Layers which are involved in
+     * selective masking (listed in \a secondPassJobs or carrying a mask image), which are
+     * labeled, which use layer-wide paint effects or symbols with data defined properties
+     * are left untouched.
+     *
+     * Nothing is split unless the QgsMapSettings::ParallelLayerTiling flag is set.
+     *
+     * \see composeTiledJobs()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    LayerRenderJobs prepareTiledJobs( LayerRenderJobs &firstPassJobs, const LayerRenderJobs &secondPassJobs ) SIP_SKIP;
+
+    /**
+     * Composes the images of tile jobs (created by prepareTiledJobs()) into
+     * the images of their parent jobs, and merges their errors and completion state.
+     *
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    static void composeTiledJobs( LayerRenderJobs &tiledJobs ) SIP_SKIP;
+
     //! \note not available in Python bindings
     static QImage composeImage( const QgsMapSettings &settings,
                                 const LayerRenderJobs &jobs,
@@ -451,6 +518,13 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
     //! \note not available in Python bindings
     void cleanupSecondPassJobs( LayerRenderJobs &jobs ) SIP_SKIP;
 
+    /**
+     * Cleans up tile jobs created by prepareTiledJobs().
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    void cleanupTiledJobs( LayerRenderJobs &jobs ) SIP_SKIP;
+
     /**
      * Handles clean up tasks for a label job, including deletion of images and storing cached
      * label results.
@@ -485,6 +559,8 @@ class CORE_EXPORT QgsMapRendererJob : public QObject SIP_ABSTRACT
 
     const QgsFeatureFilterProvider *mFeatureFilterProvider = nullptr;
 
+    QgsRenderFeatureCache *mRenderFeatureCache = nullptr;
+
     //! Convenient method to allocate a new image and stack an error if not enough memory is available
     QImage *allocateImage( QString layerId );
 
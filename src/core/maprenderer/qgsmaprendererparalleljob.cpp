@@ -61,6 +61,13 @@ void QgsMapRendererParallelJob::startPrivate()
   mLayerJobs = prepareJobs( nullptr, mLabelingEngineV2.get() );
   mLabelJob = prepareLabelingJob( nullptr, mLabelingEngineV2.get(), canUseLabelCache );
   mSecondPassLayerJobs = prepareSecondPassJobs( mLayerJobs, mLabelJob );
+  mTiledLayerJobs = prepareTiledJobs( mLayerJobs, mSecondPassLayerJobs );
+
+  mRenderQueue.clear();
+  for ( LayerRenderJob &job : mLayerJobs )
+    mRenderQueue << &job;
+  for ( LayerRenderJob &job : mTiledLayerJobs )
+    mRenderQueue << &job;
 
   QgsDebugMsgLevel( QStringLiteral( "QThreadPool max thread count is %1" ).arg( QThreadPool::globalInstance()->maxThreadCount() ), 2 );
 
@@ -68,7 +75,7 @@ void QgsMapRendererParallelJob::startPrivate()
 
   connect( &mFutureWatcher, &QFutureWatcher<void>::finished, this, &QgsMapRendererParallelJob::renderLayersFinished );
 
-  mFuture = QtConcurrent::map( mLayerJobs, renderLayerStatic );
+  mFuture = QtConcurrent::map( mRenderQueue, renderQueuedLayerStatic );
   mFutureWatcher.setFuture( mFuture );
 }
 
@@ -86,6 +93,12 @@ void QgsMapRendererParallelJob::cancel()
     if ( it->renderer && it->renderer->feedback() )
       it->renderer->feedback()->cancel();
   }
+  for ( LayerRenderJobs::iterator it = mTiledLayerJobs.begin(); it != mTiledLayerJobs.end(); ++it )
+  {
+    it->context.setRenderingStopped( true );
+    if ( it->renderer && it->renderer->feedback() )
+      it->renderer->feedback()->cancel();
+  }
 
   if ( mStatus == RenderingLayers )
   {
@@ -131,6 +144,12 @@ void QgsMapRendererParallelJob::cancelWithoutBlocking()
     if ( it->renderer && it->renderer->feedback() )
       it->renderer->feedback()->cancel();
   }
+  for ( LayerRenderJobs::iterator it = mTiledLayerJobs.begin(); it != mTiledLayerJobs.end(); ++it )
+  {
+    it->context.setRenderingStopped( true );
+    if ( it->renderer && it->renderer->feedback() )
+      it->renderer->feedback()->cancel();
+  }
 
   if ( mStatus == RenderingLayers )
   {
@@ -224,6 +243,11 @@ void QgsMapRendererParallelJob::renderLayersFinished()
 {
   Q_ASSERT( mStatus == RenderingLayers );
 
+  // merge the tiles of split layers back into their layer images
+  composeTiledJobs( mTiledLayerJobs );
+  mRenderQueue.clear();
+  cleanupTiledJobs( mTiledLayerJobs );
+
   LayerRenderJobs::const_iterator it = mLayerJobs.constBegin();
   for ( ; it != mLayerJobs.constEnd(); ++it )
   {
@@ -299,6 +323,10 @@ void QgsMapRendererParallelJob::renderingFinished()
 
     logRenderingTime( mLayerJobs, mSecondPassLayerJobs, mLabelJob );
 
+    // tile jobs are normally cleaned up once layers finish, except when canceled without blocking
+    mRenderQueue.clear();
+    cleanupTiledJobs( mTiledLayerJobs );
+
     cleanupJobs( mLayerJobs );
 
     cleanupLabelJob( mLabelJob );
@@ -323,6 +351,9 @@ void QgsMapRendererParallelJob::renderLayersSecondPassFinished()
 
   logRenderingTime( mLayerJobs, mSecondPassLayerJobs, mLabelJob );
 
+  mRenderQueue.clear();
+  cleanupTiledJobs( mTiledLayerJobs );
+
   cleanupJobs( mLayerJobs );
 
   cleanupSecondPassJobs( mSecondPassLayerJobs );
@@ -386,6 +417,10 @@ void QgsMapRendererParallelJob::renderLayerStatic( LayerRenderJob &job )
   QgsDebugMsgLevel( QStringLiteral( "job %1 end [%2 ms] (layer %3)" ).arg( reinterpret_cast< quint64 >( &job ), 0, 16 ).arg( job.renderingTime ).arg( job.layerId ), 2 );
 }
 
+void QgsMapRendererParallelJob::renderQueuedLayerStatic( LayerRenderJob *&job )
+{
+  renderLayerStatic( *job );
+}
 
 void QgsMapRendererParallelJob::renderLabelsStatic( QgsMapRendererParallelJob *self )
 {
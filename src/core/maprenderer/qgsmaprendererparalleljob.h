@@ -60,6 +60,8 @@ class CORE_EXPORT QgsMapRendererParallelJob : public QgsMapRendererQImageJob
     //! \note not available in Python bindings
     static void renderLayerStatic( LayerRenderJob &job ) SIP_SKIP;
     //! \note not available in Python bindings
+    static void renderQueuedLayerStatic( LayerRenderJob *&job ) SIP_SKIP;
+    //! \note not available in Python bindings
     static void renderLabelsStatic( QgsMapRendererParallelJob *self ) SIP_SKIP;
 
     void startPrivate() override;
@@ -75,6 +77,11 @@ class CORE_EXPORT QgsMapRendererParallelJob : public QgsMapRendererQImageJob
     LayerRenderJobs mLayerJobs;
     LabelRenderJob mLabelJob;
 
+    //! Jobs rendering additional spatial tiles of layers which are split across threads
+    LayerRenderJobs mTiledLayerJobs;
+    //! First pass layer jobs and tile jobs, as handed to the thread pool
+    QList< LayerRenderJob * > mRenderQueue;
+
     LayerRenderJobs mSecondPassLayerJobs;
     QFuture<void> mSecondPassFuture;
     QFutureWatcher<void> mSecondPassFutureWatcher;
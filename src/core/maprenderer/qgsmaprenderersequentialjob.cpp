@@ -66,6 +66,7 @@ void QgsMapRendererSequentialJob::startPrivate()
 
   mInternalJob = new QgsMapRendererCustomPainterJob( mSettings, mPainter );
   mInternalJob->setCache( mCache );
+  mInternalJob->setRenderFeatureCache( renderFeatureCache() );
 
   connect( mInternalJob, &QgsMapRendererJob::finished, this, &QgsMapRendererSequentialJob::internalFinished );
 
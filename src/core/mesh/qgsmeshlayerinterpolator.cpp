@@ -34,6 +34,9 @@
 #include "qgscoordinatetransform.h"
 #include "qgsmeshdataprovider.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 QgsMeshLayerInterpolator::QgsMeshLayerInterpolator(
   const QgsTriangularMesh &m,
   const QVector<double> &datasetValues,
@@ -68,6 +71,30 @@ int QgsMeshLayerInterpolator::bandCount() const
   return 1;
 }
 
+// Blocks with fewer pixels are interpolated in the calling thread
+static const qgssize PARALLEL_MIN_PIXELS = 100000;
+
+namespace
+{
+  //! Triangle to interpolate, with its bounding box in pixels
+  struct TriangleToInterpolate
+  {
+    int triangleIndex;
+    int topLim;
+    int bottomLim;
+    int leftLim;
+    int rightLim;
+  };
+
+  //! Range of output rows and the triangles overlapping them, in the order of the mesh
+  struct RowBand
+  {
+    int startRow;
+    int endRow;
+    QVector< int > triangles;
+  };
+}
+
 QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent, int width, int height, QgsRasterBlockFeedback *feedback )
 {
   std::unique_ptr<QgsRasterBlock> outputBlock( new QgsRasterBlock( Qgis::DataType::Float64, width, height ) );
@@ -94,18 +121,22 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
   }
 
   const QVector<QgsMeshVertex> &vertices = mTriangularMesh.vertices();
+  const QVector<QgsMeshFace> &triangles = mTriangularMesh.triangles();
+  const QVector<int> &trianglesToNativeFaces = mTriangularMesh.trianglesToNativeFaces();
 
   // currently expecting that triangulation does not add any new extra vertices on the way
   if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
     Q_ASSERT( mDatasetValues.count() == mTriangularMesh.vertices().count() );
 
+  // Find the active triangles in the extent, and their bounding box in pixels
+  QVector< TriangleToInterpolate > trianglesToInterpolate;
   for ( int i = 0; i < indexCount; ++i )
   {
     if ( feedback && feedback->isCanceled() )
-      break;
+      return outputBlock.release();
 
     if ( mContext.renderingStopped() )
-      break;
+      return outputBlock.release();
 
     int triangleIndex;
     if ( mSpatialIndexActive )
@@ -113,12 +144,12 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
     else
       triangleIndex = i;
 
-    const QgsMeshFace &face = mTriangularMesh.triangles()[triangleIndex];
+    const QgsMeshFace &face = triangles[triangleIndex];
 
     const int v1 = face[0], v2 = face[1], v3 = face[2];
     const QgsPointXY &p1 = vertices[v1], &p2 = vertices[v2], &p3 = vertices[v3];
 
-    const int nativeFaceIndex = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
+    const int nativeFaceIndex = trianglesToNativeFaces[triangleIndex];
     const bool isActive = mActiveFaceFlagValues.active( nativeFaceIndex );
     if ( !isActive )
       continue;
@@ -128,56 +159,120 @@ QgsRasterBlock *QgsMeshLayerInterpolator::block( int, const QgsRectangle &extent
       continue;
 
     // Get the BBox of the element in pixels
-    int topLim, bottomLim, leftLim, rightLim;
-    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox, leftLim, rightLim, topLim, bottomLim );
+    TriangleToInterpolate triangle;
+    triangle.triangleIndex = triangleIndex;
+    QgsMeshLayerUtils::boundingBoxToScreenRectangle( mContext.mapToPixel(), mOutputSize, bbox,
+        triangle.leftLim, triangle.rightLim, triangle.topLim, triangle.bottomLim );
+    if ( triangle.topLim > triangle.bottomLim || triangle.leftLim > triangle.rightLim )
+      continue;
 
-    double value( 0 ), value1( 0 ), value2( 0 ), value3( 0 );
-    const int faceIdx = mTriangularMesh.trianglesToNativeFaces()[triangleIndex];
+    trianglesToInterpolate.append( triangle );
+  }
 
-    if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
-    {
-      value1 = mDatasetValues[v1];
-      value2 = mDatasetValues[v2];
-      value3 = mDatasetValues[v3];
-    }
-    else
-      value = mDatasetValues[faceIdx];
+  // Split the output rows into bands, interpolated concurrently. Triangles sharing an edge both
+  // write its pixels: each band keeps the triangles in the mesh order, so that the last one wins
+  // as in a serial interpolation.
+  const int threadCount = static_cast< qgssize >( width ) * height >= PARALLEL_MIN_PIXELS ? std::max( 1, QThread::idealThreadCount() ) : 1;
+  // more bands than threads, to balance areas with denser parts of the mesh
+  const int bandHeight = std::max( 1, height / ( threadCount * 4 ) );
+  const int bandCount = std::max( 1, ( height + bandHeight - 1 ) / bandHeight );
+  std::vector< RowBand > bands( bandCount );
+  for ( int band = 0; band < bandCount; ++band )
+  {
+    bands[band].startRow = band * bandHeight;
+    bands[band].endRow = std::min( height, ( band + 1 ) * bandHeight );
+  }
+  for ( int i = 0; i < trianglesToInterpolate.count(); ++i )
+  {
+    const TriangleToInterpolate &triangle = trianglesToInterpolate.at( i );
+    const int lastBand = std::min( bandCount - 1, triangle.bottomLim / bandHeight );
+    for ( int band = triangle.topLim / bandHeight; band <= lastBand; ++band )
+      bands[band].triangles.append( i );
+  }
 
-    // interpolate in the bounding box of the face
-    for ( int j = topLim; j <= bottomLim; j++ )
+  // The pixel to map transform is inverted once, rather than for each pixel by QgsMapToPixel::toMapCoordinates()
+  bool invertible;
+  const QTransform pixelToMap = mContext.mapToPixel().transform().inverted( &invertible );
+  if ( !invertible )
+    return outputBlock.release();
+
+  const auto interpolateBand = [ &, data ]( const RowBand & band )
+  {
+    for ( int i : band.triangles )
     {
-      double *line = data + ( j * width );
-      for ( int k = leftLim; k <= rightLim; k++ )
+      if ( feedback && feedback->isCanceled() )
+        break;
+
+      if ( mContext.renderingStopped() )
+        break;
+
+      const TriangleToInterpolate &triangle = trianglesToInterpolate.at( i );
+      const QgsMeshFace &face = triangles[triangle.triangleIndex];
+
+      const int v1 = face[0], v2 = face[1], v3 = face[2];
+      const QgsPointXY &p1 = vertices[v1], &p2 = vertices[v2], &p3 = vertices[v3];
+
+      double value( 0 ), value1( 0 ), value2( 0 ), value3( 0 );
+      const int faceIdx = trianglesToNativeFaces[triangle.triangleIndex];
+
+      if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
       {
-        double val;
-        const QgsPointXY p = mContext.mapToPixel().toMapCoordinates( k, j );
-        if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
-          val = QgsMeshLayerUtils::interpolateFromVerticesData(
-                  p1,
-                  p2,
-                  p3,
-                  value1,
-                  value2,
-                  value3,
-                  p );
-        else
-        {
-          val = QgsMeshLayerUtils::interpolateFromFacesData(
-                  p1,
-                  p2,
-                  p3,
-                  value,
-                  p
-                );
-        }
-        if ( !std::isnan( val ) )
+        value1 = mDatasetValues[v1];
+        value2 = mDatasetValues[v2];
+        value3 = mDatasetValues[v3];
+      }
+      else
+        value = mDatasetValues[faceIdx];
+
+      // interpolate in the bounding box of the face, within the rows of the band
+      const int firstRow = std::max( triangle.topLim, band.startRow );
+      const int lastRow = std::min( triangle.bottomLim, band.endRow - 1 );
+      for ( int j = firstRow; j <= lastRow; j++ )
+      {
+        double *line = data + ( j * width );
+        for ( int k = triangle.leftLim; k <= triangle.rightLim; k++ )
         {
-          line[k] = val;
-          outputBlock->setIsData( j, k );
+          double val;
+          qreal mx, my;
+          pixelToMap.map( static_cast< qreal >( k ), static_cast< qreal >( j ), &mx, &my );
+          const QgsPointXY p( mx, my );
+          if ( mDataType == QgsMeshDatasetGroupMetadata::DataType::DataOnVertices )
+            val = QgsMeshLayerUtils::interpolateFromVerticesData(
+                    p1,
+                    p2,
+                    p3,
+                    value1,
+                    value2,
+                    value3,
+                    p );
+          else
+          {
+            val = QgsMeshLayerUtils::interpolateFromFacesData(
+                    p1,
+                    p2,
+                    p3,
+                    value,
+                    p
+                  );
+          }
+          if ( !std::isnan( val ) )
+          {
+            line[k] = val;
+            outputBlock->setIsData( j, k );
+          }
         }
       }
     }
+  };
 
+  if ( bandCount == 1 || threadCount == 1 )
+  {
+    for ( const RowBand &band : bands )
+      interpolateBand( band );
+  }
+  else
+  {
+    QtConcurrent::blockingMap( bands, interpolateBand );
   }
 
   return outputBlock.release();
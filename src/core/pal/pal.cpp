@@ -42,6 +42,8 @@
 #include "util.h"
 #include "palrtree.h"
 #include "qgssettings.h"
+#include "qgslabelingengine.h"
+#include "qgslabelplacements.h"
 #include <cfloat>
 #include <list>
 
@@ -155,6 +157,15 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
 
     QMutexLocker locker( &layer->mMutex );
 
+    // previous placements can only be matched to features with a single part
+    QHash< QgsFeatureId, int > partCounts;
+    const bool reusePlacements = mReusablePlacements && !layer->mergeConnectedLines() && !layer->isCurved();
+    if ( reusePlacements )
+    {
+      for ( const std::unique_ptr< FeaturePart > &featurePart : std::as_const( layer->mFeatureParts ) )
+        partCounts[ featurePart->featureId() ]++;
+    }
+
     // generate candidates for all features
     for ( const std::unique_ptr< FeaturePart > &featurePart : std::as_const( layer->mFeatureParts ) )
     {
@@ -174,8 +185,13 @@ std::unique_ptr<Problem> Pal::extract( const QgsRectangle &extent, const QgsGeom
         }
       }
 
-      // generate candidates for the feature part
-      std::vector< std::unique_ptr< LabelPosition > > candidates = featurePart->createCandidates( this );
+      // generate candidates for the feature part, unless the feature's previous placement can be reused
+      std::vector< std::unique_ptr< LabelPosition > > candidates;
+      std::unique_ptr< LabelPosition > reused = reusePlacements && partCounts.value( featurePart->featureId() ) == 1 ? reusedCandidate( featurePart.get() ) : nullptr;
+      if ( reused )
+        candidates.emplace_back( std::move( reused ) );
+      else
+        candidates = featurePart->createCandidates( this );
 
       if ( isCanceled() )
         break;
@@ -485,6 +501,29 @@ std::unique_ptr<Problem> Pal::extractProblem( const QgsRectangle &extent, const
   return extract( extent, mapBoundary );
 }
 
+std::unique_ptr< LabelPosition > Pal::reusedCandidate( FeaturePart *featurePart ) const
+{
+  QgsLabelFeature *lf = featurePart->feature();
+  if ( !lf->provider() )
+    return nullptr;
+
+  const QgsLabelPlacements::Placement *placement = mReusablePlacements->placement( lf->provider()->providerId(), lf->id() );
+  if ( !placement )
+    return nullptr;
+
+  // the label size changes if e.g. the label text is different, so the previous placement is no longer valid
+  if ( !qgsDoubleNear( placement->width, featurePart->getLabelWidth( placement->angle ) )
+       || !qgsDoubleNear( placement->height, featurePart->getLabelHeight( placement->angle ) ) )
+    return nullptr;
+
+  std::unique_ptr< LabelPosition > candidate = std::make_unique< LabelPosition >( 0, placement->x, placement->y, placement->width, placement->height, placement->angle, 0.0, featurePart,
+      placement->reversed, static_cast< LabelPosition::Quadrant >( placement->quadrant ) );
+  if ( !mReusablePlacementsExtent.contains( candidate->boundingBox() ) )
+    return nullptr;
+
+  return candidate;
+}
+
 QList<LabelPosition *> Pal::solveProblem( Problem *prob, bool displayAll, QList<LabelPosition *> *unlabeled )
 {
   if ( !prob )
@@ -494,7 +533,10 @@ QList<LabelPosition *> Pal::solveProblem( Problem *prob, bool displayAll, QList<
 
   try
   {
-    prob->chain_search();
+    if ( mSolveComponentsInParallel )
+      prob->chainSearchComponents();
+    else
+      prob->chain_search();
   }
   catch ( InternalException::Empty & )
   {
@@ -537,6 +579,12 @@ void Pal::setCandListSize( double fact )
   this->mCandListSize = fact;
 }
 
+void Pal::setReusablePlacements( const QgsLabelPlacements *placements, const QgsRectangle &extent )
+{
+  mReusablePlacements = placements;
+  mReusablePlacementsExtent = extent;
+}
+
 void Pal::setShowPartialLabels( bool show )
 {
   this->mShowPartialLabels = show;
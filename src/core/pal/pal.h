@@ -48,6 +48,7 @@
 // TODO ${MAJOR} ${MINOR} etc instead of 0.2
 
 class QgsAbstractLabelProvider;
+class QgsLabelPlacements;
 
 namespace pal
 {
@@ -163,6 +164,25 @@ namespace pal
        */
       bool showPartialLabels() const;
 
+      /**
+       * Sets whether independent components of the labeling problem should be solved separately
+       * and in parallel, via Problem::chainSearchComponents(), instead of a single Problem::chain_search()
+       * over the whole problem.
+       *
+       * \see solveComponentsInParallel()
+       * \since QGIS 3.20
+       */
+      void setSolveComponentsInParallel( bool enabled ) { mSolveComponentsInParallel = enabled; }
+
+      /**
+       * Returns TRUE if independent components of the labeling problem are solved separately
+       * and in parallel.
+       *
+       * \see setSolveComponentsInParallel()
+       * \since QGIS 3.20
+       */
+      bool solveComponentsInParallel() const { return mSolveComponentsInParallel; }
+
       /**
        * Returns the maximum number of line label candidate positions per map unit.
        *
@@ -246,6 +266,17 @@ namespace pal
        */
       bool candidatesAreConflicting( const LabelPosition *lp1, const LabelPosition *lp2 ) const;
 
+      /**
+       * Sets label \a placements from a previous labeling run to reuse. Features with a stored placement
+       * which falls completely within \a extent get that placement as their only candidate, instead of
+       * generating a full set of candidates.
+       *
+       * Ownership of \a placements is not transferred, and it must exist until extractProblem() is called.
+       *
+       * \since QGIS 3.20
+       */
+      void setReusablePlacements( const QgsLabelPlacements *placements, const QgsRectangle &extent );
+
     private:
 
       std::unordered_map< QgsAbstractLabelProvider *, std::unique_ptr< Layer > > mLayers;
@@ -272,6 +303,8 @@ namespace pal
        */
       bool mShowPartialLabels = true;
 
+      bool mSolveComponentsInParallel = false;
+
       double mMaxLineCandidatesPerMapUnit = 0;
       double mMaxPolygonCandidatesPerMapUnitSquared = 0;
 
@@ -281,6 +314,9 @@ namespace pal
 
       QgsLabelingEngineSettings::PlacementEngineVersion mPlacementVersion = QgsLabelingEngineSettings::PlacementEngineVersion2;
 
+      const QgsLabelPlacements *mReusablePlacements = nullptr;
+      QgsRectangle mReusablePlacementsExtent;
+
       //! Callback that may be called from PAL to check whether the job has not been canceled in meanwhile
       FnIsCanceled fnIsCanceled = nullptr;
       //! Application-specific context for the cancellation check function
@@ -293,6 +329,12 @@ namespace pal
        */
       std::unique_ptr< Problem > extract( const QgsRectangle &extent, const QgsGeometry &mapBoundary );
 
+      /**
+       * Returns a candidate for \a featurePart matching its placement from a previous labeling run,
+       * or NULLPTR if no placement can be reused for the feature.
+       */
+      std::unique_ptr< LabelPosition > reusedCandidate( FeaturePart *featurePart ) const;
+
       /**
        * \brief Choose the size of popmusic subpart's
        * \param r subpart size
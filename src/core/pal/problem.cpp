@@ -40,6 +40,8 @@
 #include <cfloat>
 #include <limits> //for std::numeric_limits<int>::max()
 
+#include <QtConcurrentMap>
+
 #include "qgslabelingengine.h"
 
 using namespace pal;
@@ -55,7 +57,8 @@ inline void delete_chain( Chain *chain )
 }
 
 Problem::Problem( const QgsRectangle &extent )
-  : mAllCandidatesIndex( extent )
+  : mExtent( extent )
+  , mAllCandidatesIndex( extent )
   , mActiveCandidatesIndex( extent )
 {
 
@@ -279,6 +282,11 @@ void Problem::init_sol_falp()
 
 bool Problem::candidatesAreConflicting( const LabelPosition *lp1, const LabelPosition *lp2 ) const
 {
+  if ( mIsComponent )
+  {
+    return mComponentConflicts.contains( qMakePair( std::min( lp1->globalId(), lp2->globalId() ), std::max( lp1->globalId(), lp2->globalId() ) ) );
+  }
+
   return  pal->candidatesAreConflicting( lp1, lp2 );
 }
 
@@ -659,6 +667,201 @@ void Problem::chain_search()
   delete[] ok;
 }
 
+static int findComponentRoot( std::vector< int > &parents, int feature )
+{
+  while ( parents[feature] != feature )
+  {
+    parents[feature] = parents[parents[feature]];
+    feature = parents[feature];
+  }
+  return feature;
+}
+
+struct ComponentJob
+{
+  Problem *problem = nullptr;
+  bool empty = false;
+};
+
+static void solveComponent( ComponentJob &job )
+{
+  try
+  {
+    job.problem->chain_search();
+  }
+  catch ( InternalException::Empty & )
+  {
+    job.empty = true;
+  }
+}
+
+void Problem::chainSearchComponents()
+{
+  if ( mFeatureCount == 0 )
+    return;
+
+  const int featureCount = static_cast< int >( mFeatureCount );
+
+  mSol.init( mFeatureCount );
+
+  // link features with conflicting candidates into components, collecting the conflicting pairs on the way
+  struct Conflict
+  {
+    int feature;
+    QPair< unsigned int, unsigned int > candidates;
+  };
+  std::vector< Conflict > conflicts;
+  std::vector< int > parents( mFeatureCount );
+  for ( int i = 0; i < featureCount; i++ )
+    parents[i] = i;
+
+  double amin[2];
+  double amax[2];
+  for ( int i = 0; i < featureCount; i++ )
+  {
+    if ( pal->isCanceled() )
+      return;
+
+    for ( int j = 0; j < mFeatNbLp[i]; j++ )
+    {
+      const LabelPosition *lp = mLabelPositions[ mFeatStartId[i] + j ].get();
+      lp->getBoundingBox( amin, amax );
+      mAllCandidatesIndex.intersects( QgsRectangle( amin[0], amin[1], amax[0], amax[1] ), [i, lp, &conflicts, &parents, this]( const LabelPosition * lp2 ) -> bool
+      {
+        // each pair is visited from both sides, only handle it once
+        if ( lp2->getId() > lp->getId() && candidatesAreConflicting( lp, lp2 ) )
+        {
+          conflicts.emplace_back( Conflict{ i, qMakePair( std::min( lp->globalId(), lp2->globalId() ), std::max( lp->globalId(), lp2->globalId() ) ) } );
+
+          const int root1 = findComponentRoot( parents, i );
+          const int root2 = findComponentRoot( parents, lp2->getProblemFeatureId() );
+          if ( root1 != root2 )
+            parents[ std::max( root1, root2 ) ] = std::min( root1, root2 );
+        }
+        return true;
+      } );
+    }
+  }
+
+  // components are ordered by their first feature, and list their features in ascending order
+  std::vector< int > componentForFeature( mFeatureCount, -1 );
+  std::vector< std::vector< int > > components;
+  for ( int i = 0; i < featureCount; i++ )
+  {
+    const int root = findComponentRoot( parents, i );
+    if ( componentForFeature[root] < 0 )
+    {
+      componentForFeature[root] = static_cast< int >( components.size() );
+      components.emplace_back();
+    }
+    componentForFeature[i] = componentForFeature[root];
+    components[ componentForFeature[i] ].push_back( i );
+  }
+
+  if ( components.size() == 1 )
+  {
+    chain_search();
+    return;
+  }
+
+  std::vector< std::unique_ptr< Problem > > componentProblems;
+  std::vector< int > problemForComponent( components.size(), -1 );
+  for ( std::size_t c = 0; c < components.size(); c++ )
+  {
+    const std::vector< int > &features = components[c];
+
+    // a feature without any conflicts always gets its best candidate, reduce() has already dropped all others
+    if ( features.size() == 1 && mFeatNbLp[ features.front() ] <= 1 )
+    {
+      const int feature = features.front();
+      mSol.activeLabelIds[feature] = mFeatNbLp[feature] > 0 ? mFeatStartId[feature] : -1;
+      continue;
+    }
+
+    // the component problem temporarily takes ownership of the candidates, which are renumbered
+    // to match the component's feature and candidate indices
+    std::unique_ptr< Problem > component = std::make_unique< Problem >( mExtent );
+    component->pal = pal;
+    component->mIsComponent = true;
+    component->mDisplayAll = mDisplayAll;
+    component->mFeatureCount = features.size();
+    component->mFeatStartId.resize( features.size() );
+    component->mFeatNbLp.resize( features.size() );
+    component->mInactiveCost.resize( features.size() );
+
+    int lpId = 0;
+    for ( std::size_t k = 0; k < features.size(); k++ )
+    {
+      const int feature = features[k];
+      component->mFeatStartId[k] = lpId;
+      component->mFeatNbLp[k] = mFeatNbLp[feature];
+      component->mInactiveCost[k] = mInactiveCost[feature];
+      for ( int j = 0; j < mFeatNbLp[feature]; j++ )
+      {
+        std::unique_ptr< LabelPosition > &lp = mLabelPositions[ mFeatStartId[feature] + j ];
+        lp->setProblemIds( static_cast< int >( k ), lpId++ );
+        lp->insertIntoIndex( component->mAllCandidatesIndex );
+        component->mLabelPositions.emplace_back( std::move( lp ) );
+      }
+    }
+    component->mTotalCandidates = lpId;
+    component->mAllNblp = lpId;
+
+    problemForComponent[c] = static_cast< int >( componentProblems.size() );
+    componentProblems.emplace_back( std::move( component ) );
+  }
+
+  for ( const Conflict &conflict : conflicts )
+  {
+    componentProblems[ problemForComponent[ componentForFeature[ conflict.feature ] ] ]->mComponentConflicts.insert( conflict.candidates );
+  }
+
+  std::vector< ComponentJob > jobs( componentProblems.size() );
+  for ( std::size_t i = 0; i < componentProblems.size(); i++ )
+    jobs[i].problem = componentProblems[i].get();
+
+  if ( jobs.size() > 1 )
+    QtConcurrent::blockingMap( jobs, solveComponent );
+  else if ( !jobs.empty() )
+    solveComponent( jobs.front() );
+
+  // hand the candidates back, and translate the component solutions to this problem's ids
+  bool empty = false;
+  for ( std::size_t c = 0; c < components.size(); c++ )
+  {
+    if ( problemForComponent[c] < 0 )
+      continue;
+
+    const std::vector< int > &features = components[c];
+    Problem *component = componentProblems[ problemForComponent[c] ].get();
+    empty |= jobs[ problemForComponent[c] ].empty;
+
+    for ( std::size_t k = 0; k < features.size(); k++ )
+    {
+      const int feature = features[k];
+      for ( int j = 0; j < mFeatNbLp[feature]; j++ )
+      {
+        std::unique_ptr< LabelPosition > &lp = component->mLabelPositions[ component->mFeatStartId[k] + j ];
+        lp->setProblemIds( feature, mFeatStartId[feature] + j );
+        mLabelPositions[ mFeatStartId[feature] + j ] = std::move( lp );
+      }
+
+      const int componentLabelId = component->mSol.activeLabelIds.empty() ? -1 : component->mSol.activeLabelIds[k];
+      mSol.activeLabelIds[feature] = componentLabelId < 0 ? -1 : mFeatStartId[feature] + componentLabelId - component->mFeatStartId[k];
+    }
+  }
+
+  if ( empty )
+    throw InternalException::Empty();
+
+  for ( std::size_t i = 0; i < mFeatureCount; i++ )
+  {
+    if ( mSol.activeLabelIds[i] >= 0 )
+      mLabelPositions[ mSol.activeLabelIds[i] ]->insertIntoIndex( mActiveCandidatesIndex );
+  }
+  solution_cost();
+}
+
 QList<LabelPosition *> Problem::getSolution( bool returnInactive, QList<LabelPosition *> *unlabeled )
 {
   QList<LabelPosition *> finalLabelPlacements;
@@ -36,6 +36,8 @@
 #include "qgis_core.h"
 #include <list>
 #include <QList>
+#include <QSet>
+#include <QPair>
 #include "palrtree.h"
 #include <memory>
 #include <vector>
@@ -119,6 +121,31 @@ namespace pal
        */
       void chain_search();
 
+      /**
+       * Splits the problem into its independent components (groups of features whose candidates
+       * may conflict with each other) and runs chain_search() separately on each of them.
+       *
+       * Components are solved concurrently using the global thread pool. Every component is
+       * solved in isolation, so the solution does not depend on the number of threads used or on
+       * the order in which components are processed. Problems with a single component are solved
+       * directly via chain_search().
+       *
+       * The result is not always identical to running chain_search() over the whole problem. The
+       * global run cycles its seeds over all features and only stops once no seed can be improved,
+       * so the order in which the seeds of one component are tried depends on the (unrelated)
+       * features of the other components, and it can settle in a different local optimum. Both
+       * searches stop on the same condition, i.e. when no improving chain is left from any seed of
+       * any component. Solving components separately has the advantage that the labels of a group
+       * of features no longer change when unrelated features elsewhere on the map are added or removed.
+       * Because placements can change, this solver is only used when the
+       * QgsLabelingEngineSettings::SolveComponentsInParallel flag is set (see Pal::setSolveComponentsInParallel()).
+       *
+       * Must be called after reduce().
+       *
+       * \since QGIS 3.20
+       */
+      void chainSearchComponents();
+
       /**
        * Solves the labeling problem, selecting the best candidate locations for all labels and returns a list of these
        * calculated label positions.
@@ -161,6 +188,23 @@ namespace pal
        */
       bool candidatesAreConflicting( const LabelPosition *lp1, const LabelPosition *lp2 ) const;
 
+      /**
+       * Map extent, used for the candidate indexes
+       */
+      QgsRectangle mExtent;
+
+      /**
+       * TRUE if the problem is a component of a larger problem, created by chainSearchComponents()
+       */
+      bool mIsComponent = false;
+
+      /**
+       * For component problems, the global ids of all pairs of conflicting candidates (smaller id first).
+       * These are collected upfront so that components can be solved in parallel without
+       * accessing pal's conflict cache.
+       */
+      QSet< QPair< unsigned int, unsigned int > > mComponentConflicts;
+
       /**
        * Total number of layers containing labels
        */
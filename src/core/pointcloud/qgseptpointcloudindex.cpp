@@ -25,6 +25,7 @@
 #include <QTime>
 #include <QtDebug>
 #include <QQueue>
+#include <QDateTime>
 
 #include "qgseptdecoder.h"
 #include "qgscoordinatereferencesystem.h"
@@ -55,6 +56,8 @@ void QgsEptPointCloudIndex::load( const QString &fileName )
 
   const QDir directory = QFileInfo( fileName ).absoluteDir();
   mDirectory = directory.absolutePath();
+  // cached node data from previous versions of the dataset must not be used
+  mCacheKey = QStringLiteral( "%1|%2" ).arg( QFileInfo( fileName ).absoluteFilePath() ).arg( QFileInfo( fileName ).lastModified().toMSecsSinceEpoch() );
 
   const QByteArray dataJson = f.readAll();
   bool success = loadSchema( dataJson );
@@ -279,25 +282,32 @@ QgsPointCloudBlock *QgsEptPointCloudIndex::nodeData( const IndexedPointCloudNode
   if ( !found )
     return nullptr;
 
+  if ( QgsPointCloudBlock *cached = cachedNodeData( mCacheKey, n, request ) )
+    return cached;
+
+  QgsPointCloudBlock *block = nullptr;
   if ( mDataType == QLatin1String( "binary" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.bin" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressBinary( filename, attributes(), request.attributes(), scale(), offset() );
+    block = QgsEptDecoder::decompressBinary( filename, attributes(), request.attributes(), scale(), offset() );
   }
   else if ( mDataType == QLatin1String( "zstandard" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.zst" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset() );
+    block = QgsEptDecoder::decompressZStandard( filename, attributes(), request.attributes(), scale(), offset() );
   }
   else if ( mDataType == QLatin1String( "laszip" ) )
   {
     QString filename = QStringLiteral( "%1/ept-data/%2.laz" ).arg( mDirectory, n.toString() );
-    return QgsEptDecoder::decompressLaz( filename, attributes(), request.attributes(), scale(), offset() );
+    block = QgsEptDecoder::decompressLaz( filename, attributes(), request.attributes(), scale(), offset() );
   }
   else
   {
     return nullptr;  // unsupported
   }
+
+  storeNodeDataInCache( mCacheKey, n, request, block );
+  return block;
 }
 
 QgsPointCloudBlockRequest *QgsEptPointCloudIndex::asyncNodeData( const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
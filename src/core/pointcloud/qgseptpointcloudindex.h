@@ -69,6 +69,8 @@ class CORE_EXPORT QgsEptPointCloudIndex: public QgsPointCloudIndex
     QString mDataType;
     QString mDirectory;
     QString mWkt;
+    //! Identifies the dataset in the node data cache
+    QString mCacheKey;
 
     qint64 mPointCount = 0;
 
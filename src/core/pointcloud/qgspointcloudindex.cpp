@@ -24,8 +24,14 @@
 #include <QJsonObject>
 #include <QTime>
 #include <QtDebug>
+#include <QCache>
+#include <QMutex>
 
 #include "qgstiledownloadmanager.h"
+#include "qgspointcloudrequest.h"
+
+#include <algorithm>
+#include <limits>
 
 IndexedPointCloudNode::IndexedPointCloudNode():
   mD( -1 ),
@@ -152,10 +158,81 @@ QgsDoubleRange QgsPointCloudDataBounds::zRange( const QgsVector3D &offset, const
 // QgsPointCloudIndex
 //
 
+///@cond PRIVATE
+
+//! Decoded node data blocks shared by all indexes, with costs in kilobytes
+struct QgsPointCloudNodeDataCache
+{
+  QMutex mutex;
+  QCache<QString, QgsPointCloudBlock> blocks = QCache<QString, QgsPointCloudBlock>( 256 * 1024 );
+
+  static QgsPointCloudNodeDataCache *instance()
+  {
+    static QgsPointCloudNodeDataCache sInstance;
+    return &sInstance;
+  }
+
+  static QString key( const QString &indexKey, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
+  {
+    QString key = indexKey + '|' + n.toString();
+    const QVector<QgsPointCloudAttribute> attributes = request.attributes().attributes();
+    for ( const QgsPointCloudAttribute &attribute : attributes )
+    {
+      key += QStringLiteral( "|%1:%2" ).arg( attribute.name() ).arg( static_cast< int >( attribute.type() ) );
+    }
+    return key;
+  }
+};
+
+///@endcond
+
 QgsPointCloudIndex::QgsPointCloudIndex() = default;
 
 QgsPointCloudIndex::~QgsPointCloudIndex() = default;
 
+void QgsPointCloudIndex::setNodeDataCacheSize( qint64 size )
+{
+  QgsPointCloudNodeDataCache *cache = QgsPointCloudNodeDataCache::instance();
+  QMutexLocker locker( &cache->mutex );
+  cache->blocks.setMaxCost( static_cast< int >( std::clamp< qint64 >( size / 1024, 0, std::numeric_limits< int >::max() ) ) );
+}
+
+qint64 QgsPointCloudIndex::nodeDataCacheSize()
+{
+  QgsPointCloudNodeDataCache *cache = QgsPointCloudNodeDataCache::instance();
+  QMutexLocker locker( &cache->mutex );
+  return static_cast< qint64 >( cache->blocks.maxCost() ) * 1024;
+}
+
+QgsPointCloudBlock *QgsPointCloudIndex::cachedNodeData( const QString &indexKey, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request )
+{
+  if ( indexKey.isEmpty() )
+    return nullptr;
+
+  QgsPointCloudNodeDataCache *cache = QgsPointCloudNodeDataCache::instance();
+  const QString key = QgsPointCloudNodeDataCache::key( indexKey, n, request );
+  QMutexLocker locker( &cache->mutex );
+  if ( const QgsPointCloudBlock *block = cache->blocks.object( key ) )
+  {
+    // blocks share their (implicitly shared) data with the cached block, so copies are cheap
+    return new QgsPointCloudBlock( *block );
+  }
+  return nullptr;
+}
+
+void QgsPointCloudIndex::storeNodeDataInCache( const QString &indexKey, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request, const QgsPointCloudBlock *block )
+{
+  if ( indexKey.isEmpty() || !block )
+    return;
+
+  QgsPointCloudNodeDataCache *cache = QgsPointCloudNodeDataCache::instance();
+  const QString key = QgsPointCloudNodeDataCache::key( indexKey, n, request );
+  const int cost = std::max( static_cast< int >( static_cast< qint64 >( block->pointCount() ) * block->attributes().pointRecordSize() / 1024 ), 1 );
+  QMutexLocker locker( &cache->mutex );
+  if ( cache->blocks.maxCost() > 0 )
+    cache->blocks.insert( key, new QgsPointCloudBlock( *block ), cost );
+}
+
 bool QgsPointCloudIndex::hasNode( const IndexedPointCloudNode &n ) const
 {
   mHierarchyMutex.lock();
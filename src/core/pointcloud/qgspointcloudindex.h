@@ -277,7 +277,43 @@ class CORE_EXPORT QgsPointCloudIndex: public QObject
      */
     int nodePointCount( const IndexedPointCloudNode &n );
 
+    /**
+     * Sets the maximum \a size in bytes of the cache of decoded node data blocks, shared by all
+     * point cloud indexes. A size of 0 disables the cache.
+     *
+     * \see nodeDataCacheSize()
+     * \since QGIS 3.20
+     */
+    static void setNodeDataCacheSize( qint64 size );
+
+    /**
+     * Returns the maximum size in bytes of the cache of decoded node data blocks.
+     *
+     * \see setNodeDataCacheSize()
+     * \since QGIS 3.20
+     */
+    static qint64 nodeDataCacheSize();
+
   protected: //TODO private
+
+    /**
+     * Returns a copy of the data block of node \a n decoded for the attributes of \a request from the
+     * shared node data cache, or nullptr if the block is not cached. \a indexKey identifies the data source.
+     *
+     * \see storeNodeDataInCache()
+     * \since QGIS 3.20
+     */
+    static QgsPointCloudBlock *cachedNodeData( const QString &indexKey, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request );
+
+    /**
+     * Stores a copy of the data \a block of node \a n decoded for the attributes of \a request in the
+     * shared node data cache. \a indexKey identifies the data source.
+     *
+     * \see cachedNodeData()
+     * \since QGIS 3.20
+     */
+    static void storeNodeDataInCache( const QString &indexKey, const IndexedPointCloudNode &n, const QgsPointCloudRequest &request, const QgsPointCloudBlock *block );
+
     //! Sets native attributes of the data
     void setAttributes( const QgsPointCloudAttributeCollection &attributes );
 
@@ -30,6 +30,11 @@
 #include "qgsmeshlayer.h"
 #include "qgsexpressioncontextutils.h"
 
+#include <QMutex>
+#include <QtConcurrent>
+
+#include <numeric>
+
 
 QgsProcessingAlgorithm::~QgsProcessingAlgorithm()
 {
@@ -917,6 +922,11 @@ QgsProcessingAlgorithm::Flags QgsProcessingFeatureBasedAlgorithm::flags() const
   return f;
 }
 
+bool QgsProcessingFeatureBasedAlgorithm::supportsParallelFeatureProcessing() const
+{
+  return false;
+}
+
 void QgsProcessingFeatureBasedAlgorithm::initAlgorithm( const QVariantMap &config )
 {
   addParameter( new QgsProcessingParameterFeatureSource( inputParameterName(), inputParameterDescription(), inputLayerTypes() ) );
@@ -981,6 +991,84 @@ QgsCoordinateReferenceSystem QgsProcessingFeatureBasedAlgorithm::sourceCrs() con
     return QgsCoordinateReferenceSystem();
 }
 
+///@cond PRIVATE
+namespace
+{
+
+  /**
+   * Feedback for the processFeature() calls of one chunk of features, running in a worker thread.
+   * Messages are forwarded to the algorithm feedback one at a time. Progress reports are not
+   * forwarded: the progress is only set from the algorithm thread.
+   */
+  class QgsSerializedProcessingFeedback : public QgsProcessingFeedback
+  {
+    public:
+
+      /**
+       * Constructor for QgsSerializedProcessingFeedback, forwarding messages to \a feedback
+       * while holding \a mutex. The feedback gets canceled together with \a cancelFeedback.
+       */
+      QgsSerializedProcessingFeedback( QgsProcessingFeedback *feedback, QgsFeedback *cancelFeedback, QMutex *mutex )
+        : QgsProcessingFeedback( false )
+        , mFeedback( feedback )
+        , mMutex( mutex )
+      {
+        QObject::connect( cancelFeedback, &QgsFeedback::canceled, this, &QgsFeedback::cancel, Qt::DirectConnection );
+        if ( cancelFeedback->isCanceled() )
+          cancel();
+      }
+
+      void setProgressText( const QString &text ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->setProgressText( text );
+      }
+
+      void reportError( const QString &error, bool fatalError ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->reportError( error, fatalError );
+      }
+
+      void pushWarning( const QString &warning ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->pushWarning( warning );
+      }
+
+      void pushInfo( const QString &info ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->pushInfo( info );
+      }
+
+      void pushCommandInfo( const QString &info ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->pushCommandInfo( info );
+      }
+
+      void pushDebugInfo( const QString &info ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->pushDebugInfo( info );
+      }
+
+      void pushConsoleInfo( const QString &info ) override
+      {
+        QMutexLocker locker( mMutex );
+        mFeedback->pushConsoleInfo( info );
+      }
+
+    private:
+
+      QgsProcessingFeedback *mFeedback = nullptr;
+      QMutex *mMutex = nullptr;
+  };
+
+}
+///@endcond
+
 QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariantMap &parameters, QgsProcessingContext &context, QgsProcessingFeedback *feedback )
 {
   prepareSource( parameters, context );
@@ -1007,20 +1095,97 @@ QVariantMap QgsProcessingFeatureBasedAlgorithm::processAlgorithm( const QVariant
 
   double step = count > 0 ? 100.0 / count : 1;
   int current = 0;
-  while ( it.nextFeature( f ) )
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  if ( supportsParallelFeatureProcessing() && threadCount > 1 )
   {
+    // features are read and written on this thread, in batches, and each batch is split in
+    // chunks processed concurrently, each with its own context and feedback
+    const int chunkSize = 256;
+    QMutex feedbackMutex;
+    // stops all the chunks when the algorithm is canceled or a chunk failed
+    QgsFeedback stopFeedback;
+    QObject::connect( feedback, &QgsFeedback::canceled, &stopFeedback, &QgsFeedback::cancel, Qt::DirectConnection );
     if ( feedback->isCanceled() )
+      stopFeedback.cancel();
+    QVector< QgsFeature > batch;
+    QVector< QgsFeatureList > results;
+    bool finished = false;
+    while ( !finished && !stopFeedback.isCanceled() )
     {
-      break;
+      batch.clear();
+      while ( batch.size() < chunkSize * threadCount )
+      {
+        if ( !it.nextFeature( f ) )
+        {
+          finished = true;
+          break;
+        }
+        batch << f;
+      }
+      if ( batch.isEmpty() )
+        break;
+
+      results = QVector< QgsFeatureList >( batch.size() );
+      QgsFeatureList *resultsData = results.data();
+      const int chunkCount = ( batch.size() + chunkSize - 1 ) / chunkSize;
+      std::vector< int > chunks( chunkCount );
+      std::iota( chunks.begin(), chunks.end(), 0 );
+      QString exceptionMessage;
+      QMutex exceptionMutex;
+      QtConcurrent::blockingMap( chunks, [&]( int chunk )
+      {
+        QgsSerializedProcessingFeedback chunkFeedback( feedback, &stopFeedback, &feedbackMutex );
+        QgsProcessingContext chunkContext;
+        chunkContext.copyThreadSafeSettings( context );
+        chunkContext.setFeedback( &chunkFeedback );
+        const int end = std::min( ( chunk + 1 ) * chunkSize, batch.size() );
+        for ( int i = chunk * chunkSize; i < end && !chunkFeedback.isCanceled(); ++i )
+        {
+          chunkContext.expressionContext().setFeature( batch.at( i ) );
+          try
+          {
+            resultsData[i] = processFeature( batch.at( i ), chunkContext, &chunkFeedback );
+          }
+          catch ( QgsProcessingException &e )
+          {
+            // exceptions can't cross thread boundaries, rethrow it from this thread
+            QMutexLocker locker( &exceptionMutex );
+            exceptionMessage = e.what();
+            stopFeedback.cancel();
+          }
+        }
+      } );
+
+      if ( !exceptionMessage.isEmpty() )
+        throw QgsProcessingException( exceptionMessage );
+
+      for ( const QgsFeatureList &transformed : std::as_const( results ) )
+      {
+        for ( QgsFeature transformedFeature : transformed )
+          sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      }
+
+      current += batch.size();
+      feedback->setProgress( current * step );
     }
+  }
+  else
+  {
+    while ( it.nextFeature( f ) )
+    {
+      if ( feedback->isCanceled() )
+      {
+        break;
+      }
 
-    context.expressionContext().setFeature( f );
-    const QgsFeatureList transformed = processFeature( f, context, feedback );
-    for ( QgsFeature transformedFeature : transformed )
-      sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
+      context.expressionContext().setFeature( f );
+      const QgsFeatureList transformed = processFeature( f, context, feedback );
+      for ( QgsFeature transformedFeature : transformed )
+        sink->addFeature( transformedFeature, QgsFeatureSink::FastInsert );
 
-    feedback->setProgress( current * step );
-    current++;
+      feedback->setProgress( current * step );
+      current++;
+    }
   }
 
   mSource.reset();
@@ -1114,9 +1114,25 @@ class CORE_EXPORT QgsProcessingFeatureBasedAlgorithm : public QgsProcessingAlgor
      * prevent the algorithm execution from continuing. This can be annoying for users though as it
      * can break valid model execution - so use with extreme caution, and consider using
      * \a feedback to instead report non-fatal processing failures for features instead.
+     *
+     * If supportsParallelFeatureProcessing() returns TRUE, this method is called concurrently from
+     * several threads, each with its own copy of the \a context and its own \a feedback object.
+     * Features are still added to the output in the order of the source.
      */
     virtual QgsFeatureList processFeature( const QgsFeature &feature, QgsProcessingContext &context, QgsProcessingFeedback *feedback ) SIP_THROW( QgsProcessingException ) = 0 SIP_VIRTUALERRORHANDLER( processing_exception_handler );
 
+    /**
+     * Returns TRUE if the algorithm's processFeature() implementation is thread safe, so that
+     * features can be processed in parallel.
+     *
+     * The default implementation returns FALSE.
+     *
+     * \note Not available in Python bindings. Python implementations of processFeature() require
+     * the Python global interpreter lock, so they are always called sequentially.
+     * \since QGIS 3.20
+     */
+    virtual bool supportsParallelFeatureProcessing() const SIP_SKIP;
+
   protected:
 
     void initAlgorithm( const QVariantMap &configuration = QVariantMap() ) override;
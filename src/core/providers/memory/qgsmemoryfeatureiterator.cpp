@@ -23,6 +23,7 @@
 #include "qgsproject.h"
 #include "qgsexception.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsfeaturebatch.h"
 
 ///@cond PRIVATE
 
@@ -175,34 +176,7 @@ bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
   // option 2: traversing the whole layer
   while ( mSelectIterator != mSource->mFeatures.constEnd() )
   {
-    if ( mFilterRect.isNull() )
-    {
-      // selection rect empty => using all features
-      hasFeature = true;
-    }
-    else
-    {
-      if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
-      {
-        // using exact test when checking for intersection
-        if ( mSelectIterator->hasGeometry() && mSelectRectEngine->intersects( mSelectIterator->geometry().constGet() ) )
-          hasFeature = true;
-      }
-      else
-      {
-        // check just bounding box against rect when not using intersection
-        if ( mSelectIterator->hasGeometry() && mSelectIterator->geometry().boundingBox().intersects( mFilterRect ) )
-          hasFeature = true;
-      }
-    }
-
-    if ( mSubsetExpression )
-    {
-      mSource->expressionContext()->setFeature( *mSelectIterator );
-      if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
-        hasFeature = false;
-    }
-
+    hasFeature = acceptFeatureTraverseAll( *mSelectIterator );
     if ( hasFeature )
       break;
 
@@ -224,6 +198,62 @@ bool QgsMemoryFeatureIterator::nextFeatureTraverseAll( QgsFeature &feature )
   return hasFeature;
 }
 
+bool QgsMemoryFeatureIterator::acceptFeatureTraverseAll( const QgsFeature &feature )
+{
+  if ( !mFilterRect.isNull() )
+  {
+    if ( mRequest.flags() & QgsFeatureRequest::ExactIntersect )
+    {
+      // using exact test when checking for intersection
+      if ( !feature.hasGeometry() || !mSelectRectEngine->intersects( feature.geometry().constGet() ) )
+        return false;
+    }
+    else
+    {
+      // check just bounding box against rect when not using intersection
+      if ( !feature.hasGeometry() || !feature.geometry().boundingBox().intersects( mFilterRect ) )
+        return false;
+    }
+  }
+
+  if ( mSubsetExpression )
+  {
+    mSource->expressionContext()->setFeature( feature );
+    if ( !mSubsetExpression->evaluate( mSource->expressionContext() ).toBool() )
+      return false;
+  }
+
+  return true;
+}
+
+int QgsMemoryFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return 0;
+
+  // features are appended straight from the layer's storage, without the per feature copy made
+  // by fetchFeature(). The storage itself holds QVariant attributes, so values are still converted
+  // from variants by appendFeature(). Reprojected features need to be copied anyway, so leave them to fetchFeature()
+  if ( mUsingFeatureIdList || mTransform.isValid() )
+    return -1;
+
+  int count = 0;
+  while ( count < maxFeatures && mSelectIterator != mSource->mFeatures.constEnd() )
+  {
+    if ( acceptFeatureTraverseAll( *mSelectIterator ) )
+    {
+      batch.appendFeature( *mSelectIterator );
+      count++;
+    }
+    ++mSelectIterator;
+  }
+
+  if ( mSelectIterator == mSource->mFeatures.constEnd() )
+    close();
+
+  return count;
+}
+
 bool QgsMemoryFeatureIterator::rewind()
 {
   if ( mClosed )
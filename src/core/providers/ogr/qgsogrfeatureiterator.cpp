@@ -28,6 +28,7 @@
 #include "qgsexception.h"
 #include "qgswkbtypes.h"
 #include "qgsogrtransaction.h"
+#include "qgsfeaturebatch.h"
 #include "qgssymbol.h"
 
 #include <QTextCodec>
@@ -136,6 +137,14 @@ QgsOgrFeatureIterator::QgsOgrFeatureIterator( QgsOgrFeatureSource *source, bool
     return;
   }
 
+  if ( !mFilterRect.isNull() && mRequest.flags() & QgsFeatureRequest::ExactIntersect )
+  {
+    // prepare the rectangle once, instead of converting it for every feature
+    mSelectRectGeom = QgsGeometry::fromRect( mFilterRect );
+    mSelectRectEngine.reset( QgsGeometry::createGeometryEngine( mSelectRectGeom.constGet() ) );
+    mSelectRectEngine->prepareGeometry();
+  }
+
   mFetchGeometry = ( !mFilterRect.isNull() ) ||
                    !( mRequest.flags() & QgsFeatureRequest::NoGeometry ) ||
                    ( mSource->mOgrGeometryTypeFilter != wkbUnknown );
@@ -407,6 +416,133 @@ bool QgsOgrFeatureIterator::fetchFeature( QgsFeature &feature )
   return false;
 }
 
+int QgsOgrFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  // geometries, and the filters based on them, need the complete feature: leave them to fetchFeature()
+  if ( batch.fetchGeometry() || !mFilterRect.isNull() || mSource->mOgrGeometryTypeFilter != wkbUnknown )
+    return -1;
+
+  QMutexLocker locker( mSharedDS ? &mSharedDS->mutex() : nullptr );
+
+  QgsCPLHTTPFetchOverrider oCPLHTTPFetcher( mAuthCfg, mInterruptionChecker );
+  QgsSetCPLHTTPFetchOverriderInitiatorClass( oCPLHTTPFetcher, QStringLiteral( "QgsOgrFeatureIterator" ) )
+
+  if ( mClosed || !mOgrLayer )
+    return 0;
+
+  // see fetchFeature() regarding OSM layers
+  const bool readFromDataset = !QgsOgrProviderUtils::canDriverShareSameDatasetAmongLayers( mSource->mDriverName );
+
+  gdal::ogr_feature_unique_ptr fet;
+  int count = 0;
+  while ( count < maxFeatures )
+  {
+    if ( readFromDataset )
+    {
+      OGRLayerH nextFeatureBelongingLayer;
+      fet.reset( GDALDatasetGetNextFeature( mConn->ds, &nextFeatureBelongingLayer, nullptr, nullptr, nullptr ) );
+      if ( fet && nextFeatureBelongingLayer != mOgrLayer )
+        continue;
+    }
+    else
+    {
+      fet.reset( OGR_L_GetNextFeature( mOgrLayer ) );
+    }
+
+    if ( !fet )
+    {
+      close();
+      break;
+    }
+
+    batch.beginFeature( OGR_F_GetFID( fet.get() ) );
+    for ( int column = 0; column < batch.columnCount(); ++column )
+      appendBatchValue( fet.get(), batch, column );
+    count++;
+  }
+
+  return count;
+}
+
+void QgsOgrFeatureIterator::appendBatchValue( OGRFeatureH ogrFet, QgsFeatureBatch &batch, int column ) const
+{
+  const QgsFeatureBatch::Column &batchColumn = batch.column( column );
+  const int attindex = batchColumn.fieldIndex();
+
+  if ( mFirstFieldIsFid && attindex == 0 )
+  {
+    const qint64 fid = OGR_F_GetFID( ogrFet );
+    switch ( batchColumn.type() )
+    {
+      case QgsFeatureBatch::Int64Column:
+        batch.appendInt64( column, fid );
+        break;
+      case QgsFeatureBatch::DoubleColumn:
+        batch.appendDouble( column, static_cast< double >( fid ) );
+        break;
+      case QgsFeatureBatch::StringColumn:
+      case QgsFeatureBatch::VariantColumn:
+        batch.appendValue( column, fid );
+        break;
+    }
+    return;
+  }
+
+  const int attindexWithoutFid = ( mFirstFieldIsFid ) ? attindex - 1 : attindex;
+  if ( attindexWithoutFid < 0 || attindexWithoutFid >= mFieldsWithoutFid.count() || !OGR_F_GetFieldDefnRef( ogrFet, attindexWithoutFid ) )
+  {
+    batch.appendNull( column );
+    return;
+  }
+
+  if ( !OGR_F_IsFieldSetAndNotNull( ogrFet, attindexWithoutFid ) )
+  {
+    batch.appendNull( column );
+    return;
+  }
+
+  // numbers and strings are read straight into the column, with the same conversions
+  // QgsOgrUtils::getOgrFeatureAttribute() applies, but without creating a QVariant
+  const QVariant::Type fieldType = mFieldsWithoutFid.at( attindexWithoutFid ).type();
+  switch ( batchColumn.type() )
+  {
+    case QgsFeatureBatch::DoubleColumn:
+      if ( fieldType == QVariant::Double || fieldType == QVariant::Int || fieldType == QVariant::LongLong )
+      {
+        batch.appendDouble( column, OGR_F_GetFieldAsDouble( ogrFet, attindexWithoutFid ) );
+        return;
+      }
+      break;
+
+    case QgsFeatureBatch::Int64Column:
+      if ( fieldType == QVariant::Int || fieldType == QVariant::LongLong )
+      {
+        batch.appendInt64( column, OGR_F_GetFieldAsInteger64( ogrFet, attindexWithoutFid ) );
+        return;
+      }
+      break;
+
+    case QgsFeatureBatch::StringColumn:
+      if ( fieldType == QVariant::String )
+      {
+        const char *value = OGR_F_GetFieldAsString( ogrFet, attindexWithoutFid );
+        batch.appendString( column, mSource->mEncoding ? mSource->mEncoding->toUnicode( value ) : QString::fromUtf8( value ) );
+        return;
+      }
+      break;
+
+    case QgsFeatureBatch::VariantColumn:
+      break;
+  }
+
+  bool ok = false;
+  const QVariant value = QgsOgrUtils::getOgrFeatureAttribute( ogrFet, mFieldsWithoutFid, attindexWithoutFid, mSource->mEncoding, &ok );
+  if ( ok )
+    batch.appendValue( column, value );
+  else
+    batch.appendNull( column );
+}
+
 void QgsOgrFeatureIterator::resetReading()
 {
   if ( ! mAllowResetReading )
@@ -537,7 +673,7 @@ bool QgsOgrFeatureIterator::readFeature( const gdal::ogr_feature_unique_ptr &fet
     }
     else if ( ( geometryTypeFilter && ( !feature.hasGeometry() || QgsOgrProvider::ogrWkbSingleFlatten( ( OGRwkbGeometryType )feature.geometry().wkbType() ) != mSource->mOgrGeometryTypeFilter ) )
               || ( useIntersect && ( !feature.hasGeometry()
-                                     || ( mRequest.flags() & QgsFeatureRequest::ExactIntersect && !feature.geometry().intersects( mFilterRect ) )
+                                     || ( mSelectRectEngine && !mSelectRectEngine->intersects( feature.geometry().constGet() ) )
                                      || ( !( mRequest.flags() & QgsFeatureRequest::ExactIntersect ) && !feature.geometry().boundingBoxIntersects( mFilterRect ) )
                                    )
                  ) )
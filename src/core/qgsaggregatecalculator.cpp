@@ -17,6 +17,7 @@
 
 #include "qgsaggregatecalculator.h"
 #include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
 #include "qgsfeaturerequest.h"
 #include "qgsfeatureiterator.h"
 #include "qgsgeometry.h"
@@ -677,20 +678,34 @@ QVariant QgsAggregateCalculator::calculateNumericAggregate( QgsFeatureIterator &
   Q_ASSERT( expression || attr >= 0 );
 
   QgsStatisticalSummary s( stat );
-  QgsFeature f;
 
-  while ( fit.nextFeature( f ) )
+  if ( expression )
   {
-    if ( expression )
+    Q_ASSERT( context );
+    QgsFeature f;
+    while ( fit.nextFeature( f ) )
     {
-      Q_ASSERT( context );
       context->setFeature( f );
       QVariant v = expression->evaluate( context );
       s.addVariant( v );
     }
-    else
+  }
+  else
+  {
+    // plain field values can be read in batches, avoiding a QgsFeature per feature
+    QgsFeatureBatch batch;
+    batch.addColumn( attr, QgsFeatureBatch::DoubleColumn );
+    while ( fit.nextBatch( batch, 1000 ) > 0 )
     {
-      s.addVariant( f.attribute( attr ) );
+      const QgsFeatureBatch::Column &column = batch.column( 0 );
+      const double *values = column.doubleData();
+      for ( int i = 0; i < batch.size(); ++i )
+      {
+        if ( column.isNull( i ) )
+          s.addVariant( QVariant() );
+        else
+          s.addValue( values[i] );
+      }
     }
   }
   s.finalize();
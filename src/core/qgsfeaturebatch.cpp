@@ -0,0 +1,291 @@
+/***************************************************************************
+     qgsfeaturebatch.cpp
+     --------------------------------------
+    Date                 : March 2021
+    Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsfeaturebatch.h"
+#include "qgsfields.h"
+#include "qgsgeometry.h"
+
+#include <algorithm>
+#include <cstring>
+
+QString QgsFeatureBatch::Column::stringValue( int row ) const
+{
+  if ( mNulls[ row ] )
+    return QString();
+
+  const int start = mStringOffsets[ row ];
+  return mStrings.mid( start, mStringOffsets[ row + 1 ] - start );
+}
+
+QVariant QgsFeatureBatch::Column::value( int row ) const
+{
+  switch ( mType )
+  {
+    case QgsFeatureBatch::DoubleColumn:
+      return mNulls[ row ] ? QVariant( QVariant::Double ) : QVariant( mDoubles[ row ] );
+    case QgsFeatureBatch::Int64Column:
+      return mNulls[ row ] ? QVariant( QVariant::LongLong ) : QVariant( static_cast< qlonglong >( mInts[ row ] ) );
+    case QgsFeatureBatch::StringColumn:
+      return mNulls[ row ] ? QVariant( QVariant::String ) : QVariant( stringValue( row ) );
+    case QgsFeatureBatch::VariantColumn:
+      break;
+  }
+  return mVariants.at( row );
+}
+
+QgsFeatureBatch::QgsFeatureBatch( const QgsFields &fields, const QgsAttributeList &attributes, bool fetchGeometry )
+  : mFetchGeometry( fetchGeometry )
+{
+  for ( int attribute : attributes )
+  {
+    addColumn( attribute, attribute >= 0 && attribute < fields.count() ? columnTypeForField( fields.at( attribute ) ) : VariantColumn );
+  }
+}
+
+QgsFeatureBatch::ColumnType QgsFeatureBatch::columnTypeForField( const QgsField &field )
+{
+  switch ( field.type() )
+  {
+    case QVariant::Double:
+      return DoubleColumn;
+
+    case QVariant::Int:
+    case QVariant::UInt:
+    case QVariant::LongLong:
+      return Int64Column;
+
+    case QVariant::String:
+      return StringColumn;
+
+    default:
+      return VariantColumn;
+  }
+}
+
+int QgsFeatureBatch::addColumn( int fieldIndex, QgsFeatureBatch::ColumnType type )
+{
+  Q_ASSERT( mIds.empty() );
+
+  Column column;
+  column.mFieldIndex = fieldIndex;
+  column.mType = type;
+  if ( type == StringColumn )
+    column.mStringOffsets.push_back( 0 );
+  mColumns.append( column );
+  return mColumns.size() - 1;
+}
+
+void QgsFeatureBatch::clear()
+{
+  mIds.clear();
+  mWkb.resize( 0 );
+  mWkbOffsets.resize( 1 );
+
+  for ( Column &column : mColumns )
+  {
+    column.mNulls.clear();
+    column.mDoubles.clear();
+    column.mInts.clear();
+    column.mStrings.resize( 0 );
+    if ( column.mType == StringColumn )
+      column.mStringOffsets.resize( 1 );
+    column.mVariants.resize( 0 );
+  }
+}
+
+int QgsFeatureBatch::columnIndexForField( int fieldIndex ) const
+{
+  for ( int i = 0; i < mColumns.size(); ++i )
+  {
+    if ( mColumns.at( i ).mFieldIndex == fieldIndex )
+      return i;
+  }
+  return -1;
+}
+
+const unsigned char *QgsFeatureBatch::wkb( int row, int &size ) const
+{
+  size = mWkbOffsets[ row + 1 ] - mWkbOffsets[ row ];
+  return reinterpret_cast< const unsigned char * >( mWkb.constData() ) + mWkbOffsets[ row ];
+}
+
+QgsGeometry QgsFeatureBatch::geometry( int row ) const
+{
+  int size = 0;
+  const unsigned char *data = wkb( row, size );
+  if ( size == 0 )
+    return QgsGeometry();
+
+  QgsGeometry geometry;
+  geometry.fromWkb( QByteArray( reinterpret_cast< const char * >( data ), size ) );
+  return geometry;
+}
+
+QgsFeature QgsFeatureBatch::feature( int row ) const
+{
+  QgsFeature feature( mIds[ row ] );
+
+  int attributeCount = 0;
+  for ( const Column &column : mColumns )
+    attributeCount = std::max( attributeCount, column.mFieldIndex + 1 );
+  feature.initAttributes( attributeCount );
+
+  for ( const Column &column : mColumns )
+  {
+    if ( column.mFieldIndex >= 0 )
+      feature.setAttribute( column.mFieldIndex, column.value( row ) );
+  }
+
+  if ( hasGeometry( row ) )
+    feature.setGeometry( geometry( row ) );
+
+  feature.setValid( true );
+  return feature;
+}
+
+void QgsFeatureBatch::appendFeature( const QgsFeature &feature )
+{
+  beginFeature( feature.id() );
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( int i = 0; i < mColumns.size(); ++i )
+  {
+    const int fieldIndex = mColumns.at( i ).mFieldIndex;
+    if ( fieldIndex >= 0 && fieldIndex < attributes.size() )
+      appendValue( i, attributes.at( fieldIndex ) );
+    else
+      appendNull( i );
+  }
+
+  if ( mFetchGeometry )
+    appendGeometry( feature.geometry() );
+}
+
+int QgsFeatureBatch::beginFeature( QgsFeatureId id )
+{
+  mIds.push_back( id );
+  if ( !mFetchGeometry )
+    mWkbOffsets.push_back( mWkb.size() );
+  return static_cast< int >( mIds.size() ) - 1;
+}
+
+void QgsFeatureBatch::appendNull( int column )
+{
+  Column &c = mColumns[ column ];
+  c.mNulls.push_back( 1 );
+  switch ( c.mType )
+  {
+    case DoubleColumn:
+      c.mDoubles.push_back( 0 );
+      break;
+    case Int64Column:
+      c.mInts.push_back( 0 );
+      break;
+    case StringColumn:
+      c.mStringOffsets.push_back( c.mStrings.size() );
+      break;
+    case VariantColumn:
+      c.mVariants.append( QVariant() );
+      break;
+  }
+}
+
+void QgsFeatureBatch::appendDouble( int column, double value )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.mType == DoubleColumn );
+  c.mNulls.push_back( 0 );
+  c.mDoubles.push_back( value );
+}
+
+void QgsFeatureBatch::appendInt64( int column, qint64 value )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.mType == Int64Column );
+  c.mNulls.push_back( 0 );
+  c.mInts.push_back( value );
+}
+
+void QgsFeatureBatch::appendString( int column, const QString &value )
+{
+  Column &c = mColumns[ column ];
+  Q_ASSERT( c.mType == StringColumn );
+  c.mNulls.push_back( 0 );
+  c.mStrings.append( value );
+  c.mStringOffsets.push_back( c.mStrings.size() );
+}
+
+void QgsFeatureBatch::appendValue( int column, const QVariant &value )
+{
+  Column &c = mColumns[ column ];
+  if ( c.mType == VariantColumn )
+  {
+    c.mNulls.push_back( value.isNull() ? 1 : 0 );
+    c.mVariants.append( value );
+    return;
+  }
+
+  if ( value.isNull() )
+  {
+    appendNull( column );
+    return;
+  }
+
+  bool ok = false;
+  switch ( c.mType )
+  {
+    case DoubleColumn:
+    {
+      const double d = value.toDouble( &ok );
+      if ( ok )
+        appendDouble( column, d );
+      break;
+    }
+
+    case Int64Column:
+    {
+      const qlonglong i = value.toLongLong( &ok );
+      if ( ok )
+        appendInt64( column, i );
+      break;
+    }
+
+    case StringColumn:
+      ok = true;
+      appendString( column, value.toString() );
+      break;
+
+    case VariantColumn:
+      break;
+  }
+
+  if ( !ok )
+    appendNull( column );
+}
+
+void QgsFeatureBatch::appendGeometry( const QgsGeometry &geometry )
+{
+  Q_ASSERT( mFetchGeometry );
+  if ( !geometry.isNull() )
+    mWkb.append( geometry.asWkb() );
+  mWkbOffsets.push_back( mWkb.size() );
+}
+
+void QgsFeatureBatch::appendWkb( const char *wkb, int size )
+{
+  Q_ASSERT( mFetchGeometry );
+  if ( size > 0 )
+    mWkb.append( wkb, size );
+  mWkbOffsets.push_back( mWkb.size() );
+}
@@ -0,0 +1,267 @@
+/***************************************************************************
+     qgsfeaturebatch.h
+     --------------------------------------
+    Date                 : March 2021
+    Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSFEATUREBATCH_H
+#define QGSFEATUREBATCH_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeatureid.h"
+#include "qgsfeature.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <vector>
+
+class QgsFields;
+class QgsGeometry;
+
+/**
+ * \ingroup core
+ * \class QgsFeatureBatch
+ * \brief A batch of features stored in typed, columnar buffers.
+ *
+ * Feature batches are filled by QgsFeatureIterator::nextBatch(), and allow consumers which
+ * need only a few attribute values from many features (e.g. aggregates and statistics) to
+ * read them without creating a QgsFeature and its QVariant based attributes for every feature.
+ *
+ * The columns of a batch are set up by the caller before fetching, each column referring to
+ * a field index from the request's fields. Values are stored natively as doubles, 64 bit
+ * integers or strings depending on the column type, with a separate null flag per value.
+ * Feature geometries, if requested, are stored as WKB in a single shared buffer.
+ *
+ * Buffers are reused between batches, so repeated calls to QgsFeatureIterator::nextBatch()
+ * with the same batch object do not need to allocate any memory once the buffers are large enough.
+ *
+ * \note not available in Python bindings
+ * \since QGIS 3.20
+ */
+class CORE_EXPORT QgsFeatureBatch
+{
+  public:
+
+    //! Column storage types
+    enum ColumnType
+    {
+      DoubleColumn, //!< Values are stored as doubles
+      Int64Column, //!< Values are stored as 64 bit integers
+      StringColumn, //!< Values are stored as strings
+      VariantColumn, //!< Values are stored as variants, for all other field types
+    };
+
+    /**
+     * \ingroup core
+     * \brief A single column of attribute values within a QgsFeatureBatch.
+     * \since QGIS 3.20
+     */
+    class CORE_EXPORT Column
+    {
+      public:
+
+        //! Returns the field index which the column contains values for
+        int fieldIndex() const { return mFieldIndex; }
+
+        //! Returns the storage type of the column
+        QgsFeatureBatch::ColumnType type() const { return mType; }
+
+        //! Returns TRUE if the value for the feature at \a row is NULL
+        bool isNull( int row ) const { return mNulls[ row ]; }
+
+        /**
+         * Returns the value for the feature at \a row from a DoubleColumn. NULL values are returned as 0.
+         * \see doubleData()
+         */
+        double doubleValue( int row ) const { return mDoubles[ row ]; }
+
+        /**
+         * Returns the value for the feature at \a row from an Int64Column. NULL values are returned as 0.
+         * \see int64Data()
+         */
+        qint64 int64Value( int row ) const { return mInts[ row ]; }
+
+        /**
+         * Returns the value for the feature at \a row from a StringColumn. NULL values are returned as a null string.
+         */
+        QString stringValue( int row ) const;
+
+        /**
+         * Returns the value for the feature at \a row as a variant, regardless of the column type.
+         */
+        QVariant value( int row ) const;
+
+        /**
+         * Returns a pointer to the contiguous values of a DoubleColumn.
+         */
+        const double *doubleData() const { return mDoubles.data(); }
+
+        /**
+         * Returns a pointer to the contiguous values of an Int64Column.
+         */
+        const qint64 *int64Data() const { return mInts.data(); }
+
+      private:
+
+        int mFieldIndex = -1;
+        QgsFeatureBatch::ColumnType mType = QgsFeatureBatch::VariantColumn;
+
+        std::vector< unsigned char > mNulls;
+        std::vector< double > mDoubles;
+        std::vector< qint64 > mInts;
+        QString mStrings;
+        std::vector< int > mStringOffsets;
+        QVector< QVariant > mVariants;
+
+        friend class QgsFeatureBatch;
+    };
+
+    /**
+     * Constructor for an empty QgsFeatureBatch without columns.
+     */
+    QgsFeatureBatch() = default;
+
+    /**
+     * Constructor for QgsFeatureBatch, with a column for each of the specified \a attributes
+     * from \a fields. Column types are determined using columnTypeForField().
+     *
+     * If \a fetchGeometry is TRUE then feature geometries will also be stored in the batch.
+     */
+    QgsFeatureBatch( const QgsFields &fields, const QgsAttributeList &attributes, bool fetchGeometry = false );
+
+    /**
+     * Returns the most suitable column storage type for values from \a field.
+     */
+    static ColumnType columnTypeForField( const QgsField &field );
+
+    /**
+     * Adds a column of the specified \a type, which will contain the values of the field at \a fieldIndex.
+     * Must be called before any features are added to the batch.
+     * \returns index of new column
+     */
+    int addColumn( int fieldIndex, ColumnType type );
+
+    /**
+     * Sets whether feature geometries should be stored in the batch.
+     * \see fetchGeometry()
+     */
+    void setFetchGeometry( bool fetch ) { mFetchGeometry = fetch; }
+
+    /**
+     * Returns TRUE if feature geometries should be stored in the batch.
+     * \see setFetchGeometry()
+     */
+    bool fetchGeometry() const { return mFetchGeometry; }
+
+    /**
+     * Removes all features from the batch, keeping the columns and allocated buffers.
+     */
+    void clear();
+
+    //! Returns the number of features in the batch
+    int size() const { return static_cast< int >( mIds.size() ); }
+
+    //! Returns TRUE if the batch contains no features
+    bool isEmpty() const { return mIds.empty(); }
+
+    //! Returns the feature ID for the feature at \a row
+    QgsFeatureId id( int row ) const { return mIds[ row ]; }
+
+    //! Returns the number of columns in the batch
+    int columnCount() const { return mColumns.size(); }
+
+    //! Returns the column at the specified \a index
+    const Column &column( int index ) const { return mColumns.at( index ); }
+
+    /**
+     * Returns the index of the column containing values of the field at \a fieldIndex, or -1 if
+     * no column exists for the field.
+     */
+    int columnIndexForField( int fieldIndex ) const;
+
+    /**
+     * Returns TRUE if the feature at \a row has a geometry stored in the batch.
+     */
+    bool hasGeometry( int row ) const { return mWkbOffsets[ row + 1 ] > mWkbOffsets[ row ]; }
+
+    /**
+     * Returns a pointer to the WKB geometry for the feature at \a row, storing its length in \a size.
+     */
+    const unsigned char *wkb( int row, int &size ) const;
+
+    /**
+     * Returns the geometry for the feature at \a row.
+     */
+    QgsGeometry geometry( int row ) const;
+
+    /**
+     * Returns the feature at \a row, with attributes for the batch columns only.
+     * The attributes of the feature are sized to fit the largest field index of the batch columns.
+     */
+    QgsFeature feature( int row ) const;
+
+    /**
+     * Appends a \a feature to the batch, extracting the values for every column from its attributes.
+     * Values which cannot be converted to a column's type are stored as NULL.
+     */
+    void appendFeature( const QgsFeature &feature );
+
+    /**
+     * Starts a new feature with the specified \a id. This is intended for use by feature iterators
+     * which fill batches directly: a value must then be appended to every column, followed by
+     * appendGeometry() if fetchGeometry() is TRUE.
+     * \returns row of the new feature
+     */
+    int beginFeature( QgsFeatureId id );
+
+    //! Appends a NULL value to the column at \a column for the current feature
+    void appendNull( int column );
+
+    //! Appends a double \a value to the DoubleColumn at \a column for the current feature
+    void appendDouble( int column, double value );
+
+    //! Appends an integer \a value to the Int64Column at \a column for the current feature
+    void appendInt64( int column, qint64 value );
+
+    //! Appends a string \a value to the StringColumn at \a column for the current feature
+    void appendString( int column, const QString &value );
+
+    /**
+     * Appends a \a value to the column at \a column for the current feature, converting it to the column type.
+     * Values which cannot be converted are stored as NULL.
+     */
+    void appendValue( int column, const QVariant &value );
+
+    /**
+     * Appends the \a geometry for the current feature. Null geometries are stored as missing geometries.
+     */
+    void appendGeometry( const QgsGeometry &geometry );
+
+    /**
+     * Appends the geometry for the current feature from \a size bytes of \a wkb, which are copied
+     * without being parsed. A \a size of 0 stores a missing geometry.
+     */
+    void appendWkb( const char *wkb, int size );
+
+  private:
+
+    QVector< Column > mColumns;
+    std::vector< QgsFeatureId > mIds;
+    bool mFetchGeometry = false;
+
+    QByteArray mWkb;
+    std::vector< int > mWkbOffsets { 0 };
+};
+
+#endif // QGSFEATUREBATCH_H
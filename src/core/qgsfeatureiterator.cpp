@@ -13,12 +13,15 @@
  *                                                                         *
  ***************************************************************************/
 #include "qgsfeatureiterator.h"
+#include "qgsfeaturebatch.h"
 #include "qgslogger.h"
 
 #include "qgssimplifymethod.h"
 #include "qgsexception.h"
 #include "qgsexpressionsorter.h"
 
+#include <algorithm>
+
 QgsAbstractFeatureIterator::QgsAbstractFeatureIterator( const QgsFeatureRequest &request )
   : mRequest( request )
 {
@@ -71,6 +74,42 @@ bool QgsAbstractFeatureIterator::nextFeature( QgsFeature &f )
   return dataOk;
 }
 
+int QgsAbstractFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  batch.clear();
+
+  if ( mRequest.limit() >= 0 )
+    maxFeatures = static_cast< int >( std::min< long >( maxFeatures, mRequest.limit() - mFetchedCount ) );
+  if ( maxFeatures <= 0 )
+    return 0;
+
+  // only unfiltered requests can be filled directly by the provider, everything else
+  // needs the filtering applied by nextFeature()
+  if ( !mUseCachedFeatures && mRequest.filterType() == QgsFeatureRequest::FilterNone )
+  {
+    const int count = fetchBatch( batch, maxFeatures );
+    if ( count >= 0 )
+    {
+      mFetchedCount += count;
+      return count;
+    }
+  }
+
+  QgsFeature f;
+  int count = 0;
+  while ( count < maxFeatures && nextFeature( f ) )
+  {
+    batch.appendFeature( f );
+    count++;
+  }
+  return count;
+}
+
+int QgsAbstractFeatureIterator::fetchBatch( QgsFeatureBatch &, int )
+{
+  return -1;
+}
+
 bool QgsAbstractFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   while ( fetchFeature( f ) )
@@ -223,6 +262,16 @@ void QgsAbstractFeatureIterator::setInterruptionChecker( QgsFeedback * )
 
 ///////
 
+int QgsFeatureIterator::nextBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( !mIter )
+  {
+    batch.clear();
+    return 0;
+  }
+  return mIter->nextBatch( batch, maxFeatures );
+}
+
 QgsFeatureIterator &QgsFeatureIterator::operator=( const QgsFeatureIterator &other )
 {
   if ( this != &other )
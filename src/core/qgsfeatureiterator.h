@@ -20,6 +20,7 @@
 #include "qgsindexedfeature.h"
 
 class QgsFeedback;
+class QgsFeatureBatch;
 
 /**
  * \ingroup core
@@ -46,6 +47,19 @@ class CORE_EXPORT QgsAbstractFeatureIterator
     //! fetch next feature, return TRUE on success
     virtual bool nextFeature( QgsFeature &f );
 
+    /**
+     * Fetches up to \a maxFeatures of the next features into a columnar \a batch.
+     *
+     * Any existing features in \a batch are removed first, but its columns are kept.
+     * Iterators which implement fetchBatch() fill the batch directly, otherwise
+     * features are fetched one by one and appended to the batch.
+     *
+     * \returns the number of features added to the batch, or 0 if no more features are available
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    int nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     //! reset the iterator to the starting position
     virtual bool rewind() = 0;
     //! end of iterating: free the resources / lock
@@ -127,6 +141,24 @@ class CORE_EXPORT QgsAbstractFeatureIterator
      */
     virtual bool nextFeatureFilterFids( QgsFeature &f );
 
+    /**
+     * Fetches up to \a maxFeatures of the next features directly into a columnar \a batch.
+     *
+     * Iterators can implement this method to avoid creating a QgsFeature for every fetched
+     * feature. It is only called for requests without a filter (i.e. QgsFeatureRequest::FilterNone),
+     * and the iterator is responsible for applying any other request options, such as the filter
+     * rectangle.
+     *
+     * The default implementation returns -1, indicating that features must be fetched one by
+     * one via fetchFeature() instead. Implementations should also return -1 without modifying
+     * \a batch if they cannot handle the current request.
+     *
+     * \returns the number of features added to the batch, 0 if no more features are available or -1 if not supported
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    virtual int fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     /**
      * Transforms \a feature's geometry according to the specified coordinate \a transform.
      * If \a feature has no geometry or \a transform is invalid then calling this method
@@ -299,6 +331,29 @@ class CORE_EXPORT QgsFeatureIterator
     QgsFeatureIterator &operator=( const QgsFeatureIterator &other );
 
     bool nextFeature( QgsFeature &f );
+
+    /**
+     * Fetches up to \a maxFeatures of the next features into a columnar \a batch.
+     *
+     * Any existing features in \a batch are removed first, but its columns are kept, so
+     * the same batch can be reused for the whole iteration:
+     *
+     * \code{.cpp}
+     * QgsFeatureBatch batch( layer->fields(), QgsAttributeList() << fieldIndex );
+     * QgsFeatureIterator it = layer->getFeatures( QgsFeatureRequest().setFlags( QgsFeatureRequest::NoGeometry ).setSubsetOfAttributes( QgsAttributeList() << fieldIndex ) );
+     * while ( it.nextBatch( batch, 1000 ) )
+     * {
+     *   const QgsFeatureBatch::Column &column = batch.column( 0 );
+     *   ...
+     * }
+     * \endcode
+     *
+     * \returns the number of features added to the batch, or 0 if no more features are available
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    int nextBatch( QgsFeatureBatch &batch, int maxFeatures ) SIP_SKIP;
+
     bool rewind();
     bool close();
 
@@ -78,6 +78,20 @@ class CORE_EXPORT QgsMbTiles
      */
     void setTileData( int z, int x, int y, const QByteArray &data );
 
+    /**
+     * Starts a transaction. Adding many tiles within a single transaction is much faster
+     * than letting SQLite commit each insert. Returns TRUE on success.
+     * \see commitTransaction()
+     * \since QGIS 3.20
+     */
+    bool beginTransaction();
+
+    /**
+     * Commits the transaction started with beginTransaction(). Returns TRUE on success.
+     * \since QGIS 3.20
+     */
+    bool commitTransaction();
+
     //! Decodes gzip byte stream, returns true on success. Useful for reading vector tiles.
     static bool decodeGzip( const QByteArray &bytesIn, QByteArray &bytesOut );
     //! Encodes gzip byte stream, returns true on success. Useful for writing vector tiles.
@@ -407,6 +407,7 @@ bool QgsProperty::prepare( const QgsExpressionContext &context ) const
         return false;
       }
 
+      d->expression.compile();
       d->expressionPrepared = true;
       d->expressionIsInvalid = false;
       d->expressionReferencedCols = d->expression.referencedColumns();
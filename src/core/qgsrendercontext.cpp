@@ -59,6 +59,7 @@ QgsRenderContext::QgsRenderContext( const QgsRenderContext &rh )
   , mExpressionContext( rh.mExpressionContext )
   , mGeometry( rh.mGeometry )
   , mFeatureFilterProvider( rh.mFeatureFilterProvider ? rh.mFeatureFilterProvider->clone() : nullptr )
+  , mRenderFeatureCache( rh.mRenderFeatureCache )
   , mSegmentationTolerance( rh.mSegmentationTolerance )
   , mSegmentationToleranceType( rh.mSegmentationToleranceType )
   , mTransformContext( rh.mTransformContext )
@@ -97,6 +98,7 @@ QgsRenderContext &QgsRenderContext::operator=( const QgsRenderContext &rh )
   mExpressionContext = rh.mExpressionContext;
   mGeometry = rh.mGeometry;
   mFeatureFilterProvider.reset( rh.mFeatureFilterProvider ? rh.mFeatureFilterProvider->clone() : nullptr );
+  mRenderFeatureCache = rh.mRenderFeatureCache;
   mSegmentationTolerance = rh.mSegmentationTolerance;
   mSegmentationToleranceType = rh.mSegmentationToleranceType;
   mDistanceArea = rh.mDistanceArea;
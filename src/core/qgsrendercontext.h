@@ -44,6 +44,7 @@ class QgsRenderedFeatureHandlerInterface;
 class QgsSymbolLayer;
 class QgsMaskIdProvider;
 class QgsMapClippingRegion;
+class QgsRenderFeatureCache;
 
 
 /**
@@ -641,6 +642,24 @@ class CORE_EXPORT QgsRenderContext : public QgsTemporalRangeObject
      */
     const QgsFeatureFilterProvider *featureFilterProvider() const;
 
+    /**
+     * Sets a \a cache for features fetched while rendering vector layers, which may be
+     * shared with other renders. Ownership is not transferred.
+     * \see renderFeatureCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    void setRenderFeatureCache( QgsRenderFeatureCache *cache ) { mRenderFeatureCache = cache; } SIP_SKIP
+
+    /**
+     * Returns the cache for features fetched while rendering vector layers, or NULLPTR if
+     * features are always fetched from the layers.
+     * \see setRenderFeatureCache()
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    QgsRenderFeatureCache *renderFeatureCache() const { return mRenderFeatureCache; } SIP_SKIP
+
     /**
      * Sets the segmentation tolerance applied when rendering curved geometries
      * \param tolerance the segmentation tolerance
@@ -967,6 +986,8 @@ class CORE_EXPORT QgsRenderContext : public QgsTemporalRangeObject
     //! The feature filter provider
     std::unique_ptr< QgsFeatureFilterProvider > mFeatureFilterProvider;
 
+    QgsRenderFeatureCache *mRenderFeatureCache = nullptr;
+
     double mSegmentationTolerance = M_PI_2 / 90;
 
     QgsAbstractGeometry::SegmentationToleranceType mSegmentationToleranceType = QgsAbstractGeometry::MaximumAngle;
@@ -23,10 +23,17 @@
 #include "qgsfeaturesource.h"
 #include "qgsfeedback.h"
 #include "qgsspatialindexutils.h"
+#include "qgsproviderregistry.h"
 
 #include <spatialindex/SpatialIndex.h>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
 
 using namespace SpatialIndex;
 
@@ -88,6 +95,330 @@ class QgsSpatialIndexCopyVisitor : public SpatialIndex::IVisitor
     SpatialIndex::ISpatialIndex *mNewIndex = nullptr;
 };
 
+/**
+ * \ingroup core
+ * \class QgsSpatialIndexEntryCollector
+ * \brief Custom visitor that collects the identifiers and bounding regions of all entries.
+ * \note not available in Python bindings
+ */
+class QgsSpatialIndexEntryCollector : public SpatialIndex::IVisitor
+{
+  public:
+    void visitNode( const INode &n ) override
+    { Q_UNUSED( n ) }
+
+    void visitData( const IData &d ) override
+    {
+      SpatialIndex::IShape *shape = nullptr;
+      d.getShape( &shape );
+      SpatialIndex::Region region;
+      shape->getMBR( region );
+      delete shape;
+      entries.emplace_back( d.getIdentifier(), region );
+    }
+
+    void visitData( std::vector<const IData *> &v ) override
+    { Q_UNUSED( v ) }
+
+    std::vector< std::pair< SpatialIndex::id_type, SpatialIndex::Region > > entries;
+};
+
+/**
+ * \ingroup core
+ * \class QgsSpatialIndexEntryDataStream
+ * \brief Utility class for bulk loading of R-trees from previously collected entries. Not a part of public API.
+ * \note not available in Python bindings
+*/
+class QgsSpatialIndexEntryDataStream : public IDataStream
+{
+  public:
+    explicit QgsSpatialIndexEntryDataStream( const std::vector< std::pair< SpatialIndex::id_type, SpatialIndex::Region > > &entries )
+      : mEntries( entries )
+    {}
+
+    IData *getNext() override
+    {
+      if ( mIndex >= mEntries.size() )
+        return nullptr;
+
+      const auto &entry = mEntries[ mIndex++ ];
+      return new RTree::Data( 0, nullptr, entry.second, entry.first );
+    }
+
+    bool hasNext() override { return mIndex < mEntries.size(); }
+
+    uint32_t size() override { return static_cast< uint32_t >( mEntries.size() ); }
+
+    void rewind() override { mIndex = 0; }
+
+  private:
+    const std::vector< std::pair< SpatialIndex::id_type, SpatialIndex::Region > > &mEntries;
+    std::size_t mIndex = 0;
+};
+
+/**
+ * \ingroup core
+ * \class QgsSpatialIndexPageStorage
+ * \brief R-tree storage manager which can be written to and read from a portable index file.
+ *
+ * Pages read from a file are copied on demand from a memory mapping of the file, so only the
+ * pages touched by queries are ever loaded. Pages written by the R-tree (e.g. by inserting
+ * features into an index read from a file) are kept in memory and never written back to the file.
+ *
+ * \note not available in Python bindings
+ */
+class QgsSpatialIndexPageStorage : public SpatialIndex::IStorageManager
+{
+  public:
+
+    //! Magic number identifying portable spatial index files
+    static constexpr quint32 FILE_MAGIC = 0x51534958; // "QSIX"
+
+    //! Current file format version. Must be incremented whenever the file structure changes.
+    static constexpr quint32 FILE_VERSION = 1;
+
+    QgsSpatialIndexPageStorage() = default;
+
+    ~QgsSpatialIndexPageStorage() override
+    {
+      if ( mMap )
+        mFile.unmap( mMap );
+    }
+
+    QgsSpatialIndexPageStorage( const QgsSpatialIndexPageStorage &other ) = delete;
+    QgsSpatialIndexPageStorage &operator=( const QgsSpatialIndexPageStorage &other ) = delete;
+
+    void loadByteArray( const SpatialIndex::id_type page, uint32_t &len, uint8_t **data ) override
+    {
+      auto it = mPages.constFind( page );
+      if ( it != mPages.constEnd() )
+      {
+        len = static_cast< uint32_t >( it->size() );
+        *data = new uint8_t[len];
+        std::memcpy( *data, it->constData(), len );
+        return;
+      }
+
+      auto fileIt = mFilePages.constFind( page );
+      if ( fileIt != mFilePages.constEnd() )
+      {
+        len = fileIt->length;
+        *data = new uint8_t[len];
+        std::memcpy( *data, mMap + fileIt->offset, len );
+        return;
+      }
+
+      throw Tools::InvalidPageException( page );
+    }
+
+    void storeByteArray( SpatialIndex::id_type &page, const uint32_t len, const uint8_t *const data ) override
+    {
+      if ( page == StorageManager::NewPage )
+      {
+        page = mNextPage++;
+      }
+      else if ( !mPages.contains( page ) && !mFilePages.contains( page ) )
+      {
+        throw Tools::InvalidPageException( page );
+      }
+
+      // pages from the file are shadowed by the modified copy
+      mFilePages.remove( page );
+      mPages.insert( page, QByteArray( reinterpret_cast< const char * >( data ), static_cast< int >( len ) ) );
+    }
+
+    void deleteByteArray( const SpatialIndex::id_type page ) override
+    {
+      if ( mPages.remove( page ) == 0 && mFilePages.remove( page ) == 0 )
+        throw Tools::InvalidPageException( page );
+    }
+
+    void flush() override
+    {}
+
+    /**
+     * Writes all pages to a portable index file at \a path.
+     */
+    bool write( const QString &path, const QString &sourceKey, SpatialIndex::id_type indexId, QgsSpatialIndex::Flags flags,
+                const QHash< QgsFeatureId, QgsGeometry > &geometries, QString &error ) const
+    {
+      QSaveFile file( path );
+      if ( !file.open( QIODevice::WriteOnly ) )
+      {
+        error = QObject::tr( "Could not create index file %1: %2" ).arg( path, file.errorString() );
+        return false;
+      }
+
+      QList< SpatialIndex::id_type > pageIds = mPages.keys();
+      pageIds.append( mFilePages.keys() );
+      std::sort( pageIds.begin(), pageIds.end() );
+
+      QDataStream stream( &file );
+      stream.setVersion( QDataStream::Qt_5_0 );
+      stream << FILE_MAGIC << FILE_VERSION;
+      // page contents are stored using the native byte order of libspatialindex
+      stream << static_cast< quint8 >( QSysInfo::ByteOrder == QSysInfo::LittleEndian ? 1 : 0 );
+      stream << sourceKey << static_cast< qint64 >( indexId ) << static_cast< quint32 >( flags );
+
+      stream << static_cast< quint32 >( geometries.size() );
+      for ( auto it = geometries.constBegin(); it != geometries.constEnd(); ++it )
+      {
+        stream << static_cast< qint64 >( it.key() ) << it.value().asWkb();
+      }
+
+      stream << static_cast< quint32 >( pageIds.size() );
+      for ( SpatialIndex::id_type id : std::as_const( pageIds ) )
+      {
+        auto it = mPages.constFind( id );
+        const quint32 length = it != mPages.constEnd() ? static_cast< quint32 >( it->size() ) : mFilePages.value( id ).length;
+        stream << static_cast< qint64 >( id ) << length;
+      }
+
+      for ( SpatialIndex::id_type id : std::as_const( pageIds ) )
+      {
+        auto it = mPages.constFind( id );
+        if ( it != mPages.constEnd() )
+        {
+          stream.writeRawData( it->constData(), it->size() );
+        }
+        else
+        {
+          const FilePage filePage = mFilePages.value( id );
+          stream.writeRawData( reinterpret_cast< const char * >( mMap + filePage.offset ), static_cast< int >( filePage.length ) );
+        }
+      }
+
+      if ( stream.status() != QDataStream::Ok || !file.commit() )
+      {
+        error = QObject::tr( "Could not write index file %1: %2" ).arg( path, file.errorString() );
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * Opens the portable index file at \a path, which must have been written for the specified \a sourceKey.
+     */
+    bool open( const QString &path, const QString &sourceKey, SpatialIndex::id_type &indexId, QgsSpatialIndex::Flags &flags,
+               QHash< QgsFeatureId, QgsGeometry > &geometries, QString &error )
+    {
+      mFile.setFileName( path );
+      if ( !mFile.open( QIODevice::ReadOnly ) )
+      {
+        error = QObject::tr( "Could not open index file %1: %2" ).arg( path, mFile.errorString() );
+        return false;
+      }
+
+      QDataStream stream( &mFile );
+      stream.setVersion( QDataStream::Qt_5_0 );
+
+      quint32 magic = 0;
+      quint32 version = 0;
+      stream >> magic >> version;
+      if ( magic != FILE_MAGIC )
+      {
+        error = QObject::tr( "%1 is not a spatial index file" ).arg( path );
+        return false;
+      }
+      if ( version != FILE_VERSION )
+      {
+        error = QObject::tr( "Spatial index file %1 uses an unsupported format version (%2)" ).arg( path ).arg( version );
+        return false;
+      }
+
+      quint8 littleEndian = 0;
+      stream >> littleEndian;
+      if ( static_cast< bool >( littleEndian ) != ( QSysInfo::ByteOrder == QSysInfo::LittleEndian ) )
+      {
+        error = QObject::tr( "Spatial index file %1 was created on a platform with a different byte order" ).arg( path );
+        return false;
+      }
+
+      QString fileSourceKey;
+      qint64 fileIndexId = 0;
+      quint32 fileFlags = 0;
+      stream >> fileSourceKey >> fileIndexId >> fileFlags;
+      if ( fileSourceKey != sourceKey )
+      {
+        error = QObject::tr( "Spatial index file %1 is out of date" ).arg( path );
+        return false;
+      }
+      indexId = fileIndexId;
+      flags = QgsSpatialIndex::Flags( static_cast< int >( fileFlags ) );
+
+      quint32 geometryCount = 0;
+      stream >> geometryCount;
+      geometries.reserve( static_cast< int >( geometryCount ) );
+      for ( quint32 i = 0; i < geometryCount && stream.status() == QDataStream::Ok; ++i )
+      {
+        qint64 id = 0;
+        QByteArray wkb;
+        stream >> id >> wkb;
+        QgsGeometry geometry;
+        geometry.fromWkb( wkb );
+        geometries.insert( id, geometry );
+      }
+
+      quint32 pageCount = 0;
+      stream >> pageCount;
+      QVector< QPair< SpatialIndex::id_type, quint32 > > pageTable;
+      pageTable.reserve( static_cast< int >( pageCount ) );
+      for ( quint32 i = 0; i < pageCount && stream.status() == QDataStream::Ok; ++i )
+      {
+        qint64 id = 0;
+        quint32 length = 0;
+        stream >> id >> length;
+        pageTable << qMakePair( static_cast< SpatialIndex::id_type >( id ), length );
+      }
+
+      if ( stream.status() != QDataStream::Ok )
+      {
+        error = QObject::tr( "Spatial index file %1 is corrupt" ).arg( path );
+        return false;
+      }
+
+      // page data follows the page table
+      qint64 offset = mFile.pos();
+      for ( const auto &entry : std::as_const( pageTable ) )
+      {
+        mFilePages.insert( entry.first, FilePage{ offset, entry.second } );
+        mNextPage = std::max( mNextPage, entry.first + 1 );
+        offset += entry.second;
+      }
+
+      if ( offset > mFile.size() )
+      {
+        error = QObject::tr( "Spatial index file %1 is truncated" ).arg( path );
+        return false;
+      }
+
+      if ( offset > 0 )
+      {
+        mMap = mFile.map( 0, mFile.size() );
+        if ( !mMap )
+        {
+          error = QObject::tr( "Could not map index file %1: %2" ).arg( path, mFile.errorString() );
+          return false;
+        }
+      }
+      return true;
+    }
+
+  private:
+
+    struct FilePage
+    {
+      qint64 offset = 0;
+      quint32 length = 0;
+    };
+
+    QFile mFile;
+    uchar *mMap = nullptr;
+    QHash< SpatialIndex::id_type, FilePage > mFilePages;
+    QHash< SpatialIndex::id_type, QByteArray > mPages;
+    SpatialIndex::id_type mNextPage = 0;
+};
+
 ///@cond PRIVATE
 class QgsNearestNeighborComparator : public INearestNeighborComparator
 {
@@ -275,6 +606,19 @@ class QgsSpatialIndexData : public QSharedData
         mGeometries = fids.geometries;
     }
 
+    /**
+     * Constructor for QgsSpatialIndexData which uses an existing R-\a tree from a \a storage manager.
+     * Ownership of both \a storage and \a tree is transferred.
+     */
+    QgsSpatialIndexData( SpatialIndex::IStorageManager *storage, SpatialIndex::ISpatialIndex *tree, QgsSpatialIndex::Flags flags,
+                         const QHash< QgsFeatureId, QgsGeometry > &geometries )
+      : mFlags( flags )
+      , mGeometries( geometries )
+      , mStorage( storage )
+      , mRTree( tree )
+    {
+    }
+
     QgsSpatialIndexData( const QgsSpatialIndexData &other )
       : QSharedData( other )
       , mFlags( other.mFlags )
@@ -305,6 +649,16 @@ class QgsSpatialIndexData : public QSharedData
       // for now only memory manager
       mStorage = StorageManager::createNewMemoryStorageManager();
 
+      SpatialIndex::id_type indexId;
+      mRTree = createTree( *mStorage, inputStream, indexId );
+    }
+
+    /**
+     * Creates a new R-tree within the specified \a storage, optionally bulk loading it from
+     * an \a inputStream. The identifier of the created tree is stored in \a indexId.
+     */
+    static SpatialIndex::ISpatialIndex *createTree( SpatialIndex::IStorageManager &storage, IDataStream *inputStream, SpatialIndex::id_type &indexId )
+    {
       // R-Tree parameters
       double fillFactor = 0.7;
       unsigned long indexCapacity = 10;
@@ -313,14 +667,12 @@ class QgsSpatialIndexData : public QSharedData
       RTree::RTreeVariant variant = RTree::RV_RSTAR;
 
       // create R-tree
-      SpatialIndex::id_type indexId;
-
       if ( inputStream && inputStream->hasNext() )
-        mRTree = RTree::createAndBulkLoadNewRTree( RTree::BLM_STR, *inputStream, *mStorage, fillFactor, indexCapacity,
-                 leafCapacity, dimension, variant, indexId );
+        return RTree::createAndBulkLoadNewRTree( RTree::BLM_STR, *inputStream, storage, fillFactor, indexCapacity,
+               leafCapacity, dimension, variant, indexId );
       else
-        mRTree = RTree::createNewRTree( *mStorage, fillFactor, indexCapacity,
-                                        leafCapacity, dimension, variant, indexId );
+        return RTree::createNewRTree( storage, fillFactor, indexCapacity,
+                                      leafCapacity, dimension, variant, indexId );
     }
 
     //! Storage manager
@@ -563,3 +915,93 @@ QAtomicInt QgsSpatialIndex::refs() const
 {
   return d->ref;
 }
+
+bool QgsSpatialIndex::writeToFile( const QString &path, const QString &sourceKey, QString *errorMessage ) const
+{
+  QMutexLocker locker( &d->mMutex );
+
+  // collect all entries from the existing tree...
+  QgsSpatialIndexEntryCollector collector;
+  double low[]  = { std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() };
+  double high[] = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max() };
+  SpatialIndex::Region query( low, high, 2 );
+
+  QString error;
+  try
+  {
+    d->mRTree->intersectsWithQuery( query, collector );
+
+    // ... and bulk load them into a fresh tree in portable storage. This also gives an optimally packed
+    // tree, regardless of how the original index was built
+    QgsSpatialIndexPageStorage storage;
+    SpatialIndex::id_type indexId = 0;
+    {
+      QgsSpatialIndexEntryDataStream stream( collector.entries );
+      // the tree header is only stored when the tree is destroyed
+      std::unique_ptr< SpatialIndex::ISpatialIndex > tree( QgsSpatialIndexData::createTree( storage, &stream, indexId ) );
+    }
+
+    if ( storage.write( path, sourceKey, indexId, d->mFlags, d->mGeometries, error ) )
+      return true;
+  }
+  catch ( Tools::Exception &e )
+  {
+    error = QObject::tr( "Could not write spatial index: %1" ).arg( QString::fromStdString( e.what() ) );
+  }
+  catch ( const std::exception &e )
+  {
+    error = QObject::tr( "Could not write spatial index: %1" ).arg( QString::fromLatin1( e.what() ) );
+  }
+
+  if ( errorMessage )
+    *errorMessage = error;
+  return false;
+}
+
+QgsSpatialIndex QgsSpatialIndex::fromFile( const QString &path, const QString &sourceKey, bool *ok, QString *errorMessage )
+{
+  if ( ok )
+    *ok = false;
+
+  std::unique_ptr< QgsSpatialIndexPageStorage > storage = std::make_unique< QgsSpatialIndexPageStorage >();
+  SpatialIndex::id_type indexId = 0;
+  QgsSpatialIndex::Flags flags;
+  QHash< QgsFeatureId, QgsGeometry > geometries;
+  QString error;
+  if ( !storage->open( path, sourceKey, indexId, flags, geometries, error ) )
+  {
+    if ( errorMessage )
+      *errorMessage = error;
+    return QgsSpatialIndex();
+  }
+
+  std::unique_ptr< SpatialIndex::ISpatialIndex > tree;
+  try
+  {
+    tree.reset( RTree::loadRTree( *storage, indexId ) );
+  }
+  catch ( Tools::Exception &e )
+  {
+    if ( errorMessage )
+      *errorMessage = QObject::tr( "Spatial index file %1 is corrupt: %2" ).arg( path, QString::fromStdString( e.what() ) );
+    return QgsSpatialIndex();
+  }
+
+  QgsSpatialIndex index;
+  index.d = new QgsSpatialIndexData( storage.release(), tree.release(), flags, geometries );
+
+  if ( ok )
+    *ok = true;
+  return index;
+}
+
+QString QgsSpatialIndex::indexSourceKey( const QString &providerKey, const QString &uri )
+{
+  const QVariantMap parts = QgsProviderRegistry::instance()->decodeUri( providerKey, uri );
+  const QString path = parts.value( QStringLiteral( "path" ) ).toString();
+  const QFileInfo fi( path );
+  if ( path.isEmpty() || !fi.exists() )
+    return QStringLiteral( "%1:%2" ).arg( providerKey, uri );
+
+  return QStringLiteral( "%1:%2:%3:%4" ).arg( providerKey, uri ).arg( fi.lastModified().toMSecsSinceEpoch() ).arg( fi.size() );
+}
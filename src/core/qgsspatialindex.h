@@ -265,6 +265,59 @@ class CORE_EXPORT QgsSpatialIndex : public QgsFeatureSink
     % End
 #endif
 
+    /* persistence */
+
+    /**
+     * Writes the index to a portable index file at the specified \a path.
+     *
+     * The \a sourceKey argument should uniquely identify the source (and revision of the source)
+     * which the index was built from, e.g. by using indexSourceKey(). The same key must be passed
+     * to fromFile() in order to open the index again, which prevents stale indexes from being used
+     * after the source has changed.
+     *
+     * If the index was created with the FlagStoreFeatureGeometries flag, the stored geometries
+     * are written to the file too.
+     *
+     * Returns TRUE if the index was successfully written. If not, \a errorMessage will
+     * be set to a descriptive error.
+     *
+     * \see fromFile()
+     * \since QGIS 3.20
+     */
+    bool writeToFile( const QString &path, const QString &sourceKey = QString(), QString *errorMessage SIP_OUT = nullptr ) const;
+
+    /**
+     * Opens a portable index file previously created with writeToFile() from the specified \a path.
+     *
+     * The file is memory mapped, and index pages are only read when they are required by
+     * queries, so opening even very large indexes is cheap. The file itself is never modified --
+     * any features added to or removed from the returned index are kept in memory only.
+     *
+     * The \a sourceKey must match the key used when the file was written, otherwise the
+     * index is considered out of date and will not be opened.
+     *
+     * If the file could not be opened, \a ok will be set to FALSE, \a errorMessage will be set to a
+     * descriptive error and an empty index is returned.
+     *
+     * \see writeToFile()
+     * \see indexSourceKey()
+     * \since QGIS 3.20
+     */
+    static QgsSpatialIndex fromFile( const QString &path, const QString &sourceKey = QString(), bool *ok SIP_OUT = nullptr, QString *errorMessage SIP_OUT = nullptr );
+
+    /**
+     * Returns a key identifying the data source with the specified \a providerKey and \a uri,
+     * for use with writeToFile() and fromFile().
+     *
+     * For file based sources, the key includes the modification time and size of the file, so that
+     * indexes written for the source are automatically invalidated when the file changes. For other
+     * sources, the key only depends on the provider and URI, and it is the caller's responsibility
+     * to discard index files when the source changes.
+     *
+     * \since QGIS 3.20
+     */
+    static QString indexSourceKey( const QString &providerKey, const QString &uri );
+
     /* debugging */
 
     //! Gets reference count - just for debugging!
@@ -22,6 +22,9 @@
 #include "qgscoordinatetransform.h"
 #include "qgsexception.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 Q_NOWARN_DEPRECATED_PUSH // because of deprecated members
 QgsRasterProjector::QgsRasterProjector()
   : QgsRasterInterface( nullptr )
@@ -30,6 +33,7 @@ QgsRasterProjector::QgsRasterProjector()
 }
 Q_NOWARN_DEPRECATED_POP
 
+QgsRasterProjector::~QgsRasterProjector() = default;
 
 QgsRasterProjector *QgsRasterProjector::clone() const
 {
@@ -65,6 +69,41 @@ Qgis::DataType QgsRasterProjector::dataType( int bandNo ) const
 
 /// @cond PRIVATE
 
+// Blocks with fewer destination pixels are reprojected in the calling thread
+static const qgssize PARALLEL_MIN_PIXELS = 100000;
+
+//! Range of destination rows processed by a thread
+struct RowBand
+{
+  int startRow;
+  int endRow;
+};
+
+/**
+ * Calls \a function for bands of consecutive rows covering a block of \a width by \a height pixels,
+ * from several threads if \a allowThreads is TRUE and the block is large enough.
+ */
+template <typename Function>
+static void forEachRowBand( int width, int height, bool allowThreads, const Function &function )
+{
+  const int bandCount = allowThreads && static_cast< qgssize >( width ) * height >= PARALLEL_MIN_PIXELS ?
+                        std::min( height, std::max( 1, QThread::idealThreadCount() ) ) : 1;
+  if ( bandCount <= 1 )
+  {
+    function( RowBand{ 0, height } );
+    return;
+  }
+
+  std::vector< RowBand > bands;
+  bands.reserve( bandCount );
+  for ( int band = 0; band < bandCount; ++band )
+  {
+    //make sure last band goes to end of block
+    bands.push_back( RowBand{ band * ( height / bandCount ), band < bandCount - 1 ? ( band + 1 ) * ( height / bandCount ) : height } );
+  }
+  QtConcurrent::blockingMap( bands, function );
+}
+
 void QgsRasterProjector::setCrs( const QgsCoordinateReferenceSystem &srcCRS,
                                  const QgsCoordinateReferenceSystem &destCRS,
                                  int srcDatumTransform,
@@ -76,6 +115,7 @@ void QgsRasterProjector::setCrs( const QgsCoordinateReferenceSystem &srcCRS,
   mSrcDatumTransform = srcDatumTransform;
   mDestDatumTransform = destDatumTransform;
   Q_NOWARN_DEPRECATED_POP
+  mLastData.reset();
 }
 
 void QgsRasterProjector::setCrs( const QgsCoordinateReferenceSystem &srcCRS, const QgsCoordinateReferenceSystem &destCRS, QgsCoordinateTransformContext transformContext )
@@ -87,12 +127,15 @@ void QgsRasterProjector::setCrs( const QgsCoordinateReferenceSystem &srcCRS, con
   mSrcDatumTransform = -1;
   mDestDatumTransform = -1;
   Q_NOWARN_DEPRECATED_POP
+  mLastData.reset();
 }
 
 
 ProjectorData::ProjectorData( const QgsRectangle &extent, int width, int height, QgsRasterInterface *input, const QgsCoordinateTransform &inverseCt, QgsRasterProjector::Precision precision, QgsRasterBlockFeedback *feedback )
   : mApproximate( false )
   , mInverseCt( inverseCt )
+  , mInput( input )
+  , mPrecision( precision )
   , mDestExtent( extent )
   , mDestRows( height )
   , mDestCols( width )
@@ -104,7 +147,6 @@ ProjectorData::ProjectorData( const QgsRectangle &extent, int width, int height,
   , mSrcYRes( 0.0 )
   , mDestRowsPerMatrixRow( 0.0 )
   , mDestColsPerMatrixCol( 0.0 )
-  , mHelperTopRow( 0 )
   , mCPCols( 0 )
   , mCPRows( 0 )
   , mSqrTolerance( 0.0 )
@@ -218,13 +260,6 @@ ProjectorData::ProjectorData( const QgsRectangle &extent, int width, int height,
   QgsDebugMsgLevel( cpToString(), 5 );
 #endif
 
-  // init helper points
-  pHelperTop = new QgsPointXY[mDestCols];
-  pHelperBottom = new QgsPointXY[mDestCols];
-  calcHelper( 0, pHelperTop );
-  calcHelper( 1, pHelperBottom );
-  mHelperTopRow = 0;
-
   // Calculate source dimensions
   calcSrcExtent();
   calcSrcRowsCols();
@@ -232,10 +267,9 @@ ProjectorData::ProjectorData( const QgsRectangle &extent, int width, int height,
   mSrcXRes = mSrcExtent.width() / mSrcCols;
 }
 
-ProjectorData::~ProjectorData()
+bool ProjectorData::isSameRequest( const QgsRasterInterface *input, const QgsRectangle &extent, int width, int height, QgsRasterProjector::Precision precision ) const
 {
-  delete[] pHelperTop;
-  delete[] pHelperBottom;
+  return input == mInput && extent == mDestExtent && width == mDestCols && height == mDestRows && precision == mPrecision;
 }
 
 
@@ -402,24 +436,25 @@ void ProjectorData::calcSrcRowsCols()
 }
 
 
-inline void ProjectorData::destPointOnCPMatrix( int row, int col, double *theX, double *theY )
+inline void ProjectorData::destPointOnCPMatrix( int row, int col, double *theX, double *theY ) const
 {
   *theX = mDestExtent.xMinimum() + col * mDestExtent.width() / ( mCPCols - 1 );
   *theY = mDestExtent.yMaximum() - row * mDestExtent.height() / ( mCPRows - 1 );
 }
 
-inline int ProjectorData::matrixRow( int destRow )
+inline int ProjectorData::matrixRow( int destRow ) const
 {
   return static_cast< int >( std::floor( ( destRow + 0.5 ) / mDestRowsPerMatrixRow ) );
 }
-inline int ProjectorData::matrixCol( int destCol )
+inline int ProjectorData::matrixCol( int destCol ) const
 {
   return static_cast< int >( std::floor( ( destCol + 0.5 ) / mDestColsPerMatrixCol ) );
 }
 
-void ProjectorData::calcHelper( int matrixRow, QgsPointXY *points )
+void ProjectorData::calcHelper( int matrixRow, double *x, double *y ) const
 {
   // TODO?: should we also precalc dest cell center coordinates for x and y?
+  const QList<QgsPointXY> &cpRow = mCPMatrix.at( matrixRow );
   for ( int myDestCol = 0; myDestCol < mDestCols; myDestCol++ )
   {
     double myDestX = mDestExtent.xMinimum() + ( myDestCol + 0.5 ) * mDestXRes;
@@ -433,150 +468,139 @@ void ProjectorData::calcHelper( int matrixRow, QgsPointXY *points )
 
     double xfrac = ( myDestX - myDestXMin ) / ( myDestXMax - myDestXMin );
 
-    QgsPointXY &mySrcPoint0 = mCPMatrix[matrixRow][myMatrixCol];
-    QgsPointXY &mySrcPoint1 = mCPMatrix[matrixRow][myMatrixCol + 1];
-    double s = mySrcPoint0.x() + ( mySrcPoint1.x() - mySrcPoint0.x() ) * xfrac;
-    double t = mySrcPoint0.y() + ( mySrcPoint1.y() - mySrcPoint0.y() ) * xfrac;
-
-    points[myDestCol].setX( s );
-    points[myDestCol].setY( t );
+    const QgsPointXY &mySrcPoint0 = cpRow.at( myMatrixCol );
+    const QgsPointXY &mySrcPoint1 = cpRow.at( myMatrixCol + 1 );
+    x[myDestCol] = mySrcPoint0.x() + ( mySrcPoint1.x() - mySrcPoint0.x() ) * xfrac;
+    y[myDestCol] = mySrcPoint0.y() + ( mySrcPoint1.y() - mySrcPoint0.y() ) * xfrac;
   }
 }
 
-void ProjectorData::nextHelper()
+bool ProjectorData::calcSrcIndexes( QgsRasterBlockFeedback *feedback )
 {
-  // We just switch pHelperTop and pHelperBottom, memory is not lost
-  QgsPointXY *tmp = nullptr;
-  tmp = pHelperTop;
-  pHelperTop = pHelperBottom;
-  pHelperBottom = tmp;
-  calcHelper( mHelperTopRow + 2, pHelperBottom );
-  mHelperTopRow++;
-}
+  mSrcIndexes.resize( static_cast< size_t >( mDestRows ) * mDestCols );
 
-bool ProjectorData::srcRowCol( int destRow, int destCol, int *srcRow, int *srcCol )
-{
-  if ( mApproximate )
+  // Rows are independent, so bands of rows can be calculated concurrently
+  int *indexes = mSrcIndexes.data();
+  forEachRowBand( mDestCols, mDestRows, true, [this, indexes, feedback]( const RowBand & band )
   {
-    return approximateSrcRowCol( destRow, destCol, srcRow, srcCol );
-  }
-  else
-  {
-    return preciseSrcRowCol( destRow, destCol, srcRow, srcCol );
-  }
+    calcSrcIndexes( band.startRow, band.endRow, indexes + static_cast< qgssize >( band.startRow ) * mDestCols, feedback );
+  } );
+
+  return !feedback || !feedback->isCanceled();
 }
 
-bool ProjectorData::preciseSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol )
+inline int ProjectorData::srcIndex( double x, double y ) const
 {
-#if 0 // too slow, even if we only run it on debug builds!
-  QgsDebugMsgLevel( QStringLiteral( "theDestRow = %1" ).arg( destRow ), 5 );
-  QgsDebugMsgLevel( QStringLiteral( "theDestRow = %1 mDestExtent.yMaximum() = %2 mDestYRes = %3" ).arg( destRow ).arg( mDestExtent.yMaximum() ).arg( mDestYRes ), 5 );
-#endif
-
-  // Get coordinate of center of destination cell
-  double x = mDestExtent.xMinimum() + ( destCol + 0.5 ) * mDestXRes;
-  double y = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
-  double z = 0;
-
-#if 0
-  QgsDebugMsgLevel( QStringLiteral( "x = %1 y = %2" ).arg( x ).arg( y ), 5 );
-#endif
-
-  if ( mInverseCt.isValid() )
+  if ( !mExtent.contains( x, y ) )
   {
-    try
-    {
-      mInverseCt.transformInPlace( x, y, z );
-    }
-    catch ( QgsCsException & )
-    {
-      return false;
-    }
+    return -1;
   }
 
-#if 0
-  QgsDebugMsgLevel( QStringLiteral( "x = %1 y = %2" ).arg( x ).arg( y ), 5 );
-#endif
+  // TODO: check again cell selection (coor is in the middle)
 
-  if ( !mExtent.contains( x, y ) )
-  {
-    return false;
-  }
-  // Get source row col
-  *srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - y ) / mSrcYRes ) );
-  *srcCol = static_cast< int >( std::floor( ( x - mSrcExtent.xMinimum() ) / mSrcXRes ) );
-#if 0
-  QgsDebugMsgLevel( QStringLiteral( "mSrcExtent.yMinimum() = %1 mSrcExtent.yMaximum() = %2 mSrcYRes = %3" ).arg( mSrcExtent.yMinimum() ).arg( mSrcExtent.yMaximum() ).arg( mSrcYRes ), 5 );
-  QgsDebugMsgLevel( QStringLiteral( "theSrcRow = %1 srcCol = %2" ).arg( *srcRow ).arg( *srcCol ), 5 );
-#endif
+  const int srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - y ) / mSrcYRes ) );
+  const int srcCol = static_cast< int >( std::floor( ( x - mSrcExtent.xMinimum() ) / mSrcXRes ) );
 
-  // With epsg 32661 (Polar Stereographic) it was happening that *srcCol == mSrcCols
+  // With epsg 32661 (Polar Stereographic) it was happening that srcCol == mSrcCols
   // For now silently correct limits to avoid crashes
   // TODO: review
   // should not happen
-  if ( *srcRow >= mSrcRows ) return false;
-  if ( *srcRow < 0 ) return false;
-  if ( *srcCol >= mSrcCols ) return false;
-  if ( *srcCol < 0 ) return false;
+  if ( srcRow >= mSrcRows ) return -1;
+  if ( srcRow < 0 ) return -1;
+  if ( srcCol >= mSrcCols ) return -1;
+  if ( srcCol < 0 ) return -1;
 
-  return true;
+  return srcRow * mSrcCols + srcCol;
 }
 
-bool ProjectorData::approximateSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol )
+void ProjectorData::calcSrcIndexes( int startRow, int endRow, int *indexes, QgsFeedback *feedback ) const
 {
-  int myMatrixRow = matrixRow( destRow );
-  int myMatrixCol = matrixCol( destCol );
-
-  if ( myMatrixRow > mHelperTopRow )
+  if ( !mApproximate )
   {
-    // TODO: make it more robust (for random, not sequential reading)
-    nextHelper();
-  }
-
-  double myDestY = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
-
-  // See the schema in javax.media.jai.WarpGrid doc (but up side down)
-  // TODO: use some kind of cache of values which can be reused
-  double myDestXMin, myDestYMin, myDestXMax, myDestYMax;
-
-  destPointOnCPMatrix( myMatrixRow + 1, myMatrixCol, &myDestXMin, &myDestYMin );
-  destPointOnCPMatrix( myMatrixRow, myMatrixCol + 1, &myDestXMax, &myDestYMax );
-
-  double yfrac = ( myDestY - myDestYMin ) / ( myDestYMax - myDestYMin );
-
-  QgsPointXY &myTop = pHelperTop[destCol];
-  QgsPointXY &myBot = pHelperBottom[destCol];
-
-  // Warning: this is very SLOW compared to the following code!:
-  //double mySrcX = myBot.x() + (myTop.x() - myBot.x()) * yfrac;
-  //double mySrcY = myBot.y() + (myTop.y() - myBot.y()) * yfrac;
+    // Each thread uses its own copy of the transform
+    const QgsCoordinateTransform inverseCt = mInverseCt;
+    for ( int destRow = startRow; destRow < endRow; ++destRow )
+    {
+      if ( feedback && feedback->isCanceled() )
+        return;
 
-  double tx = myTop.x();
-  double ty = myTop.y();
-  double bx = myBot.x();
-  double by = myBot.y();
-  double mySrcX = bx + ( tx - bx ) * yfrac;
-  double mySrcY = by + ( ty - by ) * yfrac;
+      for ( int destCol = 0; destCol < mDestCols; ++destCol )
+      {
+        // Get coordinate of center of destination cell
+        double x = mDestExtent.xMinimum() + ( destCol + 0.5 ) * mDestXRes;
+        double y = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
+        double z = 0;
 
-  if ( !mExtent.contains( mySrcX, mySrcY ) )
-  {
-    return false;
+        bool transformed = true;
+        if ( inverseCt.isValid() )
+        {
+          try
+          {
+            inverseCt.transformInPlace( x, y, z );
+          }
+          catch ( QgsCsException & )
+          {
+            transformed = false;
+          }
+        }
+        *indexes++ = transformed ? srcIndex( x, y ) : -1;
+      }
+    }
+    return;
   }
 
-  // TODO: check again cell selection (coor is in the middle)
+  // Source points for each destination column, interpolated on the CPMatrix grid rows above (top)
+  // and below (bottom) the destination row, and then on the destination row itself.
+  // x and y are kept in separate arrays so that the interpolation loop can be vectorized.
+  std::vector< double > topX( mDestCols ), topY( mDestCols );
+  std::vector< double > bottomX( mDestCols ), bottomY( mDestCols );
+  std::vector< double > srcX( mDestCols ), srcY( mDestCols );
+  int helperTopRow = -1;
 
-  *srcRow = static_cast< int >( std::floor( ( mSrcExtent.yMaximum() - mySrcY ) / mSrcYRes ) );
-  *srcCol = static_cast< int >( std::floor( ( mySrcX - mSrcExtent.xMinimum() ) / mSrcXRes ) );
+  for ( int destRow = startRow; destRow < endRow; ++destRow )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
 
-  // For now silently correct limits to avoid crashes
-  // TODO: review
-  // should not happen
-  if ( *srcRow >= mSrcRows ) return false;
-  if ( *srcRow < 0 ) return false;
-  if ( *srcCol >= mSrcCols ) return false;
-  if ( *srcCol < 0 ) return false;
+    const int myMatrixRow = matrixRow( destRow );
+    if ( myMatrixRow == helperTopRow + 1 && helperTopRow >= 0 )
+    {
+      // We just switch the top and bottom helpers, the previous bottom row is the new top row
+      std::swap( topX, bottomX );
+      std::swap( topY, bottomY );
+      calcHelper( myMatrixRow + 1, bottomX.data(), bottomY.data() );
+    }
+    else if ( myMatrixRow != helperTopRow )
+    {
+      calcHelper( myMatrixRow, topX.data(), topY.data() );
+      calcHelper( myMatrixRow + 1, bottomX.data(), bottomY.data() );
+    }
+    helperTopRow = myMatrixRow;
+
+    // See the schema in javax.media.jai.WarpGrid doc (but up side down)
+    const double myDestY = mDestExtent.yMaximum() - ( destRow + 0.5 ) * mDestYRes;
+    double myDestX, myDestYMin, myDestYMax;
+    destPointOnCPMatrix( myMatrixRow + 1, 0, &myDestX, &myDestYMin );
+    destPointOnCPMatrix( myMatrixRow, 0, &myDestX, &myDestYMax );
+    const double yfrac = ( myDestY - myDestYMin ) / ( myDestYMax - myDestYMin );
+
+    const double *tx = topX.data();
+    const double *ty = topY.data();
+    const double *bx = bottomX.data();
+    const double *by = bottomY.data();
+    double *sx = srcX.data();
+    double *sy = srcY.data();
+    for ( int destCol = 0; destCol < mDestCols; ++destCol )
+    {
+      sx[destCol] = bx[destCol] + ( tx[destCol] - bx[destCol] ) * yfrac;
+      sy[destCol] = by[destCol] + ( ty[destCol] - by[destCol] ) * yfrac;
+    }
 
-  return true;
+    for ( int destCol = 0; destCol < mDestCols; ++destCol )
+    {
+      *indexes++ = srcIndex( sx[destCol], sy[destCol] );
+    }
+  }
 }
 
 void ProjectorData::insertRows( const QgsCoordinateTransform &ct )
@@ -792,27 +816,40 @@ QgsRasterBlock *QgsRasterProjector::block( int bandNo, QgsRectangle  const &exte
     return mInput->block( bandNo, extent, width, height, feedback );
   }
 
-  Q_NOWARN_DEPRECATED_PUSH
-  const QgsCoordinateTransform inverseCt = mSrcDatumTransform != -1 || mDestDatumTransform != -1 ?
-      QgsCoordinateTransform( mDestCRS, mSrcCRS, mDestDatumTransform, mSrcDatumTransform ) : QgsCoordinateTransform( mDestCRS, mSrcCRS, mTransformContext ) ;
-  Q_NOWARN_DEPRECATED_POP
+  // The source pixel of each destination pixel is calculated once, and reused when the same
+  // block is requested again, e.g. for each band when writing a reprojected raster
+  if ( !mLastData || !mLastData->isSameRequest( mInput, extent, width, height, mPrecision ) )
+  {
+    mLastData.reset();
 
-  ProjectorData pd( extent, width, height, mInput, inverseCt, mPrecision, feedback );
+    Q_NOWARN_DEPRECATED_PUSH
+    const QgsCoordinateTransform inverseCt = mSrcDatumTransform != -1 || mDestDatumTransform != -1 ?
+        QgsCoordinateTransform( mDestCRS, mSrcCRS, mDestDatumTransform, mSrcDatumTransform ) : QgsCoordinateTransform( mDestCRS, mSrcCRS, mTransformContext ) ;
+    Q_NOWARN_DEPRECATED_POP
 
-  if ( feedback && feedback->isCanceled() )
-    return new QgsRasterBlock();
+    std::unique_ptr< ProjectorData > data = std::make_unique< ProjectorData >( extent, width, height, mInput, inverseCt, mPrecision, feedback );
 
-  QgsDebugMsgLevel( QStringLiteral( "srcExtent:\n%1" ).arg( pd.srcExtent().toString() ), 4 );
-  QgsDebugMsgLevel( QStringLiteral( "srcCols = %1 srcRows = %2" ).arg( pd.srcCols() ).arg( pd.srcRows() ), 4 );
+    if ( feedback && feedback->isCanceled() )
+      return new QgsRasterBlock();
 
-  // If we zoom out too much, projector srcRows / srcCols maybe 0, which can cause problems in providers
-  if ( pd.srcRows() <= 0 || pd.srcCols() <= 0 )
-  {
-    QgsDebugMsgLevel( QStringLiteral( "Zero srcRows or srcCols" ), 4 );
-    return new QgsRasterBlock();
+    QgsDebugMsgLevel( QStringLiteral( "srcExtent:\n%1" ).arg( data->srcExtent().toString() ), 4 );
+    QgsDebugMsgLevel( QStringLiteral( "srcCols = %1 srcRows = %2" ).arg( data->srcCols() ).arg( data->srcRows() ), 4 );
+
+    // If we zoom out too much, projector srcRows / srcCols maybe 0, which can cause problems in providers
+    if ( data->srcRows() <= 0 || data->srcCols() <= 0 )
+    {
+      QgsDebugMsgLevel( QStringLiteral( "Zero srcRows or srcCols" ), 4 );
+      return new QgsRasterBlock();
+    }
+
+    if ( !data->calcSrcIndexes( feedback ) )
+      return new QgsRasterBlock();
+
+    mLastData = std::move( data );
   }
+  const ProjectorData *pd = mLastData.get();
 
-  std::unique_ptr< QgsRasterBlock > inputBlock( mInput->block( bandNo, pd.srcExtent(), pd.srcCols(), pd.srcRows(), feedback ) );
+  std::unique_ptr< QgsRasterBlock > inputBlock( mInput->block( bandNo, pd->srcExtent(), pd->srcCols(), pd->srcRows(), feedback ) );
   if ( !inputBlock || inputBlock->isEmpty() )
   {
     QgsDebugMsg( QStringLiteral( "No raster data!" ) );
@@ -849,42 +886,44 @@ QgsRasterBlock *QgsRasterProjector::block( int bandNo, QgsRectangle  const &exte
 
   outputBlock->setIsNoData();
 
-  int srcRow, srcCol;
-  for ( int i = 0; i < height; ++i )
+  const char *srcBits = inputBlock->bits();
+  char *destBits = outputBlock->bits();
+  if ( !srcBits || !destBits )
   {
-    if ( feedback && feedback->isCanceled() )
-      break;
-    for ( int j = 0; j < width; ++j )
-    {
-      bool inside = pd.srcRowCol( i, j, &srcRow, &srcCol );
-      if ( !inside ) continue; // we have everything set to no data
-
-      qgssize srcIndex = static_cast< qgssize >( srcRow * pd.srcCols() + srcCol );
+    QgsDebugMsg( QStringLiteral( "Cannot get block data" ) );
+    return outputBlock.release();
+  }
+  const qgssize srcSize = static_cast< qgssize >( inputBlock->width() ) * inputBlock->height();
+  const int srcCols = pd->srcCols();
+  const int *srcIndexes = pd->srcIndexes();
 
-      // isNoData() may be slow so we check doNoData first
-      if ( doNoData && inputBlock->isNoData( srcRow, srcCol ) )
+  // Each thread copies whole destination rows, which don't share bytes of the no data bitmap.
+  // setIsNoData() may have to create the bitmap though, so that case is not threaded.
+  forEachRowBand( width, height, !doNoData, [ =, &inputBlock, &outputBlock]( const RowBand & band )
+  {
+    for ( int i = band.startRow; i < band.endRow; ++i )
+    {
+      if ( feedback && feedback->isCanceled() )
+        break;
+      for ( int j = 0; j < width; ++j )
       {
-        outputBlock->setIsNoData( i, j );
-        continue;
-      }
+        qgssize destIndex = static_cast< qgssize >( i ) * width + j;
+        const int srcIndex = srcIndexes[destIndex];
+        if ( srcIndex < 0 || static_cast< qgssize >( srcIndex ) >= srcSize )
+          continue; // we have everything set to no data
 
-      qgssize destIndex = static_cast< qgssize >( i * width + j );
-      char *srcBits = inputBlock->bits( srcIndex );
-      char *destBits = outputBlock->bits( destIndex );
-      if ( !srcBits )
-      {
-        // QgsDebugMsg( QStringLiteral( "Cannot get input block data: row = %1 col = %2" ).arg( i ).arg( j ) );
-        continue;
-      }
-      if ( !destBits )
-      {
-        // QgsDebugMsg( QStringLiteral( "Cannot set output block data: srcRow = %1 srcCol = %2" ).arg( srcRow ).arg( srcCol ) );
-        continue;
+        // isNoData() may be slow so we check doNoData first
+        if ( doNoData && inputBlock->isNoData( srcIndex / srcCols, srcIndex % srcCols ) )
+        {
+          outputBlock->setIsNoData( i, j );
+          continue;
+        }
+
+        memcpy( destBits + destIndex * pixelSize, srcBits + static_cast< qgssize >( srcIndex ) * pixelSize, pixelSize );
+        outputBlock->setIsData( i, j );
       }
-      memcpy( destBits, srcBits, pixelSize );
-      outputBlock->setIsData( i, j );
     }
-  }
+  } );
 
   return outputBlock.release();
 }
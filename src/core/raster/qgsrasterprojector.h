@@ -34,8 +34,13 @@
 #include "qgsrasterinterface.h"
 
 #include <cmath>
+#include <memory>
+#include <vector>
 
 class QgsPointXY;
+#ifndef SIP_RUN
+class ProjectorData;
+#endif
 
 /**
  * \ingroup core
@@ -62,6 +67,7 @@ class CORE_EXPORT QgsRasterProjector : public QgsRasterInterface
     Q_ENUM( Precision )
 
     QgsRasterProjector();
+    ~QgsRasterProjector() override;
 
     QgsRasterProjector *clone() const override SIP_FACTORY;
 
@@ -124,6 +130,9 @@ class CORE_EXPORT QgsRasterProjector : public QgsRasterInterface
 
     QgsCoordinateTransformContext mTransformContext;
 
+    //! Reprojection data of the last block, reused when the same block is requested again (e.g. for another band)
+    std::unique_ptr< ProjectorData > mLastData;
+
 };
 
 
@@ -132,25 +141,33 @@ class CORE_EXPORT QgsRasterProjector : public QgsRasterInterface
 
 /**
  * Internal class for reprojection of rasters - either exact or approximate.
- * QgsRasterProjector creates it and then keeps calling srcRowCol() to get source pixel position
- * for every destination pixel position.
+ * QgsRasterProjector creates it and then calls calcSrcIndexes() to get the source pixel position
+ * of every destination pixel position.
  */
 class ProjectorData
 {
   public:
     //! Initialize reprojector and calculate matrix
     ProjectorData( const QgsRectangle &extent, int width, int height, QgsRasterInterface *input, const QgsCoordinateTransform &inverseCt, QgsRasterProjector::Precision precision, QgsRasterBlockFeedback *feedback = nullptr );
-    ~ProjectorData();
 
     ProjectorData( const ProjectorData &other ) = delete;
     ProjectorData &operator=( const ProjectorData &other ) = delete;
 
     /**
-     * Returns the source row and column indexes for current source extent and resolution.
-     * If the source pixel is outside source extent srcRow and srcCol are left unchanged.
-     * \returns TRUE if inside source
+     * Calculates the index in the source block of the source pixel of every destination pixel,
+     * splitting the destination rows between threads.
+     * \returns FALSE if canceled by the \a feedback
      */
-    bool srcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
+    bool calcSrcIndexes( QgsRasterBlockFeedback *feedback = nullptr );
+
+    /**
+     * Returns the index in the source block of the source pixel of each destination pixel, row by row,
+     * or -1 for destination pixels outside of the source. calcSrcIndexes() must have been called before.
+     */
+    const int *srcIndexes() const { return mSrcIndexes.data(); }
+
+    //! Returns TRUE if the data was calculated for the same \a input, destination \a extent, size and \a precision
+    bool isSameRequest( const QgsRasterInterface *input, const QgsRectangle &extent, int width, int height, QgsRasterProjector::Precision precision ) const;
 
     QgsRectangle srcExtent() const { return mSrcExtent; }
     int srcRows() const { return mSrcRows; }
@@ -159,19 +176,22 @@ class ProjectorData
   private:
 
     //! Returns the destination point for _current_ destination position.
-    void destPointOnCPMatrix( int row, int col, double *theX, double *theY );
+    void destPointOnCPMatrix( int row, int col, double *theX, double *theY ) const;
 
     //! Returns the matrix upper left row index for destination row.
-    int matrixRow( int destRow );
+    int matrixRow( int destRow ) const;
 
     //! Returns the matrix upper left col index for destination col.
-    int matrixCol( int destCol );
+    int matrixCol( int destCol ) const;
 
-    //! Returns precise source row and column indexes for current source extent and resolution.
-    inline bool preciseSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
+    //! Returns the index in the source block of the source point \a x, \a y, or -1 if it is outside the source
+    inline int srcIndex( double x, double y ) const;
 
-    //! Returns approximate source row and column indexes for current source extent and resolution.
-    inline bool approximateSrcRowCol( int destRow, int destCol, int *srcRow, int *srcCol );
+    /**
+     * Calculates the source indexes of the destination pixels of rows \a startRow to \a endRow (excluded)
+     * into \a indexes. This method can be called concurrently for different rows.
+     */
+    void calcSrcIndexes( int startRow, int endRow, int *indexes, QgsFeedback *feedback ) const;
 
     //! \brief insert rows to matrix
     void insertRows( const QgsCoordinateTransform &ct );
@@ -206,11 +226,8 @@ class ProjectorData
     */
     bool checkRows( const QgsCoordinateTransform &ct );
 
-    //! Calculate array of src helper points
-    void calcHelper( int matrixRow, QgsPointXY *points );
-
-    //! Calc / switch helper
-    void nextHelper();
+    //! Calculate arrays of src helper point coordinates
+    void calcHelper( int matrixRow, double *x, double *y ) const;
 
     //! Gets mCPMatrix as string
     QString cpToString();
@@ -224,6 +241,10 @@ class ProjectorData
     //! Transformation from destination CRS to source CRS
     QgsCoordinateTransform mInverseCt;
 
+    //! Input and requested precision
+    const QgsRasterInterface *mInput = nullptr;
+    QgsRasterProjector::Precision mPrecision;
+
     //! Destination extent
     QgsRectangle mDestExtent;
 
@@ -270,16 +291,8 @@ class ProjectorData
     /* Same size as mCPMatrix */
     QList< QList<bool> > mCPLegalMatrix;
 
-    //! Array of source points for each destination column on top of current CPMatrix grid row
-    /* Warning: using QList is slow on access */
-    QgsPointXY *pHelperTop = nullptr;
-
-    //! Array of source points for each destination column on bottom of current CPMatrix grid row
-    /* Warning: using QList is slow on access */
-    QgsPointXY *pHelperBottom = nullptr;
-
-    //! Current mHelperTop matrix row
-    int mHelperTopRow;
+    //! Index in the source block of the source pixel of each destination pixel, or -1
+    std::vector< int > mSrcIndexes;
 
     //! Number of mCPMatrix columns
     int mCPCols;
@@ -28,6 +28,9 @@
 #include <QDomElement>
 #include <QImage>
 
+#include <limits>
+#include <vector>
+
 QgsSingleBandPseudoColorRenderer::QgsSingleBandPseudoColorRenderer( QgsRasterInterface *input, int band, QgsRasterShader *shader )
   : QgsRasterRenderer( input, QStringLiteral( "singlebandpseudocolor" ) )
   , mShader( shader )
@@ -191,6 +194,81 @@ QgsRasterRenderer *QgsSingleBandPseudoColorRenderer::create( const QDomElement &
   return r;
 }
 
+///@cond PRIVATE
+
+//! Maximum number of entries of the color table used to shade integer blocks
+static const qint64 MAX_COLOR_TABLE_SIZE = 1 << 20;
+
+/**
+ * Shades an integer \a inputBlock into \a outputData using a table with the color returned by
+ * \a shadeValue for each value between the minimum and maximum values of the block.
+ * Returns FALSE if the values span a range too large for the table to be worthwhile, in which
+ * case nothing is written.
+ */
+template <typename T, typename ShadeFunction>
+static bool shadeWithColorTable( QgsRasterBlock *inputBlock, QRgb *outputData, QRgb noDataColor, const ShadeFunction &shadeValue )
+{
+  const T *data = reinterpret_cast< const T * >( inputBlock->bits() );
+  if ( !data )
+    return false;
+
+  const qgssize count = static_cast< qgssize >( inputBlock->width() ) * inputBlock->height();
+  const bool hasNoDataValue = inputBlock->hasNoDataValue();
+  const double noDataValue = inputBlock->noDataValue();
+
+  qint64 min = std::numeric_limits< qint64 >::max();
+  qint64 max = std::numeric_limits< qint64 >::lowest();
+  for ( qgssize i = 0; i < count; ++i )
+  {
+    if ( hasNoDataValue && qgsDoubleNear( data[i], noDataValue ) )
+      continue;
+    min = std::min< qint64 >( min, data[i] );
+    max = std::max< qint64 >( max, data[i] );
+  }
+
+  if ( min > max )
+  {
+    // only no data values
+    std::fill( outputData, outputData + count, noDataColor );
+    return true;
+  }
+
+  const qint64 tableSize = max - min + 1;
+  if ( tableSize > MAX_COLOR_TABLE_SIZE || static_cast< qgssize >( tableSize ) > count )
+    return false;
+
+  std::vector< QRgb > colorTable( static_cast< std::size_t >( tableSize ) );
+  for ( qint64 i = 0; i < tableSize; ++i )
+  {
+    const double value = static_cast< double >( min + i );
+    colorTable[i] = hasNoDataValue && qgsDoubleNear( value, noDataValue ) ? noDataColor : shadeValue( value );
+  }
+
+  // Values outside of the table can only be no data values. Negative offsets wrap around
+  // to large unsigned values, so a single comparison is enough.
+  const QRgb *table = colorTable.data();
+  const quint64 size = static_cast< quint64 >( tableSize );
+  for ( qgssize i = 0; i < count; ++i )
+  {
+    const quint64 index = static_cast< quint64 >( static_cast< qint64 >( data[i] ) - min );
+    outputData[i] = index < size ? table[index] : noDataColor;
+  }
+
+  // Without a no data value, no data pixels are flagged in the no data bitmap
+  if ( !hasNoDataValue && inputBlock->hasNoData() )
+  {
+    for ( qgssize i = 0; i < count; ++i )
+    {
+      if ( inputBlock->isNoData( i ) )
+        outputData[i] = noDataColor;
+    }
+  }
+
+  return true;
+}
+
+///@endcond
+
 QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangle  const &extent, int width, int height, QgsRasterBlockFeedback *feedback )
 {
   Q_UNUSED( bandNo )
@@ -235,22 +313,13 @@ QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangl
   QRgb *outputBlockData = outputBlock->colorData();
   const QgsRasterShaderFunction *fcn = mShader->rasterShaderFunction();
 
-  qgssize count = ( qgssize )width * height;
-  bool isNoData = false;
-  for ( qgssize i = 0; i < count; i++ )
+  // Returns the rendered color of a pixel with value val
+  const auto shadePixel = [ =, &alphaBlock ]( double val, qgssize i ) -> QRgb
   {
-    double val = inputBlock->valueAndNoData( i, isNoData );
-    if ( isNoData )
-    {
-      outputBlockData[i] = myDefaultColor;
-      continue;
-    }
-
     int red, green, blue, alpha;
     if ( !fcn->shade( val, &red, &green, &blue, &alpha ) )
     {
-      outputBlockData[i] = myDefaultColor;
-      continue;
+      return myDefaultColor;
     }
 
     if ( alpha < 255 )
@@ -263,24 +332,62 @@ QgsRasterBlock *QgsSingleBandPseudoColorRenderer::block( int bandNo, QgsRectangl
 
     if ( !hasTransparency )
     {
-      outputBlockData[i] = qRgba( red, green, blue, alpha );
+      return qRgba( red, green, blue, alpha );
     }
-    else
+
+    //opacity
+    double currentOpacity = mOpacity;
+    if ( mRasterTransparency )
     {
-      //opacity
-      double currentOpacity = mOpacity;
-      if ( mRasterTransparency )
-      {
-        currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
-      }
-      if ( mAlphaBand > 0 )
-      {
-        currentOpacity *= alphaBlock->value( i ) / 255.0;
-      }
+      currentOpacity = mRasterTransparency->alphaValue( val, mOpacity * 255 ) / 255.0;
+    }
+    if ( mAlphaBand > 0 )
+    {
+      currentOpacity *= ( mAlphaBand == mBand ? val : alphaBlock->value( i ) ) / 255.0;
+    }
+
+    return qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+  };
 
-      outputBlockData[i] = qRgba( currentOpacity * red, currentOpacity * green, currentOpacity * blue, currentOpacity * alpha );
+  // Unless a separate alpha band is used, the color only depends on the value, so integer
+  // blocks can be shaded with a table of the colors of their values
+  bool shaded = false;
+  if ( mAlphaBand <= 0 || mAlphaBand == mBand )
+  {
+    const auto shadeValue = [&shadePixel]( double val ) { return shadePixel( val, 0 ); };
+    switch ( inputBlock->dataType() )
+    {
+      case Qgis::DataType::Byte:
+        shaded = shadeWithColorTable< quint8 >( inputBlock.get(), outputBlockData, myDefaultColor, shadeValue );
+        break;
+      case Qgis::DataType::UInt16:
+        shaded = shadeWithColorTable< quint16 >( inputBlock.get(), outputBlockData, myDefaultColor, shadeValue );
+        break;
+      case Qgis::DataType::Int16:
+        shaded = shadeWithColorTable< qint16 >( inputBlock.get(), outputBlockData, myDefaultColor, shadeValue );
+        break;
+      case Qgis::DataType::UInt32:
+        shaded = shadeWithColorTable< quint32 >( inputBlock.get(), outputBlockData, myDefaultColor, shadeValue );
+        break;
+      case Qgis::DataType::Int32:
+        shaded = shadeWithColorTable< qint32 >( inputBlock.get(), outputBlockData, myDefaultColor, shadeValue );
+        break;
+      default:
+        break;
     }
   }
+  if ( shaded )
+  {
+    return outputBlock.release();
+  }
+
+  qgssize count = ( qgssize )width * height;
+  bool isNoData = false;
+  for ( qgssize i = 0; i < count; i++ )
+  {
+    double val = inputBlock->valueAndNoData( i, isNoData );
+    outputBlockData[i] = isNoData ? myDefaultColor : shadePixel( val, i );
+  }
 
   return outputBlock.release();
 }
@@ -428,7 +428,11 @@ bool QgsRuleBasedRenderer::Rule::startRender( QgsRenderContext &context, const Q
 
   // init this rule
   if ( mFilter )
+  {
     mFilter->prepare( &context.expressionContext() );
+    // filters are evaluated for every feature, so it's worth flattening them to a program
+    mFilter->compile();
+  }
   if ( mSymbol )
     mSymbol->startRender( context, fields );
 
@@ -0,0 +1,420 @@
+/***************************************************************************
+  qgsrenderfeaturecache.cpp
+  --------------------------------------
+  Date                 : March 2021
+  Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsrenderfeaturecache.h"
+#include "qgsvectorlayer.h"
+#include "qgsfeaturerequest.h"
+#include "qgsexpression.h"
+#include "qgsfeedback.h"
+#include "qgsgeometry.h"
+
+#include <QSet>
+#include <cmath>
+#include <limits>
+
+///@cond PRIVATE
+
+/**
+ * Iterates over the cells of the cache covering a request, returning cached
+ * cells directly and recording the features of missing cells as they are
+ * fetched from the source.
+ */
+class QgsRenderFeatureCacheIterator : public QgsAbstractFeatureIterator
+{
+  public:
+
+    struct Cell
+    {
+      QString key;
+      QgsFeatureRequest request;
+    };
+
+    QgsRenderFeatureCacheIterator( QgsRenderFeatureCache *cache, QgsAbstractFeatureSource *source, const QgsFeatureRequest &request, const QVector< Cell > &cells )
+      : QgsAbstractFeatureIterator( QgsFeatureRequest().setFlags( request.flags() ) )
+      , mCache( cache )
+      , mSource( source )
+      , mFilterRect( request.filterRect() )
+      , mExactIntersect( request.flags() & QgsFeatureRequest::ExactIntersect )
+      , mCells( cells )
+      , mMaximumCellSize( cache->maximumSize() / 4 )
+    {
+    }
+
+    ~QgsRenderFeatureCacheIterator() override
+    {
+      close();
+    }
+
+    bool rewind() override
+    {
+      if ( mClosed )
+        return false;
+
+      mSourceIterator.close();
+      mSourceIterator = QgsFeatureIterator();
+      mSourceActive = false;
+      mCellFeatures.reset();
+      mRecorded.clear();
+      mCellIndex = -1;
+      mReturnedIds.clear();
+      return true;
+    }
+
+    bool close() override
+    {
+      if ( mClosed )
+        return false;
+
+      mSourceIterator.close();
+      mSourceIterator = QgsFeatureIterator();
+      mSourceActive = false;
+      mCellFeatures.reset();
+      mRecorded.clear();
+      mClosed = true;
+      return true;
+    }
+
+    void setInterruptionChecker( QgsFeedback *interruptionChecker ) override
+    {
+      mInterruptionChecker = interruptionChecker;
+      mSourceIterator.setInterruptionChecker( interruptionChecker );
+    }
+
+    bool isValid() const override
+    {
+      return mValid;
+    }
+
+  protected:
+
+    bool fetchFeature( QgsFeature &f ) override
+    {
+      if ( mClosed )
+        return false;
+
+      while ( true )
+      {
+        if ( mCellFeatures )
+        {
+          while ( mFeatureIndex < mCellFeatures->size() )
+          {
+            f = mCellFeatures->at( mFeatureIndex++ );
+            if ( acceptFeature( f ) )
+              return true;
+          }
+          mCellFeatures.reset();
+        }
+        else if ( mSourceActive )
+        {
+          if ( mSourceIterator.nextFeature( f ) )
+          {
+            if ( mRecording )
+            {
+              mRecordedSize += QgsRenderFeatureCache::featureSize( f );
+              // don't let a single cell take over the cache
+              if ( mRecordedSize > mMaximumCellSize )
+              {
+                mRecording = false;
+                mRecorded.clear();
+              }
+              else
+              {
+                mRecorded.append( f );
+              }
+            }
+
+            if ( acceptFeature( f ) )
+              return true;
+            continue;
+          }
+
+          const bool interrupted = mInterruptionChecker && mInterruptionChecker->isCanceled();
+          if ( !mSourceIterator.isValid() )
+            mValid = false;
+          else if ( mRecording && !interrupted )
+            mCache->insertCell( mCells.at( mCellIndex ).key, mRecorded, mRecordedSize );
+
+          mSourceIterator = QgsFeatureIterator();
+          mSourceActive = false;
+          mRecorded.clear();
+        }
+
+        if ( ++mCellIndex >= mCells.size() )
+        {
+          close();
+          return false;
+        }
+
+        const Cell &cell = mCells.at( mCellIndex );
+        mCellFeatures = mCache->cell( cell.key );
+        mFeatureIndex = 0;
+        if ( !mCellFeatures )
+        {
+          mSourceIterator = mSource->getFeatures( cell.request );
+          mSourceIterator.setInterruptionChecker( mInterruptionChecker );
+          mSourceActive = true;
+          mRecording = true;
+          mRecordedSize = 0;
+        }
+      }
+    }
+
+  private:
+
+    bool acceptFeature( const QgsFeature &feature )
+    {
+      if ( !feature.hasGeometry() )
+        return false;
+
+      if ( mExactIntersect )
+      {
+        if ( !feature.geometry().intersects( mFilterRect ) )
+          return false;
+      }
+      else if ( !feature.geometry().boundingBoxIntersects( mFilterRect ) )
+      {
+        return false;
+      }
+
+      // features crossing cell boundaries are stored in every cell they intersect
+      if ( mCells.size() > 1 )
+      {
+        if ( mReturnedIds.contains( feature.id() ) )
+          return false;
+        mReturnedIds.insert( feature.id() );
+      }
+      return true;
+    }
+
+    QgsRenderFeatureCache *mCache = nullptr;
+    QgsAbstractFeatureSource *mSource = nullptr;
+    QgsRectangle mFilterRect;
+    bool mExactIntersect = false;
+
+    QVector< Cell > mCells;
+    int mCellIndex = -1;
+    qint64 mMaximumCellSize = 0;
+
+    std::shared_ptr< const QgsRenderFeatureCache::FeatureList > mCellFeatures;
+    int mFeatureIndex = 0;
+
+    QgsFeatureIterator mSourceIterator;
+    bool mSourceActive = false;
+    bool mRecording = false;
+    QgsRenderFeatureCache::FeatureList mRecorded;
+    qint64 mRecordedSize = 0;
+
+    QSet< QgsFeatureId > mReturnedIds;
+    QgsFeedback *mInterruptionChecker = nullptr;
+    bool mValid = true;
+    bool mClosed = false;
+};
+
+///@endcond PRIVATE
+
+QgsRenderFeatureCache::QgsRenderFeatureCache( qint64 maximumSize )
+{
+  setMaximumSize( maximumSize );
+}
+
+void QgsRenderFeatureCache::setMaximumSize( qint64 maximum )
+{
+  QMutexLocker locker( &mMutex );
+  mCells.setMaxCost( static_cast< int >( std::min< qint64 >( std::max< qint64 >( maximum, 0 ) / 1024, std::numeric_limits< int >::max() ) ) );
+}
+
+qint64 QgsRenderFeatureCache::maximumSize() const
+{
+  QMutexLocker locker( &mMutex );
+  return static_cast< qint64 >( mCells.maxCost() ) * 1024;
+}
+
+qint64 QgsRenderFeatureCache::size() const
+{
+  QMutexLocker locker( &mMutex );
+  return static_cast< qint64 >( mCells.totalCost() ) * 1024;
+}
+
+void QgsRenderFeatureCache::clear()
+{
+  QMutexLocker locker( &mMutex );
+  mCells.clear();
+}
+
+void QgsRenderFeatureCache::removeLayer( const QString &layerId )
+{
+  const QString prefix = layerId + '|';
+
+  QMutexLocker locker( &mMutex );
+  const QList< QString > keys = mCells.keys();
+  for ( const QString &key : keys )
+  {
+    if ( key.startsWith( prefix ) )
+      mCells.remove( key );
+  }
+}
+
+QString QgsRenderFeatureCache::layerKey( const QgsVectorLayer *layer )
+{
+  if ( !layer || !layer->isValid() || layer->isEditable() )
+    return QString();
+
+  return QStringLiteral( "%1|%2|%3" ).arg( layer->id(), layer->source(), layer->subsetString() );
+}
+
+bool QgsRenderFeatureCache::canCacheRequest( const QgsFeatureRequest &request )
+{
+  if ( request.filterRect().isNull() || !request.filterRect().isFinite() || request.filterRect().isEmpty() )
+    return false;
+
+  if ( request.flags() & QgsFeatureRequest::NoGeometry
+       || request.limit() >= 0
+       || !request.orderBy().isEmpty()
+       || request.destinationCrs().isValid() )
+    return false;
+
+  switch ( request.filterType() )
+  {
+    case QgsFeatureRequest::FilterNone:
+      return true;
+
+    case QgsFeatureRequest::FilterExpression:
+    {
+      // the results of filters which depend on the render context or are not deterministic
+      // can't be shared with other renders
+      const QgsExpression *expression = request.filterExpression();
+      if ( !expression || expression->hasParserError() || !expression->referencedVariables().isEmpty() )
+        return false;
+
+      static const QSet< QString > sContextFunctions
+      {
+        QStringLiteral( "$scale" ),
+        QStringLiteral( "var" ),
+        QStringLiteral( "eval" ),
+        QStringLiteral( "now" ),
+        QStringLiteral( "rand" ),
+        QStringLiteral( "randf" ),
+        QStringLiteral( "uuid" ),
+      };
+      return !expression->referencedFunctions().intersects( sContextFunctions );
+    }
+
+    case QgsFeatureRequest::FilterFid:
+    case QgsFeatureRequest::FilterFids:
+      break;
+  }
+  return false;
+}
+
+QgsFeatureIterator QgsRenderFeatureCache::getFeatures( const QString &layerKey, QgsAbstractFeatureSource *source, const QgsFeatureRequest &request )
+{
+  if ( layerKey.isEmpty() || maximumSize() <= 0 || !canCacheRequest( request ) )
+    return source->getFeatures( request );
+
+  const QgsRectangle rect = request.filterRect();
+
+  // cells are between half and the full size of the requested extent, so that a request
+  // covers at most 3 x 3 cells and similar extents share the same grid
+  const double extentSize = std::max( rect.width(), rect.height() );
+  const int level = static_cast< int >( std::ceil( std::log2( extentSize ) ) ) - 1;
+  const double cellSize = std::ldexp( 1.0, level );
+
+  QgsFeatureRequest cellRequest( request );
+
+  QString simplifyKey;
+  const QgsSimplifyMethod &simplifyMethod = request.simplifyMethod();
+  if ( simplifyMethod.methodType() != QgsSimplifyMethod::NoSimplification && simplifyMethod.tolerance() > 0 )
+  {
+    // round the tolerance down to a power of two, so that renders at similar scales share the
+    // same (slightly more detailed) geometries
+    const int toleranceLevel = static_cast< int >( std::floor( std::log2( simplifyMethod.tolerance() ) ) );
+    QgsSimplifyMethod cellSimplifyMethod( simplifyMethod );
+    cellSimplifyMethod.setTolerance( std::ldexp( 1.0, toleranceLevel ) );
+    cellRequest.setSimplifyMethod( cellSimplifyMethod );
+    simplifyKey = QStringLiteral( "%1:%2:%3:%4" ).arg( simplifyMethod.methodType() ).arg( toleranceLevel ).arg( simplifyMethod.threshold() ).arg( simplifyMethod.forceLocalOptimization() );
+  }
+
+  QStringList attributes;
+  if ( request.flags() & QgsFeatureRequest::SubsetOfAttributes )
+  {
+    const QgsAttributeList attributeList = request.subsetOfAttributes();
+    attributes.reserve( attributeList.size() );
+    for ( int attribute : attributeList )
+      attributes << QString::number( attribute );
+  }
+  else
+  {
+    attributes << QStringLiteral( "*" );
+  }
+
+  const QString requestKey = QStringLiteral( "%1|%2|%3|%4|%5|%6|%7" ).arg( layerKey,
+                             request.filterExpression() ? request.filterExpression()->expression() : QString(),
+                             attributes.join( ',' ) )
+                             .arg( static_cast< int >( request.flags() ) )
+                             .arg( static_cast< int >( request.invalidGeometryCheck() ) )
+                             .arg( simplifyKey )
+                             .arg( level );
+
+  const qint64 xMin = static_cast< qint64 >( std::floor( rect.xMinimum() / cellSize ) );
+  const qint64 xMax = static_cast< qint64 >( std::floor( rect.xMaximum() / cellSize ) );
+  const qint64 yMin = static_cast< qint64 >( std::floor( rect.yMinimum() / cellSize ) );
+  const qint64 yMax = static_cast< qint64 >( std::floor( rect.yMaximum() / cellSize ) );
+
+  QVector< QgsRenderFeatureCacheIterator::Cell > cells;
+  cells.reserve( static_cast< int >( ( xMax - xMin + 1 ) * ( yMax - yMin + 1 ) ) );
+  for ( qint64 y = yMin; y <= yMax; ++y )
+  {
+    for ( qint64 x = xMin; x <= xMax; ++x )
+    {
+      QgsRenderFeatureCacheIterator::Cell cell;
+      cell.key = QStringLiteral( "%1|%2|%3" ).arg( requestKey ).arg( x ).arg( y );
+      cell.request = cellRequest;
+      cell.request.setFilterRect( QgsRectangle( x * cellSize, y * cellSize, ( x + 1 ) * cellSize, ( y + 1 ) * cellSize ) );
+      cells << cell;
+    }
+  }
+
+  return QgsFeatureIterator( new QgsRenderFeatureCacheIterator( this, source, request, cells ) );
+}
+
+std::shared_ptr< const QgsRenderFeatureCache::FeatureList > QgsRenderFeatureCache::cell( const QString &key ) const
+{
+  QMutexLocker locker( &mMutex );
+  const Entry *entry = mCells.object( key );
+  return entry ? entry->features : nullptr;
+}
+
+void QgsRenderFeatureCache::insertCell( const QString &key, const FeatureList &features, qint64 size )
+{
+  Entry *entry = new Entry;
+  entry->features = std::make_shared< const FeatureList >( features );
+
+  QMutexLocker locker( &mMutex );
+  mCells.insert( key, entry, static_cast< int >( std::max< qint64 >( size / 1024, 1 ) ) );
+}
+
+qint64 QgsRenderFeatureCache::featureSize( const QgsFeature &feature )
+{
+  qint64 size = sizeof( QgsFeature ) + static_cast< qint64 >( feature.attributeCount() ) * sizeof( QVariant );
+  if ( feature.hasGeometry() )
+    size += feature.geometry().constGet()->wkbSize();
+
+  const QgsAttributes attributes = feature.attributes();
+  for ( const QVariant &attribute : attributes )
+  {
+    if ( attribute.type() == QVariant::String )
+      size += attribute.toString().size() * sizeof( QChar );
+  }
+  return size;
+}
@@ -0,0 +1,137 @@
+/***************************************************************************
+  qgsrenderfeaturecache.h
+  --------------------------------------
+  Date                 : March 2021
+  Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSRENDERFEATURECACHE_H
+#define QGSRENDERFEATURECACHE_H
+
+#define SIP_NO_FILE
+
+#include "qgis_core.h"
+#include "qgsfeature.h"
+#include "qgsfeatureiterator.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QVector>
+#include <memory>
+
+class QgsVectorLayer;
+class QgsAbstractFeatureSource;
+class QgsFeatureRequest;
+
+/**
+ * \ingroup core
+ * \class QgsRenderFeatureCache
+ * \brief A memory bounded, thread safe cache of features fetched while rendering vector layers.
+ *
+ * The cache is intended to be shared by many render jobs, e.g. all the WMS GetMap requests handled
+ * by a QGIS Server process, so that overlapping extents do not need to fetch and decode the same
+ * features from the data provider again.
+ *
+ * Features are cached in square cells of a grid whose size depends on the size of the requested
+ * extent, so that requests for adjacent or overlapping extents at similar scales share cells.
+ * Cells are keyed by the layer, the filter expression, the fetched attributes and the geometry
+ * simplification settings of the request, so requests using different styles or filters never
+ * share features.
+ *
+ * Cached features are never invalidated automatically: removeLayer() or clear() must be called
+ * whenever the layer data or its configuration changes.
+ *
+ * \see QgsMapRendererJob::setRenderFeatureCache()
+ * \note not available in Python bindings
+ * \since QGIS 3.20
+ */
+class CORE_EXPORT QgsRenderFeatureCache
+{
+  public:
+
+    /**
+     * Constructor for QgsRenderFeatureCache, with the specified \a maximumSize in bytes.
+     */
+    explicit QgsRenderFeatureCache( qint64 maximumSize = 0 );
+
+    /**
+     * Sets the \a maximum size of the cache, in bytes. A maximum size of 0 disables the cache.
+     * \see maximumSize()
+     */
+    void setMaximumSize( qint64 maximum );
+
+    /**
+     * Returns the maximum size of the cache, in bytes.
+     * \see setMaximumSize()
+     */
+    qint64 maximumSize() const;
+
+    /**
+     * Returns the approximate size of all features currently stored in the cache, in bytes.
+     */
+    qint64 size() const;
+
+    /**
+     * Removes all cached features.
+     */
+    void clear();
+
+    /**
+     * Removes all cached features for the layer with matching \a layerId.
+     */
+    void removeLayer( const QString &layerId );
+
+    /**
+     * Returns the key identifying the features of a \a layer in the cache, or an empty
+     * string if features from the layer cannot be cached (e.g. because it is being edited).
+     *
+     * This must be called from the thread which owns the layer, usually when preparing the layer
+     * for rendering.
+     */
+    static QString layerKey( const QgsVectorLayer *layer );
+
+    /**
+     * Returns an iterator for the features matching \a request from a feature \a source, where
+     * \a layerKey identifies the layer the source was created from.
+     *
+     * Features are returned from the cache if available. Any missing cells are fetched from the
+     * \a source and stored in the cache once they have been completely iterated. If the request
+     * cannot be served from the cache (e.g. because it is ordered, or its filter depends on
+     * context variables), an iterator over the source is returned.
+     *
+     * The \a source and the cache must outlive the returned iterator.
+     *
+     * \see layerKey()
+     */
+    QgsFeatureIterator getFeatures( const QString &layerKey, QgsAbstractFeatureSource *source, const QgsFeatureRequest &request );
+
+  private:
+
+    typedef QVector< QgsFeature > FeatureList;
+
+    struct Entry
+    {
+      std::shared_ptr< const FeatureList > features;
+    };
+
+    std::shared_ptr< const FeatureList > cell( const QString &key ) const;
+    void insertCell( const QString &key, const FeatureList &features, qint64 size );
+
+    static bool canCacheRequest( const QgsFeatureRequest &request );
+    static qint64 featureSize( const QgsFeature &feature );
+
+    mutable QMutex mMutex;
+    //! Cached cells, with costs in kilobytes
+    mutable QCache< QString, Entry > mCells;
+
+    friend class QgsRenderFeatureCacheIterator;
+};
+
+#endif // QGSRENDERFEATURECACHE_H
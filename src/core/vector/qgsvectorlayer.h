@@ -365,6 +365,12 @@ typedef QSet<int> QgsAttributeIds;
  *
  *   Determines whether the provider generates a spatial index.  The default is no.
  *
+ * - scanCache=(yes|no)
+ *
+ *   Determines whether the results of the initial scan of the file (fields,
+ *   extent, feature count and indexes) are saved to a .dtcache file next to it,
+ *   and reused while the file is not modified.  The default is no.
+ *
  * - watchFile=(yes|no)
  *
  *   Defines whether the file will be monitored for changes. The default is
@@ -27,6 +27,7 @@
 #include "qgsmessagelog.h"
 #include "qgsexception.h"
 #include "qgsexpressioncontextutils.h"
+#include "qgsfeaturebatch.h"
 
 #include <QThreadStorage>
 #include <QStack>
@@ -492,6 +493,23 @@ bool QgsVectorLayerFeatureIterator::fetchFeature( QgsFeature &f )
 }
 
 
+int QgsVectorLayerFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  if ( mClosed )
+    return 0;
+
+  // batches can only be forwarded to the provider if its features don't need any further processing
+  if ( mSource->mHasEditBuffer || mHasVirtualAttributes || mTransform.isValid()
+       || mRequest.invalidGeometryCheck() != QgsFeatureRequest::GeometryNoCheck
+       || mProviderIterator.isClosed() )
+    return -1;
+
+  const int count = mProviderIterator.nextBatch( batch, maxFeatures );
+  if ( count == 0 )
+    close();
+  return count;
+}
+
 
 bool QgsVectorLayerFeatureIterator::rewind()
 {
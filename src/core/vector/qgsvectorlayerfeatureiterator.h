@@ -182,6 +182,7 @@ class CORE_EXPORT QgsVectorLayerFeatureIterator : public QgsAbstractFeatureItera
   protected:
     //! fetch next feature, return TRUE on success
     bool fetchFeature( QgsFeature &feature ) override;
+    int fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override SIP_SKIP;
 
     /**
      * Overrides default method as we only need to filter features in the edit buffer
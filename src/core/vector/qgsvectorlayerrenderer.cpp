@@ -41,6 +41,7 @@
 #include "qgsvectorlayertemporalproperties.h"
 #include "qgsmapclippingutils.h"
 #include "qgsfeaturerenderergenerator.h"
+#include "qgsrenderfeaturecache.h"
 
 #include <QPicture>
 #include <QTimer>
@@ -53,6 +54,8 @@ QgsVectorLayerRenderer::QgsVectorLayerRenderer( QgsVectorLayer *layer, QgsRender
   , mDiagrams( false )
 {
   mSource = std::make_unique< QgsVectorLayerFeatureSource >( layer );
+  if ( context.renderFeatureCache() )
+    mRenderFeatureCacheKey = QgsRenderFeatureCache::layerKey( layer );
 
   std::unique_ptr< QgsFeatureRenderer > mainRenderer( layer->renderer() ? layer->renderer()->clone() : nullptr );
 
@@ -392,7 +395,9 @@ bool QgsVectorLayerRenderer::renderInternal( QgsFeatureRenderer *renderer )
     context.setVectorSimplifyMethod( vectorMethod );
   }
 
-  QgsFeatureIterator fit = mSource->getFeatures( featureRequest );
+  QgsFeatureIterator fit = !mRenderFeatureCacheKey.isEmpty() && context.renderFeatureCache()
+                           ? context.renderFeatureCache()->getFeatures( mRenderFeatureCacheKey, mSource.get(), featureRequest )
+                           : mSource->getFeatures( featureRequest );
   // Attach an interruption checker so that iterators that have potentially
   // slow fetchFeature() implementations, such as in the WFS provider, can
   // check it, instead of relying on just the mContext.renderingStopped() check
@@ -130,6 +130,9 @@ class QgsVectorLayerRenderer : public QgsMapLayerRenderer
 
     QString mTemporalFilter;
 
+    //! Key of the layer in the context's render feature cache, empty if features can't be cached
+    QString mRenderFeatureCacheKey;
+
     std::unique_ptr< QgsVectorLayerFeatureSource > mSource;
 
     QgsFeatureRenderer *mRenderer = nullptr;
@@ -63,10 +63,32 @@ class CORE_EXPORT QgsVectorTileMVTEncoder
      */
     void addLayer( QgsVectorLayer *layer, QgsFeedback *feedback = nullptr, QString filterExpression = QString(), QString layerName = QString() );
 
+    /**
+     * Adds \a features of a layer named \a layerName with the given \a fields to the tile.
+     *
+     * Unlike addLayer(), features are not fetched from a vector layer: their geometries must already
+     * be in the CRS of the tile matrix (EPSG:3857), and they get clipped to the (buffered) tile extent.
+     * This allows features to be fetched once for many tiles, and tiles to be encoded from worker threads.
+     *
+     * Optional feedback object may be provided to support cancellation.
+     *
+     * \since QGIS 3.20
+     */
+    void addFeatures( const QString &layerName, const QgsFields &fields, const QgsFeatureList &features, QgsFeedback *feedback = nullptr );
+
+    /**
+     * Returns the extent of the tile, grown by the tile buffer. Features outside of this extent
+     * do not contribute to the tile.
+     *
+     * \since QGIS 3.20
+     */
+    QgsRectangle bufferedTileExtent() const;
+
     //! Encodes MVT using data stored previously with addLayer() calls
     QByteArray encode() const;
 
   private:
+    vector_tile::Tile_Layer *createTileLayer( const QString &layerName, const QgsFields &fields );
     void addFeature( vector_tile::Tile_Layer *tileLayer, const QgsFeature &f );
 
   private:
@@ -31,7 +31,14 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QUrl>
+#include <QtConcurrentMap>
 
+#include <numeric>
+
+///@cond PRIVATE
+//! Number of tile rows and columns processed together, sharing feature requests
+constexpr int TILE_BLOCK_SIZE = 16;
+///@endcond
 
 QgsVectorTileWriter::QgsVectorTileWriter()
 {
@@ -151,28 +158,23 @@ bool QgsVectorTileWriter::writeTiles( QgsFeedback *feedback )
     }
   }
 
+  // Tiles are processed in blocks: features of each layer are fetched and reprojected once for
+  // the whole block, binned into tiles and encoded in parallel, then the block gets written.
+  // Sources are thus read once per block of every zoom level rather than in a single pass over
+  // all zoom levels, which keeps memory bounded by the block size for large layers
   int tilesCreated = 0;
   for ( int zoomLevel = mMinZoom; zoomLevel <= mMaxZoom; ++zoomLevel )
   {
     QgsTileMatrix tileMatrix = QgsTileMatrix::fromWebMercator( zoomLevel );
 
     QgsTileRange tileRange = tileMatrix.tileRangeFromExtent( outputExtent );
-    for ( int row = tileRange.startRow(); row <= tileRange.endRow(); ++row )
+    for ( int blockRow = tileRange.startRow(); blockRow <= tileRange.endRow(); blockRow += TILE_BLOCK_SIZE )
     {
-      for ( int col = tileRange.startColumn(); col <= tileRange.endColumn(); ++col )
+      for ( int blockCol = tileRange.startColumn(); blockCol <= tileRange.endColumn(); blockCol += TILE_BLOCK_SIZE )
       {
-        QgsTileXYZ tileID( col, row, zoomLevel );
-        QgsVectorTileMVTEncoder encoder( tileID );
-        encoder.setTransformContext( mTransformContext );
-
-        for ( const Layer &layer : std::as_const( mLayers ) )
-        {
-          if ( ( layer.minZoom() >= 0 && zoomLevel < layer.minZoom() ) ||
-               ( layer.maxZoom() >= 0 && zoomLevel > layer.maxZoom() ) )
-            continue;
-
-          encoder.addLayer( layer.layer(), feedback, layer.filterExpression(), layer.layerName() );
-        }
+        const QgsTileRange blockRange( blockCol, std::min( blockCol + TILE_BLOCK_SIZE - 1, tileRange.endColumn() ),
+                                       blockRow, std::min( blockRow + TILE_BLOCK_SIZE - 1, tileRange.endRow() ) );
+        const QVector<QByteArray> blockData = encodeTileBlock( tileMatrix, blockRange, sourceType == QLatin1String( "mbtiles" ), feedback );
 
         if ( feedback && feedback->isCanceled() )
         {
@@ -180,37 +182,167 @@ bool QgsVectorTileWriter::writeTiles( QgsFeedback *feedback )
           return false;
         }
 
-        QByteArray tileData = encoder.encode();
+        if ( mbtiles )
+          mbtiles->beginTransaction();
 
-        ++tilesCreated;
+        int tileIndex = 0;
+        for ( int row = blockRange.startRow(); row <= blockRange.endRow(); ++row )
+        {
+          for ( int col = blockRange.startColumn(); col <= blockRange.endColumn(); ++col, ++tileIndex )
+          {
+            const QByteArray &tileData = blockData.at( tileIndex );
+            if ( tileData.isEmpty() )
+            {
+              // skipping empty tile - no need to write it
+              continue;
+            }
+
+            QgsTileXYZ tileID( col, row, zoomLevel );
+            if ( sourceType == QLatin1String( "xyz" ) )
+            {
+              if ( !writeTileFileXYZ( sourcePath, tileID, tileMatrix, tileData ) )
+                return false;  // error message already set
+            }
+            else  // mbtiles
+            {
+              int rowTMS = pow( 2, tileID.zoomLevel() ) - tileID.row() - 1;
+              mbtiles->setTileData( tileID.zoomLevel(), tileID.column(), rowTMS, tileData );
+            }
+          }
+        }
+
+        if ( mbtiles )
+          mbtiles->commitTransaction();
+
+        tilesCreated += blockData.count();
         if ( feedback )
         {
           feedback->setProgress( static_cast<double>( tilesCreated ) / tilesToCreate * 100 );
         }
+      }
+    }
+  }
+
+  return true;
+}
+
+QVector<QByteArray> QgsVectorTileWriter::encodeTileBlock( const QgsTileMatrix &tileMatrix, const QgsTileRange &blockRange, bool gzip, QgsFeedback *feedback )
+{
+  const int zoomLevel = tileMatrix.zoomLevel();
+  const int blockColumns = blockRange.endColumn() - blockRange.startColumn() + 1;
+  const int blockRows = blockRange.endRow() - blockRange.startRow() + 1;
+
+  QgsRectangle blockExtent = tileMatrix.tileExtent( QgsTileXYZ( blockRange.startColumn(), blockRange.startRow(), zoomLevel ) );
+  blockExtent.combineExtentWith( tileMatrix.tileExtent( QgsTileXYZ( blockRange.endColumn(), blockRange.endRow(), zoomLevel ) ) );
+
+  // features are taken into account by all tiles whose buffered extent they intersect
+  const QgsVectorTileMVTEncoder templateEncoder( QgsTileXYZ( blockRange.startColumn(), blockRange.startRow(), zoomLevel ) );
+  const double buffer = static_cast<double>( templateEncoder.tileBuffer() ) / templateEncoder.resolution() * tileMatrix.tileExtent( QgsTileXYZ( 0, 0, zoomLevel ) ).width();
+  blockExtent.grow( buffer );
+
+  // features of each layer, binned by tile
+  struct TileLayer
+  {
+    QString name;
+    QgsFields fields;
+    QVector<QgsFeatureList> tileFeatures;
+  };
+  QList<TileLayer> tileLayers;
+
+  const QgsCoordinateReferenceSystem destCrs( QStringLiteral( "EPSG:3857" ) );
+  for ( const Layer &layer : std::as_const( mLayers ) )
+  {
+    if ( ( layer.minZoom() >= 0 && zoomLevel < layer.minZoom() ) ||
+         ( layer.maxZoom() >= 0 && zoomLevel > layer.maxZoom() ) )
+      continue;
+
+    QgsVectorLayer *vl = layer.layer();
+    TileLayer tileLayer;
+    tileLayer.name = layer.layerName().isEmpty() ? vl->name() : layer.layerName();
+    tileLayer.fields = vl->fields();
+    tileLayer.tileFeatures.resize( blockColumns * blockRows );
+
+    QgsCoordinateTransform ct( vl->crs(), destCrs, mTransformContext );
+    QgsRectangle layerBlockExtent;
+    try
+    {
+      layerBlockExtent = ct.transformBoundingBox( blockExtent, QgsCoordinateTransform::ReverseTransform );
+    }
+    catch ( const QgsCsException & )
+    {
+      QgsDebugMsg( "Failed to reproject tile extent to the layer" );
+      tileLayers << tileLayer;
+      continue;
+    }
+
+    if ( layerBlockExtent.intersects( vl->extent() ) )
+    {
+      QgsFeatureRequest request;
+      request.setFilterRect( layerBlockExtent );
+      if ( !layer.filterExpression().isEmpty() )
+        request.setFilterExpression( layer.filterExpression() );
+      QgsFeatureIterator fit = vl->getFeatures( request );
+
+      QgsFeature f;
+      while ( fit.nextFeature( f ) )
+      {
+        if ( feedback && feedback->isCanceled() )
+          return QVector<QByteArray>();
 
-        if ( tileData.isEmpty() )
+        QgsGeometry g = f.geometry();
+        try
         {
-          // skipping empty tile - no need to write it
-          continue;
+          g.transform( ct );
         }
-
-        if ( sourceType == QLatin1String( "xyz" ) )
+        catch ( const QgsCsException & )
         {
-          if ( !writeTileFileXYZ( sourcePath, tileID, tileMatrix, tileData ) )
-            return false;  // error message already set
+          QgsDebugMsg( "Failed to reproject geometry " + QString::number( f.id() ) );
+          continue;
         }
-        else  // mbtiles
+        f.setGeometry( g );
+
+        QgsRectangle featureExtent = g.boundingBox();
+        featureExtent.grow( buffer );
+        const QgsTileRange featureRange = tileMatrix.tileRangeFromExtent( featureExtent );
+        if ( !featureRange.isValid() )
+          continue;
+
+        for ( int row = std::max( featureRange.startRow(), blockRange.startRow() ); row <= std::min( featureRange.endRow(), blockRange.endRow() ); ++row )
         {
-          QByteArray gzipTileData;
-          QgsMbTiles::encodeGzip( tileData, gzipTileData );
-          int rowTMS = pow( 2, tileID.zoomLevel() ) - tileID.row() - 1;
-          mbtiles->setTileData( tileID.zoomLevel(), tileID.column(), rowTMS, gzipTileData );
+          for ( int col = std::max( featureRange.startColumn(), blockRange.startColumn() ); col <= std::min( featureRange.endColumn(), blockRange.endColumn() ); ++col )
+          {
+            tileLayer.tileFeatures[( row - blockRange.startRow() ) * blockColumns + col - blockRange.startColumn()].append( f );
+          }
         }
       }
     }
+    tileLayers << tileLayer;
   }
 
-  return true;
+  // encode the tiles of the block in parallel
+  QVector<QByteArray> blockData( blockColumns * blockRows );
+  QVector<int> tileIndexes( blockData.count() );
+  std::iota( tileIndexes.begin(), tileIndexes.end(), 0 );
+  QtConcurrent::blockingMap( tileIndexes, [&]( int tileIndex )
+  {
+    if ( feedback && feedback->isCanceled() )
+      return;
+
+    const QgsTileXYZ tileID( blockRange.startColumn() + tileIndex % blockColumns, blockRange.startRow() + tileIndex / blockColumns, zoomLevel );
+    QgsVectorTileMVTEncoder encoder( tileID );
+    encoder.setTransformContext( mTransformContext );
+    for ( const TileLayer &tileLayer : std::as_const( tileLayers ) )
+    {
+      encoder.addFeatures( tileLayer.name, tileLayer.fields, tileLayer.tileFeatures.at( tileIndex ), feedback );
+    }
+
+    const QByteArray tileData = encoder.encode();
+    if ( gzip && !tileData.isEmpty() )
+      QgsMbTiles::encodeGzip( tileData, blockData[tileIndex] );
+    else
+      blockData[tileIndex] = tileData;
+  } );
+  return blockData;
 }
 
 QgsRectangle QgsVectorTileWriter::fullExtent() const
@@ -22,6 +22,7 @@
 
 class QgsFeedback;
 class QgsTileMatrix;
+class QgsTileRange;
 class QgsTileXYZ;
 class QgsVectorLayer;
 
@@ -153,6 +154,9 @@ class CORE_EXPORT QgsVectorTileWriter
      *
      * If a pointer to a feedback object is provided, it can be used to track progress or
      * provide cancellation functionality.
+     *
+     * Each zoom level is written in blocks of up to 16x16 tiles. Input layers are queried
+     * once per block (not once per tile), and the tiles of a block are encoded in parallel.
      */
     bool writeTiles( QgsFeedback *feedback = nullptr );
 
@@ -166,6 +170,12 @@ class CORE_EXPORT QgsVectorTileWriter
     QgsRectangle fullExtent() const;
 
   private:
+
+    /**
+     * Encodes the tiles of \a blockRange, fetching features of each layer only once for the whole block.
+     * Returns the encoded data of the tiles, row by row, with empty data for empty tiles.
+     */
+    QVector<QByteArray> encodeTileBlock( const QgsTileMatrix &tileMatrix, const QgsTileRange &blockRange, bool gzip, QgsFeedback *feedback );
     bool writeTileFileXYZ( const QString &sourcePath, QgsTileXYZ tileID, const QgsTileMatrix &tileMatrix, const QByteArray &tileData );
     QString mbtilesJsonSchema();
 
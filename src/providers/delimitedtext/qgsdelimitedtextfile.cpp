@@ -29,6 +29,9 @@
 #include <QRegularExpression>
 #include <QUrl>
 #include <QUrlQuery>
+#include <QHash>
+
+#include <algorithm>
 
 QgsDelimitedTextFile::QgsDelimitedTextFile( const QString &url )
   : mFileName( QString() )
@@ -110,6 +113,7 @@ bool QgsDelimitedTextFile::open()
 void QgsDelimitedTextFile::updateFile()
 {
   close();
+  mLineOffsets.clear();
   emit fileUpdated();
 }
 
@@ -119,6 +123,7 @@ void QgsDelimitedTextFile::resetDefinition()
   close();
   mFieldNames.clear();
   mMaxFieldCount = 0;
+  mLineOffsets.clear();
 }
 
 // Extract the provider definition from the url
@@ -551,6 +556,27 @@ QgsDelimitedTextFile::Status  QgsDelimitedTextFile::reset()
   mBuffer = QString();
   mPosInBuffer = 0;
 
+  // The byte offsets of the lines can only be derived from the decoded text for UTF-8
+  // and Latin-1. A UTF-8 byte order mark is skipped by the stream whatever the encoding.
+  mFirstLineOffset = -1;
+  mUtf8Offsets = false;
+  const QByteArray bom = mFile->peek( 4 );
+  if ( bom.startsWith( "\xEF\xBB\xBF" ) )
+  {
+    mFirstLineOffset = 3;
+    mUtf8Offsets = true;
+  }
+  else if ( !bom.startsWith( "\xFE\xFF" ) && !bom.startsWith( "\xFF\xFE" ) && !bom.startsWith( QByteArray( "\x00\x00\xFE\xFF", 4 ) ) )
+  {
+    const int mib = mStream->codec() ? mStream->codec()->mibEnum() : 0;
+    if ( mib == 106 || mib == 4 ) // UTF-8, ISO-8859-1
+    {
+      mFirstLineOffset = 0;
+      mUtf8Offsets = mib == 106;
+    }
+  }
+  mNextLineOffset = mFirstLineOffset;
+
   // Skip header lines
   for ( int i = mSkipLines; i-- > 0; )
   {
@@ -588,6 +614,7 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
     // We should rather use mStream->readLine(), but it fails to detect \r
     // line endings.
     int eolPos = -1;
+    int eolLength = 0;
     {
       if ( mLineNumber == 0 )
       {
@@ -639,6 +666,7 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
 
       // Extract the current line from the buffer
       buffer = mBuffer.mid( mPosInBuffer, eolPos - mPosInBuffer );
+      eolLength = nextPos - eolPos;
       // Update current position in buffer to be the one next to the end of
       // line character(s)
       mPosInBuffer = nextPos;
@@ -664,6 +692,8 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
         continue;
       }
     }
+    if ( mNextLineOffset >= 0 )
+      recordLineOffset( buffer, eolLength );
     mLineNumber++;
     if ( skipBlank && buffer.isEmpty() ) continue;
     return RecordOk;
@@ -676,11 +706,30 @@ QgsDelimitedTextFile::Status QgsDelimitedTextFile::nextLine( QString &buffer, bo
 bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 {
   if ( ! mStream ) return false;
-  if ( mLineNumber > nextLineNumber - 1 )
+  bool rewind = mLineNumber > nextLineNumber - 1;
+
+  // Jump to the last known line offset before the line, unless it can be reached by
+  // reading less than LINE_OFFSET_INTERVAL lines from the current position
+  const int offsetIndex = std::min( static_cast< int >( ( nextLineNumber - 1 ) / LINE_OFFSET_INTERVAL ), mLineOffsets.size() - 1 );
+  if ( offsetIndex > 0 && ( rewind || mLineNumber < ( offsetIndex - 1 ) * LINE_OFFSET_INTERVAL ) )
+  {
+    rewind = !seekToLineOffset( offsetIndex );
+    if ( rewind )
+    {
+      // The file has changed since the offsets were recorded, or the lengths of the
+      // lines in bytes were wrong (e.g. invalid UTF-8), so don't use them anymore
+      QgsDebugMsgLevel( QStringLiteral( "Line offsets don't match the file %1" ).arg( mFileName ), 2 );
+      mLineOffsets.clear();
+      mFirstLineOffset = -1;
+    }
+  }
+
+  if ( rewind )
   {
     mRecordNumber = -1;
     mStream->seek( 0 );
     mLineNumber = 0;
+    mNextLineOffset = mFirstLineOffset;
   }
   QString buffer;
   while ( mLineNumber < nextLineNumber - 1 )
@@ -691,6 +740,68 @@ bool QgsDelimitedTextFile::setNextLineNumber( long nextLineNumber )
 
 }
 
+bool QgsDelimitedTextFile::seekToLineOffset( int index )
+{
+  // The end of line character is only known once the first line is read
+  if ( mFirstEOLChar.isNull() )
+    return false;
+
+  const LineOffset lineOffset = mLineOffsets.at( index );
+  if ( ! mStream->seek( lineOffset.offset ) )
+    return false;
+
+  // Only read a small buffer, as the next seek may follow soon when fetching scattered records
+  mBuffer = mStream->read( std::min( mMaxBufferSize, 64 * 1024 ) );
+  mPosInBuffer = 0;
+  const int eolPos = mBuffer.indexOf( mFirstEOLChar );
+  if ( qHash( eolPos >= 0 ? mBuffer.left( eolPos ) : mBuffer ) != lineOffset.hash )
+    return false;
+
+  mLineNumber = static_cast< long >( index ) * LINE_OFFSET_INTERVAL;
+  mRecordNumber = -1;
+  mNextLineOffset = lineOffset.offset;
+  return true;
+}
+
+void QgsDelimitedTextFile::recordLineOffset( const QString &line, int eolLength )
+{
+  if ( mLineNumber % LINE_OFFSET_INTERVAL == 0 && mLineNumber / LINE_OFFSET_INTERVAL == mLineOffsets.size() )
+  {
+    LineOffset lineOffset;
+    lineOffset.offset = mNextLineOffset;
+    lineOffset.hash = qHash( line );
+    mLineOffsets.append( lineOffset );
+  }
+  // end of line characters are always encoded with one byte
+  mNextLineOffset += encodedLength( line ) + eolLength;
+}
+
+qint64 QgsDelimitedTextFile::encodedLength( const QString &text ) const
+{
+  if ( ! mUtf8Offsets )
+    return text.size();
+
+  qint64 length = 0;
+  const QChar *chars = text.constData();
+  const int size = text.size();
+  for ( int i = 0; i < size; ++i )
+  {
+    const ushort c = chars[i].unicode();
+    if ( c < 0x80 )
+      length += 1;
+    else if ( c < 0x800 )
+      length += 2;
+    else if ( QChar::isHighSurrogate( c ) && i + 1 < size && QChar::isLowSurrogate( chars[i + 1].unicode() ) )
+    {
+      length += 4;
+      ++i;
+    }
+    else
+      length += 3;
+  }
+  return length;
+}
+
 void QgsDelimitedTextFile::appendField( QStringList &record, QString field, bool quoted )
 {
   if ( mMaxFields > 0 && record.size() >= mMaxFields ) return;
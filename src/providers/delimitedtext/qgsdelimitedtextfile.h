@@ -22,6 +22,7 @@
 #include <QRegularExpression>
 #include <QUrl>
 #include <QObject>
+#include <QVector>
 
 class QgsFeature;
 class QgsField;
@@ -299,6 +300,31 @@ class QgsDelimitedTextFile : public QObject
      */
     long recordCount() { return mMaxRecordNumber; }
 
+    //! Number of lines between two line offsets recorded while reading the file
+    static const int LINE_OFFSET_INTERVAL = 1024;
+
+    //! Position of a line in the file, used to seek to a record without reading all the lines before it
+    struct LineOffset
+    {
+      //! Offset of the start of the line in bytes
+      qint64 offset = 0;
+      //! Hash of the line content, used to check that the offset still matches the file
+      uint hash = 0;
+    };
+
+    /**
+     * Returns the positions of every LINE_OFFSET_INTERVAL lines, recorded while reading the file.
+     * Offsets are only recorded for UTF-8 and ISO-8859-1 encoded files, as the length in
+     * bytes of the lines is not known for other encodings.
+     */
+    QVector<LineOffset> lineOffsets() const { return mLineOffsets; }
+
+    /**
+     * Sets the positions of lines in the file, as returned by lineOffsets() for the same file.
+     * Offsets which don't match the file are ignored.
+     */
+    void setLineOffsets( const QVector<LineOffset> &offsets ) { mLineOffsets = offsets; }
+
     /**
      * Reset the file to reread from the beginning
      */
@@ -391,6 +417,19 @@ class QgsDelimitedTextFile : public QObject
      */
     bool setNextLineNumber( long nextLineNumber );
 
+    /**
+     * Moves the stream to the line offset at \a index in mLineOffsets.
+     * Returns FALSE if the line at the offset doesn't match the file, in which case
+     * the stream must be reset.
+     */
+    bool seekToLineOffset( int index );
+
+    //! Records the line offsets after reading \a line, followed by \a eolLength end of line characters
+    void recordLineOffset( const QString &line, int eolLength );
+
+    //! Returns the length in bytes of \a text in the file
+    qint64 encodedLength( const QString &text ) const;
+
     /**
      * Utility routine to add a field to a record, accounting for trimming
      *  and discarding, and maximum field count
@@ -439,6 +478,13 @@ class QgsDelimitedTextFile : public QObject
     long mMaxRecordNumber = -1;
     int mMaxFieldCount = 0;
 
+    // Positions of lines in the file, and offset of the first and next line read,
+    // or -1 if the offsets can't be tracked for the file encoding
+    QVector<LineOffset> mLineOffsets;
+    qint64 mFirstLineOffset = -1;
+    qint64 mNextLineOffset = -1;
+    bool mUtf8Offsets = false;
+
     QString mDefaultFieldName;
     QRegularExpression mDefaultFieldRegexp;
 };
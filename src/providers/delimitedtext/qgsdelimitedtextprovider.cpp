@@ -22,6 +22,9 @@
 #include <QFileInfo>
 #include <QDataStream>
 #include <QTextStream>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QStringList>
 #include <QSettings>
 #include <QRegularExpression>
@@ -56,6 +59,12 @@ const QString QgsDelimitedTextProvider::TEXT_PROVIDER_DESCRIPTION = QStringLiter
 
 static const int SUBSET_ID_THRESHOLD_FACTOR = 10;
 
+// Identification and version of the scan cache files, the version must be
+// increased whenever the content of the cache changes.
+
+static const quint32 SCAN_CACHE_MAGIC = 0x44544321; // "DTC!"
+static const quint32 SCAN_CACHE_VERSION = 1;
+
 QRegularExpression QgsDelimitedTextProvider::sWktPrefixRegexp( QStringLiteral( "^\\s*(?:\\d+\\s+|SRID\\=\\d+\\;)" ), QRegularExpression::CaseInsensitiveOption );
 QRegularExpression QgsDelimitedTextProvider::sCrdDmsRegexp( QStringLiteral( "^\\s*(?:([-+nsew])\\s*)?(\\d{1,3})(?:[^0-9.]+([0-5]?\\d))?[^0-9.]+([0-5]?\\d(?:\\.\\d+)?)[^0-9.]*([-+nsew])?\\s*$" ), QRegularExpression::CaseInsensitiveOption );
 
@@ -155,6 +164,11 @@ QgsDelimitedTextProvider::QgsDelimitedTextProvider( const QString &uri, const Pr
     QgsDebugMsgLevel( "subset is: " + subset, 2 );
   }
 
+  if ( query.hasQueryItem( QStringLiteral( "scanCache" ) ) )
+  {
+    mUseScanCache = ! query.queryItemValue( QStringLiteral( "scanCache" ) ).toLower().startsWith( 'n' );
+  }
+
   if ( query.hasQueryItem( QStringLiteral( "quiet" ) ) ) mShowInvalidLines = false;
 
   // Do an initial scan of the file to determine field names, types,
@@ -385,6 +399,23 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
     return;
   }
 
+  // Reuse the results of a previous scan if the file has not changed since.
+  // The key is computed before the scan, so that the cache is invalid if the
+  // file is modified while it is being scanned.
+
+  const QByteArray scanCacheKey = mUseScanCache ? this->scanCacheKey( buildIndexes ) : QByteArray();
+  QStringList cachedWarnings;
+  if ( mUseScanCache && readScanCache( scanCacheKey, cachedWarnings ) )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Delimited text scan results read from " ) + scanCacheFileName(), 2 );
+    reportErrors( cachedWarnings );
+    mUseSpatialIndex = buildSpatialIndex;
+    mValid = mGeometryType != QgsWkbTypes::UnknownGeometry;
+    mLayerValid = mValid;
+    connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
+    return;
+  }
+
   // Scan the entire file to determine
   // 1) the number of fields (this is handled by QgsDelimitedTextFile mFile
   // 2) the number of valid features.  Note that the selection of valid features
@@ -413,6 +444,9 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
 
   bool foundFirstGeometry = false;
 
+  // Entries of the spatial index, to be written to the scan cache
+  QVector< QPair< QgsFeatureId, QgsRectangle > > spatialIndexEntries;
+
   while ( true )
   {
     QgsDelimitedTextFile::Status status = mFile->nextRecord( parts );
@@ -481,6 +515,8 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
                 f.setId( mFile->recordId() );
                 f.setGeometry( geom );
                 mSpatialIndex->addFeature( f );
+                if ( mUseScanCache )
+                  spatialIndexEntries.append( qMakePair( f.id(), geom.boundingBox() ) );
               }
             }
             else
@@ -548,6 +584,8 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
             f.setId( mFile->recordId() );
             f.setGeometry( QgsGeometry::fromPointXY( pt ) );
             mSpatialIndex->addFeature( f );
+            if ( mUseScanCache )
+              spatialIndexEntries.append( qMakePair( f.id(), f.geometry().boundingBox() ) );
           }
         }
         else
@@ -805,9 +843,10 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   // If more than 10% of records are being skipped, then use index.  (Not based on any experimentation,
   // could do with some analysis?)
 
+  mRecordCount = mFile->recordCount();
   if ( buildSubsetIndex )
   {
-    long recordCount = mFile->recordCount();
+    long recordCount = mRecordCount;
     recordCount -= recordCount / SUBSET_ID_THRESHOLD_FACTOR;
     mUseSubsetIndex = mSubsetIndex.size() < recordCount;
     if ( ! mUseSubsetIndex )
@@ -819,6 +858,9 @@ void QgsDelimitedTextProvider::scanFile( bool buildIndexes )
   mValid = mGeometryType != QgsWkbTypes::UnknownGeometry;
   mLayerValid = mValid;
 
+  if ( mUseScanCache && mValid )
+    writeScanCache( scanCacheKey, warnings, spatialIndexEntries );
+
   // If it is valid, then watch for changes to the file
   connect( mFile.get(), &QgsDelimitedTextFile::fileUpdated, this, &QgsDelimitedTextProvider::onFileUpdated );
 }
@@ -914,7 +956,7 @@ void QgsDelimitedTextProvider::rescanFile() const
   }
   if ( buildSubsetIndex )
   {
-    long recordCount = mFile->recordCount();
+    long recordCount = mRecordCount;
     recordCount -= recordCount / SUBSET_ID_THRESHOLD_FACTOR;
     mUseSubsetIndex = recordCount < mSubsetIndex.size();
     if ( ! mUseSubsetIndex )
@@ -1200,6 +1242,197 @@ void QgsDelimitedTextProvider::setUriParameter( const QString &parameter, const
   setDataSourceUri( QString::fromLatin1( url.toEncoded() ) );
 }
 
+QString QgsDelimitedTextProvider::scanCacheFileName() const
+{
+  return mFile->fileName() + QStringLiteral( ".dtcache" );
+}
+
+QByteArray QgsDelimitedTextProvider::scanCacheKey( bool buildIndexes ) const
+{
+  const QFileInfo dataInfo( mFile->fileName() );
+  if ( ! dataInfo.exists() )
+    return QByteArray();
+
+  QCryptographicHash hash( QCryptographicHash::Sha1 );
+  hash.addData( dataSourceUri().toUtf8() );
+  hash.addData( buildIndexes ? "1" : "0" );
+
+  // The field types can be read from a CSVT file, see readCsvtFieldTypes()
+  const QList< QFileInfo > files { dataInfo, QFileInfo( dataInfo.filePath() + 't' ), QFileInfo( dataInfo.filePath() + 'T' ) };
+  for ( const QFileInfo &info : files )
+  {
+    hash.addData( QByteArray::number( info.exists() ? info.size() : -1 ) );
+    hash.addData( QByteArray::number( info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0 ) );
+  }
+  return hash.result();
+}
+
+bool QgsDelimitedTextProvider::readScanCache( const QByteArray &key, QStringList &warnings )
+{
+  if ( key.isEmpty() )
+    return false;
+
+  QFile file( scanCacheFileName() );
+  if ( ! file.open( QIODevice::ReadOnly ) )
+    return false;
+
+  QDataStream in( &file );
+  in.setVersion( QDataStream::Qt_5_0 );
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  QByteArray cacheKey;
+  in >> magic >> version;
+  if ( magic != SCAN_CACHE_MAGIC || version != SCAN_CACHE_VERSION )
+    return false;
+  in >> cacheKey;
+  if ( cacheKey != key )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Scan cache %1 is out of date" ).arg( file.fileName() ), 2 );
+    return false;
+  }
+
+  // Read everything before modifying the provider, in case the file is truncated
+
+  QgsFields fields;
+  qint32 fieldCount = 0;
+  in >> fieldCount;
+  for ( int i = 0; i < fieldCount && in.status() == QDataStream::Ok; ++i )
+  {
+    QString name;
+    qint32 type = 0;
+    QString typeName;
+    in >> name >> type >> typeName;
+    fields.append( QgsField( name, static_cast< QVariant::Type >( type ), typeName ) );
+  }
+
+  QList<int> columns;
+  qint32 columnCount = 0;
+  bool wktHasPrefix = false;
+  qint64 numberFeatures = 0;
+  qint64 recordCount = 0;
+  double xMin = 0, yMin = 0, xMax = 0, yMax = 0;
+  qint32 wkbType = 0;
+  qint32 geometryType = 0;
+  QStringList scanWarnings;
+  QStringList invalidLines;
+  qint32 nExtraInvalidLines = 0;
+  bool useSubsetIndex = false;
+  in >> columns >> columnCount >> wktHasPrefix >> numberFeatures >> recordCount
+     >> xMin >> yMin >> xMax >> yMax >> wkbType >> geometryType
+     >> scanWarnings >> invalidLines >> nExtraInvalidLines >> useSubsetIndex;
+
+  QList<quintptr> subsetIndex;
+  qint32 subsetIndexSize = 0;
+  in >> subsetIndexSize;
+  for ( int i = 0; i < subsetIndexSize && in.status() == QDataStream::Ok; ++i )
+  {
+    quint64 id = 0;
+    in >> id;
+    subsetIndex.append( static_cast< quintptr >( id ) );
+  }
+
+  QVector< QPair< QgsFeatureId, QgsRectangle > > spatialIndexEntries;
+  qint32 spatialIndexSize = 0;
+  in >> spatialIndexSize;
+  for ( int i = 0; i < spatialIndexSize && in.status() == QDataStream::Ok; ++i )
+  {
+    qint64 id = 0;
+    double entryXMin = 0, entryYMin = 0, entryXMax = 0, entryYMax = 0;
+    in >> id >> entryXMin >> entryYMin >> entryXMax >> entryYMax;
+    spatialIndexEntries.append( qMakePair( static_cast< QgsFeatureId >( id ), QgsRectangle( entryXMin, entryYMin, entryXMax, entryYMax, false ) ) );
+  }
+
+  QVector< QgsDelimitedTextFile::LineOffset > lineOffsets;
+  qint32 lineOffsetCount = 0;
+  in >> lineOffsetCount;
+  for ( int i = 0; i < lineOffsetCount && in.status() == QDataStream::Ok; ++i )
+  {
+    QgsDelimitedTextFile::LineOffset lineOffset;
+    quint32 hash = 0;
+    in >> lineOffset.offset >> hash;
+    lineOffset.hash = hash;
+    lineOffsets.append( lineOffset );
+  }
+
+  if ( in.status() != QDataStream::Ok )
+  {
+    QgsDebugMsg( QStringLiteral( "Scan cache %1 is not valid" ).arg( file.fileName() ) );
+    return false;
+  }
+
+  attributeFields = fields;
+  attributeColumns = columns;
+  mFieldCount = columnCount;
+  mWktHasPrefix = wktHasPrefix;
+  mNumberFeatures = numberFeatures;
+  mRecordCount = recordCount;
+  mExtent = QgsRectangle( xMin, yMin, xMax, yMax, false );
+  mWkbType = static_cast< QgsWkbTypes::Type >( wkbType );
+  mGeometryType = static_cast< QgsWkbTypes::GeometryType >( geometryType );
+  mInvalidLines = invalidLines;
+  mNExtraInvalidLines = nExtraInvalidLines;
+  mUseSubsetIndex = useSubsetIndex;
+  mSubsetIndex = subsetIndex;
+  if ( mSpatialIndex )
+  {
+    for ( const QPair< QgsFeatureId, QgsRectangle > &entry : std::as_const( spatialIndexEntries ) )
+      mSpatialIndex->addFeature( entry.first, entry.second );
+  }
+  mFile->setLineOffsets( lineOffsets );
+  warnings = scanWarnings;
+  return true;
+}
+
+void QgsDelimitedTextProvider::writeScanCache( const QByteArray &key, const QStringList &warnings, const QVector< QPair< QgsFeatureId, QgsRectangle > > &spatialIndexEntries ) const
+{
+  if ( key.isEmpty() )
+    return;
+
+  QSaveFile file( scanCacheFileName() );
+  if ( ! file.open( QIODevice::WriteOnly ) )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Scan cache %1 cannot be written" ).arg( file.fileName() ), 2 );
+    return;
+  }
+
+  QDataStream out( &file );
+  out.setVersion( QDataStream::Qt_5_0 );
+
+  out << SCAN_CACHE_MAGIC << SCAN_CACHE_VERSION << key;
+
+  out << static_cast< qint32 >( attributeFields.size() );
+  for ( const QgsField &field : attributeFields )
+    out << field.name() << static_cast< qint32 >( field.type() ) << field.typeName();
+
+  out << attributeColumns << static_cast< qint32 >( mFieldCount ) << mWktHasPrefix
+      << static_cast< qint64 >( mNumberFeatures ) << static_cast< qint64 >( mRecordCount )
+      << mExtent.xMinimum() << mExtent.yMinimum() << mExtent.xMaximum() << mExtent.yMaximum()
+      << static_cast< qint32 >( mWkbType ) << static_cast< qint32 >( mGeometryType )
+      << warnings << mInvalidLines << static_cast< qint32 >( mNExtraInvalidLines ) << mUseSubsetIndex;
+
+  out << static_cast< qint32 >( mSubsetIndex.size() );
+  for ( quintptr id : std::as_const( mSubsetIndex ) )
+    out << static_cast< quint64 >( id );
+
+  out << static_cast< qint32 >( spatialIndexEntries.size() );
+  for ( const QPair< QgsFeatureId, QgsRectangle > &entry : spatialIndexEntries )
+  {
+    out << static_cast< qint64 >( entry.first )
+        << entry.second.xMinimum() << entry.second.yMinimum() << entry.second.xMaximum() << entry.second.yMaximum();
+  }
+
+  const QVector< QgsDelimitedTextFile::LineOffset > lineOffsets = mFile->lineOffsets();
+  out << static_cast< qint32 >( lineOffsets.size() );
+  for ( const QgsDelimitedTextFile::LineOffset &lineOffset : lineOffsets )
+    out << lineOffset.offset << static_cast< quint32 >( lineOffset.hash );
+
+  if ( out.status() != QDataStream::Ok || ! file.commit() )
+  {
+    QgsDebugMsgLevel( QStringLiteral( "Scan cache %1 cannot be written" ).arg( file.fileName() ), 2 );
+  }
+}
+
 void QgsDelimitedTextProvider::onFileUpdated()
 {
   if ( ! mRescanRequired )
@@ -1208,6 +1441,7 @@ void QgsDelimitedTextProvider::onFileUpdated()
     messages.append( tr( "The file has been updated by another application - reloading" ) );
     reportErrors( messages );
     mRescanRequired = true;
+    mRecordCount = -1;
     emit dataChanged();
   }
 }
@@ -153,6 +153,26 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     static bool recordIsEmpty( QStringList &record );
     void setUriParameter( const QString &parameter, const QString &value );
 
+    //! Returns the name of the file where the results of scanFile() are cached
+    QString scanCacheFileName() const;
+
+    /**
+     * Returns the key identifying the results of scanFile() for the current uri, data file
+     * and CSVT file, or an empty key if the data file doesn't exist.
+     */
+    QByteArray scanCacheKey( bool buildIndexes ) const;
+
+    /**
+     * Restores the results of scanFile() from the cache file, if it was written with the same \a key.
+     * \param key key of the scan, as returned by scanCacheKey()
+     * \param warnings will be set to the warnings reported by the scan
+     * \returns TRUE if the results were restored
+     */
+    bool readScanCache( const QByteArray &key, QStringList &warnings );
+
+    //! Writes the results of scanFile() to the cache file, with their \a key, \a warnings and spatial index entries
+    void writeScanCache( const QByteArray &key, const QStringList &warnings, const QVector< QPair< QgsFeatureId, QgsRectangle > > &spatialIndexEntries ) const;
+
 
     static QgsGeometry geomFromWkt( QString &sWkt, bool wktHasPrefixRegexp );
     static bool pointFromXY( QString &sX, QString &sY, QgsPoint &point, const QString &decimalPoint, bool xyDms );
@@ -196,6 +216,8 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     int mGeomType;
 
     mutable long mNumberFeatures;
+    // Number of records in the file when it was scanned
+    long mRecordCount = -1;
     int mSkipLines;
     QString mDecimalPoint;
     bool mXyDms = false;
@@ -230,6 +252,9 @@ class QgsDelimitedTextProvider final: public QgsVectorDataProvider
     mutable bool mCachedUseSpatialIndex;
     mutable std::unique_ptr< QgsSpatialIndex > mSpatialIndex;
 
+    //! Cache the results of the initial scan in a sidecar file
+    bool mUseScanCache = false;
+
     friend class QgsDelimitedTextFeatureIterator;
     friend class QgsDelimitedTextFeatureSource;
 };
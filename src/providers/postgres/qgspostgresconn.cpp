@@ -1631,6 +1631,13 @@ qint64 QgsPostgresConn::getBinaryInt( QgsPostgresResult &queryResult, int row, i
   return oid;
 }
 
+bool QgsPostgresConn::hasIntegerDatetimes() const
+{
+  QMutexLocker locker( &mLock );
+  const char *integerDatetimes = ::PQparameterStatus( mConn, "integer_datetimes" );
+  return integerDatetimes && qstrcmp( integerDatetimes, "on" ) == 0;
+}
+
 QString QgsPostgresConn::fieldExpressionForWhereClause( const QgsField &fld, QVariant::Type valueType, QString expr )
 {
   QString out;
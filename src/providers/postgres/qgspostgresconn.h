@@ -352,6 +352,12 @@ class QgsPostgresConn : public QObject
 
     qint64 getBinaryInt( QgsPostgresResult &queryResult, int row, int col );
 
+    //! Returns TRUE if the values from binary cursors must be converted to the host byte order
+    bool swapEndian() const { return mSwapEndian; }
+
+    //! Returns TRUE if the server transfers dates and times as integers in binary format
+    bool hasIntegerDatetimes() const;
+
     QString fieldExpressionForWhereClause( const QgsField &fld, QVariant::Type valueType = QVariant::LastType, QString expr = "%1" );
 
     QString fieldExpression( const QgsField &fld, QString expr = "%1" );
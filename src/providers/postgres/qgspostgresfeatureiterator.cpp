@@ -12,6 +12,7 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#include "qgsfeaturebatch.h"
 #include "qgsgeometry.h"
 #include "qgspostgresconnpool.h"
 #include "qgspostgresexpressioncompiler.h"
@@ -25,6 +26,88 @@
 
 #include <QElapsedTimer>
 #include <QObject>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  //! Origin of the dates and timestamps transferred in binary format
+  const QDate POSTGRES_EPOCH( 2000, 1, 1 );
+
+  const qint64 MICROSECONDS_PER_DAY = 86400000000LL;
+
+  //! Returns a value of type T transferred in binary format, converted to the host byte order if \a swapEndian is TRUE
+  template<typename T> T binaryValue( const char *data, bool swapEndian )
+  {
+    T value;
+    memcpy( &value, data, sizeof( T ) );
+    return swapEndian ? qbswap( value ) : value;
+  }
+
+  //! Returns the time of day from microseconds since midnight, rounded to milliseconds like text times
+  QTime timeFromMicroseconds( qint64 microseconds )
+  {
+    const qint64 seconds = microseconds / 1000000;
+    const int milliseconds = std::min( static_cast< int >( std::round( ( microseconds % 1000000 ) / 1000.0 ) ), 999 );
+    return QTime::fromMSecsSinceStartOfDay( static_cast< int >( seconds * 1000 + milliseconds ) );
+  }
+
+  //! Returns TRUE if a \a wkb geometry returned by PostGIS must be modified by convertPostgisWkb() before it can be read
+  bool postgisWkbNeedsConversion( const char *wkb )
+  {
+    unsigned int wkbType;
+    memcpy( &wkbType, wkb + 1, sizeof( wkbType ) );
+    return static_cast< unsigned int >( QgsPostgresConn::wkbTypeFromOgcWkbType( wkbType ) ) != wkbType || wkbType % 1000 == 16;
+  }
+
+  /**
+   * Converts the geometry type of a \a wkb geometry returned by PostGIS to the QGIS type, in place.
+   * PostGIS stores TIN as a collection of Triangles. Since Triangles are not supported, they are converted to Polygons.
+   */
+  void convertPostgisWkb( unsigned char *wkb )
+  {
+    unsigned int wkbType;
+    memcpy( &wkbType, wkb + 1, sizeof( wkbType ) );
+    QgsWkbTypes::Type newType = QgsPostgresConn::wkbTypeFromOgcWkbType( wkbType );
+
+    if ( ( unsigned int )newType != wkbType )
+    {
+      // overwrite type
+      unsigned int n = newType;
+      memcpy( wkb + 1, &n, sizeof( n ) );
+    }
+
+    const int nDims = 2 + ( QgsWkbTypes::hasZ( newType ) ? 1 : 0 ) + ( QgsWkbTypes::hasM( newType ) ? 1 : 0 );
+    if ( wkbType % 1000 == 16 )
+    {
+      unsigned int numGeoms;
+      memcpy( &numGeoms, wkb + 5, sizeof( unsigned int ) );
+      unsigned char *part = wkb + 9;
+      for ( unsigned int i = 0; i < numGeoms; ++i )
+      {
+        const unsigned int localType = QgsWkbTypes::singleType( newType ); // polygon(Z|M)
+        memcpy( part + 1, &localType, sizeof( localType ) );
+
+        // skip endian and type info
+        part += sizeof( unsigned int ) + 1;
+
+        // skip coordinates
+        unsigned int nRings;
+        memcpy( &nRings, part, sizeof( int ) );
+        part += sizeof( int );
+        for ( unsigned int j = 0; j < nRings; ++j )
+        {
+          unsigned int nPoints;
+          memcpy( &nPoints, part, sizeof( int ) );
+          part += sizeof( nPoints ) + sizeof( double ) * nDims * nPoints;
+        }
+      }
+    }
+  }
+}
 
 QgsPostgresFeatureIterator::QgsPostgresFeatureIterator( QgsPostgresFeatureSource *source, bool ownSource, const QgsFeatureRequest &request )
   : QgsAbstractFeatureIteratorFromSource<QgsPostgresFeatureSource>( source, ownSource, request )
@@ -246,59 +329,41 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
   if ( mClosed )
     return false;
 
-  if ( mFeatureQueue.empty() && !mLastFetch )
+  if ( mFeatureQueue.empty() && !mBatchResults.empty() )
   {
-#if 0 //disabled dynamic queue size
-    QElapsedTimer timer;
-    timer.start();
-#endif
-
-    QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
-    QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
-
-    lock();
-    if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
-    {
-      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-    }
-
-    QgsPostgresResult queryResult;
-    for ( ;; )
+    // rows fetched, but not read, by fetchBatch()
+    for ( ; mBatchResultIndex < mBatchResults.size(); ++mBatchResultIndex )
     {
-      queryResult = mConn->PQgetResult();
-      if ( !queryResult.result() )
-        break;
-
-      if ( queryResult.PQresultStatus() != PGRES_TUPLES_OK )
+      QgsPostgresResult &queryResult = *mBatchResults[ mBatchResultIndex ];
+      for ( ; mBatchRow < queryResult.PQntuples(); ++mBatchRow )
       {
-        QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
-        break;
+        mFeatureQueue.enqueue( QgsFeature() );
+        getFeature( queryResult, mBatchRow, mFeatureQueue.back() );
       }
+      mBatchRow = 0;
+    }
+    mBatchResults.clear();
+    mBatchResultIndex = 0;
+  }
 
-      int rows = queryResult.PQntuples();
-      if ( rows == 0 )
-        continue;
+  if ( mFeatureQueue.empty() && !mLastFetch )
+  {
+    QElapsedTimer timer;
+    timer.start();
 
-      mLastFetch = rows < mFeatureQueueSize;
+    const std::vector< std::unique_ptr< QgsPostgresResult > > results = fetchNextResults();
 
+    for ( const std::unique_ptr< QgsPostgresResult > &queryResult : results )
+    {
+      const int rows = queryResult->PQntuples();
       for ( int row = 0; row < rows; row++ )
       {
         mFeatureQueue.enqueue( QgsFeature() );
-        getFeature( queryResult, row, mFeatureQueue.back() );
+        getFeature( *queryResult, row, mFeatureQueue.back() );
       } // for each row in queue
     }
-    unlock();
 
-#if 0 //disabled dynamic queue size
-    if ( timer.elapsed() > 500 && mFeatureQueueSize > 1 )
-    {
-      mFeatureQueueSize /= 2;
-    }
-    else if ( timer.elapsed() < 50 && mFeatureQueueSize < 10000 )
-    {
-      mFeatureQueueSize *= 2;
-    }
-#endif
+    adaptFetchSize( timer.elapsed() );
   }
 
   if ( mFeatureQueue.empty() )
@@ -321,6 +386,282 @@ bool QgsPostgresFeatureIterator::fetchFeature( QgsFeature &feature )
   return true;
 }
 
+int QgsPostgresFeatureIterator::fetchBatch( QgsFeatureBatch &batch, int maxFeatures )
+{
+  // geometries which are transformed, or simplified locally, need the complete feature: leave them to fetchFeature()
+  if ( batch.fetchGeometry() && ( mTransform.isValid() || mRequest.simplifyMethod().methodType() != QgsSimplifyMethod::NoSimplification ) )
+    return -1;
+
+  if ( mClosed )
+    return 0;
+
+  int count = 0;
+
+  // features already read by fetchFeature()
+  while ( count < maxFeatures && !mFeatureQueue.empty() )
+  {
+    batch.appendFeature( mFeatureQueue.dequeue() );
+    mFetched++;
+    count++;
+  }
+
+  // position of the value of each batch column in the cursor rows, as laid out by declareCursor(), or
+  // -1 for the attributes which are not fetched. The values of primary key attributes are read from the feature id
+  const bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
+  const QgsAttributeList fetchAttributes = subsetOfAttributes ? mRequest.subsetOfAttributes() : mSource->mFields.allAttributesList();
+  int attributesColumn = mFetchGeometry ? 1 : 0;
+  switch ( mSource->mPrimaryKeyType )
+  {
+    case PktFidMap:
+      attributesColumn += mSource->mPrimaryKeyAttrs.size();
+      break;
+    case PktUnknown:
+      break;
+    default:
+      attributesColumn++;
+      break;
+  }
+  QVector< int > fieldColumns( mSource->mFields.count(), -1 );
+  for ( int idx : fetchAttributes )
+  {
+    if ( idx >= 0 && idx < fieldColumns.size() && !mSource->mPrimaryKeyAttrs.contains( idx ) )
+      fieldColumns[ idx ] = attributesColumn++;
+  }
+  QVector< int > batchColumns( batch.columnCount() );
+  QVector< int > batchPrimaryKeys( batch.columnCount() );
+  for ( int column = 0; column < batch.columnCount(); ++column )
+  {
+    const int idx = batch.column( column ).fieldIndex();
+    const bool validIndex = idx >= 0 && idx < mSource->mFields.count();
+    batchColumns[ column ] = validIndex ? fieldColumns.at( idx ) : -1;
+    batchPrimaryKeys[ column ] = validIndex && fetchAttributes.contains( idx ) ? mSource->mPrimaryKeyAttrs.indexOf( idx ) : -1;
+  }
+
+  QByteArray convertedWkb;
+  QVariantList primaryKeyValues;
+  while ( count < maxFeatures )
+  {
+    if ( mBatchResultIndex < mBatchResults.size() && mBatchRow >= mBatchResults[ mBatchResultIndex ]->PQntuples() )
+    {
+      mBatchResultIndex++;
+      mBatchRow = 0;
+      continue;
+    }
+
+    if ( mBatchResultIndex >= mBatchResults.size() )
+    {
+      mBatchResults.clear();
+      mBatchResultIndex = 0;
+      mBatchRow = 0;
+      if ( !mLastFetch )
+      {
+        QElapsedTimer timer;
+        timer.start();
+        mBatchResults = fetchNextResults();
+        adaptFetchSize( timer.elapsed() );
+      }
+
+      if ( mBatchResults.empty() )
+      {
+        QgsDebugMsg( QStringLiteral( "Finished after %1 features" ).arg( mFetched ) );
+        close();
+
+        mSource->mShared->ensureFeaturesCountedAtLeast( mFetched );
+        break;
+      }
+      continue;
+    }
+
+    QgsPostgresResult &queryResult = *mBatchResults[ mBatchResultIndex ];
+    const int row = mBatchRow++;
+
+    int col = mFetchGeometry ? 1 : 0;
+    QgsFeatureId fid = 0;
+    primaryKeyValues.clear();
+    if ( !getFeatureId( queryResult, row, col, fid, primaryKeyValues ) )
+      continue;
+
+    batch.beginFeature( fid );
+    for ( int column = 0; column < batch.columnCount(); ++column )
+    {
+      if ( batchPrimaryKeys.at( column ) >= 0 )
+        batch.appendValue( column, primaryKeyValues.value( batchPrimaryKeys.at( column ) ) );
+      else if ( batchColumns.at( column ) >= 0 )
+        appendBatchValue( batch, column, queryResult, row, batchColumns.at( column ) );
+      else
+        batch.appendNull( column );
+    }
+
+    if ( batch.fetchGeometry() )
+    {
+      // the WKB is copied as is into the batch, unless its type needs to be converted
+      const int length = mFetchGeometry ? ::PQgetlength( queryResult.result(), row, 0 ) : 0;
+      const char *wkb = length > 0 ? ::PQgetvalue( queryResult.result(), row, 0 ) : nullptr;
+      if ( length >= 5 && postgisWkbNeedsConversion( wkb ) )
+      {
+        convertedWkb = QByteArray( wkb, length );
+        convertPostgisWkb( reinterpret_cast< unsigned char * >( convertedWkb.data() ) );
+        batch.appendWkb( convertedWkb.constData(), length );
+      }
+      else
+      {
+        batch.appendWkb( wkb, length );
+      }
+    }
+
+    mFetched++;
+    count++;
+  }
+
+  return count;
+}
+
+void QgsPostgresFeatureIterator::appendBatchValue( QgsFeatureBatch &batch, int column, QgsPostgresResult &queryResult, int row, int col )
+{
+  const QgsFeatureBatch::ColumnType columnType = batch.column( column ).type();
+  const int idx = batch.column( column ).fieldIndex();
+  const QgsField &fld = mSource->mFields.at( idx );
+  const ValueFormat format = mValueFormats.at( idx );
+
+  if ( ::PQgetisnull( queryResult.result(), row, col ) )
+  {
+    batch.appendNull( column );
+    return;
+  }
+
+  const char *value = ::PQgetvalue( queryResult.result(), row, col );
+  const int length = ::PQgetlength( queryResult.result(), row, col );
+
+  // integers are stored natively in integer and double columns, doubles in double columns
+  // and text in string columns. All the other values are converted like for fetchFeature()
+  switch ( columnType )
+  {
+    case QgsFeatureBatch::Int64Column:
+    case QgsFeatureBatch::DoubleColumn:
+    {
+      qint64 integer = 0;
+      bool isInteger = true;
+      if ( format == ValueFormat::Int2 && length == sizeof( qint16 ) )
+        integer = binaryValue< qint16 >( value, mSwapEndian );
+      else if ( format == ValueFormat::Int4 && length == sizeof( qint32 ) )
+        integer = binaryValue< qint32 >( value, mSwapEndian );
+      else if ( format == ValueFormat::Text && fld.type() == QVariant::LongLong && fld.typeName() == QLatin1String( "int8" ) && length == sizeof( qint64 ) )
+        integer = binaryValue< qint64 >( value, mSwapEndian );
+      else
+        isInteger = false;
+
+      if ( isInteger )
+      {
+        if ( columnType == QgsFeatureBatch::Int64Column )
+          batch.appendInt64( column, integer );
+        else
+          batch.appendDouble( column, static_cast< double >( integer ) );
+        return;
+      }
+
+      if ( format == ValueFormat::Float8 && length == sizeof( double ) && columnType == QgsFeatureBatch::DoubleColumn )
+      {
+        const quint64 bits = binaryValue< quint64 >( value, mSwapEndian );
+        double number;
+        memcpy( &number, &bits, sizeof( number ) );
+        batch.appendDouble( column, number );
+        return;
+      }
+      break;
+    }
+
+    case QgsFeatureBatch::StringColumn:
+      if ( format == ValueFormat::Text && fld.type() == QVariant::String )
+      {
+        batch.appendString( column, QString::fromUtf8( value, length ) );
+        return;
+      }
+      break;
+
+    case QgsFeatureBatch::VariantColumn:
+      break;
+  }
+
+  batch.appendValue( column, attributeValue( idx, queryResult, row, col ) );
+}
+
+std::vector< std::unique_ptr< QgsPostgresResult > > QgsPostgresFeatureIterator::fetchNextResults()
+{
+  lock();
+  // the batch may already have been requested while the previous one was consumed
+  if ( !mFetchPending )
+    sendFetch();
+
+  std::vector< std::unique_ptr< QgsPostgresResult > > results = fetchResults();
+
+  // request the next batch now, so that the server sends it while this one is converted to features.
+  // This is not done after the first batch, so that consumers only reading the first features don't
+  // wait for an unused batch when closing the iterator, nor on transaction connections, which are used
+  // by other iterators and queries between the calls
+  if ( !mLastFetch && mFetched > 0 && !mIsTransactionConnection )
+    sendFetch();
+  unlock();
+
+  return results;
+}
+
+void QgsPostgresFeatureIterator::adaptFetchSize( qint64 elapsed )
+{
+  // adapt the size of the next batches, to keep the round trips short without making too many of them
+  if ( elapsed > 500 && mFeatureQueueSize > 1 )
+  {
+    mFeatureQueueSize /= 2;
+  }
+  else if ( elapsed < 50 && mFeatureQueueSize < 10000 )
+  {
+    mFeatureQueueSize *= 2;
+  }
+}
+
+void QgsPostgresFeatureIterator::sendFetch()
+{
+  QString fetch = QStringLiteral( "FETCH FORWARD %1 FROM %2" ).arg( mFeatureQueueSize ).arg( mCursorName );
+  QgsDebugMsgLevel( QStringLiteral( "fetching %1 features." ).arg( mFeatureQueueSize ), 4 );
+
+  if ( mConn->PQsendQuery( fetch ) == 0 ) // fetch features asynchronously
+  {
+    QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+    return;
+  }
+
+  mFetchPending = true;
+  mPendingFetchSize = mFeatureQueueSize;
+}
+
+std::vector< std::unique_ptr< QgsPostgresResult > > QgsPostgresFeatureIterator::fetchResults()
+{
+  std::vector< std::unique_ptr< QgsPostgresResult > > results;
+  if ( !mFetchPending )
+    return results;
+
+  mFetchPending = false;
+
+  // PQgetResult() must be called until it returns a null pointer before sending another query
+  for ( ;; )
+  {
+    std::unique_ptr< QgsPostgresResult > queryResult = std::make_unique< QgsPostgresResult >( mConn->PQgetResult() );
+    if ( !queryResult->result() )
+      break;
+
+    if ( queryResult->PQresultStatus() != PGRES_TUPLES_OK )
+    {
+      QgsMessageLog::logMessage( QObject::tr( "Fetching from cursor %1 failed\nDatabase error: %2" ).arg( mCursorName, mConn->PQerrorMessage() ), QObject::tr( "PostGIS" ) );
+      mLastFetch = true;
+      continue;
+    }
+
+    mLastFetch = queryResult->PQntuples() < mPendingFetchSize;
+    results.push_back( std::move( queryResult ) );
+  }
+
+  return results;
+}
+
 bool QgsPostgresFeatureIterator::nextFeatureFilterExpression( QgsFeature &f )
 {
   if ( !mExpressionCompiled )
@@ -379,10 +720,16 @@ bool QgsPostgresFeatureIterator::rewind()
   if ( mClosed )
     return false;
 
+  // discard the batch requested in advance
+  fetchResults();
+
   // move cursor to first record
 
   mConn->PQexecNR( QStringLiteral( "move absolute 0 in %1" ).arg( mCursorName ) );
   mFeatureQueue.clear();
+  mBatchResults.clear();
+  mBatchResultIndex = 0;
+  mBatchRow = 0;
   mFetched = 0;
   mLastFetch = false;
 
@@ -394,6 +741,9 @@ bool QgsPostgresFeatureIterator::close()
   if ( !mConn )
     return false;
 
+  // discard the batch requested in advance
+  fetchResults();
+
   mConn->closeCursor( mCursorName );
 
   if ( !mIsTransactionConnection )
@@ -406,6 +756,9 @@ bool QgsPostgresFeatureIterator::close()
   {
     mFeatureQueue.dequeue();
   }
+  mBatchResults.clear();
+  mBatchResultIndex = 0;
+  mBatchRow = 0;
 
   iteratorClosed();
 
@@ -573,6 +926,11 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
   }
 #endif
 
+  mSwapEndian = mConn->swapEndian();
+  mValueFormats.resize( mSource->mFields.count() );
+  for ( int idx = 0; idx < mSource->mFields.count(); ++idx )
+    mValueFormats[ idx ] = valueFormat( mSource->mFields.at( idx ) );
+
   QString query( QStringLiteral( "SELECT " ) );
   QString delim;
 
@@ -687,7 +1045,7 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
     case PktFidMap:
       for ( int idx : std::as_const( mSource->mPrimaryKeyAttrs ) )
       {
-        query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+        query += delim + attributeExpression( idx );
         delim = ',';
       }
       break;
@@ -704,7 +1062,7 @@ bool QgsPostgresFeatureIterator::declareCursor( const QString &whereClause, long
     if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
       continue;
 
-    query += delim + mConn->fieldExpression( mSource->mFields.at( idx ) );
+    query += delim + attributeExpression( idx );
   }
 
   query += " FROM " + mSource->mQuery;
@@ -746,45 +1104,7 @@ bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int
       memcpy( featureGeom, PQgetvalue( queryResult.result(), row, col ), returnedLength );
       memset( featureGeom + returnedLength, 0, 1 );
 
-      unsigned int wkbType;
-      memcpy( &wkbType, featureGeom + 1, sizeof( wkbType ) );
-      QgsWkbTypes::Type newType = QgsPostgresConn::wkbTypeFromOgcWkbType( wkbType );
-
-      if ( ( unsigned int )newType != wkbType )
-      {
-        // overwrite type
-        unsigned int n = newType;
-        memcpy( featureGeom + 1, &n, sizeof( n ) );
-      }
-
-      // PostGIS stores TIN as a collection of Triangles.
-      // Since Triangles are not supported, they have to be converted to Polygons
-      const int nDims = 2 + ( QgsWkbTypes::hasZ( newType ) ? 1 : 0 ) + ( QgsWkbTypes::hasM( newType ) ? 1 : 0 );
-      if ( wkbType % 1000 == 16 )
-      {
-        unsigned int numGeoms;
-        memcpy( &numGeoms, featureGeom + 5, sizeof( unsigned int ) );
-        unsigned char *wkb = featureGeom + 9;
-        for ( unsigned int i = 0; i < numGeoms; ++i )
-        {
-          const unsigned int localType = QgsWkbTypes::singleType( newType ); // polygon(Z|M)
-          memcpy( wkb + 1, &localType, sizeof( localType ) );
-
-          // skip endian and type info
-          wkb += sizeof( unsigned int ) + 1;
-
-          // skip coordinates
-          unsigned int nRings;
-          memcpy( &nRings, wkb, sizeof( int ) );
-          wkb += sizeof( int );
-          for ( unsigned int j = 0; j < nRings; ++j )
-          {
-            unsigned int nPoints;
-            memcpy( &nPoints, wkb, sizeof( int ) );
-            wkb += sizeof( nPoints ) + sizeof( double ) * nDims * nPoints;
-          }
-        }
-      }
+      convertPostgisWkb( featureGeom );
 
       QgsGeometry g;
       g.fromWkb( featureGeom, returnedLength + 1 );
@@ -798,11 +1118,42 @@ bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int
     col++;
   }
 
-  QgsFeatureId fid = 0;
-
   bool subsetOfAttributes = mRequest.flags() & QgsFeatureRequest::SubsetOfAttributes;
   QgsAttributeList fetchAttributes = mRequest.subsetOfAttributes();
 
+  QgsFeatureId fid = 0;
+  QVariantList primaryKeyValues;
+  if ( !getFeatureId( queryResult, row, col, fid, primaryKeyValues ) )
+    return false;
+
+  for ( int i = 0; i < primaryKeyValues.size(); ++i )
+  {
+    const int idx = mSource->mPrimaryKeyAttrs.at( i );
+    if ( !subsetOfAttributes || fetchAttributes.contains( idx ) )
+      feature.setAttribute( idx, primaryKeyValues.at( i ) );
+  }
+
+  feature.setId( fid );
+  QgsDebugMsgLevel( QStringLiteral( "fid=%1" ).arg( fid ), 4 );
+
+  // iterate attributes
+  if ( subsetOfAttributes )
+  {
+    const auto constFetchAttributes = fetchAttributes;
+    for ( int idx : constFetchAttributes )
+      getFeatureAttribute( idx, queryResult, row, col, feature );
+  }
+  else
+  {
+    for ( int idx = 0; idx < mSource->mFields.count(); ++idx )
+      getFeatureAttribute( idx, queryResult, row, col, feature );
+  }
+
+  return true;
+}
+
+bool QgsPostgresFeatureIterator::getFeatureId( QgsPostgresResult &queryResult, int row, int &col, QgsFeatureId &fid, QVariantList &primaryKeyValues )
+{
   switch ( mSource->mPrimaryKeyType )
   {
     case PktOid:
@@ -812,11 +1163,8 @@ bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int
 
     case PktInt:
       fid = mConn->getBinaryInt( queryResult, row, col++ );
-      if ( !subsetOfAttributes || fetchAttributes.contains( mSource->mPrimaryKeyAttrs.at( 0 ) ) )
-      {
-        feature.setAttribute( mSource->mPrimaryKeyAttrs[0], fid );
-      }
-      // NOTE: this needs be done _after_ the setAttribute call
+      primaryKeyValues << fid;
+      // NOTE: this needs be done _after_ storing the attribute value
       // above as we want the attribute value to be 1:1 with
       // database value
       fid = QgsPostgresUtils::int32pk_to_fid( fid );
@@ -825,51 +1173,26 @@ bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int
     case PktUint64:
     case PktInt64:
     {
-      QVariantList pkVal;
-
       int idx = mSource->mPrimaryKeyAttrs.at( 0 );
       QgsField fld = mSource->mFields.at( idx );
 
       QVariant v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), QString::number( mConn->getBinaryInt( queryResult, row, col ) ), fld.typeName() );
-      pkVal << v;
-
-      if ( !subsetOfAttributes || fetchAttributes.contains( idx ) )
-      {
-        feature.setAttribute( idx, v );
-      }
+      primaryKeyValues << v;
       col++;
 
-      fid = mSource->mShared->lookupFid( pkVal );
+      fid = mSource->mShared->lookupFid( primaryKeyValues );
     }
     break;
 
     case PktFidMap:
     {
-      QVariantList primaryKeyVals;
-
       for ( int idx : std::as_const( mSource->mPrimaryKeyAttrs ) )
       {
-        QgsField fld = mSource->mFields.at( idx );
-        QVariant v;
-
-        if ( fld.type() == QVariant::LongLong )
-        {
-          v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), QString::number( mConn->getBinaryInt( queryResult, row, col ) ), fld.typeName() );
-        }
-        else
-        {
-          v = QgsPostgresProvider::convertValue( fld.type(), fld.subType(), queryResult.PQgetvalue( row, col ), fld.typeName() );
-        }
-        primaryKeyVals << v;
-
-        if ( !subsetOfAttributes || fetchAttributes.contains( idx ) )
-          feature.setAttribute( idx, v );
-
+        primaryKeyValues << attributeValue( idx, queryResult, row, col );
         col++;
       }
 
-      fid = mSource->mShared->lookupFid( primaryKeyVals );
-
+      fid = mSource->mShared->lookupFid( primaryKeyValues );
     }
     break;
 
@@ -878,22 +1201,6 @@ bool QgsPostgresFeatureIterator::getFeature( QgsPostgresResult &queryResult, int
       return false;
   }
 
-  feature.setId( fid );
-  QgsDebugMsgLevel( QStringLiteral( "fid=%1" ).arg( fid ), 4 );
-
-  // iterate attributes
-  if ( subsetOfAttributes )
-  {
-    const auto constFetchAttributes = fetchAttributes;
-    for ( int idx : constFetchAttributes )
-      getFeatureAttribute( idx, queryResult, row, col, feature );
-  }
-  else
-  {
-    for ( int idx = 0; idx < mSource->mFields.count(); ++idx )
-      getFeatureAttribute( idx, queryResult, row, col, feature );
-  }
-
   return true;
 }
 
@@ -902,7 +1209,94 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
   if ( mSource->mPrimaryKeyAttrs.contains( idx ) )
     return;
 
-  const QgsField fld = mSource->mFields.at( idx );
+  feature.setAttribute( idx, attributeValue( idx, queryResult, row, col ) );
+
+  col++;
+}
+
+QVariant QgsPostgresFeatureIterator::attributeValue( int idx, QgsPostgresResult &queryResult, int row, int col )
+{
+  const QgsField &fld = mSource->mFields.at( idx );
+  const ValueFormat format = mValueFormats.at( idx );
+
+  if ( format != ValueFormat::Text )
+  {
+    if ( ::PQgetisnull( queryResult.result(), row, col ) )
+      return QVariant( fld.type() );
+
+    const char *value = ::PQgetvalue( queryResult.result(), row, col );
+    const int length = ::PQgetlength( queryResult.result(), row, col );
+    switch ( format )
+    {
+      case ValueFormat::Int2:
+        if ( length == sizeof( qint16 ) )
+          return static_cast< int >( binaryValue< qint16 >( value, mSwapEndian ) );
+        break;
+
+      case ValueFormat::Int4:
+        if ( length == sizeof( qint32 ) )
+          return static_cast< int >( binaryValue< qint32 >( value, mSwapEndian ) );
+        break;
+
+      case ValueFormat::Float8:
+        if ( length == sizeof( double ) )
+        {
+          const quint64 bits = binaryValue< quint64 >( value, mSwapEndian );
+          double number;
+          memcpy( &number, &bits, sizeof( number ) );
+          return number;
+        }
+        break;
+
+      case ValueFormat::Bool:
+        if ( length == 1 )
+          return *value != 0;
+        break;
+
+      case ValueFormat::Date:
+        if ( length == sizeof( qint32 ) )
+        {
+          const qint32 days = binaryValue< qint32 >( value, mSwapEndian );
+          // infinite dates are not supported by QDate
+          if ( days != std::numeric_limits< qint32 >::max() && days != std::numeric_limits< qint32 >::min() )
+            return POSTGRES_EPOCH.addDays( days );
+        }
+        break;
+
+      case ValueFormat::Time:
+        if ( length == sizeof( qint64 ) )
+        {
+          // 24:00:00 is a valid time for PostgreSQL, but not for QTime
+          const qint64 microseconds = binaryValue< qint64 >( value, mSwapEndian );
+          if ( microseconds >= 0 && microseconds < MICROSECONDS_PER_DAY )
+            return timeFromMicroseconds( microseconds );
+        }
+        break;
+
+      case ValueFormat::Timestamp:
+        if ( length == sizeof( qint64 ) )
+        {
+          // infinite timestamps are not supported by QDateTime
+          const qint64 microseconds = binaryValue< qint64 >( value, mSwapEndian );
+          if ( microseconds != std::numeric_limits< qint64 >::max() && microseconds != std::numeric_limits< qint64 >::min() )
+          {
+            qint64 days = microseconds / MICROSECONDS_PER_DAY;
+            qint64 timeOfDay = microseconds % MICROSECONDS_PER_DAY;
+            if ( timeOfDay < 0 )
+            {
+              days--;
+              timeOfDay += MICROSECONDS_PER_DAY;
+            }
+            return QDateTime( POSTGRES_EPOCH.addDays( days ), timeFromMicroseconds( timeOfDay ) );
+          }
+        }
+        break;
+
+      case ValueFormat::Text:
+        break;
+    }
+    return QVariant( fld.type() );
+  }
 
   QVariant v;
 
@@ -950,9 +1344,46 @@ void QgsPostgresFeatureIterator::getFeatureAttribute( int idx, QgsPostgresResult
       break;
     }
   }
-  feature.setAttribute( idx, v );
 
-  col++;
+  return v;
+}
+
+QgsPostgresFeatureIterator::ValueFormat QgsPostgresFeatureIterator::valueFormat( const QgsField &field ) const
+{
+  // domains and arrays keep their own type name, and are converted to text.
+  // Numeric values are also kept as text, so that they are rounded to doubles like in the other queries
+  const QString &typeName = field.typeName();
+  if ( typeName == QLatin1String( "int2" ) )
+    return ValueFormat::Int2;
+  else if ( typeName == QLatin1String( "int4" ) )
+    return ValueFormat::Int4;
+  else if ( typeName == QLatin1String( "float8" ) )
+    return ValueFormat::Float8;
+  else if ( typeName == QLatin1String( "bool" ) )
+    return ValueFormat::Bool;
+  else if ( typeName == QLatin1String( "date" ) )
+    return ValueFormat::Date;
+
+  // with floating point datetimes (removed in PostgreSQL 10), times are sent as seconds
+  if ( !mConn->hasIntegerDatetimes() )
+    return ValueFormat::Text;
+
+  // timestamps with time zone are converted to the session time zone as text
+  if ( typeName == QLatin1String( "time" ) )
+    return ValueFormat::Time;
+  else if ( typeName == QLatin1String( "timestamp" ) )
+    return ValueFormat::Timestamp;
+
+  return ValueFormat::Text;
+}
+
+QString QgsPostgresFeatureIterator::attributeExpression( int idx ) const
+{
+  const QgsField &field = mSource->mFields.at( idx );
+  if ( mValueFormats.at( idx ) != ValueFormat::Text )
+    return QgsPostgresConn::quotedIdentifier( field.name() );
+
+  return mConn->fieldExpression( field );
 }
 
 
@@ -19,6 +19,9 @@
 
 #include <QQueue>
 
+#include <memory>
+#include <vector>
+
 #include "qgspostgresprovider.h"
 
 class QgsPostgresProvider;
@@ -81,6 +84,7 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
 
   protected:
     bool fetchFeature( QgsFeature &feature ) override;
+    int fetchBatch( QgsFeatureBatch &batch, int maxFeatures ) override;
     bool nextFeatureFilterExpression( QgsFeature &f ) override;
     bool prepareSimplification( const QgsSimplifyMethod &simplifyMethod ) override;
 
@@ -89,11 +93,52 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
     QgsPostgresConn *mConn = nullptr;
 
 
+    //! Formats of the attribute values transferred by the binary cursor
+    enum class ValueFormat
+    {
+      Text, //!< Converted to text in the query if needed, and converted back with QgsPostgresProvider::convertValue()
+      Int2,
+      Int4,
+      Float8,
+      Bool,
+      Date, //!< Days since 2000-01-01
+      Time, //!< Microseconds since midnight
+      Timestamp, //!< Microseconds since 2000-01-01 00:00:00
+    };
+
     QString whereClauseRect();
     bool getFeature( QgsPostgresResult &queryResult, int row, QgsFeature &feature );
+
+    /**
+     * Reads the feature id of a \a row from the primary key columns, starting at \a col, which is moved past them.
+     * The values of the primary key attributes are stored in \a primaryKeyValues, in the order of the primary key attributes.
+     */
+    bool getFeatureId( QgsPostgresResult &queryResult, int row, int &col, QgsFeatureId &fid, QVariantList &primaryKeyValues );
     void getFeatureAttribute( int idx, QgsPostgresResult &queryResult, int row, int &col, QgsFeature &feature );
+    QVariant attributeValue( int idx, QgsPostgresResult &queryResult, int row, int col );
+
+    //! Appends the value at \a col of a \a row to the batch \a column, natively for numeric and text values
+    void appendBatchValue( QgsFeatureBatch &batch, int column, QgsPostgresResult &queryResult, int row, int col );
     bool declareCursor( const QString &whereClause, long limit = -1, bool closeOnFail = true, const QString &orderBy = QString() );
 
+    //! Returns the format used to transfer the values of a \a field
+    ValueFormat valueFormat( const QgsField &field ) const;
+
+    //! Returns the expression selecting the attribute \a idx in the cursor
+    QString attributeExpression( int idx ) const;
+
+    //! Sends the query fetching the next batch of features, without waiting for the results
+    void sendFetch();
+
+    //! Waits for the results of the pending fetch, if any
+    std::vector< std::unique_ptr< QgsPostgresResult > > fetchResults();
+
+    //! Fetches the next batch of rows from the cursor, and requests the following one in advance when possible
+    std::vector< std::unique_ptr< QgsPostgresResult > > fetchNextResults();
+
+    //! Adapts the size of the next batches to the \a elapsed milliseconds taken to fetch and read the last one
+    void adaptFetchSize( qint64 elapsed );
+
     QString mCursorName;
 
     /**
@@ -102,9 +147,30 @@ class QgsPostgresFeatureIterator final: public QgsAbstractFeatureIteratorFromSou
      */
     QQueue<QgsFeature> mFeatureQueue;
 
-    //! Maximal size of the feature queue
+    //! Maximal size of the feature queue, adapted to the time taken by each fetch
     int mFeatureQueueSize = 2000;
 
+    //! TRUE if a fetch was sent and its results were not read yet
+    bool mFetchPending = false;
+
+    //! Number of features requested by the pending fetch
+    int mPendingFetchSize = 0;
+
+    //! Fetched rows which were not read yet by fetchBatch()
+    std::vector< std::unique_ptr< QgsPostgresResult > > mBatchResults;
+
+    //! Index of the result read by fetchBatch() within mBatchResults
+    std::size_t mBatchResultIndex = 0;
+
+    //! Next row read by fetchBatch() within the current result
+    int mBatchRow = 0;
+
+    //! Formats of the attribute values, by field index
+    QVector< ValueFormat > mValueFormats;
+
+    //! TRUE if the binary values must be converted to the host byte order
+    bool mSwapEndian = false;
+
     //! Number of retrieved features
     int mFetched = 0;
 
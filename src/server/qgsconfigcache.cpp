@@ -41,6 +41,9 @@ QgsConfigCache::QgsConfigCache()
 
 const QgsProject *QgsConfigCache::project( const QString &path, const QgsServerSettings *settings )
 {
+  if ( settings )
+    mRenderFeatureCache.setMaximumSize( settings->renderFeatureCacheSize() );
+
   if ( ! mProjectCache[ path ] )
   {
 
@@ -159,14 +162,28 @@ QDomDocument *QgsConfigCache::xmlDocument( const QString &filePath )
   return xmlDoc;
 }
 
+QgsRenderFeatureCache *QgsConfigCache::renderFeatureCache()
+{
+  return &mRenderFeatureCache;
+}
+
 void QgsConfigCache::removeChangedEntry( const QString &path )
 {
+  if ( const QgsProject *project = mProjectCache.object( path ) )
+  {
+    const QStringList layerIds = project->mapLayers().keys();
+    for ( const QString &layerId : layerIds )
+      mRenderFeatureCache.removeLayer( layerId );
+  }
+
   mProjectCache.remove( path );
 
   //xml document must be removed last, as other config cache destructors may require it
   mXmlDocumentCache.remove( path );
 
   mFileSystemWatcher.removePath( path );
+
+  emit projectRemovedFromCache( path );
 }
 
 
@@ -29,6 +29,7 @@
 #include "qgis_sip.h"
 #include "qgsproject.h"
 #include "qgsserversettings.h"
+#include "qgsrenderfeaturecache.h"
 
 /**
  * \ingroup server
@@ -65,6 +66,23 @@ class SERVER_EXPORT QgsConfigCache : public QObject
      */
     const QgsProject *project( const QString &path, const QgsServerSettings *settings = nullptr );
 
+    /**
+     * Returns the cache of features fetched for rendering, which is shared by all requests.
+     * Cached features of a project's layers are removed along with the project.
+     * \note not available in Python bindings
+     * \since QGIS 3.20
+     */
+    QgsRenderFeatureCache *renderFeatureCache() SIP_SKIP;
+
+  signals:
+
+    /**
+     * Emitted when the entry for \a path is removed from the cache, either
+     * with removeEntry() or because the file has been modified.
+     * \since QGIS 3.20
+     */
+    void projectRemovedFromCache( const QString &path );
+
   private:
     QgsConfigCache() SIP_FORCE;
 
@@ -77,6 +95,8 @@ class SERVER_EXPORT QgsConfigCache : public QObject
     QCache<QString, QDomDocument> mXmlDocumentCache;
     QCache<QString, QgsProject> mProjectCache;
 
+    QgsRenderFeatureCache mRenderFeatureCache;
+
   private slots:
     //! Removes changed entry from this cache
     void removeChangedEntry( const QString &path );
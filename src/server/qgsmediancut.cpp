@@ -25,7 +25,7 @@
 #include <QMultiMap>
 #include <QHash>
 
-namespace QgsWms
+namespace QgsServerImageUtils
 {
 
   typedef QList< QPair<QRgb, int> > QgsColorBox; //Color / number of pixels
@@ -320,6 +320,6 @@ namespace QgsWms
     }
   }
 
-} // namespace QgsWms
+} // namespace QgsServerImageUtils
 
 
@@ -23,6 +23,8 @@
 #ifndef QGSMEDIANCUT_H
 #define QGSMEDIANCUT_H
 
+#define SIP_NO_FILE
+
 #include <QVector>
 #include <QImage>
 
@@ -31,7 +33,7 @@
  * \brief Median cut implementation
  */
 
-namespace QgsWms
+namespace QgsServerImageUtils
 {
 
   /**
@@ -39,7 +41,7 @@ namespace QgsWms
    */
   void medianCut( QVector<QRgb> &colorTable, int nColors, const QImage &inputImage );
 
-} // namespace QgsWms
+} // namespace QgsServerImageUtils
 
 #endif
 
@@ -0,0 +1,133 @@
+/***************************************************************************
+                              qgsserverimageutils.cpp
+                              -----------------------
+  begin                : March 2021
+  copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgsserverimageutils.h"
+#include "qgsmediancut.h"
+
+#include <QImage>
+#include <QRegularExpression>
+
+QgsServerImageUtils::ImageOutputFormat QgsServerImageUtils::parseImageFormat( const QString &format )
+{
+  if ( format.compare( QLatin1String( "png" ), Qt::CaseInsensitive ) == 0 ||
+       format.compare( QLatin1String( "image/png" ), Qt::CaseInsensitive ) == 0 )
+  {
+    return PNG;
+  }
+  else if ( format.compare( QLatin1String( "jpg " ), Qt::CaseInsensitive ) == 0  ||
+            format.compare( QLatin1String( "image/jpeg" ), Qt::CaseInsensitive ) == 0 )
+  {
+    return JPEG;
+  }
+  else if ( format.compare( QLatin1String( "webp" ), Qt::CaseInsensitive ) == 0  ||
+            format.compare( QLatin1String( "image/webp" ), Qt::CaseInsensitive ) == 0 )
+  {
+    return WEBP;
+  }
+  else
+  {
+    // lookup for png with mode
+    QRegularExpression modeExpr = QRegularExpression( QStringLiteral( "image/png\\s*;\\s*mode=([^;]+)" ),
+                                  QRegularExpression::CaseInsensitiveOption );
+
+    QRegularExpressionMatch match = modeExpr.match( format );
+    QString mode = match.captured( 1 );
+    if ( mode.compare( QLatin1String( "16bit" ), Qt::CaseInsensitive ) == 0 )
+      return PNG16;
+    if ( mode.compare( QLatin1String( "8bit" ), Qt::CaseInsensitive ) == 0 )
+      return PNG8;
+    if ( mode.compare( QLatin1String( "1bit" ), Qt::CaseInsensitive ) == 0 )
+      return PNG1;
+  }
+
+  return UNKN;
+}
+
+QString QgsServerImageUtils::contentType( ImageOutputFormat format )
+{
+  switch ( format )
+  {
+    case PNG:
+    case PNG8:
+    case PNG16:
+    case PNG1:
+      return QStringLiteral( "image/png" );
+    case JPEG:
+      return QStringLiteral( "image/jpeg" );
+    case WEBP:
+      return QStringLiteral( "image/webp" );
+    case UNKN:
+      break;
+  }
+  return QString();
+}
+
+bool QgsServerImageUtils::writeImage( QIODevice *device, const QImage &image, ImageOutputFormat format, int imageQuality )
+{
+  QImage  result;
+  QString saveFormat;
+  switch ( format )
+  {
+    case PNG:
+      result = image;
+      saveFormat = "PNG";
+      break;
+    case PNG8:
+    {
+      QVector<QRgb> colorTable;
+
+      // Rendering is made with the format QImage::Format_ARGB32_Premultiplied
+      // So we need to convert it in QImage::Format_ARGB32 in order to properly build
+      // the color table.
+      QImage img256 = image.convertToFormat( QImage::Format_ARGB32 );
+      medianCut( colorTable, 256, img256 );
+      result = img256.convertToFormat( QImage::Format_Indexed8, colorTable,
+                                       Qt::ColorOnly | Qt::ThresholdDither |
+                                       Qt::ThresholdAlphaDither | Qt::NoOpaqueDetection );
+    }
+    saveFormat = "PNG";
+    break;
+    case PNG16:
+      result = image.convertToFormat( QImage::Format_ARGB4444_Premultiplied );
+      saveFormat = "PNG";
+      break;
+    case PNG1:
+      result = image.convertToFormat( QImage::Format_Mono,
+                                      Qt::MonoOnly | Qt::ThresholdDither |
+                                      Qt::ThresholdAlphaDither | Qt::NoOpaqueDetection );
+      saveFormat = "PNG";
+      break;
+    case JPEG:
+      result = image;
+      saveFormat = "JPEG";
+      break;
+    case WEBP:
+      result = image;
+      saveFormat = QStringLiteral( "WEBP" );
+      break;
+    case UNKN:
+      return false;
+  }
+
+  // Preserve DPI, some conversions, in particular the one for 8bit will drop this information
+  result.setDotsPerMeterX( image.dotsPerMeterX() );
+  result.setDotsPerMeterY( image.dotsPerMeterY() );
+
+  if ( format == JPEG || format == WEBP )
+    return result.save( device, qPrintable( saveFormat ), imageQuality );
+  else
+    return result.save( device, qPrintable( saveFormat ) );
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+                              qgsserverimageutils.h
+                              ---------------------
+  begin                : March 2021
+  copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QGSSERVERIMAGEUTILS_H
+#define QGSSERVERIMAGEUTILS_H
+
+#define SIP_NO_FILE
+
+#include <QString>
+
+#include "qgis_server.h"
+
+class QImage;
+class QIODevice;
+
+/**
+ * \ingroup server
+ * \brief The QgsServerImageUtils namespace provides the image encoding shared by the
+ * services returning rendered images.
+ * \since QGIS 3.20
+ */
+namespace QgsServerImageUtils
+{
+  //! Supported image output format
+  enum ImageOutputFormat
+  {
+    UNKN,
+    PNG,
+    PNG8,
+    PNG16,
+    PNG1,
+    JPEG,
+    WEBP
+  };
+
+  /**
+   * Parses an image format string, e.g. "image/jpeg" or "image/png; mode=8bit".
+   * \returns the output format, or UNKN if the format is not supported
+   */
+  SERVER_EXPORT ImageOutputFormat parseImageFormat( const QString &format );
+
+  /**
+   * Returns the content type of images encoded with \a format, or an empty string for UNKN.
+   */
+  SERVER_EXPORT QString contentType( ImageOutputFormat format );
+
+  /**
+   * Encodes \a image with \a format to \a device. The \a imageQuality is used by
+   * lossy formats, -1 meaning the default quality.
+   * \returns TRUE if the image could be encoded
+   */
+  SERVER_EXPORT bool writeImage( QIODevice *device, const QImage &image, ImageOutputFormat format, int imageQuality = -1 );
+}
+
+#endif
@@ -333,6 +333,50 @@ void QgsServerSettings::initSettings()
                                     QVariant()
                                   };
   mSettings[ sServiceUrl.envVar ] = sWmtsServiceUrl;
+
+  // render feature cache size
+  const Setting sRenderFeatureCacheSize = { QgsServerSettingsEnv::QGIS_SERVER_RENDER_FEATURE_CACHE_SIZE,
+                                            QgsServerSettingsEnv::DEFAULT_VALUE,
+                                            QStringLiteral( "Specify the size of the cache of features fetched for rendering" ),
+                                            QStringLiteral( "/cache/render_feature_size" ),
+                                            QVariant::LongLong,
+                                            QVariant( 0 ),
+                                            QVariant()
+                                          };
+  mSettings[ sRenderFeatureCacheSize.envVar ] = sRenderFeatureCacheSize;
+
+  // WMTS tile memory cache size
+  const Setting sWmtsCacheSize = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_SIZE,
+                                   QgsServerSettingsEnv::DEFAULT_VALUE,
+                                   QStringLiteral( "Specify the size of the WMTS tile memory cache" ),
+                                   QStringLiteral( "/cache/wmts_size" ),
+                                   QVariant::LongLong,
+                                   QVariant( 0 ),
+                                   QVariant()
+                                 };
+  mSettings[ sWmtsCacheSize.envVar ] = sWmtsCacheSize;
+
+  // WMTS tile disk cache directory
+  const Setting sWmtsCacheDirectory = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_DIRECTORY,
+                                        QgsServerSettingsEnv::DEFAULT_VALUE,
+                                        QStringLiteral( "Specify the WMTS tile disk cache directory" ),
+                                        QStringLiteral( "/cache/wmts_directory" ),
+                                        QVariant::String,
+                                        QVariant( "" ),
+                                        QVariant()
+                                      };
+  mSettings[ sWmtsCacheDirectory.envVar ] = sWmtsCacheDirectory;
+
+  // WMTS metatile size
+  const Setting sWmtsMetatileSize = { QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE,
+                                      QgsServerSettingsEnv::DEFAULT_VALUE,
+                                      QStringLiteral( "Number of tiles along each side of the rendered WMTS metatiles" ),
+                                      QStringLiteral( "/qgis/server_wmts_metatile_size" ),
+                                      QVariant::Int,
+                                      QVariant( 4 ),
+                                      QVariant()
+                                    };
+  mSettings[ sWmtsMetatileSize.envVar ] = sWmtsMetatileSize;
 }
 
 void QgsServerSettings::load()
@@ -588,6 +632,26 @@ bool QgsServerSettings::logProfile()
   return value( QgsServerSettingsEnv::QGIS_SERVER_LOG_PROFILE, false ).toBool();
 }
 
+qint64 QgsServerSettings::renderFeatureCacheSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_RENDER_FEATURE_CACHE_SIZE ).toLongLong();
+}
+
+qint64 QgsServerSettings::wmtsCacheSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_SIZE ).toLongLong();
+}
+
+QString QgsServerSettings::wmtsCacheDirectory() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_CACHE_DIRECTORY ).toString();
+}
+
+int QgsServerSettings::wmtsMetatileSize() const
+{
+  return value( QgsServerSettingsEnv::QGIS_SERVER_WMTS_METATILE_SIZE ).toInt();
+}
+
 QString QgsServerSettings::serviceUrl( const QString &service ) const
 {
   QString result;
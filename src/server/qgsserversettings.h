@@ -77,6 +77,10 @@ class SERVER_EXPORT QgsServerSettingsEnv : public QObject
       QGIS_SERVER_WCS_SERVICE_URL, //!< To set the WCS service URL if it's not present in the project. (since QGIS 3.20).
       QGIS_SERVER_WMTS_SERVICE_URL, //!< To set the WMTS service URL if it's not present in the project. (since QGIS 3.20).
       QGIS_SERVER_LANDING_PAGE_PREFIX, //! Prefix of the path component of the landing page base URL, default is empty (since QGIS 3.20).
+      QGIS_SERVER_RENDER_FEATURE_CACHE_SIZE, //!< Maximum size in bytes of the cache of features fetched for WMS rendering, shared across requests. Disabled by default (since QGIS 3.20).
+      QGIS_SERVER_WMTS_CACHE_SIZE, //!< Maximum size in bytes of the built-in WMTS tile memory cache. Disabled by default (since QGIS 3.20).
+      QGIS_SERVER_WMTS_CACHE_DIRECTORY, //!< Directory of the built-in WMTS tile disk cache. Disabled by default (since QGIS 3.20).
+      QGIS_SERVER_WMTS_METATILE_SIZE, //!< Number of tiles along each side of the metatiles rendered by WMTS GetTile requests when a built-in tile cache is enabled, defaults to 4 (since QGIS 3.20).
     };
     Q_ENUM( EnvVar )
 };
@@ -294,6 +298,52 @@ class SERVER_EXPORT QgsServerSettings
      */
     QString serviceUrl( const QString &service ) const;
 
+    /**
+     * Returns the maximum size in bytes of the cache of features fetched for rendering
+     * WMS maps, which is shared across requests and projects. A size of 0 disables the cache.
+     *
+     * The default value is 0, this value can be changed by setting the environment
+     * variable QGIS_SERVER_RENDER_FEATURE_CACHE_SIZE.
+     *
+     * \since QGIS 3.20
+     */
+    qint64 renderFeatureCacheSize() const;
+
+    /**
+     * Returns the maximum size in bytes of the built-in memory cache for WMTS tiles.
+     * A size of 0 disables the memory cache.
+     *
+     * The default value is 0, this value can be changed by setting the environment
+     * variable QGIS_SERVER_WMTS_CACHE_SIZE.
+     *
+     * \see wmtsCacheDirectory()
+     * \since QGIS 3.20
+     */
+    qint64 wmtsCacheSize() const;
+
+    /**
+     * Returns the directory of the built-in disk cache for WMTS tiles.
+     * An empty directory disables the disk cache.
+     *
+     * The default value is empty, this value can be changed by setting the environment
+     * variable QGIS_SERVER_WMTS_CACHE_DIRECTORY.
+     *
+     * \see wmtsCacheSize()
+     * \since QGIS 3.20
+     */
+    QString wmtsCacheDirectory() const;
+
+    /**
+     * Returns the number of tiles along each side of the metatiles rendered for WMTS
+     * GetTile requests. Metatiles are only used when a built-in WMTS tile cache is enabled.
+     *
+     * The default value is 4, this value can be changed by setting the environment
+     * variable QGIS_SERVER_WMTS_METATILE_SIZE.
+     *
+     * \since QGIS 3.20
+     */
+    int wmtsMetatileSize() const;
+
     /**
      * Returns the string representation of a setting.
      * \since QGIS 3.16
@@ -29,10 +29,12 @@ namespace QgsWms
     bool parallelRendering
     , int maxThreads
     , QgsFeatureFilterProvider *featureFilterProvider
+    , QgsRenderFeatureCache *renderFeatureCache
   )
     :
     mParallelRendering( parallelRendering )
     , mFeatureFilterProvider( featureFilterProvider )
+    , mRenderFeatureCache( renderFeatureCache )
   {
 #ifndef HAVE_SERVER_PYTHON_PLUGINS
     Q_UNUSED( mFeatureFilterProvider )
@@ -56,6 +58,7 @@ namespace QgsWms
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
       renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
 #endif
+      renderJob.setRenderFeatureCache( mRenderFeatureCache );
       renderJob.start();
 
       // Allows the main thread to manage blocking call coming from rendering
@@ -77,6 +80,7 @@ namespace QgsWms
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
       renderJob.setFeatureFilterProvider( mFeatureFilterProvider );
 #endif
+      renderJob.setRenderFeatureCache( mRenderFeatureCache );
       renderJob.renderSynchronously();
       mErrors = renderJob.errors();
     }
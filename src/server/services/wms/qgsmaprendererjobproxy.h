@@ -22,6 +22,7 @@
 #include "qgsmaprendererjob.h"
 
 class QgsFeatureFilterProvider;
+class QgsRenderFeatureCache;
 
 namespace QgsWms
 {
@@ -42,11 +43,13 @@ namespace QgsWms
        * \param parallelRendering TRUE to activate parallel rendering, FALSE otherwise
        * \param maxThreads The number of threads to use in case of parallel rendering
        * \param featureFilterProvider Features filtering
+       * \param renderFeatureCache Cache of features shared with other requests, or NULLPTR (since QGIS 3.20)
        */
       QgsMapRendererJobProxy(
         bool parallelRendering
         , int maxThreads
         , QgsFeatureFilterProvider *featureFilterProvider
+        , QgsRenderFeatureCache *renderFeatureCache = nullptr
       );
 
       /**
@@ -71,6 +74,7 @@ namespace QgsWms
     private:
       bool mParallelRendering;
       QgsFeatureFilterProvider *mFeatureFilterProvider = nullptr;
+      QgsRenderFeatureCache *mRenderFeatureCache = nullptr;
       std::unique_ptr<QPainter> mPainter;
 
       void getRenderErrors( const QgsMapRendererJob *job );
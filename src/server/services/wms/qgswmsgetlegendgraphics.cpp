@@ -26,6 +26,7 @@
 #include "qgsmaplayerlegend.h"
 
 #include "qgswmsutils.h"
+#include "qgsserverimageutils.h"
 #include "qgswmsrequest.h"
 #include "qgswmsserviceexception.h"
 #include "qgswmsgetlegendgraphics.h"
@@ -75,12 +76,12 @@ namespace QgsWms
     }
     else if ( format == QgsWmsParameters::Format::NONE )
     {
-      switch ( parseImageFormat( parameters.formatAsString() ) )
+      switch ( QgsServerImageUtils::parseImageFormat( parameters.formatAsString() ) )
       {
-        case PNG:
-        case PNG8:
-        case PNG16:
-        case PNG1:
+        case QgsServerImageUtils::PNG:
+        case QgsServerImageUtils::PNG8:
+        case QgsServerImageUtils::PNG16:
+        case QgsServerImageUtils::PNG1:
           format = QgsWmsParameters::Format::PNG;
           imageContentType = "image/png";
           imageSaveFormat = "PNG";
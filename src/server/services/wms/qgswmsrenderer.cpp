@@ -51,6 +51,7 @@
 #include "qgswmsserviceexception.h"
 #include "qgsserverprojectutils.h"
 #include "qgsserverfeatureid.h"
+#include "qgsconfigcache.h"
 #include "qgsmaplayerstylemanager.h"
 #include "qgswkbtypes.h"
 #include "qgsannotationmanager.h"
@@ -2903,7 +2904,8 @@ namespace QgsWms
     mContext.accessControl()->resolveFilterFeatures( mapSettings.layers() );
     filters.addProvider( mContext.accessControl() );
 #endif
-    QgsMapRendererJobProxy renderJob( mContext.settings().parallelRendering(), mContext.settings().maxThreads(), &filters );
+    QgsRenderFeatureCache *featureCache = mContext.settings().renderFeatureCacheSize() > 0 ? QgsConfigCache::instance()->renderFeatureCache() : nullptr;
+    QgsMapRendererJobProxy renderJob( mContext.settings().parallelRendering(), mContext.settings().maxThreads(), &filters, featureCache );
     renderJob.render( mapSettings, &image );
     painter = renderJob.takePainter();
 
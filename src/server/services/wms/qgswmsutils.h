@@ -36,31 +36,15 @@ class QgsRectangle;
 //! WMS implementation
 namespace QgsWms
 {
-  //! Supported image output format
-  enum ImageOutputFormat
-  {
-    UNKN,
-    PNG,
-    PNG8,
-    PNG16,
-    PNG1,
-    JPEG,
-    WEBP
-  };
 
   /**
    * Returns WMS service URL
    */
   QUrl serviceUrl( const QgsServerRequest &request, const QgsProject *project, const QgsServerSettings &settings );
 
-  /**
-   * Parse image format parameter
-   *  \returns OutputFormat
-   */
-  ImageOutputFormat parseImageFormat( const QString &format );
-
   /**
    * Write image response
+   * \see QgsServerImageUtils::writeImage()
    */
   void writeImage( QgsServerResponse &response, QImage &img, const QString &formatStr,
                    int imageQuality = -1 );
@@ -17,12 +17,123 @@
 #include "qgswmtsutils.h"
 #include "qgswmtsparameters.h"
 #include "qgswmtsgettile.h"
+#include "qgswmtstilecache.h"
+#include "qgsbufferserverresponse.h"
+#include "qgsserverimageutils.h"
+#include "qgsserverprojectutils.h"
 
+#include <QBuffer>
 #include <QImage>
 
 namespace QgsWmts
 {
 
+  namespace
+  {
+
+    /**
+     * Returns the number of tiles along each side of the rendered metatiles, making sure
+     * that metatiles respect the maximum WMS image size.
+     */
+    int metatileSize( const QgsServerSettings &settings, const QgsProject *project )
+    {
+      int size = std::max( settings.wmtsMetatileSize(), 1 );
+      const QList< int > maxSizes
+      {
+        settings.wmsMaxWidth(), settings.wmsMaxHeight(),
+        QgsServerProjectUtils::wmsMaxWidth( *project ), QgsServerProjectUtils::wmsMaxHeight( *project )
+      };
+      for ( int maxSize : maxSizes )
+      {
+        if ( maxSize > 0 )
+          size = std::min( size, std::max( maxSize / 256, 1 ) );
+      }
+      return size;
+    }
+
+    /**
+     * Returns the key identifying the tiles of the requested layer, format and tile matrix set in
+     * the built-in tile cache, or an empty string if tiles can't be cached for the current user.
+     */
+    QString tileSetKey( QgsServerInterface *serverIface, const QgsWmtsParameters &params )
+    {
+      QStringList key;
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+      QgsAccessControl *accessControl = serverIface->accessControls();
+      if ( accessControl && !accessControl->fillCacheKey( key ) )
+        return QString();
+#else
+      ( void )serverIface;
+#endif
+      key << params.layer() << params.formatAsString() << params.tileMatrixSet();
+      return key.join( '|' );
+    }
+
+    /**
+     * Renders the metatile containing the requested tile, stores all of its tiles in the built-in
+     * tile cache and returns the encoded requested tile. If the metatile can't be rendered, the
+     * WMS response is copied to \a response and an empty array is returned.
+     *
+     * The metatile is rendered as lossless PNG, then every tile is encoded to \a format with the
+     * same encoder as WMS GetMap images.
+     */
+    QByteArray renderMetatile( QgsServerInterface *serverIface, const QgsProject *project,
+                               QUrlQuery query, const QgsWmtsParameters &params,
+                               QgsServerImageUtils::ImageOutputFormat format,
+                               const metatileDef &metatile, const QString &key,
+                               QgsServerResponse &response )
+    {
+      const QString formatName = QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT );
+      query.removeAllQueryItems( formatName );
+      query.addQueryItem( formatName, QStringLiteral( "image/png" ) );
+
+      QgsServerParameters wmsParams( query );
+      QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
+      QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
+
+      QgsBufferServerResponse wmsResponse;
+      service->executeRequest( wmsRequest, wmsResponse, project );
+
+      const QByteArray data = wmsResponse.body() + wmsResponse.data();
+      QImage image;
+      if ( !wmsResponse.header( QStringLiteral( "Content-Type" ) ).startsWith( QLatin1String( "image/png" ) )
+           || !image.loadFromData( data, "PNG" )
+           || image.width() != metatile.cols * 256 || image.height() != metatile.rows * 256 )
+      {
+        // most likely a service exception, forward it as is
+        const QMap< QString, QString > headers = wmsResponse.headers();
+        for ( auto it = headers.constBegin(); it != headers.constEnd(); ++it )
+          response.setHeader( it.key(), it.value() );
+        response.setStatusCode( wmsResponse.statusCode() );
+        response.write( data );
+        return QByteArray();
+      }
+
+      // same quality as WMS GetMap requests without IMAGE_QUALITY
+      const int quality = QgsServerProjectUtils::wmsImageQuality( *project );
+      const int tileMatrix = params.tileMatrixAsInt();
+
+      QgsWmtsTileCache *cache = QgsWmtsTileCache::instance();
+      QByteArray requestedTile;
+      for ( int row = 0; row < metatile.rows; ++row )
+      {
+        for ( int col = 0; col < metatile.cols; ++col )
+        {
+          QByteArray tile;
+          QBuffer buffer( &tile );
+          buffer.open( QIODevice::WriteOnly );
+          QgsServerImageUtils::writeImage( &buffer, image.copy( col * 256, row * 256, 256, 256 ), format, quality );
+
+          cache->insertTile( project, key, tileMatrix, metatile.minRow + row, metatile.minCol + col, tile );
+          if ( metatile.minRow + row == metatile.row && metatile.minCol + col == metatile.col )
+            requestedTile = tile;
+        }
+      }
+      return requestedTile;
+    }
+
+  }
+
   void writeGetTile( QgsServerInterface *serverIface, const QgsProject *project,
                      const QString &version, const QgsServerRequest &request,
                      QgsServerResponse &response )
@@ -30,8 +141,24 @@ namespace QgsWmts
     Q_UNUSED( version )
     const QgsWmtsParameters params( QUrlQuery( request.url() ) );
 
+    // Built-in tile cache, rendering metatiles
+    QgsWmtsTileCache *tileCache = QgsWmtsTileCache::instance();
+    const QgsServerSettings *settings = serverIface->serverSettings();
+    // formats the encoder does not know are left to WMS, which reports them
+    const QgsServerImageUtils::ImageOutputFormat tileFormat = QgsServerImageUtils::parseImageFormat( params.formatAsString() );
+    QString key;
+    if ( settings )
+    {
+      tileCache->setStorage( settings->wmtsCacheSize(), settings->wmtsCacheDirectory() );
+      if ( tileCache->isEnabled() && tileFormat != QgsServerImageUtils::UNKN )
+        key = tileSetKey( serverIface, params );
+    }
+
     // WMS query
-    QUrlQuery query = translateWmtsParamToWmsQueryItem( QStringLiteral( "GetMap" ), params, project, serverIface );
+    metatileDef metatile;
+    QUrlQuery query = key.isEmpty()
+                      ? translateWmtsParamToWmsQueryItem( QStringLiteral( "GetMap" ), params, project, serverIface )
+                      : translateWmtsParamToWmsQueryItem( QStringLiteral( "GetMap" ), params, project, serverIface, metatileSize( *settings, project ), &metatile );
 
     // Get cached image
 #ifdef HAVE_SERVER_PYTHON_PLUGINS
@@ -66,6 +193,25 @@ namespace QgsWmts
     }
 #endif
 
+    if ( !key.isEmpty() )
+    {
+      QByteArray content = tileCache->tile( project, key, params.tileMatrixAsInt(), metatile.row, metatile.col );
+      if ( content.isEmpty() )
+      {
+        content = renderMetatile( serverIface, project, query, params, tileFormat, metatile, key, response );
+        if ( content.isEmpty() )
+          return;
+      }
+
+      response.setHeader( QStringLiteral( "Content-Type" ), QgsServerImageUtils::contentType( tileFormat ) );
+      response.write( content );
+#ifdef HAVE_SERVER_PYTHON_PLUGINS
+      if ( cacheManager )
+        cacheManager->setCachedImage( &content, project, request, accessControl );
+#endif
+      return;
+    }
+
     QgsServerParameters wmsParams( query );
     QgsServerRequest wmsRequest( "?" + query.query( QUrl::FullyDecoded ) );
     QgsService *service = serverIface->serviceRegistry()->getService( wmsParams.service(), wmsParams.version() );
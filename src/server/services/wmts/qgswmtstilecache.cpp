@@ -0,0 +1,185 @@
+/***************************************************************************
+                              qgswmtstilecache.cpp
+                              -------------------------
+  begin                : March 2021
+  copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "qgswmtstilecache.h"
+#include "qgsconfigcache.h"
+#include "qgsmessagelog.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <limits>
+
+namespace QgsWmts
+{
+
+  QgsWmtsTileCache *QgsWmtsTileCache::instance()
+  {
+    static QgsWmtsTileCache sInstance;
+    return &sInstance;
+  }
+
+  QgsWmtsTileCache::QgsWmtsTileCache()
+  {
+    // the project gets reloaded after being removed from the config cache, e.g. when its file changed
+    mConfigCacheConnection = QObject::connect( QgsConfigCache::instance(), &QgsConfigCache::projectRemovedFromCache, [this]( const QString & path )
+    {
+      removeProject( path );
+    } );
+  }
+
+  QgsWmtsTileCache::~QgsWmtsTileCache()
+  {
+    QObject::disconnect( mConfigCacheConnection );
+  }
+
+  void QgsWmtsTileCache::setStorage( qint64 memorySize, const QString &directory )
+  {
+    QMutexLocker locker( &mMutex );
+    // costs are in kilobytes
+    mTiles.setMaxCost( static_cast< int >( std::min< qint64 >( std::max< qint64 >( memorySize, 0 ) / 1024, std::numeric_limits< int >::max() ) ) );
+    mDirectory = directory;
+  }
+
+  bool QgsWmtsTileCache::isEnabled() const
+  {
+    QMutexLocker locker( &mMutex );
+    return mTiles.maxCost() > 0 || !mDirectory.isEmpty();
+  }
+
+  QByteArray QgsWmtsTileCache::tile( const QgsProject *project, const QString &tileSetKey, int tileMatrix, int row, int col )
+  {
+    QMutexLocker locker( &mMutex );
+    const QString version = projectVersion( project );
+    const QString key = QStringLiteral( "%1|%2|%3|%4|%5|%6" ).arg( project->fileName(), version, tileSetKey ).arg( tileMatrix ).arg( row ).arg( col );
+    if ( const QByteArray *data = mTiles.object( key ) )
+      return *data;
+
+    if ( mDirectory.isEmpty() )
+      return QByteArray();
+
+    QFile file( tilePath( project->fileName(), version, tileSetKey, tileMatrix, row, col ) );
+    if ( !file.open( QIODevice::ReadOnly ) )
+      return QByteArray();
+
+    const QByteArray data = file.readAll();
+    if ( !data.isEmpty() && mTiles.maxCost() > 0 )
+      mTiles.insert( key, new QByteArray( data ), std::max( data.size() / 1024, 1 ) );
+    return data;
+  }
+
+  void QgsWmtsTileCache::insertTile( const QgsProject *project, const QString &tileSetKey, int tileMatrix, int row, int col, const QByteArray &data )
+  {
+    if ( data.isEmpty() )
+      return;
+
+    QMutexLocker locker( &mMutex );
+    const QString version = projectVersion( project );
+    if ( mTiles.maxCost() > 0 )
+    {
+      const QString key = QStringLiteral( "%1|%2|%3|%4|%5|%6" ).arg( project->fileName(), version, tileSetKey ).arg( tileMatrix ).arg( row ).arg( col );
+      mTiles.insert( key, new QByteArray( data ), std::max( data.size() / 1024, 1 ) );
+    }
+
+    if ( mDirectory.isEmpty() )
+      return;
+
+    const QString path = tilePath( project->fileName(), version, tileSetKey, tileMatrix, row, col );
+    if ( !QDir().mkpath( QFileInfo( path ).absolutePath() ) )
+    {
+      QgsMessageLog::logMessage( QStringLiteral( "Unable to create WMTS cache directory for '%1'" ).arg( path ), QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+      return;
+    }
+
+    // write to a temporary file first, so that other processes never read partial tiles
+    QSaveFile file( path );
+    if ( !file.open( QIODevice::WriteOnly ) || file.write( data ) != data.size() || !file.commit() )
+    {
+      QgsMessageLog::logMessage( QStringLiteral( "Unable to write WMTS cache tile '%1'" ).arg( path ), QStringLiteral( "Server" ), Qgis::MessageLevel::Warning );
+    }
+  }
+
+  void QgsWmtsTileCache::removeProject( const QString &path )
+  {
+    QMutexLocker locker( &mMutex );
+    mProjectVersions.remove( path );
+    removeProjectTiles( path );
+  }
+
+  QString QgsWmtsTileCache::projectVersion( const QgsProject *project )
+  {
+    const QString path = project->fileName();
+    auto it = mProjectVersions.find( path );
+    if ( it != mProjectVersions.end() && it->project == project )
+      return it->version;
+
+    // the project has been (re)loaded, tiles from other versions of the project file are obsolete
+    const QString version = QString::number( project->lastModified().toMSecsSinceEpoch() );
+    if ( it == mProjectVersions.end() || it->version != version )
+      removeProjectTiles( path, version );
+
+    ProjectVersion projectVersion;
+    projectVersion.project = project;
+    projectVersion.version = version;
+    mProjectVersions.insert( path, projectVersion );
+    return version;
+  }
+
+  QString QgsWmtsTileCache::projectDirectory( const QString &path ) const
+  {
+    const QString hash = QString::fromLatin1( QCryptographicHash::hash( path.toUtf8(), QCryptographicHash::Md5 ).toHex() );
+    return QDir( mDirectory ).filePath( hash );
+  }
+
+  QString QgsWmtsTileCache::tilePath( const QString &path, const QString &version, const QString &tileSetKey, int tileMatrix, int row, int col ) const
+  {
+    // tile set keys contain layer names and CRS identifiers, which are not safe for file names
+    const QString tileSetHash = QString::fromLatin1( QCryptographicHash::hash( tileSetKey.toUtf8(), QCryptographicHash::Md5 ).toHex() );
+    return QStringLiteral( "%1/%2/%3/%4/%5/%6" ).arg( projectDirectory( path ), version, tileSetHash ).arg( tileMatrix ).arg( row ).arg( col );
+  }
+
+  void QgsWmtsTileCache::removeProjectTiles( const QString &path, const QString &keepVersion )
+  {
+    const QString prefix = path + '|';
+    const QString keepPrefix = prefix + keepVersion + '|';
+    const QList< QString > keys = mTiles.keys();
+    for ( const QString &key : keys )
+    {
+      if ( key.startsWith( prefix ) && ( keepVersion.isEmpty() || !key.startsWith( keepPrefix ) ) )
+        mTiles.remove( key );
+    }
+
+    if ( mDirectory.isEmpty() )
+      return;
+
+    QDir projectDir( projectDirectory( path ) );
+    if ( keepVersion.isEmpty() )
+    {
+      projectDir.removeRecursively();
+      return;
+    }
+
+    const QStringList versions = projectDir.entryList( QDir::Dirs | QDir::NoDotAndDotDot );
+    for ( const QString &version : versions )
+    {
+      if ( version != keepVersion )
+        QDir( projectDir.filePath( version ) ).removeRecursively();
+    }
+  }
+
+} // namespace QgsWmts
@@ -0,0 +1,112 @@
+/***************************************************************************
+                              qgswmtstilecache.h
+                              -------------------------
+  begin                : March 2021
+  copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef QGSWMTSTILECACHE_H
+#define QGSWMTSTILECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QString>
+
+#include "qgsproject.h"
+
+namespace QgsWmts
+{
+
+  /**
+   * \ingroup server
+   * \class QgsWmts::QgsWmtsTileCache
+   * \brief Built-in store for encoded WMTS tiles, kept in memory and/or on disk.
+   *
+   * Tiles are stored per project, and keyed by a tile set key (identifying the layer, format, tile matrix
+   * set and access control variant) and the tile position within the tile matrix set. The cached tiles of a
+   * project are discarded as soon as the project file is modified, or when the project is removed from
+   * QgsConfigCache.
+   *
+   * The disk store is organized as one directory per project file, so it can be shared by all the server
+   * processes using the same directory.
+   *
+   * \since QGIS 3.20
+   */
+  class QgsWmtsTileCache
+  {
+    public:
+
+      //! Returns the tile cache shared by all requests of the process
+      static QgsWmtsTileCache *instance();
+
+      /**
+       * Sets the maximum size in bytes of the memory store to \a memorySize, and the
+       * \a directory of the disk store. A size of 0 or an empty directory disable the
+       * corresponding store.
+       */
+      void setStorage( qint64 memorySize, const QString &directory );
+
+      //! Returns TRUE if tiles are stored in memory or on disk
+      bool isEnabled() const;
+
+      /**
+       * Returns the encoded tile from \a project at \a row and \a col of the tile matrix
+       * \a tileMatrix, for the tile set identified by \a tileSetKey, or an empty array
+       * if the tile is not cached.
+       */
+      QByteArray tile( const QgsProject *project, const QString &tileSetKey, int tileMatrix, int row, int col );
+
+      /**
+       * Stores the encoded \a data of a tile.
+       * \see tile()
+       */
+      void insertTile( const QgsProject *project, const QString &tileSetKey, int tileMatrix, int row, int col, const QByteArray &data );
+
+      /**
+       * Removes all cached tiles for the project read from \a path.
+       * This is called whenever the project is removed from QgsConfigCache.
+       */
+      void removeProject( const QString &path );
+
+    private:
+
+      QgsWmtsTileCache();
+      ~QgsWmtsTileCache();
+
+      //! Returns the version of \a project, purging tiles from previous versions
+      QString projectVersion( const QgsProject *project );
+      QString projectDirectory( const QString &path ) const;
+      QString tilePath( const QString &path, const QString &version, const QString &tileSetKey, int tileMatrix, int row, int col ) const;
+      //! Removes cached tiles of the project read from \a path, except those of \a keepVersion
+      void removeProjectTiles( const QString &path, const QString &keepVersion = QString() );
+
+      mutable QMutex mMutex;
+      QCache< QString, QByteArray > mTiles;
+      QString mDirectory;
+
+      struct ProjectVersion
+      {
+        QPointer< const QgsProject > project;
+        QString version;
+      };
+
+      //! Project file path / version of the loaded project
+      QHash< QString, ProjectVersion > mProjectVersions;
+
+      QMetaObject::Connection mConfigCacheConnection;
+  };
+
+} // namespace QgsWmts
+
+#endif
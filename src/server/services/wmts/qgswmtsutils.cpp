@@ -623,7 +623,8 @@ namespace QgsWmts
   }
 
   QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
-      const QgsProject *project, QgsServerInterface *serverIface )
+      const QgsProject *project, QgsServerInterface *serverIface,
+      int metatileSize, metatileDef *metatile )
   {
 #ifndef HAVE_SERVER_PYTHON_PLUGINS
     ( void )serverIface;
@@ -757,11 +758,33 @@ namespace QgsWmts
       throw QgsRequestNotWellFormedException( QStringLiteral( "TileCol is unknown" ) );
     }
 
+    // block of tiles to render, aligned on the metatile grid and clipped to the tile matrix
+    int minRow = tr;
+    int minCol = tc;
+    int rows = 1;
+    int cols = 1;
+    if ( metatile && metatileSize > 1 )
+    {
+      minRow = ( tr / metatileSize ) * metatileSize;
+      minCol = ( tc / metatileSize ) * metatileSize;
+      rows = std::min( metatileSize, tm.row - minRow );
+      cols = std::min( metatileSize, tm.col - minCol );
+    }
+    if ( metatile )
+    {
+      metatile->minRow = minRow;
+      metatile->minCol = minCol;
+      metatile->rows = rows;
+      metatile->cols = cols;
+      metatile->row = tr;
+      metatile->col = tc;
+    }
+
     double res = tm.resolution;
-    double minx = tm.left + tc * ( tileSize * res );
-    double miny = tm.top - ( tr + 1 ) * ( tileSize * res );
-    double maxx = tm.left + ( tc + 1 ) * ( tileSize * res );
-    double maxy = tm.top - tr * ( tileSize * res );
+    double minx = tm.left + minCol * ( tileSize * res );
+    double miny = tm.top - ( minRow + rows ) * ( tileSize * res );
+    double maxx = tm.left + ( minCol + cols ) * ( tileSize * res );
+    double maxy = tm.top - minRow * ( tileSize * res );
     QString bbox;
     if ( tms.hasAxisInverted )
     {
@@ -790,8 +813,8 @@ namespace QgsWmts
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::STYLES ), QString() );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::CRS ), tms.ref );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::BBOX ), bbox );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QStringLiteral( "256" ) );
-    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QStringLiteral( "256" ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::WIDTH ), QString::number( cols * tileSize ) );
+    query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::HEIGHT ), QString::number( rows * tileSize ) );
     query.addQueryItem( QgsWmsParameterForWmts::name( QgsWmsParameterForWmts::FORMAT ), format );
     if ( params.format() == QgsWmtsParameters::Format::PNG )
     {
@@ -99,6 +99,21 @@ namespace QgsWmts
     QMap< int, tileMatrixLimitDef > tileMatrixLimits;
   };
 
+  struct metatileDef
+  {
+    int minRow = 0;
+
+    int minCol = 0;
+
+    int rows = 1;
+
+    int cols = 1;
+
+    int row = 0;
+
+    int col = 0;
+  };
+
   struct layerDef
   {
     QString id;
@@ -143,9 +158,14 @@ namespace QgsWmts
 
   /**
    * Translate WMTS parameters to WMS query item
+   *
+   * If \a metatile is set, the query covers the block of up to \a metatileSize x \a metatileSize
+   * tiles containing the requested tile, and \a metatile is filled with the position of the block
+   * and of the requested tile within the tile matrix.
    */
   QUrlQuery translateWmtsParamToWmsQueryItem( const QString &request, const QgsWmtsParameters &params,
-      const QgsProject *project, QgsServerInterface *serverIface );
+      const QgsProject *project, QgsServerInterface *serverIface,
+      int metatileSize = 1, metatileDef *metatile = nullptr );
 
 } // namespace QgsWmts
 
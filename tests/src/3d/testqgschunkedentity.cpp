@@ -0,0 +1,201 @@
+/***************************************************************************
+     testqgschunkedentity.cpp
+     ----------------------
+    Date                 : October 2026
+    Copyright            : (C) 2026 by QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+
+#include "qgsaabb.h"
+#include "qgschunkedentity_p.h"
+#include "qgschunkloader_p.h"
+#include "qgschunknode_p.h"
+
+#include <QPointer>
+#include <Qt3DCore/QEntity>
+
+//! Chunk loader which only finishes when asked to and records whether it got canceled
+class TestChunkLoader : public QgsChunkLoader
+{
+    Q_OBJECT
+  public:
+    TestChunkLoader( QgsChunkNode *node ) : QgsChunkLoader( node ) {}
+
+    Qt3DCore::QEntity *createEntity( Qt3DCore::QEntity *parent ) override { return new Qt3DCore::QEntity( parent ); }
+
+    void cancel() override { mCanceled = true; }
+
+    void finish() { emit finished(); }
+
+    bool mCanceled = false;
+};
+
+class TestChunkLoaderFactory : public QgsQuadtreeChunkLoaderFactory
+{
+    Q_OBJECT
+  public:
+    TestChunkLoaderFactory()
+    {
+      // the box stands on the horizontal X,Z plane
+      setupQuadtree( QgsAABB( 0, 0, 0, 100, 10, 100 ), 100, 2 );
+    }
+
+    QgsChunkLoader *createChunkLoader( QgsChunkNode *node ) const override
+    {
+      TestChunkLoader *loader = new TestChunkLoader( node );
+      mLoaders << loader;
+      return loader;
+    }
+
+    mutable QList<QPointer<TestChunkLoader>> mLoaders;
+};
+
+class TestChunkedEntity : public QgsChunkedEntity
+{
+    Q_OBJECT
+  public:
+    TestChunkedEntity( TestChunkLoaderFactory *factory )
+      : QgsChunkedEntity( 1, factory, false )
+    {
+    }
+
+    ~TestChunkedEntity() override
+    {
+      cancelActiveJobs();
+    }
+};
+
+/**
+ * \ingroup UnitTests
+ * Tests the scheduling of chunk loads of chunked entities
+ */
+class TestQgsChunkedEntity : public QObject
+{
+    Q_OBJECT
+  public:
+    TestQgsChunkedEntity() = default;
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+
+    void testLoadOrder();
+    void testCancelUnrequestedLoads();
+
+  private:
+    static QgsChunkedEntity::SceneState sceneState( const QVector3D &cameraPos, const QVector3D &viewCenter );
+};
+
+//runs before all tests
+void TestQgsChunkedEntity::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+//runs after all tests
+void TestQgsChunkedEntity::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+QgsChunkedEntity::SceneState TestQgsChunkedEntity::sceneState( const QVector3D &cameraPos, const QVector3D &viewCenter )
+{
+  QMatrix4x4 projection;
+  projection.perspective( 45, 1, 1, 1000 );
+  QMatrix4x4 view;
+  view.lookAt( cameraPos, viewCenter, QVector3D( 0, 1, 0 ) );
+
+  QgsChunkedEntity::SceneState state;
+  state.cameraPos = cameraPos;
+  state.cameraFov = 45;
+  state.screenSizePx = 1000;
+  state.viewProjectionMatrix = projection * view;
+  return state;
+}
+
+void TestQgsChunkedEntity::testLoadOrder()
+{
+  TestChunkLoaderFactory factory;
+  TestChunkedEntity entity( &factory );
+  entity.setMaximumConcurrentJobs( 1 );
+
+  // camera next to the corner at the origin, looking at the center of the box
+  const QgsChunkedEntity::SceneState state = sceneState( QVector3D( -50, 50, -50 ), QVector3D( 50, 0, 50 ) );
+
+  entity.update( state );
+  QCOMPARE( factory.mLoaders.count(), 1 );
+  QCOMPARE( factory.mLoaders.at( 0 )->chunk()->tileId(), QgsChunkNodeId( 0, 0, 0 ) );
+  factory.mLoaders.at( 0 )->finish();
+  QCOMPARE( entity.rootNode()->state(), QgsChunkNode::Loaded );
+  QCOMPARE( entity.pendingJobsCount(), 0 );
+
+  // the root has an unacceptable error, so all its children get requested - the child closest
+  // to the camera has the largest screen space error and must be loaded first
+  entity.update( state );
+  QCOMPARE( entity.pendingJobsCount(), 4 );
+  QCOMPARE( factory.mLoaders.count(), 2 );
+  QCOMPARE( factory.mLoaders.at( 1 )->chunk()->tileId(), QgsChunkNodeId( 1, 0, 1 ) );
+
+  // the farthest child must come last
+  for ( int i = 1; i < 4; ++i )
+    factory.mLoaders.at( i )->finish();
+  QCOMPARE( factory.mLoaders.count(), 4 );
+  QCOMPARE( factory.mLoaders.at( 3 )->chunk()->tileId(), QgsChunkNodeId( 1, 1, 0 ) );
+}
+
+void TestQgsChunkedEntity::testCancelUnrequestedLoads()
+{
+  TestChunkLoaderFactory factory;
+  TestChunkedEntity entity( &factory );
+  entity.setMaximumConcurrentJobs( 1 );
+
+  const QgsChunkedEntity::SceneState state = sceneState( QVector3D( -50, 50, -50 ), QVector3D( 50, 0, 50 ) );
+  entity.update( state );
+  factory.mLoaders.at( 0 )->finish();
+  entity.update( state );
+  QCOMPARE( entity.pendingJobsCount(), 4 );
+
+  QPointer<TestChunkLoader> activeLoader = factory.mLoaders.at( 1 );
+  QgsChunkNode *activeNode = activeLoader->chunk();
+  QCOMPARE( activeNode->state(), QgsChunkNode::Loading );
+  QCOMPARE( entity.rootNode()->children()[3]->state(), QgsChunkNode::QueuedForLoad );
+
+  // turn the camera away: nothing is visible anymore, so the queued loads are dropped
+  // and the running one gets canceled
+  const QgsChunkedEntity::SceneState awayState = sceneState( QVector3D( -50, 50, -50 ), QVector3D( -150, 50, -150 ) );
+  entity.update( awayState );
+  QCOMPARE( entity.pendingJobsCount(), 0 );
+  QVERIFY( activeLoader );
+  QVERIFY( activeLoader->mCanceled );
+  QCOMPARE( activeNode->state(), QgsChunkNode::Skeleton );
+  QgsChunkNode *const *children = entity.rootNode()->children();
+  for ( int i = 0; i < entity.rootNode()->childCount(); ++i )
+    QCOMPARE( children[i]->state(), QgsChunkNode::Skeleton );
+  QCOMPARE( entity.rootNode()->state(), QgsChunkNode::Loaded );
+
+  // a late finished() signal of the canceled loader must be ignored
+  activeLoader->finish();
+  QCOMPARE( activeNode->state(), QgsChunkNode::Skeleton );
+  QCOMPARE( entity.pendingJobsCount(), 0 );
+  QCoreApplication::sendPostedEvents( nullptr, QEvent::DeferredDelete );
+  QVERIFY( !activeLoader );
+
+  // looking back again requests the children from scratch, with a new loader
+  entity.update( state );
+  QCOMPARE( entity.pendingJobsCount(), 4 );
+  QCOMPARE( factory.mLoaders.count(), 3 );
+  QCOMPARE( factory.mLoaders.at( 2 )->chunk(), activeNode );
+  QVERIFY( !factory.mLoaders.at( 2 )->mCanceled );
+}
+
+QGSTEST_MAIN( TestQgsChunkedEntity )
+#include "testqgschunkedentity.moc"
@@ -19,6 +19,10 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgstininterpolator.h"
 #include "qgsidwinterpolator.h"
 #include "qgsvectorlayer.h"
+#include "qgspoint.h"
+#include "qgsgridfilewriter.h"
+
+#include <QTemporaryDir>
 
 class TestQgsInterpolator : public QObject
 {
@@ -35,6 +39,8 @@ class TestQgsInterpolator : public QObject
 
     void TIN_IDW_Interpolator_with_attribute();
     void TIN_IDW_Interpolator_with_Z();
+    void IDW_Interpolator_indexed();
+    void IDW_GridFileWriter_noInputData();
 
   private:
 };
@@ -357,6 +363,118 @@ void TestQgsInterpolator::TIN_IDW_Interpolator_with_Z()
   QVERIFY( tin.interpolatePoint( 2.5, 1.5, resultTIN, nullptr ) != 0 );
 }
 
+void TestQgsInterpolator::IDW_Interpolator_indexed()
+{
+  std::unique_ptr<QgsVectorLayer> layer = std::make_unique<QgsVectorLayer>( QStringLiteral( "PointZ" ),
+                                           QStringLiteral( "point" ),
+                                           QStringLiteral( "memory" ) );
+
+  // 20 x 20 grid of points with pseudo random values
+  QgsFeatureList flist;
+  for ( int i = 0; i < 20; ++i )
+  {
+    for ( int j = 0; j < 20; ++j )
+    {
+      QgsFeature f;
+      f.setGeometry( QgsGeometry( new QgsPoint( i, j, ( i * 7 + j * 13 ) % 17 ) ) );
+      flist << f;
+    }
+  }
+  layer->dataProvider()->addFeatures( flist );
+
+  QgsInterpolator::LayerData layerdata;
+  layerdata.source = layer.get();
+  layerdata.valueSource = QgsInterpolator::ValueZ;
+  QList<QgsInterpolator::LayerData> layerDataList;
+  layerDataList.append( layerdata );
+
+  QgsIDWInterpolator idw( layerDataList );
+  QgsIDWInterpolator indexed( layerDataList );
+  QCOMPARE( indexed.maxNeighbors(), 0 );
+  QCOMPARE( indexed.searchRadius(), 0.0 );
+
+  // using all the points through the index gives the same results
+  indexed.setMaxNeighbors( 400 );
+  double result = -1;
+  double indexedResult = -1;
+  for ( double x = -2.25; x < 22; x += 1.7 )
+  {
+    for ( double y = -1.5; y < 22; y += 2.3 )
+    {
+      QCOMPARE( idw.interpolatePoint( x, y, result, nullptr ), 0 );
+      QCOMPARE( indexed.interpolatePoint( x, y, indexedResult, nullptr ), 0 );
+      QGSCOMPARENEAR( indexedResult, result, 0.00000001 );
+    }
+  }
+
+  // points on input vertices
+  QCOMPARE( indexed.interpolatePoint( 3, 4, indexedResult, nullptr ), 0 );
+  QCOMPARE( indexedResult, static_cast< double >( ( 3 * 7 + 4 * 13 ) % 17 ) );
+
+  // nearest neighbors: between 4 points at the same distance, the result is their mean
+  indexed.setMaxNeighbors( 4 );
+  QCOMPARE( indexed.interpolatePoint( 5.5, 7.5, indexedResult, nullptr ), 0 );
+  QGSCOMPARENEAR( indexedResult, ( ( 5 * 7 + 7 * 13 ) % 17 + ( 6 * 7 + 7 * 13 ) % 17 + ( 5 * 7 + 8 * 13 ) % 17 + ( 6 * 7 + 8 * 13 ) % 17 ) / 4.0, 0.00000001 );
+
+  // search radius
+  indexed.setMaxNeighbors( 0 );
+  indexed.setSearchRadius( 0.5 );
+  QCOMPARE( indexed.interpolatePoint( 5.2, 7.1, indexedResult, nullptr ), 0 );
+  QGSCOMPARENEAR( indexedResult, ( 5 * 7 + 7 * 13 ) % 17, 0.00000001 );
+  // no input point within the radius
+  QVERIFY( indexed.interpolatePoint( 5.5, 7.5, indexedResult, nullptr ) != 0 );
+  QVERIFY( indexed.interpolatePoint( 30, 30, indexedResult, nullptr ) != 0 );
+}
+
+void TestQgsInterpolator::IDW_GridFileWriter_noInputData()
+{
+  // an empty layer, and a layer with only NULL values: no input vertex can be cached
+  std::unique_ptr<QgsVectorLayer> emptyLayer = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?crs=EPSG:4326&field=ZValue:real" ),
+      QStringLiteral( "empty" ),
+      QStringLiteral( "memory" ) );
+  std::unique_ptr<QgsVectorLayer> nullLayer = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?crs=EPSG:4326&field=ZValue:real" ),
+      QStringLiteral( "null" ),
+      QStringLiteral( "memory" ) );
+  QgsFeatureList flist;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( nullLayer->fields() );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    f.setAttribute( 0, QVariant() );
+    flist << f;
+  }
+  nullLayer->dataProvider()->addFeatures( flist );
+
+  const QTemporaryDir dir;
+  for ( QgsVectorLayer *layer : { emptyLayer.get(), nullLayer.get() } )
+  {
+    for ( int maxNeighbors : { 0, 5 } )
+    {
+      QgsInterpolator::LayerData layerdata;
+      layerdata.source = layer;
+      layerdata.valueSource = QgsInterpolator::ValueAttribute;
+      layerdata.interpolationAttribute = 0;
+      QgsIDWInterpolator idw( QList<QgsInterpolator::LayerData>() << layerdata );
+      idw.setMaxNeighbors( maxNeighbors );
+      QCOMPARE( idw.cacheInputData(), 0 );
+
+      // large enough to be evaluated by several threads if there were input vertices
+      const QString path = dir.filePath( QStringLiteral( "%1_%2.asc" ).arg( layer->name() ).arg( maxNeighbors ) );
+      QgsGridFileWriter writer( &idw, path, QgsRectangle( 0, 0, 10, 10 ), 200, 200 );
+      QCOMPARE( writer.writeFile(), 0 );
+
+      QFile file( path );
+      QVERIFY( file.open( QIODevice::ReadOnly ) );
+      const QStringList lines = QString::fromUtf8( file.readAll() ).trimmed().split( '\n' );
+      // 6 header lines, and one line per row
+      QCOMPARE( lines.count(), 206 );
+      const QString noDataRow = QStringLiteral( "-9999 " ).repeated( 200 ).trimmed();
+      for ( int row = 6; row < lines.count(); ++row )
+        QCOMPARE( lines.at( row ).trimmed(), noDataRow );
+    }
+  }
+}
+
 void TestQgsInterpolator::TIN_IDW_Interpolator_with_attribute()
 {
   std::unique_ptr<QgsVectorLayer>mLayerPoint = std::make_unique<QgsVectorLayer>( QStringLiteral( "Point?field=ZValue:real" ),
@@ -25,6 +25,12 @@ Email                : nyall dot dawson at gmail dot com
 #include "qgsgraphbuilder.h"
 #include "qgsgraph.h"
 #include "qgsgraphanalyzer.h"
+#include "qgscontractionhierarchy.h"
+
+#include <QBuffer>
+
+#include <cmath>
+#include <limits>
 
 class TestQgsNetworkAnalysis : public QObject
 {
@@ -43,9 +49,13 @@ class TestQgsNetworkAnalysis : public QObject
     void dijkkjkjkskkjsktra();
     void testRouteFail();
     void testRouteFail2();
+    void shortestPath();
+    void contractionHierarchy();
 
   private:
     std::unique_ptr< QgsVectorLayer > buildNetwork();
+    static std::unique_ptr< QgsGraph > buildGridGraph( int size );
+    static double pathCost( const QgsGraph *graph, const QVector< int > &path );
 
 
 };
@@ -576,6 +586,165 @@ void TestQgsNetworkAnalysis::testRouteFail2()
 }
 
 
+std::unique_ptr< QgsGraph > TestQgsNetworkAnalysis::buildGridGraph( int size )
+{
+  // a grid of one way and two way streets, with costs up to four times the edge length
+  std::unique_ptr< QgsGraph > graph = std::make_unique< QgsGraph >();
+  for ( int y = 0; y < size; ++y )
+  {
+    for ( int x = 0; x < size; ++x )
+      graph->addVertex( QgsPointXY( x + ( ( x * 7 + y * 3 ) % 10 ) / 20.0, y + ( ( x * 5 + y * 11 ) % 10 ) / 20.0 ) );
+  }
+
+  int counter = 0;
+  auto addEdge = [&]( int from, int to )
+  {
+    ++counter;
+    if ( counter % 11 == 0 )
+      return;
+    const double length = graph->vertex( from ).point().distance( graph->vertex( to ).point() );
+    graph->addEdge( from, to, QVector< QVariant >() << length * ( 1 + ( counter * 37 % 13 ) / 4.0 ) );
+  };
+  for ( int y = 0; y < size; ++y )
+  {
+    for ( int x = 0; x < size; ++x )
+    {
+      const int vertex = y * size + x;
+      if ( x + 1 < size )
+      {
+        addEdge( vertex, vertex + 1 );
+        addEdge( vertex + 1, vertex );
+      }
+      if ( y + 1 < size )
+      {
+        addEdge( vertex, vertex + size );
+        addEdge( vertex + size, vertex );
+      }
+    }
+  }
+  return graph;
+}
+
+double TestQgsNetworkAnalysis::pathCost( const QgsGraph *graph, const QVector<int> &path )
+{
+  double cost = 0;
+  for ( int i = 1; i < path.size(); ++i )
+  {
+    double edgeCost = std::numeric_limits< double >::infinity();
+    const QgsGraphEdgeIds edges = graph->vertex( path.at( i - 1 ) ).outgoingEdges();
+    for ( int edgeId : edges )
+    {
+      if ( graph->edge( edgeId ).toVertex() == path.at( i ) )
+        edgeCost = std::min( edgeCost, graph->edge( edgeId ).cost( 0 ).toDouble() );
+    }
+    cost += edgeCost;
+  }
+  return cost;
+}
+
+void TestQgsNetworkAnalysis::shortestPath()
+{
+  std::unique_ptr< QgsGraph > graph = buildGridGraph( 20 );
+  // an isolated vertex
+  const int isolatedIdx = graph->addVertex( QgsPointXY( 50, 50 ) );
+
+  for ( int startVertexIdx : { 0, 57, 211, 399 } )
+  {
+    QVector< int > tree;
+    QVector< double > costs;
+    QgsGraphAnalyzer::dijkstra( graph.get(), startVertexIdx, 0, &tree, &costs );
+
+    for ( int endVertexIdx = 0; endVertexIdx < 400; endVertexIdx += 7 )
+    {
+      QVector< int > path;
+      const double cost = QgsGraphAnalyzer::shortestPath( graph.get(), startVertexIdx, endVertexIdx, 0, &path );
+      if ( std::isinf( costs.at( endVertexIdx ) ) )
+      {
+        QVERIFY( std::isinf( cost ) );
+        QVERIFY( path.isEmpty() );
+        continue;
+      }
+      QGSCOMPARENEAR( cost, costs.at( endVertexIdx ), 0.000001 );
+      QCOMPARE( path.constFirst(), startVertexIdx );
+      QCOMPARE( path.constLast(), endVertexIdx );
+      QGSCOMPARENEAR( pathCost( graph.get(), path ), cost, 0.000001 );
+    }
+  }
+
+  QVector< int > path;
+  QCOMPARE( QgsGraphAnalyzer::shortestPath( graph.get(), 0, 0, 0, &path ), 0.0 );
+  QCOMPARE( path, QVector< int >() << 0 );
+  QVERIFY( std::isinf( QgsGraphAnalyzer::shortestPath( graph.get(), 0, isolatedIdx, 0, &path ) ) );
+  QVERIFY( path.isEmpty() );
+  QVERIFY( std::isinf( QgsGraphAnalyzer::shortestPath( graph.get(), 0, 1000, 0, &path ) ) );
+  QVERIFY( path.isEmpty() );
+}
+
+void TestQgsNetworkAnalysis::contractionHierarchy()
+{
+  std::unique_ptr< QgsGraph > graph = buildGridGraph( 30 );
+  const int isolatedIdx = graph->addVertex( QgsPointXY( 50, 50 ) );
+
+  QgsContractionHierarchy hierarchy( graph.get(), 0 );
+  QVERIFY( hierarchy.isValid() );
+  QCOMPARE( hierarchy.criterion(), 0 );
+  QVERIFY( hierarchy.shortcutCount() > 0 );
+
+  for ( int startVertexIdx : { 0, 57, 211, 463, 899 } )
+  {
+    QVector< int > tree;
+    QVector< double > costs;
+    QgsGraphAnalyzer::dijkstra( graph.get(), startVertexIdx, 0, &tree, &costs );
+
+    for ( int endVertexIdx = 0; endVertexIdx < 900; endVertexIdx += 5 )
+    {
+      QVector< int > path;
+      const double cost = hierarchy.shortestPath( startVertexIdx, endVertexIdx, &path );
+      if ( std::isinf( costs.at( endVertexIdx ) ) )
+      {
+        QVERIFY( std::isinf( cost ) );
+        QVERIFY( path.isEmpty() );
+        continue;
+      }
+      QGSCOMPARENEAR( cost, costs.at( endVertexIdx ), 0.000001 );
+      QCOMPARE( path.constFirst(), startVertexIdx );
+      QCOMPARE( path.constLast(), endVertexIdx );
+      QGSCOMPARENEAR( pathCost( graph.get(), path ), cost, 0.000001 );
+    }
+  }
+
+  QVector< int > path;
+  QVERIFY( std::isinf( hierarchy.shortestPath( 0, isolatedIdx, &path ) ) );
+  QVERIFY( path.isEmpty() );
+  QVERIFY( std::isinf( hierarchy.shortestPath( -1, 0, &path ) ) );
+
+  // save and reload the hierarchy
+  QBuffer buffer;
+  buffer.open( QIODevice::ReadWrite );
+  QVERIFY( hierarchy.write( &buffer ) );
+  buffer.seek( 0 );
+  std::unique_ptr< QgsContractionHierarchy > loaded( QgsContractionHierarchy::read( &buffer, graph.get() ) );
+  QVERIFY( loaded );
+  QVERIFY( loaded->isValid() );
+  QCOMPARE( loaded->shortcutCount(), hierarchy.shortcutCount() );
+  QVector< int > loadedPath;
+  hierarchy.shortestPath( 12, 876, &path );
+  QCOMPARE( loaded->shortestPath( 12, 876, &loadedPath ), hierarchy.shortestPath( 12, 876 ) );
+  QCOMPARE( loadedPath, path );
+
+  // a hierarchy can't be loaded for another graph
+  std::unique_ptr< QgsGraph > otherGraph = buildGridGraph( 30 );
+  otherGraph->addEdge( 0, 899, QVector< QVariant >() << 1.0 );
+  buffer.seek( 0 );
+  QVERIFY( !QgsContractionHierarchy::read( &buffer, otherGraph.get() ) );
+
+  QBuffer invalidBuffer;
+  invalidBuffer.open( QIODevice::ReadWrite );
+  invalidBuffer.write( "not a hierarchy" );
+  invalidBuffer.seek( 0 );
+  QVERIFY( !QgsContractionHierarchy::read( &invalidBuffer, graph.get() ) );
+}
+
 
 QGSTEST_MAIN( TestQgsNetworkAnalysis )
 #include "testqgsnetworkanalysis.moc"
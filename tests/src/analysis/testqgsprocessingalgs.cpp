@@ -61,6 +61,8 @@
 #include "qgsmarkersymbol.h"
 #include "qgsfillsymbol.h"
 
+#include <QThread>
+
 class TestQgsProcessingAlgs: public QObject
 {
     Q_OBJECT
@@ -184,6 +186,10 @@ class TestQgsProcessingAlgs: public QObject
 
     void rasterize();
 
+    void dissolveCascaded();
+    void parallelFeatureProcessing();
+    void networkAnalysisBatches();
+
   private:
 
     bool imageCheck( const QString &testName, const QString &renderedImage );
@@ -6633,6 +6639,246 @@ void TestQgsProcessingAlgs::rasterize()
   QVERIFY( checker.compareImages( "rasterize", 500 ) );
 }
 
+void TestQgsProcessingAlgs::dissolveCascaded()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:dissolve" ) ) );
+  QVERIFY( alg != nullptr );
+
+  // a grid of adjacent squares, large enough to be dissolved in several groups
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Polygon?crs=EPSG:3857&field=half:integer&field=column:integer" ), QStringLiteral( "squares" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int x = 0; x < 60; ++x )
+  {
+    for ( int y = 0; y < 50; ++y )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << ( x < 30 ? 0 : 1 ) << x );
+      f.setGeometry( QgsGeometry::fromRect( QgsRectangle( x, y, x + 1, y + 1 ) ) );
+      features << f;
+    }
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+  QgsProcessingFeedback feedback;
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  // dissolve all
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 1L );
+  QgsFeature f;
+  QVERIFY( outputLayer->getFeatures().nextFeature( f ) );
+  QGSCOMPARENEAR( f.geometry().area(), 3000, 0.0001 );
+  QCOMPARE( f.geometry().constGet()->partCount(), 1 );
+
+  // dissolve by field
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "half" ) );
+  results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 2L );
+  QgsFeatureIterator it = outputLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    QGSCOMPARENEAR( f.geometry().area(), 1500, 0.0001 );
+    QCOMPARE( f.geometry().boundingBox(), f.attribute( 0 ).toInt() == 0 ? QgsRectangle( 0, 0, 30, 50 ) : QgsRectangle( 30, 0, 60, 50 ) );
+  }
+
+  // many groups, collected in several batches. Progress is only reported from the thread running the algorithm
+  QList< double > progress;
+  bool progressFromOtherThread = false;
+  connect( &feedback, &QgsFeedback::progressChanged, this, [&progress, &progressFromOtherThread]( double value )
+  {
+    if ( QThread::currentThread() != qApp->thread() )
+      progressFromOtherThread = true;
+    progress << value;
+  }, Qt::DirectConnection );
+  parameters.insert( QStringLiteral( "FIELD" ), QStringLiteral( "column" ) );
+  results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  QVERIFY( !progressFromOtherThread );
+  QVERIFY( !progress.isEmpty() );
+  QVERIFY( std::is_sorted( progress.begin(), progress.end() ) );
+  QGSCOMPARENEAR( progress.last(), 100, 0.001 );
+  outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 60L );
+  it = outputLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    const int x = f.attribute( 1 ).toInt();
+    QGSCOMPARENEAR( f.geometry().area(), 50, 0.0001 );
+    QCOMPARE( f.geometry().boundingBox(), QgsRectangle( x, 0, x + 1, 50 ) );
+  }
+}
+
+void TestQgsProcessingAlgs::parallelFeatureProcessing()
+{
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:extractvertices" ) ) );
+  QVERIFY( alg != nullptr );
+  QVERIFY( static_cast< QgsProcessingFeatureBasedAlgorithm * >( alg.get() )->supportsParallelFeatureProcessing() );
+
+  // enough features for several batches
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "LineString?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "lines" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer->isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 20000; ++i )
+  {
+    QgsFeature f;
+    f.setAttributes( QgsAttributes() << i );
+    f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(%1 0, %1 1)" ).arg( i ) ) );
+    features << f;
+  }
+  QVERIFY( layer->dataProvider()->addFeatures( features ) );
+
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+  QgsProcessingFeedback feedback;
+  // progress is only reported from the thread running the algorithm
+  QList< double > progress;
+  bool progressFromOtherThread = false;
+  connect( &feedback, &QgsFeedback::progressChanged, this, [&progress, &progressFromOtherThread]( double value )
+  {
+    if ( QThread::currentThread() != qApp->thread() )
+      progressFromOtherThread = true;
+    progress << value;
+  }, Qt::DirectConnection );
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( layer.get() ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  bool ok = false;
+  const QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  QVERIFY( !progressFromOtherThread );
+  QVERIFY( !progress.isEmpty() );
+  QVERIFY( std::is_sorted( progress.begin(), progress.end() ) );
+  QGSCOMPARENEAR( progress.last(), 100, 0.001 );
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), 40000L );
+
+  // features are output in the order of the source
+  QgsFeatureIterator it = outputLayer->getFeatures();
+  QgsFeature f;
+  int index = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( 0 ).toInt(), index / 2 );
+    QCOMPARE( f.geometry().asPoint(), QgsPointXY( index / 2, index % 2 ) );
+    index++;
+  }
+  QCOMPARE( index, 40000 );
+}
+
+void TestQgsProcessingAlgs::networkAnalysisBatches()
+{
+  // a main road along the equator, where WGS84 distances match EPSG:3857 distances, and an isolated road
+  std::unique_ptr< QgsVectorLayer > network = std::make_unique< QgsVectorLayer >( QStringLiteral( "LineString?crs=EPSG:3857" ), QStringLiteral( "network" ), QStringLiteral( "memory" ) );
+  QVERIFY( network->isValid() );
+  QgsFeature f;
+  f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(0 0, 1000 0)" ) ) );
+  QVERIFY( network->dataProvider()->addFeature( f ) );
+  f.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "LineString(2000 0, 2100 0)" ) ) );
+  QVERIFY( network->dataProvider()->addFeature( f ) );
+
+  // more start points than a batch of either algorithm, every fifth one on the isolated road
+  const int pointCount = 16 * std::max( QThread::idealThreadCount(), 1 ) + 7;
+  std::unique_ptr< QgsVectorLayer > startPoints = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=EPSG:3857&field=id:integer" ), QStringLiteral( "start" ), QStringLiteral( "memory" ) );
+  QVERIFY( startPoints->isValid() );
+  QgsFeatureList features;
+  auto startX = [pointCount]( int i ) { return i % 5 == 3 ? 2050.0 : 1000.0 * ( i + 1 ) / ( pointCount + 1 ); };
+  for ( int i = 0; i < pointCount; ++i )
+  {
+    QgsFeature point;
+    point.setAttributes( QgsAttributes() << i );
+    point.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( startX( i ), 1 ) ) );
+    features << point;
+  }
+  QVERIFY( startPoints->dataProvider()->addFeatures( features ) );
+
+  std::unique_ptr< QgsProcessingContext > context = std::make_unique< QgsProcessingContext >();
+  QgsProcessingFeedback feedback;
+
+  std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:shortestpathlayertopoint" ) ) );
+  QVERIFY( alg != nullptr );
+  QVariantMap parameters;
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( network.get() ) );
+  parameters.insert( QStringLiteral( "STRATEGY" ), 0 );
+  parameters.insert( QStringLiteral( "START_POINTS" ), QVariant::fromValue( startPoints.get() ) );
+  parameters.insert( QStringLiteral( "END_POINT" ), QStringLiteral( "0,0 [EPSG:3857]" ) );
+  parameters.insert( QStringLiteral( "OUTPUT" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  bool ok = false;
+  QVariantMap results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  QgsVectorLayer *outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), static_cast< long >( pointCount ) );
+
+  // routes are output in the order of the start points, and unreachable start points have no route
+  QgsFeatureIterator it = outputLayer->getFeatures();
+  int index = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( QStringLiteral( "id" ) ).toInt(), index );
+    if ( index % 5 == 3 )
+    {
+      QVERIFY( !f.hasGeometry() );
+      QVERIFY( f.attribute( QStringLiteral( "cost" ) ).isNull() );
+    }
+    else
+    {
+      const QgsPolylineXY route = f.geometry().asPolyline();
+      QVERIFY( !route.isEmpty() );
+      QGSCOMPARENEAR( route.first().x(), startX( index ), 0.001 );
+      QCOMPARE( route.last(), QgsPointXY( 0, 0 ) );
+      QGSCOMPARENEAR( f.attribute( QStringLiteral( "cost" ) ).toDouble(), startX( index ), 0.001 );
+    }
+    index++;
+  }
+  QCOMPARE( index, pointCount );
+
+  alg.reset( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:serviceareafromlayer" ) ) );
+  QVERIFY( alg != nullptr );
+  parameters.clear();
+  parameters.insert( QStringLiteral( "INPUT" ), QVariant::fromValue( network.get() ) );
+  parameters.insert( QStringLiteral( "STRATEGY" ), 0 );
+  parameters.insert( QStringLiteral( "START_POINTS" ), QVariant::fromValue( startPoints.get() ) );
+  parameters.insert( QStringLiteral( "TRAVEL_COST2" ), 20 );
+  parameters.insert( QStringLiteral( "OUTPUT_LINES" ), QgsProcessing::TEMPORARY_OUTPUT );
+
+  results = alg->run( parameters, *context, &feedback, &ok );
+  QVERIFY( ok );
+  outputLayer = qobject_cast< QgsVectorLayer * >( context->getMapLayer( results.value( QStringLiteral( "OUTPUT_LINES" ) ).toString() ) );
+  QVERIFY( outputLayer );
+  QCOMPARE( outputLayer->featureCount(), static_cast< long >( pointCount ) );
+
+  // service areas are output in the order of the start points, each one only covering its own road
+  it = outputLayer->getFeatures();
+  index = 0;
+  while ( it.nextFeature( f ) )
+  {
+    QCOMPARE( f.attribute( QStringLiteral( "id" ) ).toInt(), index );
+    QCOMPARE( f.attribute( QStringLiteral( "type" ) ).toString(), QStringLiteral( "lines" ) );
+    const QgsRectangle extent = f.geometry().boundingBox();
+    const double x = startX( index );
+    const double roadStart = index % 5 == 3 ? 2000 : 0;
+    const double roadEnd = index % 5 == 3 ? 2100 : 1000;
+    QGSCOMPARENEAR( extent.xMinimum(), std::max( x - 20, roadStart ), 0.001 );
+    QGSCOMPARENEAR( extent.xMaximum(), std::min( x + 20, roadEnd ), 0.001 );
+    index++;
+  }
+  QCOMPARE( index, pointCount );
+}
+
 void TestQgsProcessingAlgs::exportMeshTimeSeries()
 {
   std::unique_ptr< QgsProcessingAlgorithm > alg( QgsApplication::processingRegistry()->createAlgorithmById( QStringLiteral( "native:meshexporttimeseries" ) ) );
@@ -56,6 +56,7 @@ class TestQgsRasterCalculator : public QObject
     void dualOpRasterRaster(); //test dual op on raster ref and raster ref
 
     void calcWithLayers();
+    void calcWithMultipleStrips();
     void calcWithReprojectedLayers();
 
     void errors();
@@ -499,6 +500,54 @@ void TestQgsRasterCalculator::calcWithLayers()
   delete block;
 }
 
+void TestQgsRasterCalculator::calcWithMultipleStrips()
+{
+  // output large enough to be processed in several strips of rows
+  QgsRasterCalculatorEntry entry1;
+  entry1.bandNumber = 1;
+  entry1.raster = mpLandsatRasterLayer;
+  entry1.ref = QStringLiteral( "landsat@1" );
+
+  QgsRasterCalculatorEntry entry2;
+  entry2.bandNumber = 2;
+  entry2.raster = mpLandsatRasterLayer;
+  entry2.ref = QStringLiteral( "landsat@2" );
+
+  QVector<QgsRasterCalculatorEntry> entries;
+  entries << entry1 << entry2;
+
+  QgsCoordinateReferenceSystem crs( QStringLiteral( "EPSG:32633" ) );
+  const QgsRectangle extent = mpLandsatRasterLayer->extent();
+  const int columns = 2000;
+  const int rows = 1500;
+
+  QTemporaryFile tmpFile;
+  tmpFile.open(); // fileName is not available until open
+  QString tmpName = tmpFile.fileName();
+  tmpFile.close();
+
+  QgsRasterCalculator rc( QStringLiteral( "\"landsat@1\" + 2 * \"landsat@2\"" ),
+                          tmpName,
+                          QStringLiteral( "GTiff" ),
+                          extent, crs, columns, rows, entries,
+                          QgsProject::instance()->transformContext() );
+  QCOMPARE( static_cast< int >( rc.processCalculation() ), 0 );
+
+  std::unique_ptr< QgsRasterLayer > result = std::make_unique< QgsRasterLayer >( tmpName, QStringLiteral( "result" ) );
+  QCOMPARE( result->width(), columns );
+  QCOMPARE( result->height(), rows );
+  std::unique_ptr< QgsRasterBlock > resultBlock( result->dataProvider()->block( 1, extent, columns, rows ) );
+  std::unique_ptr< QgsRasterBlock > band1( mpLandsatRasterLayer->dataProvider()->block( 1, extent, columns, rows ) );
+  std::unique_ptr< QgsRasterBlock > band2( mpLandsatRasterLayer->dataProvider()->block( 2, extent, columns, rows ) );
+  for ( int row = 0; row < rows; row += 7 )
+  {
+    for ( int col = 0; col < columns; col += 13 )
+    {
+      QCOMPARE( resultBlock->value( row, col ), band1->value( row, col ) + 2 * band2->value( row, col ) );
+    }
+  }
+}
+
 void TestQgsRasterCalculator::calcWithReprojectedLayers()
 {
   QgsRasterCalculatorEntry entry1;
@@ -23,6 +23,12 @@
 #include "qgszonalstatistics.h"
 #include "qgsproject.h"
 #include "qgsvectorlayerutils.h"
+#include "qgsrasterfilewriter.h"
+#include "qgsrasterdataprovider.h"
+#include "qgsrasterblock.h"
+#include "qgspolygon.h"
+
+#include <QTemporaryFile>
 
 /**
  * \ingroup UnitTests
@@ -43,8 +49,11 @@ class TestQgsZonalStatistics : public QObject
     void testNoData();
     void testSmallPolygons();
     void testShortName();
+    void testTileBased();
 
   private:
+    void compareTileBased( QgsVectorLayer *vectorLayer, QgsRasterLayer *rasterLayer );
+
     QgsVectorLayer *mVectorLayer = nullptr;
     QgsRasterLayer *mRasterLayer = nullptr;
     QString mTempPath;
@@ -360,5 +369,116 @@ void TestQgsZonalStatistics::testShortName()
   QCOMPARE( QgsZonalStatistics::shortName( QgsZonalStatistics::Variance ), QStringLiteral( "variance" ) );
 }
 
+void TestQgsZonalStatistics::compareTileBased( QgsVectorLayer *vectorLayer, QgsRasterLayer *rasterLayer )
+{
+  QgsZonalStatistics zs( vectorLayer, rasterLayer, QStringLiteral( "z" ), 1, QgsZonalStatistics::All );
+  QVERIFY( !zs.tileBasedCalculation() );
+  QCOMPARE( zs.calculateStatistics( nullptr ), QgsZonalStatistics::Success );
+
+  QgsZonalStatistics tiled( vectorLayer, rasterLayer, QStringLiteral( "t" ), 1, QgsZonalStatistics::All );
+  tiled.setTileBasedCalculation( true );
+  QVERIFY( tiled.tileBasedCalculation() );
+  QCOMPARE( tiled.calculateStatistics( nullptr ), QgsZonalStatistics::Success );
+
+  const QList< QgsZonalStatistics::Statistic > statistics
+  {
+    QgsZonalStatistics::Count,
+    QgsZonalStatistics::Sum,
+    QgsZonalStatistics::Mean,
+    QgsZonalStatistics::Median,
+    QgsZonalStatistics::StDev,
+    QgsZonalStatistics::Min,
+    QgsZonalStatistics::Max,
+    QgsZonalStatistics::Range,
+    QgsZonalStatistics::Minority,
+    QgsZonalStatistics::Majority,
+    QgsZonalStatistics::Variety,
+    QgsZonalStatistics::Variance
+  };
+
+  QgsFeature f;
+  QgsFeatureIterator it = vectorLayer->getFeatures();
+  while ( it.nextFeature( f ) )
+  {
+    for ( QgsZonalStatistics::Statistic statistic : statistics )
+    {
+      const QString name = QgsZonalStatistics::shortName( statistic );
+      QCOMPARE( f.attribute( QStringLiteral( "t" ) + name ).isNull(), f.attribute( QStringLiteral( "z" ) + name ).isNull() );
+      QGSCOMPARENEAR( f.attribute( QStringLiteral( "t" ) + name ).toDouble(), f.attribute( QStringLiteral( "z" ) + name ).toDouble(), 0.000001 );
+    }
+  }
+}
+
+void TestQgsZonalStatistics::testTileBased()
+{
+  QString myDataPath( TEST_DATA_DIR ); //defined in CmakeLists.txt
+  QString myTestDataPath = myDataPath + "/zonalstatistics/";
+
+  // the tile based calculation must give the same results as the zone by zone calculation,
+  // including for zones with edges along the pixel centers and zones smaller than a pixel
+  std::unique_ptr< QgsRasterLayer > edgeRasterLayer = std::make_unique< QgsRasterLayer >( myTestDataPath + "edge_problem.asc", QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  std::unique_ptr< QgsVectorLayer > polysLayer = std::make_unique< QgsVectorLayer >( myTestDataPath + "polys.shp", QStringLiteral( "poly" ), QStringLiteral( "ogr" ) );
+  std::unique_ptr< QgsVectorLayer > polys( polysLayer->materialize( QgsFeatureRequest() ) );
+  compareTileBased( polys.get(), edgeRasterLayer.get() );
+
+  std::unique_ptr< QgsRasterLayer > rasterLayer = std::make_unique< QgsRasterLayer >( myTestDataPath + "raster.tif", QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  std::unique_ptr< QgsVectorLayer > smallPolysLayer = std::make_unique< QgsVectorLayer >( myTestDataPath + "small_polys.shp", QStringLiteral( "poly" ), QStringLiteral( "ogr" ) );
+  std::unique_ptr< QgsVectorLayer > smallPolys( smallPolysLayer->materialize( QgsFeatureRequest() ) );
+  compareTileBased( smallPolys.get(), rasterLayer.get() );
+
+  // a raster spanning many tiles, with zones crossing tile boundaries
+  QTemporaryFile tmpFile;
+  tmpFile.open();
+  tmpFile.close();
+  const int nCols = 1300;
+  const int nRows = 1100;
+  const QgsRectangle extent( 0, 0, 1300, 1100 );
+  const QgsCoordinateReferenceSystem crs( QStringLiteral( "EPSG:3857" ) );
+  {
+    QgsRasterFileWriter writer( tmpFile.fileName() );
+    writer.setOutputProviderKey( QStringLiteral( "gdal" ) );
+    writer.setOutputFormat( QStringLiteral( "GTiff" ) );
+    std::unique_ptr< QgsRasterDataProvider > dp( writer.createOneBandRaster( Qgis::DataType::Float32, nCols, nRows, extent, crs ) );
+    QVERIFY( dp->isValid() );
+    dp->setNoDataValue( 1, -9999 );
+    QgsRasterBlock block( Qgis::DataType::Float32, nCols, nRows );
+    for ( int row = 0; row < nRows; ++row )
+    {
+      for ( int col = 0; col < nCols; ++col )
+        block.setValue( row, col, ( row * 7 + col * 3 ) % 50 == 0 ? -9999 : ( row / 10 + col / 20 ) % 13 );
+    }
+    if ( !dp->isEditable() )
+    {
+      QVERIFY( dp->setEditable( true ) );
+    }
+    QVERIFY( dp->writeBlock( &block, 1 ) );
+    QVERIFY( dp->setEditable( false ) );
+  }
+  std::unique_ptr< QgsRasterLayer > largeRasterLayer = std::make_unique< QgsRasterLayer >( tmpFile.fileName(), QStringLiteral( "raster" ), QStringLiteral( "gdal" ) );
+  QVERIFY( largeRasterLayer->isValid() );
+
+  QgsVectorLayer zones( QStringLiteral( "MultiPolygon?crs=epsg:3857" ), QStringLiteral( "zones" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  // a zone with a hole, covering most of the raster
+  QgsFeature feature;
+  feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((-50 -30, 1210.3 40.7, 1280 1050.2, 30.4 1150, -50 -30),(400 400, 800.25 420, 700 700.5, 400 400)))" ) ) );
+  features << feature;
+  // a buffered zone, with arcs crossing tile boundaries
+  feature.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( 511.7, 600.2 ) ).buffer( 170.3, 16 ) );
+  features << feature;
+  // a multipart zone, with a part smaller than a pixel
+  feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((1000 100, 1100 100, 1100 200, 1000 200, 1000 100)),((200.1 900.1, 200.4 900.1, 200.4 900.4, 200.1 900.1)))" ) ) );
+  features << feature;
+  // a zone smaller than a pixel
+  feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((300.1 300.1, 300.7 300.2, 300.4 300.8, 300.1 300.1)))" ) ) );
+  features << feature;
+  // a zone outside of the raster
+  feature.setGeometry( QgsGeometry::fromWkt( QStringLiteral( "MultiPolygon(((2000 2000, 2100 2000, 2100 2100, 2000 2000)))" ) ) );
+  features << feature;
+  QVERIFY( zones.dataProvider()->addFeatures( features ) );
+
+  compareTileBased( &zones, largeRasterLayer.get() );
+}
+
 QGSTEST_MAIN( TestQgsZonalStatistics )
 #include "testqgszonalstatistics.moc"
@@ -1904,6 +1904,121 @@ class TestQgsExpression: public QObject
       run_evaluation_test( exp4, evalError, result );
     }
 
+    void eval_compiled_data()
+    {
+      QTest::addColumn<QString>( "string" );
+
+      QTest::newRow( "int plus" ) << QStringLiteral( "i + 1" );
+      QTest::newRow( "int minus double" ) << QStringLiteral( "i - d" );
+      QTest::newRow( "int mul double" ) << QStringLiteral( "i * d" );
+      QTest::newRow( "int div" ) << QStringLiteral( "i / 2" );
+      QTest::newRow( "int mod" ) << QStringLiteral( "i % 3" );
+      QTest::newRow( "mod zero" ) << QStringLiteral( "i % zero" );
+      QTest::newRow( "div zero" ) << QStringLiteral( "i / zero" );
+      QTest::newRow( "int div zero" ) << QStringLiteral( "i // zero" );
+      QTest::newRow( "double int div" ) << QStringLiteral( "d // 2" );
+      QTest::newRow( "pow" ) << QStringLiteral( "d ^ 2" );
+      QTest::newRow( "nested arithmetic" ) << QStringLiteral( "(i + d) * (i - 2) / 3" );
+      QTest::newRow( "minus int" ) << QStringLiteral( "-i" );
+      QTest::newRow( "minus double" ) << QStringLiteral( "-d" );
+      QTest::newRow( "minus null" ) << QStringLiteral( "-nul" );
+      QTest::newRow( "minus string" ) << QStringLiteral( "-n" );
+      QTest::newRow( "not int" ) << QStringLiteral( "NOT i" );
+      QTest::newRow( "not zero" ) << QStringLiteral( "NOT zero" );
+      QTest::newRow( "not null" ) << QStringLiteral( "NOT nul" );
+      QTest::newRow( "eq" ) << QStringLiteral( "i = 7" );
+      QTest::newRow( "ne" ) << QStringLiteral( "i <> 7" );
+      QTest::newRow( "gt" ) << QStringLiteral( "d > i" );
+      QTest::newRow( "le" ) << QStringLiteral( "d <= 2.5" );
+      QTest::newRow( "is" ) << QStringLiteral( "i IS 7" );
+      QTest::newRow( "is null" ) << QStringLiteral( "nul IS NULL" );
+      QTest::newRow( "is not null" ) << QStringLiteral( "nul IS NOT NULL" );
+      QTest::newRow( "null plus" ) << QStringLiteral( "nul + 1" );
+      QTest::newRow( "null eq" ) << QStringLiteral( "nul = 1" );
+      QTest::newRow( "concat" ) << QStringLiteral( "s || 'x'" );
+      QTest::newRow( "string plus" ) << QStringLiteral( "s + 'x'" );
+      QTest::newRow( "null string plus" ) << QStringLiteral( "nuls + 'x'" );
+      QTest::newRow( "null strings plus" ) << QStringLiteral( "nuls + nuls" );
+      QTest::newRow( "null concat" ) << QStringLiteral( "nuls || 'x'" );
+      QTest::newRow( "concat int" ) << QStringLiteral( "s || i" );
+      QTest::newRow( "string eq" ) << QStringLiteral( "s = 'abc'" );
+      QTest::newRow( "string lt" ) << QStringLiteral( "s < 'b'" );
+      QTest::newRow( "string is" ) << QStringLiteral( "s IS 'ABC'" );
+      QTest::newRow( "numeric string plus" ) << QStringLiteral( "n + 1" );
+      QTest::newRow( "numeric string eq" ) << QStringLiteral( "n = 12" );
+      QTest::newRow( "and" ) << QStringLiteral( "i > 3 AND d < 3" );
+      QTest::newRow( "and short circuit" ) << QStringLiteral( "i > 10 AND s = 'abc'" );
+      QTest::newRow( "or" ) << QStringLiteral( "i > 10 OR d < 3" );
+      QTest::newRow( "or short circuit" ) << QStringLiteral( "i > 3 OR s = 'abc'" );
+      QTest::newRow( "and null" ) << QStringLiteral( "zero AND nul" );
+      QTest::newRow( "or null" ) << QStringLiteral( "nul OR i" );
+      QTest::newRow( "and null unknown" ) << QStringLiteral( "i AND nul" );
+      QTest::newRow( "case" ) << QStringLiteral( "CASE WHEN i > 10 THEN 'big' WHEN i > 5 THEN 'medium' ELSE 'small' END" );
+      QTest::newRow( "case no else" ) << QStringLiteral( "CASE WHEN nul THEN 1 END" );
+      QTest::newRow( "case nested" ) << QStringLiteral( "CASE WHEN i > 5 THEN CASE WHEN d > 2 THEN i * 2 END ELSE 0 END" );
+      QTest::newRow( "like" ) << QStringLiteral( "s LIKE 'a%'" );
+      QTest::newRow( "like null" ) << QStringLiteral( "nul LIKE 'a%'" );
+      QTest::newRow( "function" ) << QStringLiteral( "upper(s) || i" );
+      QTest::newRow( "in" ) << QStringLiteral( "i IN (1, 7)" );
+      QTest::newRow( "function arithmetic" ) << QStringLiteral( "coalesce(nul, i) * 2" );
+      QTest::newRow( "function string" ) << QStringLiteral( "to_int(n) + i" );
+      QTest::newRow( "static" ) << QStringLiteral( "1 + 2 * 3 + i" );
+      QTest::newRow( "date" ) << QStringLiteral( "dt + to_interval('1 day')" );
+      QTest::newRow( "date compare" ) << QStringLiteral( "dt > to_date('2020-01-01')" );
+      QTest::newRow( "arithmetic error" ) << QStringLiteral( "'x' - i" );
+      QTest::newRow( "logic error" ) << QStringLiteral( "'x' AND i" );
+      QTest::newRow( "missing field" ) << QStringLiteral( "missing + 1" );
+    }
+
+    void eval_compiled()
+    {
+      // compiled expressions must give exactly the same results as the node tree
+      QFETCH( QString, string );
+
+      QgsFields fields;
+      fields.append( QgsField( QStringLiteral( "i" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "zero" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "d" ), QVariant::Double ) );
+      fields.append( QgsField( QStringLiteral( "s" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "n" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "nul" ), QVariant::Int ) );
+      fields.append( QgsField( QStringLiteral( "nuls" ), QVariant::String ) );
+      fields.append( QgsField( QStringLiteral( "dt" ), QVariant::Date ) );
+
+      QgsFeature f( fields );
+      f.setAttributes( QgsAttributes() << 7 << 0 << 2.5 << QStringLiteral( "abc" ) << QStringLiteral( "12" )
+                       << QVariant( QVariant::Int ) << QVariant( QVariant::String ) << QDate( 2021, 3, 4 ) );
+      f.setValid( true );
+
+      QgsExpressionContext context = QgsExpressionContextUtils::createFeatureBasedContext( f, fields );
+
+      QgsExpression tree( string );
+      tree.prepare( &context );
+      QVERIFY( !tree.isCompiled() );
+      const QVariant expected = tree.evaluate( &context );
+
+      QgsExpression compiled( string );
+      compiled.prepare( &context );
+      QVERIFY( compiled.compile() );
+      QVERIFY( compiled.isCompiled() );
+      const QVariant result = compiled.evaluate( &context );
+
+      QCOMPARE( compiled.hasEvalError(), tree.hasEvalError() );
+      QCOMPARE( compiled.evalErrorString(), tree.evalErrorString() );
+      QCOMPARE( result.type(), expected.type() );
+      QCOMPARE( result.isNull(), expected.isNull() );
+      QCOMPARE( result, expected );
+
+      // program must be rebuilt when preparing again, and survive implicit sharing
+      QVERIFY( compiled.prepare( &context ) || tree.hasEvalError() );
+      QVERIFY( compiled.isCompiled() );
+      QgsExpression copy( compiled );
+      QCOMPARE( copy.evaluate( &context ), expected );
+      QVERIFY( copy.prepare( &context ) || tree.hasEvalError() );
+      QVERIFY( copy.isCompiled() );
+      QCOMPARE( copy.evaluate( &context ), expected );
+    }
+
     void eval_columns()
     {
       QgsFields fields;
@@ -19,6 +19,10 @@
 #include <QSettings>
 
 #include "qgsfeature.h"
+#include "qgsfeaturebatch.h"
+#include "qgsfeatureiterator.h"
+#include "qgsaggregatecalculator.h"
+#include "qgsvectorlayer.h"
 #include "qgsfield.h"
 #include "qgsgeometry.h"
 #include "qgssymbol.h"
@@ -47,6 +51,7 @@ class TestQgsFeature: public QObject
     void equality();
     void attributeUsingField();
     void dataStream();
+    void batch();
 
 
   private:
@@ -59,6 +64,9 @@ class TestQgsFeature: public QObject
 
 void TestQgsFeature::initTestCase()
 {
+  QgsApplication::init();
+  QgsApplication::initQgis();
+
   //add fields
   QgsField field( QStringLiteral( "field1" ) );
   mFields.append( field );
@@ -76,7 +84,7 @@ void TestQgsFeature::initTestCase()
 
 void TestQgsFeature::cleanupTestCase()
 {
-
+  QgsApplication::exitQgis();
 }
 
 void TestQgsFeature::init()
@@ -582,5 +590,100 @@ void TestQgsFeature::dataStream()
   QCOMPARE( resultFeature.isValid(), originalFeature.isValid() );
 }
 
+void TestQgsFeature::batch()
+{
+  QgsVectorLayer layer( QStringLiteral( "Point?crs=epsg:4326&field=dbl:double&field=int:integer&field=str:string" ), QStringLiteral( "layer" ), QStringLiteral( "memory" ) );
+  QVERIFY( layer.isValid() );
+
+  QgsFeatureList features;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( layer.fields() );
+    f.setAttributes( QgsAttributes() << ( i % 3 == 0 ? QVariant() : QVariant( i * 1.5 ) )
+                     << ( i % 4 == 0 ? QVariant() : QVariant( i ) )
+                     << ( i % 5 == 0 ? QVariant() : QVariant( QStringLiteral( "s%1" ).arg( i ) ) ) );
+    if ( i != 7 )
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    features << f;
+  }
+  QVERIFY( layer.dataProvider()->addFeatures( features ) );
+
+  const QgsAttributeList attributes = QgsAttributeList() << 0 << 1 << 2;
+  QgsFeatureBatch batch( layer.fields(), attributes, true );
+  QCOMPARE( batch.columnCount(), 3 );
+  QCOMPARE( batch.column( 0 ).type(), QgsFeatureBatch::DoubleColumn );
+  QCOMPARE( batch.column( 1 ).type(), QgsFeatureBatch::Int64Column );
+  QCOMPARE( batch.column( 2 ).type(), QgsFeatureBatch::StringColumn );
+  QCOMPARE( batch.columnIndexForField( 2 ), 2 );
+  QCOMPARE( batch.columnIndexForField( 5 ), -1 );
+
+  auto compareBatches = [&layer, &batch]( const QgsFeatureRequest & request, int expectedCount )
+  {
+    QgsFeatureIterator expectedIt = layer.getFeatures( request );
+    QgsFeatureIterator batchIt = layer.getFeatures( request );
+    QgsFeature expected;
+    int total = 0;
+    int count = 0;
+    while ( ( count = batchIt.nextBatch( batch, 3 ) ) > 0 )
+    {
+      QVERIFY( count <= 3 );
+      QCOMPARE( batch.size(), count );
+      for ( int row = 0; row < count; ++row )
+      {
+        QVERIFY( expectedIt.nextFeature( expected ) );
+        QCOMPARE( batch.id( row ), expected.id() );
+        for ( int col = 0; col < batch.columnCount(); ++col )
+        {
+          const QVariant value = expected.attribute( batch.column( col ).fieldIndex() );
+          QCOMPARE( batch.column( col ).isNull( row ), value.isNull() );
+          if ( !value.isNull() )
+            QCOMPARE( batch.column( col ).value( row ), value );
+        }
+        QCOMPARE( batch.hasGeometry( row ), expected.hasGeometry() );
+        if ( expected.hasGeometry() )
+          QCOMPARE( batch.geometry( row ).asWkt(), expected.geometry().asWkt() );
+
+        QgsFeature f = batch.feature( row );
+        QCOMPARE( f.id(), expected.id() );
+        QCOMPARE( f.attribute( 1 ).isNull(), expected.attribute( 1 ).isNull() );
+      }
+      total += count;
+    }
+    QVERIFY( !expectedIt.nextFeature( expected ) );
+    QCOMPARE( total, expectedCount );
+    QVERIFY( batch.isEmpty() );
+  };
+
+  // filled directly by provider
+  compareBatches( QgsFeatureRequest(), 10 );
+  compareBatches( QgsFeatureRequest().setFilterRect( QgsRectangle( 1.5, 1.5, 5.5, 5.5 ) ), 4 );
+  compareBatches( QgsFeatureRequest().setLimit( 5 ), 5 );
+  // filled by feature
+  compareBatches( QgsFeatureRequest().setFilterExpression( QStringLiteral( "\"int\" > 4" ) ), 4 );
+  compareBatches( QgsFeatureRequest().setFilterFids( QgsFeatureIds() << 2 << 3 ), 2 );
+
+  // values which can't be converted to the column type are NULL
+  QgsFeatureBatch converted;
+  converted.addColumn( 2, QgsFeatureBatch::DoubleColumn );
+  QgsFeature f( layer.fields() );
+  f.setAttributes( QgsAttributes() << 1.0 << 2 << QStringLiteral( "abc" ) );
+  converted.appendFeature( f );
+  f.setAttributes( QgsAttributes() << 1.0 << 2 << QStringLiteral( "4.5" ) );
+  converted.appendFeature( f );
+  QCOMPARE( converted.size(), 2 );
+  QVERIFY( converted.column( 0 ).isNull( 0 ) );
+  QVERIFY( !converted.column( 0 ).isNull( 1 ) );
+  QCOMPARE( converted.column( 0 ).doubleValue( 1 ), 4.5 );
+  QVERIFY( !converted.hasGeometry( 1 ) );
+
+  // aggregates use batches for plain fields
+  QgsAggregateCalculator calc( &layer );
+  bool ok = false;
+  QCOMPARE( calc.calculate( QgsAggregateCalculator::Sum, QStringLiteral( "dbl" ), nullptr, &ok ).toDouble(), 40.5 );
+  QVERIFY( ok );
+  QCOMPARE( calc.calculate( QgsAggregateCalculator::CountMissing, QStringLiteral( "dbl" ), nullptr, &ok ).toInt(), 4 );
+  QVERIFY( ok );
+}
+
 QGSTEST_MAIN( TestQgsFeature )
 #include "testqgsfeature.moc"
@@ -226,6 +226,9 @@ class TestQgsGeometry : public QObject
 
     void wktParser();
 
+    void benchmarkLineStringBoundingBox();
+    void benchmarkLineStringTransform();
+
   private:
     //! Must be called before each render test
     void initPainterTest();
@@ -19490,5 +19493,45 @@ void TestQgsGeometry::wktParser()
   QVERIFY( mline.fromWkt( "MultiLineString EMPTY" ) );
   QCOMPARE( mline.asWkt(), QStringLiteral( "MultiLineString EMPTY" ) );
 }
+
+static void benchmarkCoordinates( QVector< double > &x, QVector< double > &y )
+{
+  x.reserve( 100000 );
+  y.reserve( 100000 );
+  for ( int i = 0; i < 100000; ++i )
+  {
+    x << std::cos( i * 0.001 ) * i;
+    y << std::sin( i * 0.001 ) * i;
+  }
+}
+
+void TestQgsGeometry::benchmarkLineStringBoundingBox()
+{
+  QVector< double > x;
+  QVector< double > y;
+  benchmarkCoordinates( x, y );
+  QgsRectangle bounds;
+  QBENCHMARK
+  {
+    // the coordinate arrays are implicitly shared, so this only measures the (uncached) bounding box calculation
+    const QgsLineString line( x, y );
+    bounds = line.boundingBox();
+  }
+  QVERIFY( !bounds.isEmpty() );
+}
+
+void TestQgsGeometry::benchmarkLineStringTransform()
+{
+  QVector< double > x;
+  QVector< double > y;
+  benchmarkCoordinates( x, y );
+  QgsLineString line( x, y );
+  const QTransform transform = QTransform::fromScale( 1.0001, 0.9999 ).rotate( 0.5 ).translate( 10, 20 );
+  QBENCHMARK
+  {
+    line.transform( transform );
+  }
+}
+
 QGSTEST_MAIN( TestQgsGeometry )
 #include "testqgsgeometry.moc"
@@ -34,6 +34,7 @@
 #include "qgslabelingresults.h"
 #include "qgscallout.h"
 #include "qgslinesymbol.h"
+#include "qgsmaprenderercache.h"
 
 class TestQgsLabelingEngine : public QObject
 {
@@ -96,6 +97,8 @@ class TestQgsLabelingEngine : public QObject
     void testLineAnchorHorizontalConstraints();
     void testLineAnchorClipping();
     void testShowAllLabelsWhenALabelHasNoCandidates();
+    void testIndependentComponents();
+    void testReusePlacementsAfterPan();
 
   private:
     QgsVectorLayer *vl = nullptr;
@@ -3684,5 +3687,268 @@ void TestQgsLabelingEngine::testShowAllLabelsWhenALabelHasNoCandidates()
   QVERIFY( imageCheck( QStringLiteral( "show_all_labels_when_no_candidates" ), img, 20 ) );
 }
 
+void TestQgsLabelingEngine::testIndependentComponents()
+{
+  // with SolveComponentsInParallel, clusters of conflicting labels are solved as independent components,
+  // potentially in parallel, and the results must not depend on how the components were scheduled
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+
+  QgsTextFormat format = settings.format();
+  format.setSize( 20 );
+  format.setColor( QColor( 0, 0, 0 ) );
+  settings.setFormat( format );
+
+  settings.fieldName = QStringLiteral( "'label ' || \"id\"" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::AroundPoint;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  int id = 0;
+  const QList< QgsPointXY > clusterCenters = QList< QgsPointXY >() << QgsPointXY( 1500, 1500 ) << QgsPointXY( 5000, 1500 ) << QgsPointXY( 8500, 1500 )
+      << QgsPointXY( 1500, 5500 ) << QgsPointXY( 5000, 5500 ) << QgsPointXY( 8500, 5500 );
+  for ( const QgsPointXY &center : clusterCenters )
+  {
+    for ( int i = 0; i < 4; ++i )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << id++ );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( center.x() + i * 60, center.y() + ( i % 2 ) * 60 ) ) );
+      QVERIFY( vl2->dataProvider()->addFeature( f ) );
+    }
+  }
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );  // TODO: this should not be necessary!
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setLabelingEngineSettings( createLabelEngineSettings() );
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 640, 480 ) );
+  mapSettings.setExtent( QgsRectangle( 0, 0, 10000, 7500 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  QgsLabelingEngineSettings engineSettings = mapSettings.labelingEngineSettings();
+  engineSettings.setFlag( QgsLabelingEngineSettings::DrawLabelRectOnly, true );
+  // the sequential solver remains the default
+  QVERIFY( !engineSettings.testFlag( QgsLabelingEngineSettings::SolveComponentsInParallel ) );
+  engineSettings.setFlag( QgsLabelingEngineSettings::SolveComponentsInParallel, true );
+  mapSettings.setLabelingEngineSettings( engineSettings );
+
+  auto renderLabels = [&mapSettings]
+  {
+    QgsMapRendererSequentialJob job( mapSettings );
+    job.start();
+    job.waitForFinished();
+
+    std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+    QList<QgsLabelPosition> labels = results->labelsWithinRect( mapSettings.extent() );
+    std::sort( labels.begin(), labels.end(), []( const QgsLabelPosition & a, const QgsLabelPosition & b ) { return a.featureId < b.featureId; } );
+    return labels;
+  };
+
+  const QList<QgsLabelPosition> labels = renderLabels();
+  QVERIFY( labels.count() >= clusterCenters.count() );
+  for ( const QgsPointXY &center : clusterCenters )
+  {
+    bool clusterLabeled = false;
+    for ( const QgsLabelPosition &label : labels )
+    {
+      if ( label.labelRect.intersects( QgsRectangle( center.x() - 1500, center.y() - 1500, center.x() + 1500, center.y() + 1500 ) ) )
+        clusterLabeled = true;
+    }
+    QVERIFY( clusterLabeled );
+  }
+
+  for ( int run = 0; run < 5; ++run )
+  {
+    const QList<QgsLabelPosition> otherLabels = renderLabels();
+    QCOMPARE( otherLabels.count(), labels.count() );
+    for ( int i = 0; i < labels.count(); ++i )
+    {
+      QCOMPARE( otherLabels.at( i ).featureId, labels.at( i ).featureId );
+      QCOMPARE( otherLabels.at( i ).labelRect, labels.at( i ).labelRect );
+    }
+  }
+
+  // a cluster rendered on its own forms a single component, which is solved by a plain chain_search()
+  // over the whole problem. Its labels must match the ones found when solving it as one of several components
+  for ( int cluster = 0; cluster < clusterCenters.count(); ++cluster )
+  {
+    QVERIFY( vl2->setSubsetString( QStringLiteral( "\"id\" >= %1 AND \"id\" < %2" ).arg( cluster * 4 ).arg( cluster * 4 + 4 ) ) );
+    const QList<QgsLabelPosition> clusterLabels = renderLabels();
+    QVERIFY( !clusterLabels.isEmpty() );
+    for ( const QgsLabelPosition &clusterLabel : clusterLabels )
+    {
+      auto label = std::find_if( labels.begin(), labels.end(), [&clusterLabel]( const QgsLabelPosition & l ) { return l.featureId == clusterLabel.featureId; } );
+      QVERIFY( label != labels.end() );
+      QCOMPARE( label->labelRect, clusterLabel.labelRect );
+    }
+    // memory provider feature ids start at 1
+    const int labelsInCluster = static_cast< int >( std::count_if( labels.begin(), labels.end(), [cluster]( const QgsLabelPosition & l )
+    {
+      return l.featureId > cluster * 4 && l.featureId <= cluster * 4 + 4;
+    } ) );
+    QCOMPARE( labelsInCluster, clusterLabels.count() );
+  }
+  vl2->setSubsetString( QString() );
+
+  // pairs of points whose preferred candidates do not overlap, while some of their other candidates do.
+  // Each pair forms its own component, and the greedy initial solution cannot be improved by
+  // the chain search, so both solvers must place every label at the same position
+  std::unique_ptr< QgsVectorLayer> vl3( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl3->setRenderer( new QgsNullSymbolRenderer() );
+  format.setSize( 10 );
+  settings.setFormat( format );
+  id = 0;
+  for ( int y = 1000; y < 7000; y += 2000 )
+  {
+    for ( int x = 1000; x < 9000; x += 4000 )
+    {
+      for ( int i = 0; i < 2; ++i )
+      {
+        QgsFeature f;
+        f.setAttributes( QgsAttributes() << id++ );
+        f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( x + i * 1100, y ) ) );
+        QVERIFY( vl3->dataProvider()->addFeature( f ) );
+      }
+    }
+  }
+  vl3->updateExtents();
+  vl3->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );  // TODO: this should not be necessary!
+  vl3->setLabelsEnabled( true );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl3.get() );
+
+  const QList<QgsLabelPosition> componentLabels = renderLabels();
+  engineSettings.setFlag( QgsLabelingEngineSettings::SolveComponentsInParallel, false );
+  mapSettings.setLabelingEngineSettings( engineSettings );
+  const QList<QgsLabelPosition> sequentialLabels = renderLabels();
+
+  QCOMPARE( sequentialLabels.count(), static_cast< int >( vl3->featureCount() ) );
+  QCOMPARE( componentLabels.count(), sequentialLabels.count() );
+  for ( int i = 0; i < sequentialLabels.count(); ++i )
+  {
+    QCOMPARE( componentLabels.at( i ).featureId, sequentialLabels.at( i ).featureId );
+    QCOMPARE( componentLabels.at( i ).labelRect, sequentialLabels.at( i ).labelRect );
+  }
+}
+
+void TestQgsLabelingEngine::testReusePlacementsAfterPan()
+{
+  QgsPalLayerSettings settings;
+  setDefaultLabelParams( settings );
+
+  QgsTextFormat format = settings.format();
+  format.setSize( 10 );
+  format.setColor( QColor( 0, 0, 0 ) );
+  settings.setFormat( format );
+
+  settings.fieldName = QStringLiteral( "\"id\"" );
+  settings.isExpression = true;
+  settings.placement = QgsPalLayerSettings::OverPoint;
+  settings.quadOffset = QgsPalLayerSettings::QuadrantAbove;
+
+  std::unique_ptr< QgsVectorLayer> vl2( new QgsVectorLayer( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "vl" ), QStringLiteral( "memory" ) ) );
+  vl2->setRenderer( new QgsNullSymbolRenderer() );
+
+  int id = 1;
+  for ( int x = 500; x < 12000; x += 1000 )
+  {
+    for ( int y = 500; y < 7000; y += 1000 )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << id++ );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( x, y ) ) );
+      QVERIFY( vl2->dataProvider()->addFeature( f ) );
+    }
+  }
+  vl2->updateExtents();
+
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+  vl2->setLabelsEnabled( true );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setLabelingEngineSettings( createLabelEngineSettings() );
+  mapSettings.setDestinationCrs( vl2->crs() );
+  mapSettings.setOutputSize( QSize( 640, 480 ) );
+  mapSettings.setExtent( QgsRectangle( 0, 0, 10000, 7500 ) );
+  mapSettings.setLayers( QList<QgsMapLayer *>() << vl2.get() );
+  mapSettings.setOutputDpi( 96 );
+
+  QgsLabelingEngineSettings engineSettings = mapSettings.labelingEngineSettings();
+  engineSettings.setFlag( QgsLabelingEngineSettings::DrawLabelRectOnly, true );
+  mapSettings.setLabelingEngineSettings( engineSettings );
+
+  QgsMapRendererCache cache;
+  auto renderLabels = [&cache]( const QgsMapSettings & settings )
+  {
+    cache.updateParameters( settings.visibleExtent(), settings.mapToPixel() );
+    QgsMapRendererSequentialJob job( settings );
+    job.setCache( &cache );
+    job.start();
+    job.waitForFinished();
+
+    QHash< QgsFeatureId, QgsLabelPosition > labels;
+    std::unique_ptr< QgsLabelingResults > results( job.takeLabelingResults() );
+    const QList<QgsLabelPosition> positions = results->labelsWithinRect( settings.visibleExtent() );
+    for ( const QgsLabelPosition &position : positions )
+      labels.insert( position.featureId, position );
+    return labels;
+  };
+
+  const QHash< QgsFeatureId, QgsLabelPosition > labels = renderLabels( mapSettings );
+  QVERIFY( !labels.isEmpty() );
+
+  const QgsLabelPlacements placements = cache.labelPlacements();
+  QCOMPARE( placements.count(), labels.count() );
+  QVERIFY( placements.isCompatible( mapSettings ) );
+
+  // only the extent may change
+  QgsMapSettings zoomed = mapSettings;
+  zoomed.setExtent( QgsRectangle( 0, 0, 20000, 15000 ) );
+  QVERIFY( !placements.isCompatible( zoomed ) );
+  QVERIFY( placements.reusableExtent( zoomed ).isNull() );
+
+  QgsMapSettings panned = mapSettings;
+  panned.setExtent( QgsRectangle( 2000, 0, 12000, 7500 ) );
+  QVERIFY( placements.isCompatible( panned ) );
+  // a margin is applied to the edges which have moved
+  const QgsRectangle reusableExtent = placements.reusableExtent( panned );
+  QGSCOMPARENEAR( reusableExtent.xMinimum(), 2750, 0.001 );
+  QGSCOMPARENEAR( reusableExtent.xMaximum(), 9250, 0.001 );
+  QGSCOMPARENEAR( reusableExtent.yMinimum(), 0, 0.001 );
+  QGSCOMPARENEAR( reusableExtent.yMaximum(), 7500, 0.001 );
+
+  QgsMapSettings disjoint = mapSettings;
+  disjoint.setExtent( QgsRectangle( 20000, 0, 30000, 7500 ) );
+  QVERIFY( placements.reusableExtent( disjoint ).isNull() );
+
+  // change the placement without notifying the cache, so that reused placements can be told apart from new ones
+  settings.quadOffset = QgsPalLayerSettings::QuadrantBelow;
+  vl2->setLabeling( new QgsVectorLayerSimpleLabeling( settings ) );
+
+  const QHash< QgsFeatureId, QgsLabelPosition > pannedLabels = renderLabels( panned );
+
+  // feature at 5500, 3500 is well within the area shared by both extents
+  const QgsFeatureId reusedFid = 5 * 7 + 3 + 1;
+  QVERIFY( labels.contains( reusedFid ) );
+  QVERIFY( pannedLabels.contains( reusedFid ) );
+  QCOMPARE( pannedLabels.value( reusedFid ).labelRect, labels.value( reusedFid ).labelRect );
+  QVERIFY( labels.value( reusedFid ).labelRect.yMinimum() > 3500 - 1 );
+
+  // feature at 11500, 3500 was not visible before, so uses the new placement
+  const QgsFeatureId newFid = 11 * 7 + 3 + 1;
+  QVERIFY( pannedLabels.contains( newFid ) );
+  QVERIFY( pannedLabels.value( newFid ).labelRect.yMaximum() < 3500 + 1 );
+
+  // invalidating the layer discards the placements
+  vl2->triggerRepaint();
+  QVERIFY( cache.labelPlacements().isEmpty() );
+}
+
 QGSTEST_MAIN( TestQgsLabelingEngine )
 #include "testqgslabelingengine.moc"
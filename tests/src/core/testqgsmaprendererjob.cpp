@@ -20,6 +20,7 @@
 #include <QTime>
 #include <QApplication>
 #include <QDesktopServices>
+#include <QThreadPool>
 
 #include "qgsvectorlayer.h"
 #include "qgsvectorfilewriter.h"
@@ -31,6 +32,7 @@
 #include "qgsfield.h"
 #include "qgis.h"
 #include "qgsmaprenderersequentialjob.h"
+#include "qgsmaprendererparalleljob.h"
 #include "qgsmaplayer.h"
 #include "qgsreadwritecontext.h"
 #include "qgsproviderregistry.h"
@@ -45,6 +47,9 @@
 #include "qgssinglesymbolrenderer.h"
 #include "qgsrasterlayertemporalproperties.h"
 #include "qgslinesymbol.h"
+#include "qgsmarkersymbol.h"
+#include "qgsheatmaprenderer.h"
+#include "qgsproperty.h"
 
 //qgs unit test utility class
 #include "qgsmultirenderchecker.h"
@@ -91,9 +96,16 @@ class TestQgsMapRendererJob : public QObject
 
     void temporalRender();
 
+    void parallelLayerTiling();
+    void parallelLayerTilingHeatmap();
+    void parallelLayerTilingDataDefinedSize();
+
   private:
     bool imageCheck( const QString &type, const QImage &image, int mismatchCount = 0 );
 
+    //! Renders the points layer with a parallel job, with or without layer tiling on 4 threads
+    QImage renderPointsParallel( QgsVectorLayer *pointsLayer, bool tiled );
+
     QString mEncoding;
     QgsVectorFileWriter::WriterError mError =  QgsVectorFileWriter::NoError ;
     QgsCoordinateReferenceSystem mCRS;
@@ -947,6 +959,110 @@ void TestQgsMapRendererJob::temporalRender()
 
 }
 
+void TestQgsMapRendererJob::parallelLayerTiling()
+{
+  std::unique_ptr< QgsVectorLayer > polysLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/polys.shp" ),
+      QStringLiteral( "polys" ), QStringLiteral( "ogr" ) );
+  QVERIFY( polysLayer->isValid() );
+  std::unique_ptr< QgsVectorLayer > pointsLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/points.shp" ),
+      QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( pointsLayer->isValid() );
+
+  // large markers will cross tile boundaries
+  std::unique_ptr< QgsMarkerSymbol > marker( QgsMarkerSymbol::createSimple( QVariantMap() ) );
+  marker->setSize( 12 );
+  marker->setColor( QColor( 255, 0, 255 ) );
+  pointsLayer->setRenderer( new QgsSingleSymbolRenderer( marker.release() ) );
+
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( polysLayer->crs() );
+  QgsRectangle extent = polysLayer->extent();
+  extent.combineExtentWith( pointsLayer->extent() );
+  mapSettings.setExtent( extent );
+  mapSettings.setOutputSize( QSize( 512, 512 ) );
+  mapSettings.setFlag( QgsMapSettings::DrawLabeling, false );
+  mapSettings.setOutputDpi( 96 );
+  mapSettings.setLayers( QList< QgsMapLayer * >() << pointsLayer.get() << polysLayer.get() );
+
+  QgsMapRendererParallelJob untiledJob( mapSettings );
+  untiledJob.start();
+  untiledJob.waitForFinished();
+  const QImage untiled = untiledJob.renderedImage();
+
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  mapSettings.setFlag( QgsMapSettings::ParallelLayerTiling, true );
+  QgsMapRendererParallelJob tiledJob( mapSettings );
+  tiledJob.start();
+  tiledJob.waitForFinished();
+  const QImage tiled = tiledJob.renderedImage();
+
+  QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+
+  QVERIFY( tiledJob.errors().isEmpty() );
+  QCOMPARE( tiled, untiled );
+}
+
+QImage TestQgsMapRendererJob::renderPointsParallel( QgsVectorLayer *pointsLayer, bool tiled )
+{
+  QgsMapSettings mapSettings;
+  mapSettings.setDestinationCrs( pointsLayer->crs() );
+  mapSettings.setExtent( pointsLayer->extent() );
+  mapSettings.setOutputSize( QSize( 512, 512 ) );
+  mapSettings.setFlag( QgsMapSettings::DrawLabeling, false );
+  mapSettings.setFlag( QgsMapSettings::ParallelLayerTiling, tiled );
+  mapSettings.setOutputDpi( 96 );
+  mapSettings.setLayers( QList< QgsMapLayer * >() << pointsLayer );
+
+  const int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount( 4 );
+
+  QgsMapRendererParallelJob job( mapSettings );
+  job.start();
+  job.waitForFinished();
+
+  QThreadPool::globalInstance()->setMaxThreadCount( threadCount );
+
+  return job.renderedImage();
+}
+
+void TestQgsMapRendererJob::parallelLayerTilingHeatmap()
+{
+  // the heatmap is normalized with the maximum density of the whole map and
+  // its radius reaches beyond symbol extents: it must not be split into tiles
+  std::unique_ptr< QgsVectorLayer > pointsLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/points.shp" ),
+      QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( pointsLayer->isValid() );
+
+  QgsHeatmapRenderer *renderer = new QgsHeatmapRenderer();
+  renderer->setRadius( 40 );
+  renderer->setRadiusUnit( QgsUnitTypes::RenderPixels );
+  pointsLayer->setRenderer( renderer );
+
+  const QImage untiled = renderPointsParallel( pointsLayer.get(), false );
+  const QImage tiled = renderPointsParallel( pointsLayer.get(), true );
+  QCOMPARE( tiled, untiled );
+}
+
+void TestQgsMapRendererJob::parallelLayerTilingDataDefinedSize()
+{
+  // the symbol extent can't be estimated for data defined sizes, so large markers would be clipped at tile boundaries
+  std::unique_ptr< QgsVectorLayer > pointsLayer = std::make_unique< QgsVectorLayer >( TEST_DATA_DIR + QStringLiteral( "/points.shp" ),
+      QStringLiteral( "points" ), QStringLiteral( "ogr" ) );
+  QVERIFY( pointsLayer->isValid() );
+
+  std::unique_ptr< QgsMarkerSymbol > marker( QgsMarkerSymbol::createSimple( QVariantMap() ) );
+  marker->setSize( 2 );
+  marker->setColor( QColor( 255, 0, 255 ) );
+  marker->setDataDefinedSize( QgsProperty::fromExpression( QStringLiteral( "\"Importance\" / 2" ) ) );
+  pointsLayer->setRenderer( new QgsSingleSymbolRenderer( marker.release() ) );
+
+  const QImage untiled = renderPointsParallel( pointsLayer.get(), false );
+  const QImage tiled = renderPointsParallel( pointsLayer.get(), true );
+  QCOMPARE( tiled, untiled );
+}
+
 bool TestQgsMapRendererJob::imageCheck( const QString &testName, const QImage &image, int mismatchCount )
 {
   mReport += "<h2>" + testName + "</h2>\n";
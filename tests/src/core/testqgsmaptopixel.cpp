@@ -30,6 +30,8 @@ class TestQgsMapToPixel: public QObject
     void fromScale();
     void equality();
     void toMapCoordinates();
+    void transformPolygon();
+    void benchmarkTransformPolygon();
 };
 
 void TestQgsMapToPixel::rotation()
@@ -150,6 +152,45 @@ void TestQgsMapToPixel::toMapCoordinates()
   QCOMPARE( p, QgsPointXY( 20, 20 ) );
 }
 
+void TestQgsMapToPixel::transformPolygon()
+{
+  QgsMapToPixel m2p( 0.5, 5, 5, 10, 10, 30 );
+
+  QPolygonF polygon;
+  polygon << QPointF( 1, 2 ) << QPointF( -3.5, 7 ) << QPointF( 11, -4 ) << QPointF( 5, 5 );
+
+  QPolygonF expected;
+  for ( const QPointF &point : std::as_const( polygon ) )
+    expected << m2p.transform( point.x(), point.y() ).toQPointF();
+
+  m2p.transformInPlace( polygon );
+  QCOMPARE( polygon.size(), expected.size() );
+  for ( int i = 0; i < polygon.size(); ++i )
+  {
+    QGSCOMPARENEAR( polygon.at( i ).x(), expected.at( i ).x(), 0.000001 );
+    QGSCOMPARENEAR( polygon.at( i ).y(), expected.at( i ).y(), 0.000001 );
+  }
+
+  // empty polygon
+  QPolygonF empty;
+  m2p.transformInPlace( empty );
+  QVERIFY( empty.isEmpty() );
+}
+
+void TestQgsMapToPixel::benchmarkTransformPolygon()
+{
+  QgsMapToPixel m2p( 0.5, 5, 5, 1000, 1000, 0 );
+  QPolygonF polygon;
+  polygon.reserve( 100000 );
+  for ( int i = 0; i < 100000; ++i )
+    polygon << QPointF( i % 1000, i / 1000 );
+
+  QBENCHMARK
+  {
+    m2p.transformInPlace( polygon );
+  }
+}
+
 QGSTEST_MAIN( TestQgsMapToPixel )
 #include "testqgsmaptopixel.moc"
 
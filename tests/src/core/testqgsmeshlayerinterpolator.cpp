@@ -39,6 +39,7 @@ class TestQgsMeshLayerInterpolator: public QObject
     void cleanup() {} // will be called after every testfunction.
 
     void testExportRasterBand();
+    void testExportRasterBandLargeBlock();
   private:
     QString mTestDataDir;
 };
@@ -89,5 +90,56 @@ void TestQgsMeshLayerInterpolator::testExportRasterBand()
   QVERIFY( block->isNoData( 10, 10 ) );
 }
 
+void TestQgsMeshLayerInterpolator::testExportRasterBandLargeBlock()
+{
+  QgsMeshLayer memoryLayer( mTestDataDir + "/mesh/quad_and_triangle.2dm",
+                            "Triangle and Quad Mdal",
+                            "mdal" );
+  QVERIFY( memoryLayer.isValid() );
+  QgsMeshDatasetIndex index( 0, 0 ); // bed elevation
+  memoryLayer.setCrs( QgsCoordinateReferenceSystem::fromEpsgId( 27700 ) );
+
+  // small enough to be interpolated in a single thread
+  std::unique_ptr< QgsRasterBlock > block( QgsMeshUtils::exportRasterBlock(
+        memoryLayer,
+        index,
+        memoryLayer.crs(),
+        QgsProject::instance()->transformContext(),
+        5,
+        memoryLayer.extent()
+      ) );
+  QCOMPARE( block->width(), 400 );
+  QCOMPARE( block->height(), 200 );
+
+  // large enough to be interpolated by bands of rows in several threads
+  std::unique_ptr< QgsRasterBlock > largeBlock( QgsMeshUtils::exportRasterBlock(
+        memoryLayer,
+        index,
+        memoryLayer.crs(),
+        QgsProject::instance()->transformContext(),
+        2.5,
+        memoryLayer.extent()
+      ) );
+  QCOMPARE( largeBlock->width(), 800 );
+  QCOMPARE( largeBlock->height(), 400 );
+
+  QCOMPARE( largeBlock->value( 0, 0 ), 10.0 );
+  QVERIFY( largeBlock->isNoData( 0, 799 ) );
+
+  // pixel ( row, col ) of the block is at the same location as pixel ( 2 * row, 2 * col ) of the large block
+  int dataCount = 0;
+  for ( int row = 0; row < block->height(); ++row )
+  {
+    for ( int col = 0; col < block->width(); ++col )
+    {
+      if ( block->isNoData( row, col ) || largeBlock->isNoData( 2 * row, 2 * col ) )
+        continue;
+      QGSCOMPARENEAR( largeBlock->value( 2 * row, 2 * col ), block->value( row, col ), 1e-6 );
+      dataCount++;
+    }
+  }
+  QVERIFY( dataCount > block->width() * block->height() / 2 );
+}
+
 QGSTEST_MAIN( TestQgsMeshLayerInterpolator )
 #include "testqgsmeshlayerinterpolator.moc"
@@ -24,9 +24,12 @@
 #include <qgsproviderregistry.h>
 #include <qgsvectorlayer.h>
 #include <qgsnetworkaccessmanager.h>
+#include <qgsvectorfilewriter.h>
+#include <qgsfeaturebatch.h>
 
 #include <QObject>
 #include <QThread>
+#include <QTemporaryDir>
 
 #include <cpl_conv.h>
 
@@ -50,6 +53,7 @@ class TestQgsOgrProvider : public QObject
     void encodeUri();
     void testThread();
     void testCsvFeatureAddition();
+    void testBatch();
 
   private:
     QString mTestDataDir;
@@ -395,6 +399,99 @@ void TestQgsOgrProvider::testCsvFeatureAddition()
   QFile::remove( csvFilename );
 }
 
+void TestQgsOgrProvider::testBatch()
+{
+  QgsVectorLayer ml( QStringLiteral( "Point?crs=epsg:4326&field=dbl:double&field=int:integer&field=int64:long&field=str:string" ), QStringLiteral( "ml" ), QStringLiteral( "memory" ) );
+  QVERIFY( ml.isValid() );
+  QgsFeatureList features;
+  for ( int i = 0; i < 10; ++i )
+  {
+    QgsFeature f( ml.fields() );
+    f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( i, i ) ) );
+    f.setAttributes( QgsAttributes() << ( i % 3 == 0 ? QVariant() : QVariant( i * 1.5 ) )
+                     << ( i % 4 == 0 ? QVariant() : QVariant( i * 10 ) )
+                     << QVariant( 10000000000LL + i )
+                     << ( i % 5 == 0 ? QVariant() : QVariant( i % 2 ? QStringLiteral( "%1.5" ).arg( i ) : QStringLiteral( "caf\u00e9 %1" ).arg( i ) ) ) );
+    features << f;
+  }
+  QVERIFY( ml.dataProvider()->addFeatures( features ) );
+
+  QTemporaryDir dir;
+  const QString fileName = dir.filePath( QStringLiteral( "batch.gpkg" ) );
+  QgsVectorFileWriter::SaveVectorOptions options;
+  options.driverName = QStringLiteral( "GPKG" );
+  options.layerName = QStringLiteral( "batch" );
+  QCOMPARE( QgsVectorFileWriter::writeAsVectorFormatV3( &ml, fileName, ml.transformContext(), options ), QgsVectorFileWriter::NoError );
+
+  QgsVectorLayer vl( fileName + QStringLiteral( "|layername=batch" ), QStringLiteral( "vl" ), QStringLiteral( "ogr" ) );
+  QVERIFY( vl.isValid() );
+  QCOMPARE( vl.fields().at( 0 ).name(), QStringLiteral( "fid" ) );
+
+  // batches must contain exactly what nextFeature() returns, whether the values are read natively
+  // or converted because the column type does not match the field type
+  auto checkBatches = [&vl]( QgsFeatureBatch batch, const QgsFeatureRequest & request, int expectedCount )
+  {
+    QgsFeatureBatch expected = batch;
+    QgsFeatureIterator featureIt = vl.getFeatures( request );
+    QgsFeature f;
+    while ( featureIt.nextFeature( f ) )
+      expected.appendFeature( f );
+    QCOMPARE( expected.size(), expectedCount );
+
+    QgsFeatureIterator batchIt = vl.getFeatures( request );
+    int row = 0;
+    int count = 0;
+    while ( ( count = batchIt.nextBatch( batch, 3 ) ) > 0 )
+    {
+      QCOMPARE( batch.size(), count );
+      for ( int i = 0; i < count; ++i, ++row )
+      {
+        QCOMPARE( batch.id( i ), expected.id( row ) );
+        for ( int c = 0; c < batch.columnCount(); ++c )
+        {
+          QCOMPARE( batch.column( c ).isNull( i ), expected.column( c ).isNull( row ) );
+          QCOMPARE( batch.column( c ).value( i ), expected.column( c ).value( row ) );
+        }
+        QCOMPARE( batch.hasGeometry( i ), expected.hasGeometry( row ) );
+      }
+    }
+    QCOMPARE( row, expectedCount );
+  };
+
+  QgsAttributeList attributes;
+  for ( int i = 0; i < vl.fields().count(); ++i )
+    attributes << i;
+  const QgsFeatureRequest noGeometry = QgsFeatureRequest().setFlags( QgsFeatureRequest::NoGeometry ).setSubsetOfAttributes( attributes );
+
+  // default column types: fid and integers as Int64Column, double as DoubleColumn, string as StringColumn
+  checkBatches( QgsFeatureBatch( vl.fields(), attributes ), noGeometry, 10 );
+
+  // converted columns
+  QgsFeatureBatch converted;
+  converted.addColumn( 0, QgsFeatureBatch::DoubleColumn );
+  converted.addColumn( 2, QgsFeatureBatch::DoubleColumn );
+  converted.addColumn( 3, QgsFeatureBatch::DoubleColumn );
+  converted.addColumn( 4, QgsFeatureBatch::DoubleColumn );
+  converted.addColumn( 1, QgsFeatureBatch::Int64Column );
+  converted.addColumn( 4, QgsFeatureBatch::Int64Column );
+  converted.addColumn( 1, QgsFeatureBatch::StringColumn );
+  converted.addColumn( 2, QgsFeatureBatch::VariantColumn );
+  converted.addColumn( 4, QgsFeatureBatch::VariantColumn );
+  checkBatches( converted, noGeometry, 10 );
+
+  // limits
+  checkBatches( QgsFeatureBatch( vl.fields(), attributes ), QgsFeatureRequest( noGeometry ).setLimit( 4 ), 4 );
+
+  // subset strings are applied by OGR
+  vl.setSubsetString( QStringLiteral( "\"int64\" > 10000000004" ) );
+  checkBatches( QgsFeatureBatch( vl.fields(), attributes ), noGeometry, 5 );
+  vl.setSubsetString( QString() );
+
+  // geometries and filter rectangles are left to nextFeature()
+  checkBatches( QgsFeatureBatch( vl.fields(), attributes, true ), QgsFeatureRequest(), 10 );
+  checkBatches( QgsFeatureBatch( vl.fields(), attributes ), QgsFeatureRequest( noGeometry ).setFilterRect( QgsRectangle( 1.5, 1.5, 5.5, 5.5 ) ), 4 );
+}
+
 
 QGSTEST_MAIN( TestQgsOgrProvider )
 #include "testqgsogrprovider.moc"
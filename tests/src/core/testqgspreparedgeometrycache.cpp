@@ -0,0 +1,175 @@
+/***************************************************************************
+     testqgspreparedgeometrycache.cpp
+     --------------------------------------
+    Date                 : March 2021
+    Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include "qgsapplication.h"
+#include "qgsgeos.h"
+#include "qgspreparedgeometrycache.h"
+
+class TestQgsPreparedGeometryCache: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+
+    void cacheByFeatureId();
+    void cacheByIdentity();
+    void eviction();
+    void testRelation();
+};
+
+void TestQgsPreparedGeometryCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsPreparedGeometryCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+void TestQgsPreparedGeometryCache::cacheByFeatureId()
+{
+  QgsPreparedGeometryCache cache;
+  const QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+
+  std::shared_ptr< QgsGeos > engine = cache.engine( 1, polygon );
+  QVERIFY( engine );
+  QCOMPARE( cache.count(), 1 );
+  QVERIFY( engine->contains( QgsGeometry::fromWkt( QStringLiteral( "Point(5 5)" ) ).constGet() ) );
+  QVERIFY( !engine->contains( QgsGeometry::fromWkt( QStringLiteral( "Point(15 5)" ) ).constGet() ) );
+
+  // the same id returns the same engine, even for a separately fetched geometry
+  QCOMPARE( cache.engine( 1, QgsGeometry::fromWkt( polygon.asWkt() ) ).get(), engine.get() );
+  QVERIFY( cache.engine( 2, polygon ).get() != engine.get() );
+  QCOMPARE( cache.count(), 2 );
+
+  // removed engines remain usable while referenced
+  cache.remove( 1 );
+  QCOMPARE( cache.count(), 1 );
+  QVERIFY( engine->intersects( QgsGeometry::fromWkt( QStringLiteral( "LineString(-5 5, 5 5)" ) ).constGet() ) );
+  QVERIFY( cache.engine( 1, polygon ).get() != engine.get() );
+
+  QVERIFY( !cache.engine( 3, QgsGeometry() ) );
+
+  cache.clear();
+  QCOMPARE( cache.count(), 0 );
+}
+
+void TestQgsPreparedGeometryCache::cacheByIdentity()
+{
+  QgsPreparedGeometryCache cache;
+  const QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+  const QgsGeometry copy = polygon;
+  const QgsGeometry equal = QgsGeometry::fromWkt( polygon.asWkt() );
+
+  std::shared_ptr< QgsGeos > engine = cache.engine( polygon );
+  QVERIFY( engine );
+  QCOMPARE( cache.engine( copy ).get(), engine.get() );
+  QVERIFY( cache.engine( equal ).get() != engine.get() );
+  QCOMPARE( cache.count(), 2 );
+}
+
+void TestQgsPreparedGeometryCache::eviction()
+{
+  // room for a single square
+  QgsPreparedGeometryCache cache( 8 );
+  QCOMPARE( cache.maximumVertexCount(), 8 );
+  const QgsGeometry square = QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+
+  std::shared_ptr< QgsGeos > engine1 = cache.engine( 1, square );
+  std::shared_ptr< QgsGeos > engine2 = cache.engine( 2, square );
+  QCOMPARE( cache.count(), 1 );
+  // evicted engines remain usable while referenced
+  const QgsGeometry point = QgsGeometry::fromWkt( QStringLiteral( "Point(5 5)" ) );
+  QVERIFY( engine1->contains( point.constGet() ) );
+  QVERIFY( engine2->contains( point.constGet() ) );
+
+  // geometries larger than the cache are not stored, but still prepared
+  cache.setMaximumVertexCount( 2 );
+  QCOMPARE( cache.count(), 0 );
+  std::shared_ptr< QgsGeos > engine3 = cache.engine( 3, square );
+  QVERIFY( engine3 );
+  QCOMPARE( cache.count(), 0 );
+  QVERIFY( engine3->contains( point.constGet() ) );
+}
+
+void TestQgsPreparedGeometryCache::testRelation()
+{
+  const QgsGeometry polygon = QgsGeometry::fromWkt( QStringLiteral( "Polygon((0 0, 10 0, 10 10, 0 10, 0 0))" ) );
+  QgsGeos engine( polygon.constGet() );
+  engine.prepareGeometry();
+
+  const QVector< QgsGeometry > candidates
+  {
+    QgsGeometry::fromWkt( QStringLiteral( "Point(5 5)" ) ),
+    QgsGeometry::fromWkt( QStringLiteral( "Point(15 5)" ) ),
+    QgsGeometry::fromWkt( QStringLiteral( "LineString(-5 5, 5 5)" ) ),
+    QgsGeometry::fromWkt( QStringLiteral( "Polygon((10 0, 20 0, 20 10, 10 10, 10 0))" ) ),
+    QgsGeometry::fromWkt( QStringLiteral( "Polygon((-1 -1, 11 -1, 11 11, -1 11, -1 -1))" ) ),
+    // bounding box overlaps the polygon, but the geometry does not
+    QgsGeometry::fromWkt( QStringLiteral( "LineString(9 12, 12 9)" ) ),
+    QgsGeometry()
+  };
+
+  // results must match the individual predicates
+  const QList< QgsGeos::Relation > relations { QgsGeos::RelationIntersects, QgsGeos::RelationTouches, QgsGeos::RelationCrosses,
+        QgsGeos::RelationWithin, QgsGeos::RelationOverlaps, QgsGeos::RelationContains, QgsGeos::RelationDisjoint };
+  for ( QgsGeos::Relation relation : relations )
+  {
+    const QVector< bool > results = engine.testRelation( candidates, relation );
+    QCOMPARE( results.size(), candidates.size() );
+    for ( int i = 0; i < candidates.size() - 1; ++i )
+    {
+      const QgsAbstractGeometry *candidate = candidates.at( i ).constGet();
+      bool expected = false;
+      switch ( relation )
+      {
+        case QgsGeos::RelationIntersects:
+          expected = engine.intersects( candidate );
+          break;
+        case QgsGeos::RelationTouches:
+          expected = engine.touches( candidate );
+          break;
+        case QgsGeos::RelationCrosses:
+          expected = engine.crosses( candidate );
+          break;
+        case QgsGeos::RelationWithin:
+          expected = engine.within( candidate );
+          break;
+        case QgsGeos::RelationOverlaps:
+          expected = engine.overlaps( candidate );
+          break;
+        case QgsGeos::RelationContains:
+          expected = engine.contains( candidate );
+          break;
+        case QgsGeos::RelationDisjoint:
+          expected = engine.disjoint( candidate );
+          break;
+      }
+      QCOMPARE( results.at( i ), expected );
+    }
+    // null geometries never match
+    QVERIFY( !results.last() );
+  }
+
+  QCOMPARE( engine.testRelation( candidates, QgsGeos::RelationIntersects ), QVector< bool >( { true, false, true, true, true, false, false } ) );
+  QCOMPARE( engine.testRelation( candidates, QgsGeos::RelationWithin ), QVector< bool >( { false, false, false, false, true, false, false } ) );
+}
+
+QGSTEST_MAIN( TestQgsPreparedGeometryCache )
+#include "testqgspreparedgeometrycache.moc"
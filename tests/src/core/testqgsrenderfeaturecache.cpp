@@ -0,0 +1,182 @@
+/***************************************************************************
+     testqgsrenderfeaturecache.cpp
+     --------------------------------------
+    Date                 : March 2021
+    Copyright            : (C) 2021 by the QGIS project
+ ***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qgstest.h"
+#include "qgsapplication.h"
+#include "qgsvectorlayer.h"
+#include "qgsvectorlayerfeatureiterator.h"
+#include "qgsrenderfeaturecache.h"
+#include "qgsmaprenderersequentialjob.h"
+#include "qgsmapsettings.h"
+
+class TestQgsRenderFeatureCache: public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    void initTestCase();// will be called before the first testfunction is executed.
+    void cleanupTestCase();// will be called after the last testfunction was executed.
+
+    void cachedFeatures();
+    void uncachedRequests();
+    void render();
+
+  private:
+    std::unique_ptr< QgsVectorLayer > createLayer() const;
+    static QgsFeatureIds ids( QgsFeatureIterator it );
+};
+
+void TestQgsRenderFeatureCache::initTestCase()
+{
+  QgsApplication::init();
+  QgsApplication::initQgis();
+}
+
+void TestQgsRenderFeatureCache::cleanupTestCase()
+{
+  QgsApplication::exitQgis();
+}
+
+std::unique_ptr< QgsVectorLayer > TestQgsRenderFeatureCache::createLayer() const
+{
+  std::unique_ptr< QgsVectorLayer > layer = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=epsg:3857&field=id:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  int id = 0;
+  for ( int x = 0; x < 100; x += 5 )
+  {
+    for ( int y = 0; y < 100; y += 5 )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << id++ );
+      f.setGeometry( QgsGeometry::fromPointXY( QgsPointXY( x + 0.5, y + 0.5 ) ) );
+      features << f;
+    }
+  }
+  layer->dataProvider()->addFeatures( features );
+  return layer;
+}
+
+QgsFeatureIds TestQgsRenderFeatureCache::ids( QgsFeatureIterator it )
+{
+  QgsFeatureIds ids;
+  QgsFeature f;
+  while ( it.nextFeature( f ) )
+  {
+    // every feature must only be returned once, even when crossing cells
+    if ( ids.contains( f.id() ) )
+      return QgsFeatureIds();
+    ids.insert( f.id() );
+  }
+  return ids;
+}
+
+void TestQgsRenderFeatureCache::cachedFeatures()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  const QString key = QgsRenderFeatureCache::layerKey( layer.get() );
+  QVERIFY( !key.isEmpty() );
+
+  QgsRenderFeatureCache cache( 10 * 1024 * 1024 );
+  QCOMPARE( cache.maximumSize(), 10LL * 1024 * 1024 );
+  QCOMPARE( cache.size(), 0LL );
+
+  const QgsFeatureRequest request = QgsFeatureRequest().setFilterRect( QgsRectangle( 12, 23, 47, 61 ) ).setFilterExpression( QStringLiteral( "id % 2 = 0" ) );
+  QgsVectorLayerFeatureSource source( layer.get() );
+  const QgsFeatureIds expected = ids( source.getFeatures( request ) );
+  QVERIFY( !expected.isEmpty() );
+
+  QCOMPARE( ids( cache.getFeatures( key, &source, request ) ), expected );
+  QVERIFY( cache.size() > 0 );
+
+  // delete all features from the layer - the cached features must be returned regardless
+  layer->dataProvider()->truncate();
+  QgsVectorLayerFeatureSource truncatedSource( layer.get() );
+  QVERIFY( ids( truncatedSource.getFeatures( request ) ).isEmpty() );
+  QCOMPARE( ids( cache.getFeatures( key, &truncatedSource, request ) ), expected );
+
+  // a slightly shifted extent uses the same cells
+  const QgsFeatureRequest shifted = QgsFeatureRequest( request ).setFilterRect( QgsRectangle( 13, 24, 48, 62 ) );
+  QVERIFY( !ids( cache.getFeatures( key, &truncatedSource, shifted ) ).isEmpty() );
+
+  // different filters don't share features
+  const QgsFeatureRequest otherFilter = QgsFeatureRequest( request ).setFilterExpression( QStringLiteral( "id % 2 = 1" ) );
+  QVERIFY( ids( cache.getFeatures( key, &truncatedSource, otherFilter ) ).isEmpty() );
+
+  cache.removeLayer( layer->id() );
+  QCOMPARE( cache.size(), 0LL );
+  QVERIFY( ids( cache.getFeatures( key, &truncatedSource, request ) ).isEmpty() );
+}
+
+void TestQgsRenderFeatureCache::uncachedRequests()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+  const QString key = QgsRenderFeatureCache::layerKey( layer.get() );
+  QgsVectorLayerFeatureSource source( layer.get() );
+
+  QgsRenderFeatureCache cache( 10 * 1024 * 1024 );
+  const QgsRectangle rect( 12, 23, 47, 61 );
+
+  // ordered requests
+  QVERIFY( !ids( cache.getFeatures( key, &source, QgsFeatureRequest().setFilterRect( rect ).addOrderBy( QStringLiteral( "id" ) ) ) ).isEmpty() );
+  QCOMPARE( cache.size(), 0LL );
+
+  // filters depending on the context
+  QVERIFY( !ids( cache.getFeatures( key, &source, QgsFeatureRequest().setFilterRect( rect ).setFilterExpression( QStringLiteral( "@map_scale > 0 or id >= 0" ) ) ) ).isEmpty() );
+  QCOMPARE( cache.size(), 0LL );
+
+  // requests without extent
+  QVERIFY( !ids( cache.getFeatures( key, &source, QgsFeatureRequest() ) ).isEmpty() );
+  QCOMPARE( cache.size(), 0LL );
+
+  // edited layers
+  layer->startEditing();
+  QVERIFY( QgsRenderFeatureCache::layerKey( layer.get() ).isEmpty() );
+  layer->rollBack();
+
+  // disabled cache
+  QgsRenderFeatureCache disabled;
+  QVERIFY( !ids( disabled.getFeatures( key, &source, QgsFeatureRequest().setFilterRect( rect ) ) ).isEmpty() );
+  QCOMPARE( disabled.size(), 0LL );
+}
+
+void TestQgsRenderFeatureCache::render()
+{
+  std::unique_ptr< QgsVectorLayer > layer = createLayer();
+
+  QgsMapSettings settings;
+  settings.setDestinationCrs( layer->crs() );
+  settings.setOutputSize( QSize( 256, 256 ) );
+  settings.setExtent( QgsRectangle( 10, 10, 60, 60 ) );
+  settings.setLayers( QList< QgsMapLayer * >() << layer.get() );
+
+  QgsRenderFeatureCache cache( 10 * 1024 * 1024 );
+
+  QgsMapRendererSequentialJob job( settings );
+  job.setRenderFeatureCache( &cache );
+  job.start();
+  job.waitForFinished();
+  QVERIFY( cache.size() > 0 );
+  const QImage image = job.renderedImage();
+
+  // render again from the cache, after removing the features from the layer
+  layer->dataProvider()->truncate();
+  QgsMapRendererSequentialJob cachedJob( settings );
+  cachedJob.setRenderFeatureCache( &cache );
+  cachedJob.start();
+  cachedJob.waitForFinished();
+  QCOMPARE( cachedJob.renderedImage(), image );
+}
+
+QGSTEST_MAIN( TestQgsRenderFeatureCache )
+#include "testqgsrenderfeaturecache.moc"
@@ -26,6 +26,8 @@
 #include "qgslinestring.h"
 #include "qgslogger.h"
 
+#include <QTemporaryDir>
+
 static QgsFeature _pointFeature( QgsFeatureId id, qreal x, qreal y )
 {
   QgsFeature f( id );
@@ -280,6 +282,74 @@ class TestQgsSpatialIndex : public QObject
       QVERIFY( res.isEmpty() );
     }
 
+    void testPersistence()
+    {
+      QTemporaryDir dir;
+      const QString path = dir.filePath( QStringLiteral( "index.qsix" ) );
+
+      QgsSpatialIndex index( QgsSpatialIndex::FlagStoreFeatureGeometries );
+      for ( int i = 0; i < 1000; ++i )
+      {
+        QgsFeature f( _pointFeature( i, i % 50, i / 50 ) );
+        index.addFeature( f );
+      }
+
+      QString error;
+      QVERIFY( index.writeToFile( path, QStringLiteral( "key" ), &error ) );
+      QVERIFY( error.isEmpty() );
+
+      bool ok = false;
+      QgsSpatialIndex loaded = QgsSpatialIndex::fromFile( path, QStringLiteral( "key" ), &ok, &error );
+      QVERIFY( ok );
+
+      QList<QgsFeatureId> expected = index.intersects( QgsRectangle( 10.5, 2.5, 20.5, 7.5 ) );
+      QList<QgsFeatureId> fids = loaded.intersects( QgsRectangle( 10.5, 2.5, 20.5, 7.5 ) );
+      std::sort( expected.begin(), expected.end() );
+      std::sort( fids.begin(), fids.end() );
+      QCOMPARE( fids.count(), 50 );
+      QCOMPARE( fids, expected );
+      QCOMPARE( loaded.geometry( 51 ).asWkt(), QStringLiteral( "Point (1 1)" ) );
+      QCOMPARE( loaded.nearestNeighbor( QgsPointXY( 3.1, 4.1 ), 1 ), QList< QgsFeatureId >() << 203 );
+
+      // modifying the loaded index must not touch the file
+      QgsFeature f( _pointFeature( 5000, 100, 100 ) );
+      QVERIFY( loaded.addFeature( f ) );
+      QVERIFY( loaded.deleteFeature( _pointFeature( 51, 1, 1 ) ) );
+      QCOMPARE( loaded.intersects( QgsRectangle( 99, 99, 101, 101 ) ), QList< QgsFeatureId >() << 5000 );
+      QVERIFY( loaded.intersects( QgsRectangle( 0.5, 0.5, 1.5, 1.5 ) ).isEmpty() );
+
+      QgsSpatialIndex reloaded = QgsSpatialIndex::fromFile( path, QStringLiteral( "key" ), &ok );
+      QVERIFY( ok );
+      QVERIFY( reloaded.intersects( QgsRectangle( 99, 99, 101, 101 ) ).isEmpty() );
+      QCOMPARE( reloaded.intersects( QgsRectangle( 0.5, 0.5, 1.5, 1.5 ) ), QList< QgsFeatureId >() << 51 );
+
+      // mismatched source key
+      QgsSpatialIndex stale = QgsSpatialIndex::fromFile( path, QStringLiteral( "other key" ), &ok, &error );
+      QVERIFY( !ok );
+      QVERIFY( !error.isEmpty() );
+      QVERIFY( stale.intersects( QgsRectangle( 0, 0, 100, 100 ) ).isEmpty() );
+
+      // not an index file
+      QFile file( dir.filePath( QStringLiteral( "bad.qsix" ) ) );
+      QVERIFY( file.open( QIODevice::WriteOnly ) );
+      file.write( "not a spatial index" );
+      file.close();
+      QgsSpatialIndex::fromFile( file.fileName(), QStringLiteral( "key" ), &ok );
+      QVERIFY( !ok );
+
+      // source keys for file based layers depend on file contents
+      const QString dataPath = dir.filePath( QStringLiteral( "data.csv" ) );
+      QFile data( dataPath );
+      QVERIFY( data.open( QIODevice::WriteOnly ) );
+      data.write( "x,y\n1,2\n" );
+      data.close();
+      const QString key1 = QgsSpatialIndex::indexSourceKey( QStringLiteral( "ogr" ), dataPath );
+      QVERIFY( data.open( QIODevice::Append ) );
+      data.write( "3,4\n" );
+      data.close();
+      QVERIFY( key1 != QgsSpatialIndex::indexSourceKey( QStringLiteral( "ogr" ), dataPath ) );
+    }
+
     void testRetrieveGeometries()
     {
       QgsVectorLayer *vl = new QgsVectorLayer( QStringLiteral( "LineString" ), QStringLiteral( "x" ), QStringLiteral( "memory" ) );
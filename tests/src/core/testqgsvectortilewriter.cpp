@@ -22,6 +22,7 @@
 #include "qgsmbtiles.h"
 #include "qgsproject.h"
 #include "qgstiles.h"
+#include "qgsvectordataprovider.h"
 #include "qgsvectorlayer.h"
 #include "qgsvectortilemvtdecoder.h"
 #include "qgsvectortilelayer.h"
@@ -54,6 +55,7 @@ class TestQgsVectorTileWriter : public QObject
     void test_mbtiles();
     void test_mbtiles_metadata();
     void test_filtering();
+    void test_tileBlocks();
 };
 
 
@@ -315,6 +317,67 @@ void TestQgsVectorTileWriter::test_filtering()
   QCOMPARE( features0["polys"].count(), 0 );
 }
 
+void TestQgsVectorTileWriter::test_tileBlocks()
+{
+  // test writing of a tile range larger than the blocks of tiles encoded together
+
+  QString fileName = QDir::tempPath() + "/test_qgsvectortilewriter_blocks.mbtiles";
+  if ( QFile::exists( fileName ) )
+    QFile::remove( fileName );
+
+  QgsDataSourceUri ds;
+  ds.setParam( "type", "mbtiles" );
+  ds.setParam( "url", fileName );
+
+  // one point at the center of each tile of a 20x20 tiles range at zoom level 6
+  const int zoomLevel = 6;
+  QgsTileMatrix tileMatrix = QgsTileMatrix::fromWebMercator( zoomLevel );
+  std::unique_ptr< QgsVectorLayer > vlPoints = std::make_unique< QgsVectorLayer >( QStringLiteral( "Point?crs=epsg:3857&field=col:integer&field=row:integer" ), QStringLiteral( "points" ), QStringLiteral( "memory" ) );
+  QgsFeatureList features;
+  for ( int row = 10; row < 30; ++row )
+  {
+    for ( int col = 10; col < 30; ++col )
+    {
+      QgsFeature f;
+      f.setAttributes( QgsAttributes() << col << row );
+      f.setGeometry( QgsGeometry::fromPointXY( tileMatrix.tileExtent( QgsTileXYZ( col, row, zoomLevel ) ).center() ) );
+      features << f;
+    }
+  }
+  QVERIFY( vlPoints->dataProvider()->addFeatures( features ) );
+
+  QgsVectorTileWriter writer;
+  writer.setDestinationUri( ds.encodedUri() );
+  writer.setMinZoom( zoomLevel );
+  writer.setMaxZoom( zoomLevel );
+  writer.setLayers( QList<QgsVectorTileWriter::Layer>() << QgsVectorTileWriter::Layer( vlPoints.get() ) );
+
+  QVERIFY( writer.writeTiles() );
+  QVERIFY( writer.errorMessage().isEmpty() );
+
+  QgsMbTiles reader( fileName );
+  QVERIFY( reader.open() );
+
+  QMap<QString, QgsFields> perLayerFields;
+  perLayerFields["points"] = vlPoints->fields();
+  for ( int row = 10; row < 30; ++row )
+  {
+    for ( int col = 10; col < 30; ++col )
+    {
+      const int rowTMS = ( 1 << zoomLevel ) - row - 1;
+      QByteArray tileData;
+      QVERIFY( QgsMbTiles::decodeGzip( reader.tileData( zoomLevel, col, rowTMS ), tileData ) );
+
+      QgsVectorTileMVTDecoder decoder;
+      QVERIFY( decoder.decode( QgsTileXYZ( col, row, zoomLevel ), tileData ) );
+      const QgsVectorTileFeatures tileFeatures = decoder.layerFeatures( perLayerFields, QgsCoordinateTransform() );
+      QCOMPARE( tileFeatures["points"].count(), 1 );
+      QCOMPARE( tileFeatures["points"][0].attribute( 0 ).toInt(), col );
+      QCOMPARE( tileFeatures["points"][0].attribute( 1 ).toInt(), row );
+    }
+  }
+}
+
 
 QGSTEST_MAIN( TestQgsVectorTileWriter )
 #include "testqgsvectortilewriter.moc"
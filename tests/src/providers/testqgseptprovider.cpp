@@ -30,6 +30,7 @@
 #include "qgseptprovider.h"
 #include "qgspointcloudlayer.h"
 #include "qgspointcloudindex.h"
+#include "qgspointcloudrequest.h"
 #include "qgspointcloudlayerelevationproperties.h"
 
 /**
@@ -57,6 +58,7 @@ class TestQgsEptProvider : public QObject
     void validLayerWithEptHierarchy();
     void attributes();
     void calculateZRange();
+    void nodeDataCache();
     void testIdentify();
 
   private:
@@ -256,6 +258,50 @@ void TestQgsEptProvider::calculateZRange()
   QGSCOMPARENEAR( range.upper(), 160.54, 0.01 );
 }
 
+void TestQgsEptProvider::nodeDataCache()
+{
+  std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/sunshine-coast/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
+  QVERIFY( layer->isValid() );
+  QgsPointCloudIndex *index = layer->dataProvider()->index();
+  const IndexedPointCloudNode root = index->root();
+
+  QgsPointCloudAttributeCollection attributes;
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "X" ), QgsPointCloudAttribute::Int32 ) );
+  attributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Classification" ), QgsPointCloudAttribute::Char ) );
+  QgsPointCloudRequest request;
+  request.setAttributes( attributes );
+
+  const qint64 cacheSize = QgsPointCloudIndex::nodeDataCacheSize();
+  QVERIFY( cacheSize > 0 );
+
+  std::unique_ptr< QgsPointCloudBlock > block( index->nodeData( root, request ) );
+  QVERIFY( block );
+  QCOMPARE( block->pointCount(), 253 );
+  QCOMPARE( block->attributes().pointRecordSize(), 5 );
+
+  // the second request is served from the cache, and returns a separate block with the same data
+  std::unique_ptr< QgsPointCloudBlock > cachedBlock( index->nodeData( root, request ) );
+  QVERIFY( cachedBlock );
+  QVERIFY( cachedBlock.get() != block.get() );
+  QCOMPARE( cachedBlock->pointCount(), block->pointCount() );
+  QCOMPARE( QByteArray( cachedBlock->data(), cachedBlock->pointCount() * 5 ), QByteArray( block->data(), block->pointCount() * 5 ) );
+  block.reset();
+  QCOMPARE( cachedBlock->pointCount(), 253 );
+
+  // requests for other attributes are not mixed up
+  QgsPointCloudAttributeCollection otherAttributes;
+  otherAttributes.push_back( QgsPointCloudAttribute( QStringLiteral( "Z" ), QgsPointCloudAttribute::Int32 ) );
+  request.setAttributes( otherAttributes );
+  std::unique_ptr< QgsPointCloudBlock > otherBlock( index->nodeData( root, request ) );
+  QCOMPARE( otherBlock->attributes().pointRecordSize(), 4 );
+
+  // disabled cache
+  QgsPointCloudIndex::setNodeDataCacheSize( 0 );
+  std::unique_ptr< QgsPointCloudBlock > uncachedBlock( index->nodeData( root, request ) );
+  QCOMPARE( uncachedBlock->pointCount(), 253 );
+  QgsPointCloudIndex::setNodeDataCacheSize( cacheSize );
+}
+
 void TestQgsEptProvider::testIdentify()
 {
   std::unique_ptr< QgsPointCloudLayer > layer = std::make_unique< QgsPointCloudLayer >( mTestDataDir + QStringLiteral( "point_clouds/ept/sunshine-coast/ept.json" ), QStringLiteral( "layer" ), QStringLiteral( "ept" ) );
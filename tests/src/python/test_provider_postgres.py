@@ -50,6 +50,7 @@ from qgis.core import (
     QgsVectorDataProvider,
     QgsDataSourceUri,
     QgsProviderConnectionException,
+    QgsAggregateCalculator,
 )
 from qgis.gui import QgsGui, QgsAttributeForm
 from qgis.PyQt.QtCore import QDate, QTime, QDateTime, QVariant, QDir, QObject, QByteArray, QTemporaryDir
@@ -199,6 +200,67 @@ class TestPyQgsPostgresProvider(unittest.TestCase, ProviderTestCase):
         self.assertEqual(f.attributes()[datetime_idx], QDateTime(
             QDate(2004, 3, 4), QTime(13, 41, 52)))
 
+    def testBinaryCursorValues(self):
+        """Test values transferred in binary format, over several batches of features"""
+        query = ('(SELECT i AS id, (i - 15000)::int2 AS i2, (i - 15000) * 0.5::float8 AS f8, i % 2 = 0 AS b, '
+                 'make_date(2000, 1, 1) + (i - 15000) AS d, make_time(0, 0, 0) + make_interval(secs => i + 0.25) AS t, '
+                 'make_timestamp(2000, 1, 1, 0, 0, 0) - make_interval(secs => i) AS ts, NULL::geometry(Point) AS g '
+                 'FROM generate_series(1, 30000) i '
+                 'UNION ALL SELECT 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL)')
+        vl = QgsVectorLayer('{} table="{}" (g) key=\'id\''.format(self.dbconn, query), "binary", "postgres")
+        self.assertTrue(vl.isValid())
+
+        features = {f['id']: f for f in vl.getFeatures()}
+        self.assertEqual(len(features), 30001)
+        for i in (1, 2, 14999, 15000, 15001, 29999, 30000):
+            f = features[i]
+            self.assertEqual(f['i2'], i - 15000)
+            self.assertEqual(f['f8'], (i - 15000) * 0.5)
+            self.assertEqual(f['b'], i % 2 == 0)
+            self.assertEqual(f['d'], QDate(2000, 1, 1).addDays(i - 15000))
+            self.assertEqual(f['t'], QTime(0, 0).addMSecs(i * 1000 + 250))
+            self.assertEqual(f['ts'], QDateTime(QDate(1999, 12, 31), QTime(0, 0).addSecs(86400 - i)))
+        self.assertEqual(features[0].attributes()[1:], [NULL] * 6)
+
+        # stop reading after a few batches, the iterator must discard the batch requested in advance
+        for count, f in enumerate(vl.getFeatures()):
+            if count == 10000:
+                break
+        self.assertEqual(vl.featureCount(), 30001)
+
+    def testBatchValues(self):
+        """Test that the values read in batches by numeric aggregates match the values of the features"""
+        query = ('(SELECT i AS id, (i % 1000 - 500)::int2 AS i2, (i * 7 - 100000)::int4 AS i4, i::int8 * 1000000 AS i8, '
+                 '(i - 15000) * 0.25::float8 AS f8, (i / 3.0)::numeric(10, 2) AS n '
+                 'FROM generate_series(1, 30000) i '
+                 'UNION ALL SELECT 0, NULL, NULL, NULL, NULL, NULL)')
+        vl = QgsVectorLayer('{} table="{}" key=\'id\''.format(self.dbconn, query), "batches", "postgres")
+        self.assertTrue(vl.isValid())
+
+        features = list(vl.getFeatures())
+        self.assertEqual(len(features), 30001)
+        fids = [f.id() for f in features]
+        for field in ('id', 'i2', 'i4', 'i8', 'f8', 'n'):
+            values = [f[field] for f in features if f[field] != NULL]
+            for aggregate, expected in ((QgsAggregateCalculator.Count, len(values)),
+                                        (QgsAggregateCalculator.CountMissing, len(features) - len(values)),
+                                        (QgsAggregateCalculator.Min, min(values)),
+                                        (QgsAggregateCalculator.Max, max(values)),
+                                        (QgsAggregateCalculator.Sum, sum(values))):
+                # without a filter, values are read in batches. A filter on the feature ids reads them with nextFeature()
+                batch_value, ok = vl.aggregate(aggregate, field)
+                self.assertTrue(ok)
+                feature_value, ok = vl.aggregate(aggregate, field, fids=fids)
+                self.assertTrue(ok)
+                self.assertAlmostEqual(batch_value, expected, 2, (field, aggregate))
+                self.assertEqual(batch_value, feature_value, (field, aggregate))
+
+        # subset strings are part of the cursor query, so their features are read in batches too
+        vl.setSubsetString('"id" % 2 = 0')
+        value, ok = vl.aggregate(QgsAggregateCalculator.Sum, 'i4')
+        self.assertTrue(ok)
+        self.assertEqual(value, sum(f['i4'] for f in features if f['id'] % 2 == 0))
+
     def testBooleanType(self):
         vl = QgsVectorLayer('{} table="qgis_test"."boolean_table" sql='.format(
             self.dbconn), "testbool", "postgres")
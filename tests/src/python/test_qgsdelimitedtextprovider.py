@@ -933,6 +933,56 @@ class TestQgsDelimitedTextProviderOther(unittest.TestCase):
         assert vl.fields().at(6).type() == QVariant.Time
         assert vl.fields().at(9).type() == QVariant.String
 
+    def test_048_scan_cache(self):
+        # Scan results cached in a sidecar file
+        (filehandle, filename) = tempfile.mkstemp(suffix='.csv')
+        if os.name == "nt":
+            filename = filename.replace("\\", "/")
+        with os.fdopen(filehandle, "w", encoding="utf-8") as f:
+            f.write("id,x,y,name\n")
+            for i in range(3000):
+                f.write("{0},{1},{2},n\u00e4me {0} \U0001F600\n".format(i, i % 100, i // 100))
+
+        url = MyUrl.fromLocalFile(filename)
+        url.addQueryItem("type", "csv")
+        url.addQueryItem("xField", "x")
+        url.addQueryItem("yField", "y")
+        url.addQueryItem("spatialIndex", "yes")
+        url.addQueryItem("scanCache", "yes")
+        url.addQueryItem("watchFile", "no")
+
+        vl = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+        self.assertTrue(vl.isValid())
+        self.assertTrue(os.path.exists(filename + '.dtcache'))
+
+        # the second layer reads the results from the cache
+        vl2 = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+        self.assertTrue(vl2.isValid())
+        self.assertEqual(vl2.featureCount(), 3000)
+        self.assertEqual(vl2.fields().names(), vl.fields().names())
+        self.assertEqual([f.type() for f in vl2.fields()], [f.type() for f in vl.fields()])
+        self.assertEqual(vl2.extent(), vl.extent())
+        self.assertEqual(vl2.hasSpatialIndex(), QgsFeatureSource.SpatialIndexPresent)
+        request = QgsFeatureRequest().setFilterRect(QgsRectangle(10.5, 5.5, 12.5, 7.5))
+        self.assertEqual(sorted(f['id'] for f in vl2.getFeatures(request)), [611, 612, 711, 712])
+
+        # features are read from the line offsets recorded in the cache, feature ids are line numbers
+        for fid in (2900, 3001, 1500, 2, 2049, 1026):
+            f = vl2.getFeature(fid)
+            self.assertEqual(f['id'], fid - 2)
+            self.assertEqual(f['name'], 'n\u00e4me {} \U0001F600'.format(fid - 2))
+
+        # the cache is not used once the file is modified
+        with open(filename, "a", encoding="utf-8") as f:
+            f.write("3000,0,0,last\n")
+        vl3 = QgsVectorLayer(url.toString(), 'test', 'delimitedtext')
+        self.assertTrue(vl3.isValid())
+        self.assertEqual(vl3.featureCount(), 3001)
+        self.assertEqual(vl3.getFeature(3002)['name'], 'last')
+
+        os.remove(filename + '.dtcache')
+        os.remove(filename)
+
     def testSpatialIndex(self):
         srcpath = os.path.join(TEST_DATA_DIR, 'provider')
         basetestfile = os.path.join(srcpath, 'delimited_xyzm.csv')
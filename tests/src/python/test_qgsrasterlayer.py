@@ -243,6 +243,52 @@ class TestQgsRasterLayer(unittest.TestCase):
             myRasterLayer.dataProvider(), 1, myRasterShader)
         myRasterLayer.setRenderer(myPseudoRenderer)
 
+    def testPseudoColorIntegerBlock(self):
+        """Test that integer rasters, shaded with a color table, render like float rasters"""
+        tempdir = QTemporaryDir()
+        data = np.arange(-50, 250, 0.03).astype(np.int16)[:10000].reshape(100, 100)
+        data[10:20, 10:20] = -9999
+        layers = []
+        for name, data_type in (('int16', gdal.GDT_Int16), ('float32', gdal.GDT_Float32)):
+            path = os.path.join(tempdir.path(), '{}.tif'.format(name))
+            driver = gdal.GetDriverByName('GTiff')
+            out_raster = driver.Create(path, 100, 100, 1, data_type)
+            out_raster.SetGeoTransform([0, 1, 0, 100, 0, -1])
+            out_band = out_raster.GetRasterBand(1)
+            out_band.SetNoDataValue(-9999)
+            out_band.WriteArray(data)
+            out_band.FlushCache()
+            del out_raster
+
+            layer = QgsRasterLayer(path, name)
+            self.assertTrue(layer.isValid())
+            layers.append(layer)
+
+        self.assertEqual(layers[0].dataProvider().dataType(1), Qgis.Int16)
+        self.assertEqual(layers[1].dataProvider().dataType(1), Qgis.Float32)
+
+        for ramp_type in (QgsColorRampShader.Interpolated, QgsColorRampShader.Discrete, QgsColorRampShader.Exact):
+            for clip in (False, True):
+                blocks = []
+                for layer in layers:
+                    color_ramp_shader = QgsColorRampShader()
+                    color_ramp_shader.setColorRampType(ramp_type)
+                    color_ramp_shader.setClip(clip)
+                    color_ramp_shader.setColorRampItemList([QgsColorRampShader.ColorRampItem(0, QColor(255, 255, 0)),
+                                                            QgsColorRampShader.ColorRampItem(100, QColor(255, 0, 255, 100)),
+                                                            QgsColorRampShader.ColorRampItem(200, QColor(0, 255, 0))])
+                    shader = QgsRasterShader()
+                    shader.setRasterShaderFunction(color_ramp_shader)
+                    renderer = QgsSingleBandPseudoColorRenderer(layer.dataProvider(), 1, shader)
+                    renderer.setOpacity(0.5)
+                    block = renderer.block(1, layer.extent(), 100, 100)
+                    self.assertFalse(block.isEmpty())
+                    blocks.append(block)
+
+                self.assertEqual(blocks[0].data(), blocks[1].data())
+                self.assertEqual(blocks[0].color(15, 15), 0)
+                self.assertNotEqual(blocks[0].color(50, 10), 0)
+
     def onRendererChanged(self):
         self.rendererChanged = True
 
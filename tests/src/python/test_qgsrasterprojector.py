@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+"""QGIS Unit tests for QgsRasterProjector.
+
+.. note:: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+"""
+__author__ = 'The QGIS Project'
+__date__ = '22/03/2021'
+__copyright__ = 'Copyright 2021, The QGIS Project'
+
+import qgis  # NOQA
+
+import os
+
+from qgis.core import (QgsRasterLayer,
+                       QgsRasterProjector,
+                       QgsCoordinateReferenceSystem,
+                       QgsCoordinateTransform,
+                       QgsProject)
+from utilities import unitTestDataPath
+from qgis.testing import start_app, unittest
+
+start_app()
+
+
+class TestQgsRasterProjector(unittest.TestCase):
+
+    def setUp(self):
+        self.layer = QgsRasterLayer(os.path.join(unitTestDataPath(), 'landsat.tif'), 'landsat')
+        self.assertTrue(self.layer.isValid())
+        self.provider = self.layer.dataProvider()
+        self.dest_crs = QgsCoordinateReferenceSystem('EPSG:4326')
+        ct = QgsCoordinateTransform(self.provider.crs(), self.dest_crs, QgsProject.instance())
+        self.extent = ct.transformBoundingBox(self.provider.extent())
+
+    def projector(self, precision=QgsRasterProjector.Approximate):
+        projector = QgsRasterProjector()
+        projector.setCrs(self.provider.crs(), self.dest_crs, QgsProject.instance().transformContext())
+        projector.setPrecision(precision)
+        projector.setInput(self.provider)
+        return projector
+
+    def testBlock(self):
+        for precision in (QgsRasterProjector.Approximate, QgsRasterProjector.Exact):
+            # large enough to be reprojected from several threads
+            block = self.projector(precision).block(1, self.extent, 500, 400)
+            self.assertEqual(block.width(), 500)
+            self.assertEqual(block.height(), 400)
+            self.assertFalse(block.isNoData(200, 250))
+
+            small_block = self.projector(precision).block(1, self.extent, 50, 40)
+            self.assertFalse(small_block.isNoData(20, 25))
+
+    def testReuseBlock(self):
+        """
+        Test that the source pixels calculated for a block are reused for the next bands
+        """
+        projector = self.projector()
+        for band in (1, 2, 3, 1):
+            block = projector.block(band, self.extent, 500, 400)
+            expected = self.projector().block(band, self.extent, 500, 400)
+            self.assertEqual(block.data(), expected.data())
+
+        # another extent or precision must not reuse them
+        extent = self.extent.buffered(-self.extent.width() / 10)
+        self.assertEqual(projector.block(1, extent, 500, 400).data(),
+                         self.projector().block(1, extent, 500, 400).data())
+        projector.setPrecision(QgsRasterProjector.Exact)
+        self.assertEqual(projector.block(1, extent, 500, 400).data(),
+                         self.projector(QgsRasterProjector.Exact).block(1, extent, 500, 400).data())
+
+        # nor changing the CRS
+        dest_crs = QgsCoordinateReferenceSystem('EPSG:3857')
+        extent = QgsCoordinateTransform(self.provider.crs(), dest_crs, QgsProject.instance()).transformBoundingBox(self.provider.extent())
+        projector.setCrs(self.provider.crs(), dest_crs, QgsProject.instance().transformContext())
+        expected = QgsRasterProjector()
+        expected.setCrs(self.provider.crs(), dest_crs, QgsProject.instance().transformContext())
+        expected.setPrecision(QgsRasterProjector.Exact)
+        expected.setInput(self.provider)
+        self.assertEqual(projector.block(1, extent, 500, 400).data(),
+                         expected.block(1, extent, 500, 400).data())
+
+
+if __name__ == '__main__':
+    unittest.main()
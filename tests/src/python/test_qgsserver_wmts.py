@@ -20,14 +20,17 @@ import os
 os.environ['QT_HASH_SEED'] = '1'
 
 import re
+import shutil
+import tempfile
 import urllib.request
 import urllib.parse
 import urllib.error
 
-from qgis.server import QgsServerRequest
+from qgis.server import QgsServerRequest, QgsConfigCache
 
 from qgis.testing import unittest
-from qgis.PyQt.QtCore import QSize
+from qgis.PyQt.QtCore import QSize, QBuffer, QIODevice
+from qgis.PyQt.QtGui import QImage, QColor
 
 import osgeo.gdal  # NOQA
 
@@ -229,6 +232,106 @@ class TestQgsServerWMTS(QgsServerTestBase):
         r, h = self._result(self._execute_request(qs))
         self._img_diff_error(r, h, "WMTS_GetTile_Hello_4326_0", 20000)
 
+    def _gettile_query(self, row, col, tile_format='image/png'):
+        return "?" + "&".join(["%s=%s" % i for i in list({
+            "MAP": urllib.parse.quote(self.projectGroupsPath),
+            "SERVICE": "WMTS",
+            "VERSION": "1.0.0",
+            "REQUEST": "GetTile",
+            "LAYER": "QGIS Server Hello World",
+            "STYLE": "",
+            "TILEMATRIXSET": "EPSG:3857",
+            "TILEMATRIX": "1",
+            "TILEROW": str(row),
+            "TILECOL": str(col),
+            "FORMAT": urllib.parse.quote(tile_format)
+        }.items())])
+
+    def _cached_tiles(self, cache_dir):
+        return [os.path.join(root, f) for root, dirs, files in os.walk(cache_dir) for f in files]
+
+    def _tile_diff(self, image, reference):
+        """Returns the fraction of pixels which differ between two tiles"""
+        self.assertEqual(image.size(), reference.size())
+        image = image.convertToFormat(QImage.Format_ARGB32)
+        reference = reference.convertToFormat(QImage.Format_ARGB32)
+        diff = 0
+        for y in range(reference.height()):
+            for x in range(reference.width()):
+                if image.pixel(x, y) != reference.pixel(x, y):
+                    diff += 1
+        return diff / (reference.width() * reference.height())
+
+    def test_wmts_gettile_cache(self):
+        """Test the built-in tile cache, which renders metatiles"""
+
+        # tiles rendered one by one, without cache
+        reference = {}
+        for row in range(2):
+            for col in range(2):
+                r, h = self._result(self._execute_request(self._gettile_query(row, col)))
+                self.assertEqual(h['Content-Type'], 'image/png')
+                reference[(row, col)] = QImage.fromData(r, 'PNG')
+                self.assertFalse(reference[(row, col)].isNull())
+
+        cache_dir = tempfile.mkdtemp()
+        self.server.putenv('QGIS_SERVER_WMTS_CACHE_DIRECTORY', cache_dir)
+        self.server.putenv('QGIS_SERVER_WMTS_METATILE_SIZE', '2')
+        try:
+            # a single request renders the 2x2 metatile, and all of its tiles get stored
+            r, h = self._result(self._execute_request(self._gettile_query(0, 1)))
+            self.assertEqual(h['Content-Type'], 'image/png')
+            image = QImage.fromData(r, 'PNG')
+            self.assertLess(self._tile_diff(image, reference[(0, 1)]), 0.1)
+            tiles = self._cached_tiles(cache_dir)
+            self.assertEqual(len(tiles), 4)
+            for tile in tiles:
+                with open(tile, 'rb') as f:
+                    stored = QImage.fromData(f.read(), 'PNG')
+                row, col = [int(p) for p in tile.split(os.sep)[-2:]]
+                self.assertLess(self._tile_diff(stored, reference[(row, col)]), 0.1)
+
+            # other tiles of the metatile are served from the cache
+            marker = QImage(256, 256, QImage.Format_ARGB32)
+            marker.fill(QColor(255, 0, 0))
+            marker_data = QBuffer()
+            marker_data.open(QIODevice.WriteOnly)
+            marker.save(marker_data, 'PNG')
+            for tile in tiles:
+                with open(tile, 'wb') as f:
+                    f.write(bytes(marker_data.data()))
+            r, h = self._result(self._execute_request(self._gettile_query(1, 0)))
+            self.assertEqual(r, bytes(marker_data.data()))
+            self.assertEqual(len(self._cached_tiles(cache_dir)), 4)
+
+            # removing the project from the configuration cache invalidates its tiles
+            QgsConfigCache.instance().removeEntry(self.projectGroupsPath)
+            self.assertEqual(self._cached_tiles(cache_dir), [])
+            r, h = self._result(self._execute_request(self._gettile_query(1, 0)))
+            self.assertNotEqual(r, bytes(marker_data.data()))
+            self.assertLess(self._tile_diff(QImage.fromData(r, 'PNG'), reference[(1, 0)]), 0.1)
+            self.assertEqual(len(self._cached_tiles(cache_dir)), 4)
+
+            # tiles are encoded like WMS images, with the PNG mode and JPEG format of the request
+            r, h = self._result(self._execute_request(self._gettile_query(1, 1, 'image/png; mode=8bit')))
+            self.assertEqual(h['Content-Type'], 'image/png')
+            image = QImage.fromData(r, 'PNG')
+            self.assertEqual(image.format(), QImage.Format_Indexed8)
+            self.assertEqual(image.size(), QSize(256, 256))
+
+            r, h = self._result(self._execute_request(self._gettile_query(1, 1, 'image/jpeg')))
+            self.assertEqual(h['Content-Type'], 'image/jpeg')
+            image = QImage.fromData(r, 'JPEG')
+            self.assertEqual(image.size(), QSize(256, 256))
+
+            # 4 tiles for each of the 3 formats
+            self.assertEqual(len(self._cached_tiles(cache_dir)), 12)
+        finally:
+            self.server.putenv('QGIS_SERVER_WMTS_CACHE_DIRECTORY', '')
+            self.server.putenv('QGIS_SERVER_WMTS_METATILE_SIZE', '')
+            QgsConfigCache.instance().removeEntry(self.projectGroupsPath)
+            shutil.rmtree(cache_dir, True)
+
     def test_wmts_gettile_invalid_parameters(self):
         qs = "?" + "&".join(["%s=%s" % i for i in list({
             "MAP": urllib.parse.quote(self.projectGroupsPath),